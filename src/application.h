@@ -80,7 +80,26 @@
 /*! Major version of the database model. */
 #define DATABASE_MODEL_MAJOR      0
 /*! Minor version of the database model. */
-#define DATABASE_MODEL_MINOR      2
+#define DATABASE_MODEL_MINOR      9
+/*! Default size of the database connection pool. */
+#define DATABASE_POOL_SIZE        8
+/*! Number of database connections opened at startup. */
+#define DATABASE_POOL_WARM_UP     2
+/*! Default maximum number of statuses per timeline. */
+#define DATABASE_RETENTION_TIMELINE_LIMIT 1000
+/*! Default maximum number of statuses per list. */
+#define DATABASE_RETENTION_LIST_LIMIT     500
+/*! Default maximum age of statuses in seconds (90 days). */
+#define DATABASE_RETENTION_MAX_AGE        7776000
+
+/*! Default number of accounts synchronized in parallel. */
+#define SYNC_THREADS              4
+/*! Default user stream setting. */
+#define SYNC_STREAM_MODE          FALSE
+/*! Default user stream hostname. */
+#define SYNC_STREAM_HOSTNAME      "userstream.twitter.com"
+/*! Default user stream port. */
+#define SYNC_STREAM_PORT          80
 
 /*! Gettext package name. */
 #define GETTEXT_PACKAGE_NAME      "jekyll"
@@ -38,9 +38,74 @@ _database_init_upgrade(TwitterDbHandle *handle, gint major, gint minor, GError *
 {
 	gboolean result = FALSE;
 
+	/* upgrade step by step */
 	if(major == 0 && minor == 1)
 	{
-		result = twitterdb_upgrade_0_1_to_0_2(handle, err);
+		g_debug("Upgrading database: 0.1 => 0.2");
+		if((result = twitterdb_upgrade_0_1_to_0_2(handle, err)))
+		{
+			minor = 2;
+		}
+	}
+
+	if(major == 0 && minor == 2)
+	{
+		g_debug("Upgrading database: 0.2 => 0.3");
+		if((result = twitterdb_upgrade_0_2_to_0_3(handle, err)))
+		{
+			minor = 3;
+		}
+	}
+
+	if(major == 0 && minor == 3)
+	{
+		g_debug("Upgrading database: 0.3 => 0.4");
+		if((result = twitterdb_upgrade_0_3_to_0_4(handle, err)))
+		{
+			minor = 4;
+		}
+	}
+
+	if(major == 0 && minor == 4)
+	{
+		g_debug("Upgrading database: 0.4 => 0.5");
+		if((result = twitterdb_upgrade_0_4_to_0_5(handle, err)))
+		{
+			minor = 5;
+		}
+	}
+
+	if(major == 0 && minor == 5)
+	{
+		g_debug("Upgrading database: 0.5 => 0.6");
+		if((result = twitterdb_upgrade_0_5_to_0_6(handle, err)))
+		{
+			minor = 6;
+		}
+	}
+
+	if(major == 0 && minor == 6)
+	{
+		g_debug("Upgrading database: 0.6 => 0.7");
+		if((result = twitterdb_upgrade_0_6_to_0_7(handle, err)))
+		{
+			minor = 7;
+		}
+	}
+
+	if(major == 0 && minor == 7)
+	{
+		g_debug("Upgrading database: 0.7 => 0.8");
+		if((result = twitterdb_upgrade_0_7_to_0_8(handle, err)))
+		{
+			minor = 8;
+		}
+	}
+
+	if(major == 0 && minor == 8)
+	{
+		g_debug("Upgrading database: 0.8 => 0.9");
+		result = twitterdb_upgrade_0_8_to_0_9(handle, err);
 	}
 
 	return result;
@@ -32,6 +32,7 @@
 #include "../settings.h"
 #include "../pathbuilder.h"
 #include "../database_init.h"
+#include "../twitterdb.h"
 #include "../application.h"
 
 /**
@@ -178,6 +179,34 @@ _gui_enable_account_initialization(Config *config)
 	value_set_bool(value, TRUE);
 }
 
+static void
+_gui_init_database_pool(Config *config)
+{
+	Section *section;
+	Value *value;
+	GError *err = NULL;
+
+	if((section = section_find_first_child(config_get_root(config), "Database")))
+	{
+		if((value = section_find_first_value(section, "pool-size")) && VALUE_IS_INT32(value) && value_get_int32(value) > 0)
+		{
+			twitterdb_set_pool_size(value_get_int32(value));
+		}
+	}
+
+	/* open connections in advance */
+	if(!twitterdb_warm_up(DATABASE_POOL_WARM_UP, &err))
+	{
+		g_warning("Couldn't open database connections");
+	}
+
+	if(err)
+	{
+		g_warning("%s", err->message);
+		g_error_free(err);
+	}
+}
+
 static void
 _gui_save_config(Config *config)
 {
@@ -295,6 +324,9 @@ gui_start(Config *config, Cache *cache)
 
 		if(database_is_valid)
 		{
+			/* initialize database connection pool */
+			_gui_init_database_pool(config);
+
 			/* initialize first account (if neccessary) */
 			g_debug("Testing account initialization status...");
 			if(!(account_is_initialized = _gui_check_account_initialization(config)))
@@ -139,6 +139,10 @@ typedef enum
 	MAINWINDOW_SYNC_STEP_NOTIFY_FOLLOWERS,
 	/*! Updates followers. */
 	MAINWINDOW_SYNC_STEP_FOLLOWERS,
+	/*! Displays a clean-up notification. */
+	MAINWINDOW_SYNC_STEP_NOTIFY_RETENTION,
+	/*! Removes old data from the database. */
+	MAINWINDOW_SYNC_STEP_RETENTION,
 	/*! Last synchronization id. */
 	MAINWINDOW_SYNC_STEP_LAST
 } _MainWindowSyncStep;
@@ -174,9 +178,49 @@ typedef struct
 }
 _MainwindowEditFollowersWorker;
 
+/**
+ * \struct _MainWindowStream
+ * \brief Holds the user stream of an account.
+ */
+typedef struct
+{
+	/*! Mainwindow. */
+	GtkWidget *widget;
+	/*! Name of the user account. */
+	gchar *username;
+	/*! OAuth access key. */
+	gchar *access_key;
+	/*! OAuth access secret. */
+	gchar *access_secret;
+	/*! Thread receiving the stream. */
+	GThread *thread;
+	/*! 1 while the stream thread is running. */
+	volatile gint running;
+	/*! 1 while the stream is connected. */
+	volatile gint connected;
+} _MainWindowStream;
+
 /*! Callback function to process account data. */
 typedef void (* _MainWindowProcessAccountFunc)(GtkWidget *widget, const gchar *username, const gchar *access_key, const gchar *access_secret);
 
+/**
+ * \struct _MainWindowSyncAccountTask
+ * \brief Synchronization of a single account processed by the worker pool.
+ */
+typedef struct
+{
+	/*! The mainwindow. */
+	GtkWidget *widget;
+	/*! Function processing the account. */
+	_MainWindowProcessAccountFunc func;
+	/*! Username of the account. */
+	gchar *username;
+	/*! OAuth access key. */
+	gchar *access_key;
+	/*! OAuth access secret. */
+	gchar *access_secret;
+} _MainWindowSyncAccountTask;
+
 /**
  * \struct _MainWindowPrivate
  * \brief Private data of the mainwindow.
@@ -278,6 +322,22 @@ typedef struct
 		/*! A mutex. */
 		GMutex *mutex;
 	} last_gui_sync;
+	/**
+	 * \struct _streams
+	 * \brief Holds the user streams of the accounts.
+	 *
+	 * \var streams
+	 * \brief User streams of the accounts.
+	 */
+	struct _streams
+	{
+		/*! Streams (_MainWindowStream) indexed by username. */
+		GHashTable *table;
+		/*! Id of the scheduled GUI refresh or 0. */
+		guint refresh_source;
+		/*! Mutex to protect the streams. */
+		GMutex *mutex;
+	} streams;
 	/**
 	 * \struct _sync_state
 	 * \brief Holds state of the synchronization "co-procedure".
@@ -317,6 +377,7 @@ typedef struct
  *	forward declarations:
  */
 static void _mainwindow_search(GtkWidget *mainwindow);
+static gboolean _mainwindow_sync_gui(GtkWidget *widget);
 
 /*
  *	log handler:
@@ -649,6 +710,46 @@ _mainwindow_sync_get_accounts(GtkWidget *widget, gchar ***usernames, gchar ***ac
 	return result;
 }
 
+static gint
+_mainwindow_sync_get_thread_count(GtkWidget *widget)
+{
+	Config *config;
+	Section *section;
+	Value *value;
+	gint threads = SYNC_THREADS;
+
+	config = mainwindow_lock_config(widget);
+
+	if((section = section_find_first_child(config_get_root(config), "Global")))
+	{
+		if((value = section_find_first_value(section, "sync-threads")) && VALUE_IS_INT32(value) && value_get_int32(value) > 0)
+		{
+			threads = value_get_int32(value);
+		}
+	}
+
+	mainwindow_unlock_config(widget);
+
+	return threads;
+}
+
+static void
+_mainwindow_sync_account_worker(_MainWindowSyncAccountTask *task, gpointer user_data)
+{
+	_MainWindowPrivate *private = MAINWINDOW_GET_DATA(task->widget);
+
+	/* skip remaining accounts if the synchronization has been cancelled */
+	if(!g_cancellable_is_cancelled(private->cancellable))
+	{
+		task->func(task->widget, task->username, task->access_key, task->access_secret);
+	}
+
+	g_free(task->username);
+	g_free(task->access_key);
+	g_free(task->access_secret);
+	g_slice_free(_MainWindowSyncAccountTask, task);
+}
+
 static void
 _mainwindow_sync_foreach_account(GtkWidget *widget, _MainWindowProcessAccountFunc func)
 {
@@ -656,17 +757,51 @@ _mainwindow_sync_foreach_account(GtkWidget *widget, _MainWindowProcessAccountFun
 	gchar **access_keys = NULL;
 	gchar **access_secrets = NULL;
 	gint count;
+	gint threads;
+	GThreadPool *pool = NULL;
+	_MainWindowSyncAccountTask *task;
+	GError *err = NULL;
 
 	g_assert(func != NULL);
 
 	count = _mainwindow_sync_get_accounts(widget, &usernames, &access_keys, &access_secrets);
+	threads = MIN(count, _mainwindow_sync_get_thread_count(widget));
+
+	/* synchronize accounts in parallel */
+	if(threads > 1)
+	{
+		g_debug("Synchronizing %d accounts (%d threads)", count, threads);
+
+		if(!(pool = g_thread_pool_new((GFunc)_mainwindow_sync_account_worker, NULL, threads, FALSE, &err)))
+		{
+			g_warning("%s", err->message);
+			g_error_free(err);
+		}
+	}
 
 	for(gint i = 0; i < count; ++i)
 	{
-		func(widget, usernames[i], access_keys[i], access_secrets[i]);
-		g_free(usernames[i]);
-		g_free(access_keys[i]);
-		g_free(access_secrets[i]);
+		task = g_slice_new(_MainWindowSyncAccountTask);
+		task->widget = widget;
+		task->func = func;
+		task->username = usernames[i];
+		task->access_key = access_keys[i];
+		task->access_secret = access_secrets[i];
+
+		if(pool)
+		{
+			g_thread_pool_push(pool, task, NULL);
+		}
+		else
+		{
+			_mainwindow_sync_account_worker(task, NULL);
+		}
+	}
+
+	/* wait until all accounts have been processed */
+	if(pool)
+	{
+		g_thread_pool_free(pool, FALSE, TRUE);
 	}
 
 	g_free(usernames);
@@ -675,7 +810,7 @@ _mainwindow_sync_foreach_account(GtkWidget *widget, _MainWindowProcessAccountFun
 }
 
 static TwitterWebClient *
-_mainwindow_sync_create_twitter_client(const gchar *username, const gchar *access_key, const gchar *access_secret)
+_mainwindow_sync_create_twitter_client(const gchar *username, const gchar *access_key, const gchar *access_secret, GCancellable *cancellable)
 {
 	TwitterWebClient *client;
 
@@ -683,7 +818,7 @@ _mainwindow_sync_create_twitter_client(const gchar *username, const gchar *acces
 	twitter_web_client_set_username(client, username);
 	twitter_web_client_set_oauth_authorization(client, OAUTH_CONSUMER_KEY, OAUTH_CONSUMER_SECRET, access_key, access_secret);
 	twitter_web_client_set_format(client, "xml");
-	g_object_set(G_OBJECT(client), "status-count", MAINWINDOW_DEFAULT_STATUS_COUNT, NULL);
+	g_object_set(G_OBJECT(client), "status-count", MAINWINDOW_DEFAULT_STATUS_COUNT, "background", TRUE, "cancellable", cancellable, NULL);
 
 	return client;
 }
@@ -725,7 +860,7 @@ _mainwindow_sync_copy_user(TwitterUser user, gpointer destination)
 }
 
 static gboolean
-_mainwindow_sync_map_username(TwitterDbHandle *handle, const gchar *username, const gchar *access_key, const gchar *access_secret, gchar guid[], gint size, GError **err)
+_mainwindow_sync_map_username(TwitterDbHandle *handle, const gchar *username, const gchar *access_key, const gchar *access_secret, gchar guid[], gint size, GCancellable *cancellable, GError **err)
 {
 	TwitterWebClient *client;
 	gchar *buffer = NULL;
@@ -739,7 +874,7 @@ _mainwindow_sync_map_username(TwitterDbHandle *handle, const gchar *username, co
 	if(!(result = twitterdb_map_username(handle, username, guid, size, err)))
 	{
 		/* get user from Twitter service */
-		if(!*err && (client = _mainwindow_sync_create_twitter_client(username, access_key, access_secret)))
+		if(!*err && (client = _mainwindow_sync_create_twitter_client(username, access_key, access_secret, cancellable)))
 		{
 			if(twitter_web_client_get_user_details(client, username, &buffer, &length))
 			{
@@ -786,6 +921,349 @@ _mainwindow_sync_map_username(TwitterDbHandle *handle, const gchar *username, co
 	return result;
 }
 
+/*
+ *	user streams:
+ */
+static gboolean
+_mainwindow_stream_get_enabled(GtkWidget *widget)
+{
+	Config *config;
+	Section *section;
+	Value *value;
+	gboolean enabled = SYNC_STREAM_MODE;
+
+	config = mainwindow_lock_config(widget);
+
+	if((section = section_find_first_child(config_get_root(config), "Global")))
+	{
+		if((value = section_find_first_value(section, "stream-mode")) && VALUE_IS_BOOLEAN(value))
+		{
+			enabled = value_get_bool(value);
+		}
+	}
+
+	mainwindow_unlock_config(widget);
+
+	return enabled;
+}
+
+static void
+_mainwindow_stream_set_endpoint(GtkWidget *widget, TwitterWebClient *client)
+{
+	Config *config;
+	Section *section;
+	Value *value;
+
+	config = mainwindow_lock_config(widget);
+
+	if((section = section_find_first_child(config_get_root(config), "Global")))
+	{
+		if((value = section_find_first_value(section, "stream-hostname")) && VALUE_IS_STRING(value) && value_get_string(value))
+		{
+			g_object_set(G_OBJECT(client), "stream-hostname", value_get_string(value), NULL);
+		}
+
+		if((value = section_find_first_value(section, "stream-port")) && VALUE_IS_INT32(value) && value_get_int32(value) > 0 && value_get_int32(value) <= 65535)
+		{
+			g_object_set(G_OBJECT(client), "stream-port", value_get_int32(value), NULL);
+		}
+	}
+
+	mainwindow_unlock_config(widget);
+}
+
+static gboolean
+_mainwindow_stream_refresh_gui(GtkWidget *widget)
+{
+	_MainWindowPrivate *private = MAINWINDOW_GET_DATA(widget);
+
+	g_mutex_lock(private->streams.mutex);
+	private->streams.refresh_source = 0;
+	g_mutex_unlock(private->streams.mutex);
+
+	/* force refresh */
+	g_mutex_lock(private->last_gui_sync.mutex);
+	memset(&private->last_gui_sync.time, 0, sizeof(GTimeVal));
+	g_mutex_unlock(private->last_gui_sync.mutex);
+
+	return _mainwindow_sync_gui(widget);
+}
+
+static void
+_mainwindow_stream_event(TwitterSyncStreamEvent event, _MainWindowStream *stream)
+{
+	_MainWindowPrivate *private = MAINWINDOW_GET_DATA(stream->widget);
+
+	if(event == TWITTERSYNC_STREAM_CONNECTED)
+	{
+		g_debug("User stream of \"%s\" connected", stream->username);
+		g_atomic_int_set(&stream->connected, 1);
+	}
+	else if(event == TWITTERSYNC_STREAM_UPDATED)
+	{
+		/* statuses usually arrive in bursts, so coalesce refreshs */
+		g_mutex_lock(private->streams.mutex);
+
+		if(!private->streams.refresh_source)
+		{
+			private->streams.refresh_source = g_timeout_add_seconds(MAINWINDOW_STREAM_REFRESH_DELAY, (GSourceFunc)_mainwindow_stream_refresh_gui, stream->widget);
+		}
+
+		g_mutex_unlock(private->streams.mutex);
+	}
+}
+
+static void
+_mainwindow_stream_update_timelines(_MainWindowStream *stream)
+{
+	_MainWindowPrivate *private = MAINWINDOW_GET_DATA(stream->widget);
+	TwitterDbHandle *handle;
+	TwitterWebClient *client;
+	gchar user_guid[32];
+	gint count;
+	GTimeVal now;
+	GError *err = NULL;
+
+	g_debug("Fetching statuses missed by the user stream (username=\"%s\")", stream->username);
+
+	if((handle = twitterdb_get_handle(&err)))
+	{
+		if(_mainwindow_sync_map_username(handle, stream->username, stream->access_key, stream->access_secret, user_guid, 32, private->cancellable, &err))
+		{
+			client = _mainwindow_sync_create_twitter_client(stream->username, stream->access_key, stream->access_secret, private->cancellable);
+
+			if(twittersync_update_timelines(handle, client, &count, private->cancellable, &err))
+			{
+				g_get_current_time(&now);
+				twitterdb_set_last_sync(handle, TWITTERDB_SYNC_SOURCE_TIMELINES, user_guid, now.tv_sec);
+
+				if(count)
+				{
+					_mainwindow_stream_event(TWITTERSYNC_STREAM_UPDATED, stream);
+				}
+			}
+
+			g_object_unref(client);
+		}
+
+		twitterdb_close_handle(handle);
+	}
+
+	if(err)
+	{
+		g_warning("%s", err->message);
+		g_error_free(err);
+	}
+}
+
+static gboolean
+_mainwindow_stream_wait(GCancellable *cancellable, gint milliseconds)
+{
+	while(milliseconds > 0 && !g_cancellable_is_cancelled(cancellable))
+	{
+		g_usleep(MIN(milliseconds, 100) * 1000);
+		milliseconds -= 100;
+	}
+
+	return !g_cancellable_is_cancelled(cancellable);
+}
+
+static gpointer
+_mainwindow_stream_thread(_MainWindowStream *stream)
+{
+	_MainWindowPrivate *private = MAINWINDOW_GET_DATA(stream->widget);
+	TwitterDbHandle *handle;
+	TwitterWebClient *client;
+	gboolean closed;
+	gboolean connected;
+	gboolean first = TRUE;
+	gint network_delay = 0;
+	gint http_delay = 0;
+	gint delay;
+	GError *err = NULL;
+
+	g_debug("Starting user stream thread (username=\"%s\")", stream->username);
+
+	while(!g_cancellable_is_cancelled(private->cancellable) && _mainwindow_stream_get_enabled(stream->widget))
+	{
+		/* the first connect is preceded by a regular timeline synchronization */
+		if(!first)
+		{
+			_mainwindow_stream_update_timelines(stream);
+		}
+
+		first = FALSE;
+		closed = FALSE;
+
+		if((handle = twitterdb_get_handle(&err)))
+		{
+			client = _mainwindow_sync_create_twitter_client(stream->username, stream->access_key, stream->access_secret, private->cancellable);
+			_mainwindow_stream_set_endpoint(stream->widget, client);
+
+			closed = twittersync_process_user_stream(handle, client, (TwitterSyncStreamFunc)_mainwindow_stream_event, stream, private->cancellable, &err);
+
+			g_object_unref(client);
+			twitterdb_close_handle(handle);
+		}
+
+		connected = g_atomic_int_get(&stream->connected);
+		g_atomic_int_set(&stream->connected, 0);
+
+		if(g_cancellable_is_cancelled(private->cancellable))
+		{
+			break;
+		}
+
+		/* start over once the stream has been working */
+		if(connected)
+		{
+			network_delay = 0;
+			http_delay = 0;
+		}
+
+		if(closed || !err || !err->code)
+		{
+			/* network error: back off linearly */
+			network_delay = MIN(network_delay + MAINWINDOW_STREAM_NETWORK_BACKOFF, MAINWINDOW_STREAM_NETWORK_BACKOFF_MAX);
+			delay = network_delay;
+		}
+		else
+		{
+			/* HTTP error: back off exponentially */
+			if(err->code == 420)
+			{
+				http_delay = MAX(MIN(http_delay * 2, MAINWINDOW_STREAM_HTTP_BACKOFF_MAX), MAINWINDOW_STREAM_RATE_LIMIT_BACKOFF);
+			}
+			else
+			{
+				http_delay = http_delay ? MIN(http_delay * 2, MAINWINDOW_STREAM_HTTP_BACKOFF_MAX) : MAINWINDOW_STREAM_HTTP_BACKOFF;
+			}
+
+			delay = http_delay;
+		}
+
+		g_warning("User stream of \"%s\" closed (%s), reconnecting in %d ms", stream->username, err ? err->message : "remote host closed connection", delay);
+
+		if(err)
+		{
+			g_error_free(err);
+			err = NULL;
+		}
+
+		_mainwindow_stream_wait(private->cancellable, delay);
+	}
+
+	if(err)
+	{
+		g_error_free(err);
+	}
+
+	g_debug("User stream thread has been finished (username=\"%s\")", stream->username);
+	g_atomic_int_set(&stream->running, 0);
+
+	return NULL;
+}
+
+static void
+_mainwindow_stream_free(_MainWindowStream *stream)
+{
+	g_free(stream->username);
+	g_free(stream->access_key);
+	g_free(stream->access_secret);
+	g_slice_free(_MainWindowStream, stream);
+}
+
+static gboolean
+_mainwindow_stream_open(GtkWidget *widget, const gchar *username, const gchar *access_key, const gchar *access_secret)
+{
+	_MainWindowPrivate *private = MAINWINDOW_GET_DATA(widget);
+	_MainWindowStream *stream;
+	gboolean connected = FALSE;
+	GError *err = NULL;
+
+	g_mutex_lock(private->streams.mutex);
+
+	/* remove finished stream */
+	if((stream = g_hash_table_lookup(private->streams.table, username)) && !g_atomic_int_get(&stream->running))
+	{
+		g_thread_join(stream->thread);
+		g_hash_table_remove(private->streams.table, username);
+		stream = NULL;
+	}
+
+	if(stream)
+	{
+		connected = g_atomic_int_get(&stream->connected);
+	}
+	else if(!g_cancellable_is_cancelled(private->cancellable))
+	{
+		stream = g_slice_new0(_MainWindowStream);
+		stream->widget = widget;
+		stream->username = g_strdup(username);
+		stream->access_key = g_strdup(access_key);
+		stream->access_secret = g_strdup(access_secret);
+		stream->running = 1;
+
+		if((stream->thread = g_thread_create((GThreadFunc)_mainwindow_stream_thread, stream, TRUE, &err)))
+		{
+			g_hash_table_insert(private->streams.table, stream->username, stream);
+		}
+		else
+		{
+			g_warning("%s", err->message);
+			g_error_free(err);
+			_mainwindow_stream_free(stream);
+		}
+	}
+
+	g_mutex_unlock(private->streams.mutex);
+
+	return connected;
+}
+
+static void
+_mainwindow_stream_close_all(GtkWidget *widget)
+{
+	_MainWindowPrivate *private = MAINWINDOW_GET_DATA(widget);
+	GHashTableIter iter;
+	_MainWindowStream *stream;
+	GList *threads = NULL;
+	GList *iter_thread;
+
+	/* stream threads exit when the cancellable has been cancelled */
+	g_mutex_lock(private->streams.mutex);
+
+	g_hash_table_iter_init(&iter, private->streams.table);
+
+	while(g_hash_table_iter_next(&iter, NULL, (gpointer *)&stream))
+	{
+		threads = g_list_prepend(threads, stream->thread);
+	}
+
+	g_mutex_unlock(private->streams.mutex);
+
+	/* stream threads may lock the mutex, so join them unlocked */
+	for(iter_thread = threads; iter_thread; iter_thread = iter_thread->next)
+	{
+		g_thread_join((GThread *)iter_thread->data);
+	}
+
+	g_list_free(threads);
+
+	g_mutex_lock(private->streams.mutex);
+
+	if(private->streams.refresh_source)
+	{
+		g_source_remove(private->streams.refresh_source);
+		private->streams.refresh_source = 0;
+	}
+
+	g_hash_table_destroy(private->streams.table);
+	private->streams.table = NULL;
+
+	g_mutex_unlock(private->streams.mutex);
+}
+
 static void
 _mainwindow_sync_timelines(GtkWidget *widget, const gchar *username, const gchar *access_key, const gchar *access_secret)
 {
@@ -802,9 +1280,16 @@ _mainwindow_sync_timelines(GtkWidget *widget, const gchar *username, const gchar
 
 	private = MAINWINDOW_GET_DATA(widget);
 
+	/* poll timelines only while the user stream isn't connected */
+	if(_mainwindow_stream_get_enabled(widget) && _mainwindow_stream_open(widget, username, access_key, access_secret))
+	{
+		g_debug("Timelines of \"%s\" are received from the user stream", username);
+		return;
+	}
+
 	if((handle = twitterdb_get_handle(&err)))
 	{
-		if(_mainwindow_sync_map_username(handle, username, access_key, access_secret, user_guid, 32, &err))
+		if(_mainwindow_sync_map_username(handle, username, access_key, access_secret, user_guid, 32, private->cancellable, &err))
 		{
 			/* get last synchronization timestamp */
 			last_sync = twitterdb_get_last_sync(handle, TWITTERDB_SYNC_SOURCE_TIMELINES, user_guid, 0);
@@ -815,7 +1300,7 @@ _mainwindow_sync_timelines(GtkWidget *widget, const gchar *username, const gchar
 				/* synchronize timelines */
 				g_debug("Synchronizing timelines (username=\"%s\")", username);
 
-				client = _mainwindow_sync_create_twitter_client(username, access_key, access_secret);
+				client = _mainwindow_sync_create_twitter_client(username, access_key, access_secret, private->cancellable);
 
 				/*
 				 * If this is the first timeline synchronization we fetch as many tweets as possible.
@@ -871,7 +1356,7 @@ _mainwindow_sync_lists(GtkWidget *widget, const gchar *username, const gchar *ac
 
 	if((handle = twitterdb_get_handle(&err)))
 	{
-		if(_mainwindow_sync_map_username(handle, username, access_key, access_secret, user_guid, 32, &err))
+		if(_mainwindow_sync_map_username(handle, username, access_key, access_secret, user_guid, 32, private->cancellable, &err))
 		{
 			/* get last synchronization timestamp */
 			last_sync = twitterdb_get_last_sync(handle, TWITTERDB_SYNC_SOURCE_LISTS, user_guid, 0);
@@ -889,7 +1374,7 @@ _mainwindow_sync_lists(GtkWidget *widget, const gchar *username, const gchar *ac
 				/* synchronize lists */
 				g_debug("Synchronizing lists (username=\"%s\")", username);
 
-				client = _mainwindow_sync_create_twitter_client(username, access_key, access_secret);
+				client = _mainwindow_sync_create_twitter_client(username, access_key, access_secret, private->cancellable);
 
 				if(twittersync_update_lists(handle, client, &count, sync_members, private->cancellable, &err))
 				{
@@ -938,9 +1423,9 @@ _mainwindow_sync_followers(GtkWidget *widget, const gchar *username, const gchar
 
 	if((handle = twitterdb_get_handle(&err)))
 	{
-		if(_mainwindow_sync_map_username(handle, username, access_key, access_secret, user_guid, 32, &err))
+		if(_mainwindow_sync_map_username(handle, username, access_key, access_secret, user_guid, 32, private->cancellable, &err))
 		{
-			client = _mainwindow_sync_create_twitter_client(username, access_key, access_secret);
+			client = _mainwindow_sync_create_twitter_client(username, access_key, access_secret, private->cancellable);
 
 			/*
 			 *	friends:
@@ -1005,6 +1490,100 @@ _mainwindow_sync_followers(GtkWidget *widget, const gchar *username, const gchar
 	}
 }
 
+static void
+_mainwindow_sync_retention_get_policy(GtkWidget *widget, TwitterDbRetentionPolicy *policy)
+{
+	Config *config;
+	Section *section;
+	Value *value;
+
+	policy->max_timeline_statuses = DATABASE_RETENTION_TIMELINE_LIMIT;
+	policy->max_list_statuses = DATABASE_RETENTION_LIST_LIMIT;
+	policy->max_age = DATABASE_RETENTION_MAX_AGE;
+
+	config = mainwindow_lock_config(widget);
+
+	if((section = section_find_first_child(config_get_root(config), "Database")))
+	{
+		if((value = section_find_first_value(section, "max-timeline-statuses")) && VALUE_IS_INT32(value))
+		{
+			policy->max_timeline_statuses = value_get_int32(value);
+		}
+
+		if((value = section_find_first_value(section, "max-list-statuses")) && VALUE_IS_INT32(value))
+		{
+			policy->max_list_statuses = value_get_int32(value);
+		}
+
+		if((value = section_find_first_value(section, "max-status-age")) && VALUE_IS_INT32(value))
+		{
+			policy->max_age = value_get_int32(value);
+		}
+	}
+
+	mainwindow_unlock_config(widget);
+}
+
+static void
+_mainwindow_sync_retention(GtkWidget *widget)
+{
+	_MainWindowPrivate *private;
+	TwitterDbHandle *handle;
+	TwitterDbRetentionPolicy policy;
+	TwitterDbRetentionStats stats;
+	gboolean finished = FALSE;
+	gint last_sync;
+	GTimeVal now;
+	GError *err = NULL;
+
+	g_assert(GTK_IS_WINDOW(widget));
+
+	private = MAINWINDOW_GET_DATA(widget);
+
+	if((handle = twitterdb_get_handle(&err)))
+	{
+		/* get last clean-up timestamp */
+		last_sync = twitterdb_get_last_sync(handle, TWITTERDB_SYNC_SOURCE_RETENTION, "0", 0);
+
+		/* test difference */
+		if((_mainwindow_sync_get_diff(last_sync) > MAINWINDOW_RETENTION_SYNC_MIN) || !last_sync)
+		{
+			g_debug("Cleaning up database");
+
+			_mainwindow_sync_retention_get_policy(widget, &policy);
+			memset(&stats, 0, sizeof(TwitterDbRetentionStats));
+
+			/* process small slices to keep the database responsive for other threads */
+			while(!finished && !err && stats.slices < MAINWINDOW_RETENTION_MAX_SLICES && !g_cancellable_is_cancelled(private->cancellable))
+			{
+				if(twitterdb_retention_slice(handle, &policy, MAINWINDOW_RETENTION_SLICE_SIZE, &stats, &finished, &err) && !finished)
+				{
+					g_usleep(MAINWINDOW_RETENTION_SLICE_DELAY);
+				}
+			}
+
+			g_debug("Database clean-up %s (slices=%d, timeline entries=%d, list entries=%d, statuses=%d, users=%d, released pages=%d, free pages=%d)",
+			        finished ? "finished" : "interrupted", stats.slices, stats.timeline_entries, stats.list_entries, stats.statuses, stats.users,
+			        stats.released_pages, stats.free_pages);
+
+			/* continue in the next synchronization cycle if the job couldn't be completed */
+			if(finished)
+			{
+				g_get_current_time(&now);
+				twitterdb_set_last_sync(handle, TWITTERDB_SYNC_SOURCE_RETENTION, "0", now.tv_sec);
+			}
+		}
+
+		twitterdb_close_handle(handle);
+	}
+
+	if(err)
+	{
+		g_warning("%s", err->message);
+		g_error_free(err);
+	}
+}
+
 static gboolean
 _mainwindow_sync_gui(GtkWidget *widget)
 {
@@ -1107,6 +1686,15 @@ _mainwindow_sync_coprocedure(GtkWidget *widget, gint step)
 			_mainwindow_sync_foreach_account(widget, _mainwindow_sync_followers);
 			break;
 
+		case MAINWINDOW_SYNC_STEP_NOTIFY_RETENTION:
+			g_debug("Cleaning up database");
+			statusbar_set_text(private->statusbar, _("Cleaning up database..."));
+			break;
+
+		case MAINWINDOW_SYNC_STEP_RETENTION:
+			_mainwindow_sync_retention(widget);
+			break;
+
 		case MAINWINDOW_SYNC_STEP_LAST:
 			statusbar_show(private->statusbar, FALSE);
 			break;
@@ -2316,6 +2904,10 @@ _mainwindows_destroy_worker(GtkWidget *widget)
 	g_thread_join(private->sync.thread);
 	g_debug("Thread has been finished");
 
+	/* finish user streams */
+	g_debug("Closing user streams...");
+	_mainwindow_stream_close_all(widget);
+
 	/* destroy children */
 	if(private->systray)
 	{
@@ -2363,6 +2955,7 @@ _mainwindows_destroy_worker(GtkWidget *widget)
 	g_mutex_free(private->sync_state.mutex);
 	g_mutex_free(private->notification_level.mutex);
 	g_mutex_free(private->last_gui_sync.mutex);
+	g_mutex_free(private->streams.mutex);
 	g_free(private);
 
 	/* destroy window widget */
@@ -2563,6 +3156,8 @@ _mainwindow_create(Config *config, Cache *cache)
 	private->notification_level.mutex = g_mutex_new();
 	private->sync_state.mutex = g_mutex_new();
 	private->last_gui_sync.mutex = g_mutex_new();
+	private->streams.table = g_hash_table_new_full(g_str_hash, g_str_equal, NULL, (GDestroyNotify)_mainwindow_stream_free);
+	private->streams.mutex = g_mutex_new();
 	g_object_set_data(G_OBJECT(window), "private", private);
 
 	/* assign startup options */
@@ -2967,6 +3562,11 @@ mainwindow_get_current_sync_status(GtkWidget *widget)
 			result = MAINWINDOW_SYNC_STATUS_SYNC_FOLLOWERS;
 			break;
 
+		case MAINWINDOW_SYNC_STEP_NOTIFY_RETENTION:
+		case MAINWINDOW_SYNC_STEP_RETENTION:
+			result = MAINWINDOW_SYNC_STATUS_CLEANUP;
+			break;
+
 		case MAINWINDOW_SYNC_STEP_GUI:
 			result = MAINWINDOW_SYNC_STATUS_SYNC_GUI;
 			break;
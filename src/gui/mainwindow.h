@@ -55,8 +55,28 @@
 #define MAINWINDOW_FOLLOWERS_SYNC_MIN    1800
 /*! Minimum update interval for the GUI. */
 #define MAINWINDOW_GUI_SYNC_MIN          5
+/*! Minimum interval between database clean-ups. */
+#define MAINWINDOW_RETENTION_SYNC_MIN    3600
+/*! Maximum number of rows processed in a single clean-up step. */
+#define MAINWINDOW_RETENTION_SLICE_SIZE  200
+/*! Maximum number of clean-up steps per synchronization. */
+#define MAINWINDOW_RETENTION_MAX_SLICES  250
+/*! Pause between clean-up steps in microseconds. */
+#define MAINWINDOW_RETENTION_SLICE_DELAY 20000
 /*! Default status count. */
 #define MAINWINDOW_DEFAULT_STATUS_COUNT  40
+/*! Delay in seconds between receiving statuses from a user stream and refreshing the GUI. */
+#define MAINWINDOW_STREAM_REFRESH_DELAY  2
+/*! Initial reconnect delay in milliseconds after a network error. */
+#define MAINWINDOW_STREAM_NETWORK_BACKOFF       250
+/*! Maximum reconnect delay in milliseconds after network errors. */
+#define MAINWINDOW_STREAM_NETWORK_BACKOFF_MAX   16000
+/*! Initial reconnect delay in milliseconds after a HTTP error. */
+#define MAINWINDOW_STREAM_HTTP_BACKOFF          5000
+/*! Maximum reconnect delay in milliseconds after HTTP errors. */
+#define MAINWINDOW_STREAM_HTTP_BACKOFF_MAX      320000
+/*! Initial reconnect delay in milliseconds after the stream has been rate limited. */
+#define MAINWINDOW_STREAM_RATE_LIMIT_BACKOFF    60000
 
 /*!
  * \typedef MainWindowSyncStatus
@@ -75,7 +95,9 @@ typedef enum
 	/*! Mainwindow is synchronizing followers. */
 	MAINWINDOW_SYNC_STATUS_SYNC_FOLLOWERS,
 	/*! Mainwindow is synchronizing gui. */
-	MAINWINDOW_SYNC_STATUS_SYNC_GUI
+	MAINWINDOW_SYNC_STATUS_SYNC_GUI,
+	/*! Mainwindow is cleaning up the database. */
+	MAINWINDOW_SYNC_STATUS_CLEANUP
 } MainWindowSyncStatus;
 /**
  * \param config a Configuration instance
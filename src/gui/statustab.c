@@ -144,6 +144,26 @@ typedef struct
 		/*! Mutex protecting the list. */
 		GMutex *mutex;
 	} accountlist;
+	/**
+	 * \struct _cursor
+	 * \brief Position of the oldest loaded status.
+	 *
+	 * \var cursor
+	 * \brief Position of the oldest loaded status. Only accessed by the background worker.
+	 */
+	struct _cursor
+	{
+		/*! Timestamp of the oldest status. */
+		gint timestamp;
+		/*! Guid of the oldest status. */
+		gchar guid[32];
+		/*! Number of statuses received by the last request. */
+		gint received;
+		/*! TRUE if there are no older statuses. */
+		gboolean exhausted;
+	} cursor;
+	/*! Timestamp of the newest loaded status. Only accessed by the background worker. */
+	gint newest_timestamp;
 	/*! The background color. */
 	gchar *background_color;
 	/*! Indicates if background color has changed. */
@@ -157,9 +177,16 @@ enum
 	/*! Refresh tab. */
 	STATUS_TAB_SIGNAL_REFRESH = 2,
 	/*! Do nothing. */
-	STATUS_TAB_SIGNAL_IDLE = 3
+	STATUS_TAB_SIGNAL_IDLE = 3,
+	/*! Load older statuses. */
+	STATUS_TAB_SIGNAL_LOAD_OLDER = 4,
+	/*! Mark loaded statuses read. */
+	STATUS_TAB_SIGNAL_MARK_READ = 5
 };
 
+/*! Distance to the end of the page (in pixels) at which older statuses are loaded. */
+#define STATUS_TAB_SCROLL_THRESHOLD 100
+
 /**
  * \struct _StatusTabTweetData
  * \brief Holds a Twitter status and the related author.
@@ -1614,11 +1641,27 @@ _status_tab_add_tweet(TwitterStatus status, TwitterUser user, _StatusTab *tab)
 	arg->user = user;
 	arg->status = status;
 
+	/* remember the oldest status */
+	++tab->cursor.received;
+
+	if(status.timestamp > 0 && (!tab->cursor.timestamp || status.timestamp < tab->cursor.timestamp ||
+	   (status.timestamp == tab->cursor.timestamp && g_ascii_strtoll(status.id, NULL, 10) < g_ascii_strtoll(tab->cursor.guid, NULL, 10))))
+	{
+		tab->cursor.timestamp = status.timestamp;
+		g_strlcpy(tab->cursor.guid, status.id, 32);
+	}
+
+	/* remember the newest status */
+	if(status.timestamp > tab->newest_timestamp)
+	{
+		tab->newest_timestamp = status.timestamp;
+	}
+
 	g_async_queue_push(tab->widget_factory.queue, arg);
 }
 
 static void
-_status_tab_populate_list(TwitterClient *client, _StatusTab *tab, GError **err)
+_status_tab_populate_list(TwitterClient *client, _StatusTab *tab, gint before_timestamp, const gchar *before_guid, GError **err)
 {
 	gchar *tab_id;
 	gchar **pieces;
@@ -1627,7 +1670,8 @@ _status_tab_populate_list(TwitterClient *client, _StatusTab *tab, GError **err)
 
 	if((pieces = g_strsplit(tab_id, "@", 2)))
 	{
-		twitter_client_process_list(client, pieces[0], pieces[1], (TwitterProcessStatusFunc)_status_tab_add_tweet, tab, tab->cancellable, err);
+		twitter_client_process_list(client, pieces[0], pieces[1], (TwitterProcessStatusFunc)_status_tab_add_tweet,
+		                            before_timestamp, before_guid, TWITTER_CLIENT_DEFAULT_PAGE_SIZE, tab, tab->cancellable, err);
 		g_strfreev(pieces);
 	}
 
@@ -1678,19 +1722,45 @@ _status_tab_update_color(_StatusTab *tab)
 }
 
 static void
-_status_tab_populate(_StatusTab *tab)
+_status_tab_populate(_StatusTab *tab, gboolean older)
 {
 	static GStaticMutex mutex = G_STATIC_MUTEX_INIT;
 	gchar *tab_id;
 	TabTypeId type;
 	TwitterClient *client;
+	gint before_timestamp = 0;
+	gchar before_guid[32] = { 0 };
 	GError *err = NULL;
 
+	type = ((Tab *)tab)->type_id;
+
+	/* test if older statuses are available */
+	if(older)
+	{
+		if(tab->cursor.exhausted || !tab->cursor.timestamp || type == TAB_TYPE_ID_SEARCH)
+		{
+			return;
+		}
+
+		before_timestamp = tab->cursor.timestamp;
+		g_strlcpy(before_guid, tab->cursor.guid, 32);
+	}
+
 	g_static_mutex_lock(&mutex);
 
-	/* get id & type from tab */
+	/* get id from tab */
 	tab_id = tab_get_id((Tab *)tab);
-	type = ((Tab *)tab)->type_id;
+	tab->cursor.received = 0;
+
+	/*
+	 * The list is repopulated with the newest statuses: a synchronization may have stored
+	 * older statuses in the meantime, so try to load older statuses again. The position
+	 * is kept because loaded statuses aren't removed from the list.
+	 */
+	if(!older)
+	{
+		tab->cursor.exhausted = FALSE;
+	}
 
 	/* create TwitterClient */
 	if(type == TAB_TYPE_ID_SEARCH)
@@ -1706,19 +1776,22 @@ _status_tab_populate(_StatusTab *tab)
 	switch(type)
 	{
 		case TAB_TYPE_ID_PUBLIC_TIMELINE:
-			twitter_client_process_public_timeline(client, tab_id, (TwitterProcessStatusFunc)_status_tab_add_tweet, tab, tab->cancellable, &err);
+			twitter_client_process_public_timeline(client, tab_id, (TwitterProcessStatusFunc)_status_tab_add_tweet,
+			                                       before_timestamp, before_guid, TWITTER_CLIENT_DEFAULT_PAGE_SIZE, tab, tab->cancellable, &err);
 			break;
 	
 		case TAB_TYPE_ID_REPLIES:
-			twitter_client_process_replies(client, tab_id, (TwitterProcessStatusFunc)_status_tab_add_tweet, tab, tab->cancellable, &err);
+			twitter_client_process_replies(client, tab_id, (TwitterProcessStatusFunc)_status_tab_add_tweet,
+			                               before_timestamp, before_guid, TWITTER_CLIENT_DEFAULT_PAGE_SIZE, tab, tab->cancellable, &err);
 			break;
 
 		case TAB_TYPE_ID_USER_TIMELINE:
-			twitter_client_process_usertimeline(client, tab_id, (TwitterProcessStatusFunc)_status_tab_add_tweet, tab, tab->cancellable, &err);
+			twitter_client_process_usertimeline(client, tab_id, (TwitterProcessStatusFunc)_status_tab_add_tweet,
+			                                    before_timestamp, before_guid, TWITTER_CLIENT_DEFAULT_PAGE_SIZE, tab, tab->cancellable, &err);
 			break;
 
 		case TAB_TYPE_ID_LIST:
-			_status_tab_populate_list(client, tab, &err);
+			_status_tab_populate_list(client, tab, before_timestamp, before_guid, &err);
 			break;
 
 		case TAB_TYPE_ID_SEARCH:
@@ -1729,6 +1802,13 @@ _status_tab_populate(_StatusTab *tab)
 			g_warning("Unknown tab id: %d", type);
 	}
 
+	/* an incomplete page marks the end of the timeline */
+	if(older && !err && tab->cursor.received < TWITTER_CLIENT_DEFAULT_PAGE_SIZE)
+	{
+		g_debug("No older statuses available");
+		tab->cursor.exhausted = TRUE;
+	}
+
 	/* change background color of old tweets if necessary*/
 	if(tab->background_changed)
 	{
@@ -1749,6 +1829,121 @@ _status_tab_populate(_StatusTab *tab)
 	g_static_mutex_unlock(&mutex);
 }
 
+/*
+ *	read state:
+ */
+static gboolean
+_status_tab_is_selected(_StatusTab *tab)
+{
+	GtkNotebook *notebook = GTK_NOTEBOOK(tab->tabbar);
+	gboolean selected;
+
+	gdk_threads_enter();
+	selected = gtk_notebook_get_current_page(notebook) == gtk_notebook_page_num(notebook, ((Tab *)tab)->widget);
+	gdk_threads_leave();
+
+	return selected;
+}
+
+static void
+_status_tab_update_read_state(_StatusTab *tab, gboolean mark_read)
+{
+	TabTypeId type;
+	TwitterDbTimelineType timeline = TWITTERDB_TIMELINE_TYPE_PUBLIC;
+	TwitterDbHandle *handle;
+	gchar *tab_id;
+	gchar **pieces = NULL;
+	gint count = 0;
+	GError *err = NULL;
+
+	type = ((Tab *)tab)->type_id;
+
+	switch(type)
+	{
+		case TAB_TYPE_ID_PUBLIC_TIMELINE:
+			timeline = TWITTERDB_TIMELINE_TYPE_PUBLIC;
+			break;
+
+		case TAB_TYPE_ID_REPLIES:
+			timeline = TWITTERDB_TIMELINE_TYPE_REPLIES;
+			break;
+
+		case TAB_TYPE_ID_USER_TIMELINE:
+			timeline = TWITTERDB_TIMELINE_TYPE_USER_TIMELINE;
+			break;
+
+		case TAB_TYPE_ID_LIST:
+			break;
+
+		default:
+			/* search results aren't stored */
+			return;
+	}
+
+	tab_id = tab_get_id((Tab *)tab);
+
+	/* list ids are built from owner & list name */
+	if(type == TAB_TYPE_ID_LIST && (!(pieces = g_strsplit(tab_id, "@", 2)) || !pieces[0] || !pieces[1]))
+	{
+		g_warning("Invalid list id: \"%s\"", tab_id);
+		g_strfreev(pieces);
+		g_free(tab_id);
+
+		return;
+	}
+
+	if((handle = twitterdb_get_handle(&err)))
+	{
+		if(mark_read)
+		{
+			/* statuses shown in the selected tab have been read */
+			if(tab->newest_timestamp)
+			{
+				g_debug("Marking statuses read: type_id=%d, id=\"%s\", timestamp=%d", type, tab_id, tab->newest_timestamp);
+
+				if(pieces)
+				{
+					twitterdb_mark_list_read(handle, pieces[0], pieces[1], tab->newest_timestamp, &err);
+				}
+				else
+				{
+					twitterdb_mark_timeline_read(handle, tab_id, timeline, tab->newest_timestamp, &err);
+				}
+			}
+		}
+
+		if(!err)
+		{
+			if(pieces)
+			{
+				count = twitterdb_count_unread_in_list(handle, pieces[0], pieces[1], &err);
+			}
+			else
+			{
+				count = twitterdb_count_unread_in_timeline(handle, tab_id, timeline, &err);
+			}
+		}
+
+		twitterdb_close_handle(handle);
+	}
+
+	/* update page header */
+	if(err)
+	{
+		g_warning("%s", err->message);
+		g_error_free(err);
+	}
+	else
+	{
+		gdk_threads_enter();
+		tabbar_set_page_unread(tab->tabbar, ((Tab *)tab)->widget, count);
+		gdk_threads_leave();
+	}
+
+	g_strfreev(pieces);
+	g_free(tab_id);
+}
+
 /*
  *	widget factory:
  */
@@ -2014,7 +2209,23 @@ _status_tab_worker(gpointer data)
 			gdk_threads_leave();
 
 			/* populate data */
-			_status_tab_populate(meta);
+			_status_tab_populate(meta, FALSE);
+
+			/* statuses loaded into the selected tab are read, otherwise show the number of unread statuses */
+			_status_tab_update_read_state(meta, _status_tab_is_selected(meta));
+		}
+		else if(signal == STATUS_TAB_SIGNAL_LOAD_OLDER)
+		{
+			gdk_threads_enter();
+			tabbar_set_page_busy(meta->tabbar, ((Tab *)meta)->widget, TRUE);
+			gdk_threads_leave();
+
+			/* append next page */
+			_status_tab_populate(meta, TRUE);
+		}
+		else if(signal == STATUS_TAB_SIGNAL_MARK_READ)
+		{
+			_status_tab_update_read_state(meta, TRUE);
 		}
 		else if(signal == STATUS_TAB_SIGNAL_DESTROY)
 		{
@@ -2295,12 +2506,35 @@ _status_tab_scroll(GtkWidget *widget, gboolean down)
 	gtk_range_set_value(GTK_RANGE(scrollbar), value);
 }
 
+static void
+_status_tab_scroll_value_changed(GtkAdjustment *adjustment, GtkWidget *widget)
+{
+	/* load older statuses when the end of the page has been reached */
+	if(gtk_adjustment_get_upper(adjustment) > gtk_adjustment_get_page_size(adjustment) &&
+	   gtk_adjustment_get_value(adjustment) + gtk_adjustment_get_page_size(adjustment) >= gtk_adjustment_get_upper(adjustment) - STATUS_TAB_SCROLL_THRESHOLD)
+	{
+		_status_tab_send_signal(widget, STATUS_TAB_SIGNAL_LOAD_OLDER);
+	}
+}
+
+static void
+_status_tab_selected(GtkWidget *widget)
+{
+	_StatusTab *meta = g_object_get_data(G_OBJECT(widget), "meta");
+
+	if(meta->initialized)
+	{
+		_status_tab_send_signal(widget, STATUS_TAB_SIGNAL_MARK_READ);
+	}
+}
+
 static TabFuncs status_tab_funcs =
 {
 	_status_tab_destroyed,
 	_status_tab_refresh,
 	_status_tab_set_busy,
-	_status_tab_scroll
+	_status_tab_scroll,
+	_status_tab_selected
 };
 
 static gchar *
@@ -2416,6 +2650,11 @@ status_tab_create(GtkWidget *tabbar, TabTypeId type_id, const gchar *id)
 	meta->widget_factory.running = FALSE;
 	meta->widget_factory.mutex = g_mutex_new();
 	meta->visible = FALSE;
+	meta->cursor.timestamp = 0;
+	meta->cursor.guid[0] = '\0';
+	meta->cursor.received = 0;
+	meta->cursor.exhausted = FALSE;
+	meta->newest_timestamp = 0;
 
 	mainwindow = tabbar_get_mainwindow(tabbar);
 	config = mainwindow_lock_config(mainwindow);
@@ -2439,6 +2678,7 @@ status_tab_create(GtkWidget *tabbar, TabTypeId type_id, const gchar *id)
 	_status_tab_wait_for_worker(widget);
 
 	g_signal_connect(G_OBJECT(widget), "key-press-event", G_CALLBACK(_status_tab_key_press), meta);
+	g_signal_connect(G_OBJECT(gtk_scrolled_window_get_vadjustment(GTK_SCROLLED_WINDOW(scrolled))), "value-changed", G_CALLBACK(_status_tab_scroll_value_changed), widget);
 
 	gtk_widget_show_all(widget);
 
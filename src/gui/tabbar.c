@@ -581,7 +581,19 @@ _tabbar_open_status_page(GtkNotebook *notebook, TabTypeId type_id, const gchar *
 static void
 _tabbar_switch_page(GtkNotebook *notebook, gpointer page, guint page_num, gpointer user_data)
 {
+	GtkWidget *child;
+	Tab *meta;
+
 	_tabbar_page_changed(notebook, page_num);
+
+	/* call selection handler */
+	if((child = gtk_notebook_get_nth_page(notebook, page_num)))
+	{
+		if((meta = g_object_get_data(G_OBJECT(child), "meta")) && meta->funcs->selected)
+		{
+			meta->funcs->selected(child);
+		}
+	}
 }
 
 /*
@@ -1040,6 +1052,59 @@ tabbar_set_page_busy(GtkWidget *widget, GtkWidget *page, gboolean busy)
 	#endif
 }
 
+void
+tabbar_set_page_unread(GtkWidget *widget, GtkWidget *page, gint count)
+{
+	GtkWidget *label;
+	GList *children;
+	GList *iter;
+	Tab *tab;
+	gchar *id;
+	gchar *text;
+	gboolean found = FALSE;
+
+	if(!(tab = g_object_get_data(G_OBJECT(page), "meta")))
+	{
+		return;
+	}
+
+	/* get label related to specified page */
+	if((label = gtk_notebook_get_tab_label(GTK_NOTEBOOK(widget), page)))
+	{
+		g_assert(GTK_IS_CONTAINER(label));
+
+		id = tab_get_id(tab);
+
+		if(count > 0)
+		{
+			text = g_strdup_printf("%s (%d)", id, count);
+		}
+		else
+		{
+			text = g_strdup(id);
+		}
+
+		/* search for label widget */
+		iter = children = gtk_container_get_children(GTK_CONTAINER(label));
+
+		while(iter && !found)
+		{
+			if(GTK_IS_LABEL(iter->data))
+			{
+				found = TRUE;
+				gtk_label_set_text(GTK_LABEL(iter->data), text);
+			}
+
+			iter = iter->next;
+		}
+
+		/* cleanup */
+		g_list_free(children);
+		g_free(text);
+		g_free(id);
+	}
+}
+
 GtkWidget *
 tabbar_get_mainwindow(GtkWidget *widget)
 {
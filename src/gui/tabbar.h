@@ -93,6 +93,8 @@ struct _TabFuncs
 	void (* set_busy)(GtkWidget *widget, gboolean busy);
 	/*! Scroll function. */
 	void (* scroll)(GtkWidget *widget, gboolean down);
+	/*! Called if a tab has been selected. */
+	void (* selected)(GtkWidget *widget);
 };
 
 /**
@@ -261,6 +263,15 @@ gboolean tabbar_is_busy(GtkWidget *widget);
  */
 void tabbar_set_page_busy(GtkWidget *widget, GtkWidget *page, gboolean busy);
 
+/**
+ * \param widget the tabbar widget
+ * \param page a page
+ * \param count number of unread statuses
+ *
+ * Shows the number of unread statuses in the page header. The number is hidden if count is 0.
+ */
+void tabbar_set_page_unread(GtkWidget *widget, GtkWidget *page, gint count);
+
 /**
  * \param widget the tabbar widget
  * \return a pointer to the mainwindow
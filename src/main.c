@@ -33,6 +33,11 @@
 #include "pathbuilder.h"
 #include "cache.h"
 #include "listener.h"
+#include "twitterdb.h"
+#include "net/httpclient.h"
+#include "net/netutil.h"
+#include "net/openssl.h"
+#include "net/twitterratelimit.h"
 #include "gui/gui.h"
 
 /**
@@ -196,6 +201,8 @@ main(int argc, char *argv[])
 	Config *config = NULL;
 	Cache *cache = NULL;
 	GError *err = NULL;
+	guint64 encoded_bytes;
+	guint64 decoded_bytes;
 
 	/*
 	 *	INITIALIZATION:
@@ -291,6 +298,17 @@ main(int argc, char *argv[])
 			/*
 			 *	SHUTDOWN:
 			 */
+			/* close database connections */
+			twitterdb_cleanup();
+
+			/* close idle HTTP connections */
+			http_client_get_content_statistics(&encoded_bytes, &decoded_bytes);
+			g_debug("Received HTTP content: %" G_GUINT64_FORMAT " bytes (%" G_GUINT64_FORMAT " bytes decoded)", encoded_bytes, decoded_bytes);
+			http_client_close_idle_connections();
+			network_util_clear_dns_cache();
+			openssl_cleanup();
+			twitter_rate_limit_cleanup();
+
 			/* save configuration & destroy it */
 			if(config_get_filename(config))
 			{
@@ -39,7 +39,8 @@ enum
 {
 	PROP_NONE,
 	PROP_SOCKET,
-	PROP_SSL_ENABLED
+	PROP_SSL_ENABLED,
+	PROP_SESSION_KEY
 };
 
 /**
@@ -60,8 +61,8 @@ struct _GTcpStreamPrivate
 	gboolean ssl_enabled;
 	/*! An OpenSSL handle. */
 	SSL *ssl;
-	/*! An OpenSSL context. */
-	SSL_CTX *ctx;
+	/*! Identifies the remote host in the SSL session cache. */
+	gchar *session_key;
 	/*! Indicates if the handshake has been performed successfully. */
 	gboolean handshake;
 };
@@ -180,6 +181,10 @@ _g_tcp_stream_get_property(GObject *object, guint prop_id, GValue *value, GParam
 			g_value_set_boolean(value, stream->priv->ssl_enabled);
 			break;
 
+		case PROP_SESSION_KEY:
+			g_value_set_string(value, stream->priv->session_key);
+			break;
+
 		default:
 			G_OBJECT_WARN_INVALID_PROPERTY_ID(object, prop_id, pspec);
 	}
@@ -200,6 +205,11 @@ _g_tcp_stream_set_property(GObject *object, guint prop_id, const GValue *value,
 			stream->priv->ssl_enabled = g_value_get_boolean(value);
 			break;
 
+		case PROP_SESSION_KEY:
+			g_free(stream->priv->session_key);
+			stream->priv->session_key = g_value_dup_string(value);
+			break;
+
 		default:
 			G_OBJECT_WARN_INVALID_PROPERTY_ID(object, prop_id, pspec);
 	}
@@ -214,21 +224,18 @@ _g_tcp_stream_ssl_client_init(GTcpStream *stream, GError **err)
 	g_debug("Initializing SSL client");
 
 	g_return_val_if_fail(stream->priv->ssl == NULL, FALSE);
-	g_return_val_if_fail(stream->priv->ctx == NULL, FALSE);
 	g_return_val_if_fail(stream->priv->handshake == FALSE, FALSE);
 
 	g_socket_set_blocking(stream->priv->socket, TRUE);
 
-	if(!(ctx = SSL_CTX_new(SSLv23_client_method())))
+	if(!(ctx = openssl_get_client_context(err)))
 	{
-		g_set_error(err, 0, 0, "Couldn't allocate memory for SSL context");
 		return FALSE;
 	}
 
 	if(!(ssl = SSL_new(ctx)))
 	{
 		g_set_error(err, 0, 0, "Failed to allocate SSL structure");
-		SSL_CTX_free(ctx);
 		return FALSE;
 	}
 
@@ -236,15 +243,19 @@ _g_tcp_stream_ssl_client_init(GTcpStream *stream, GError **err)
 	{
 		g_set_error(err, 0, 0, "Failed to associate socket to SSL stream");
 		SSL_free(ssl);
-		SSL_CTX_free(ctx);
 		return FALSE;
 	}
 
 	SSL_set_connect_state(ssl);
 	SSL_set_mode(ssl, SSL_MODE_AUTO_RETRY);
 
+	/* try to resume a previous session */
+	if(stream->priv->session_key)
+	{
+		openssl_resume_session(ssl, stream->priv->session_key);
+	}
+
 	stream->priv->ssl = ssl;
-	stream->priv->ctx = ctx;
 
 	return TRUE;
 }
@@ -255,12 +266,14 @@ _g_tcp_stream_ssl_handshake(GTcpStream *stream, GError **err)
 	gint result;
 	gint errno;
 	const gchar *errstr;
+	GTimer *timer;
 
 	g_return_val_if_fail(stream->priv->ssl != NULL, FALSE);
-	g_return_val_if_fail(stream->priv->ctx != NULL, FALSE);
 	g_return_val_if_fail(stream->priv->handshake == FALSE, FALSE);
 
 	g_debug("Performing SSL handshake");
+	timer = g_timer_new();
+
 	while(1)
 	{
 		/* establish connection */
@@ -316,10 +329,21 @@ _g_tcp_stream_ssl_handshake(GTcpStream *stream, GError **err)
 		else
 		{
 			stream->priv->handshake = TRUE;
+			openssl_register_handshake(stream->priv->ssl, stream->priv->session_key, g_timer_elapsed(timer, NULL));
+			g_timer_destroy(timer);
+
 			return TRUE;
 		}
 	}
 
+	/* don't offer a possibly broken session again */
+	if(stream->priv->session_key)
+	{
+		openssl_remove_session(stream->priv->session_key);
+	}
+
+	g_timer_destroy(timer);
+
 	return FALSE;
 }
 
@@ -359,9 +383,9 @@ g_tcp_stream_new(GSocket *socket)
 }
 
 GTcpStream *
-g_tcp_stream_new_ssl(GSocket *socket)
+g_tcp_stream_new_ssl(GSocket *socket, const gchar *session_key)
 {
-	return g_object_new(G_TYPE_TCP_STREAM, "socket", socket, "ssl-enabled", TRUE, NULL);
+	return g_object_new(G_TYPE_TCP_STREAM, "socket", socket, "ssl-enabled", TRUE, "session-key", session_key, NULL);
 }
 
 /*
@@ -413,13 +437,10 @@ g_tcp_stream_finalize(GObject *object)
 			SSL_shutdown(stream->priv->ssl);
 			SSL_free(stream->priv->ssl);
 		}
-
-		if(stream->priv->ctx)
-		{
-			SSL_CTX_free(stream->priv->ctx);
-		}
 	}
 
+	g_free(stream->priv->session_key);
+
 	g_object_unref(stream->priv->socket);
 	G_OBJECT_CLASS(g_tcp_stream_parent_class)->finalize(object);
 }
@@ -451,6 +472,8 @@ g_tcp_stream_class_init(GTcpStreamClass *klass)
 	                                g_param_spec_object("socket", NULL, NULL, G_TYPE_SOCKET, G_PARAM_CONSTRUCT_ONLY | G_PARAM_READWRITE));
 	g_object_class_install_property(gobject_class, PROP_SSL_ENABLED,
 	                                g_param_spec_boolean("ssl-enabled", NULL, NULL, FALSE, G_PARAM_CONSTRUCT_ONLY | G_PARAM_READWRITE));
+	g_object_class_install_property(gobject_class, PROP_SESSION_KEY,
+	                                g_param_spec_string("session-key", NULL, NULL, NULL, G_PARAM_CONSTRUCT_ONLY | G_PARAM_READWRITE));
 }
 
 static void
@@ -62,6 +62,7 @@ typedef struct _GTcpStream           GTcpStream;
  * the following properties:
  * - \b socket: the underlying socket (GSocket, rw)\n
  * - \b ssl-enabled: activates/deactivates SSL (boolean, rw)\n
+ * - \b session-key: identifies the remote host in the SSL session cache (string, rw)\n
  */
 struct _GTcpStreamClass
 {
@@ -90,7 +91,8 @@ struct _GTcpStreamClass
 	 * \param err holds failure messages
 	 * \return TRUE on success
 	 *
-	 * Perfoms a SSL handshake.
+	 * Perfoms a SSL handshake. A cached session of the host specified by the session-key
+	 * property is resumed if possible.
 	 */
 	gboolean (* ssl_handshake)(GTcpStream *stream, GError **err);
 };
@@ -135,11 +137,12 @@ GTcpStream *g_tcp_stream_new(GSocket *socket);
 
 /**
  * \param socket a GSocket instance
+ * \param session_key identifies the remote host in the SSL session cache or NULL
  * \return a new GTcpStream instance
  *
  * Creates a new GTcpStream instance and enables SSL.
  */
-GTcpStream *g_tcp_stream_new_ssl(GSocket *socket);
+GTcpStream *g_tcp_stream_new_ssl(GSocket *socket, const gchar *session_key);
 
 /**
  * @}
@@ -22,8 +22,8 @@
  * \date 5. December 2010
  */
 
-#include <ctype.h>
-
+#include <string.h>
+#include <errno.h>
 #include "httpclient.h"
 #include "gtcpstream.h"
 #include "netutil.h"
@@ -49,7 +49,9 @@ enum
 	PROP_HEADER_AUTHORIZATION,
 	PROP_HEADERS,
 	PROP_STATUS,
-	PROP_AUTO_ESCAPE
+	PROP_AUTO_ESCAPE,
+	PROP_TIMEOUT,
+	PROP_CANCELLABLE
 };
 
 /**
@@ -84,8 +86,74 @@ struct _HttpClientPrivate
 	gint header_offset;
 	/*! Escape post values automatically. */
 	gboolean auto_escape;
+	/*! TRUE if the current connection has been taken from the connection pool. */
+	gboolean reused;
+	/*! TRUE if the current connection can be reused after the response has been read. */
+	gboolean keep_alive;
+	/*! Function receiving the message body or NULL to store it in the response buffer. */
+	HttpClientContentFunc content_func;
+	/*! User data passed to content_func. */
+	gpointer content_data;
+	/*! Cancels the running request or NULL. */
+	GCancellable *cancellable;
+	/*! Seconds a blocking socket operation may take or 0. */
+	guint timeout;
 };
 
+/*! Maximum number of idle connections kept per remote host. */
+#define HTTP_CLIENT_POOL_MAX_IDLE_CONNECTIONS 4
+/*! Seconds an idle connection is kept open. */
+#define HTTP_CLIENT_POOL_IDLE_TIMEOUT         30
+
+/**
+ * \struct _HttpClientIdleConnection
+ * \brief An idle connection stored in the connection pool.
+ */
+typedef struct
+{
+	/*! The connected stream. */
+	GTcpStream *stream;
+	/*! Time the connection has been released to the pool. */
+	glong released;
+} _HttpClientIdleConnection;
+
+/*! Maximum number of asynchronous requests processed at the same time. */
+#define HTTP_CLIENT_ASYNC_MAX_THREADS         8
+
+/**
+ * \struct _HttpClientAsyncRequest
+ * \brief An asynchronous GET request.
+ */
+typedef struct
+{
+	/*! Path of the requested content. */
+	gchar *path;
+	/*! Client processing the request, configured like the client which started it. */
+	HttpClient *client;
+	/*! Cancels the request when the caller's cancellable is triggered or the timeout is reached. */
+	GCancellable *cancellable;
+	/*! Cancellable passed by the caller or NULL. */
+	GCancellable *user_cancellable;
+	/*! Handler connected to the caller's cancellable. */
+	gulong cancelled_id;
+	/*! Timeout source or NULL. */
+	GSource *timeout;
+	/*! Set to 1 if the timeout has been reached. */
+	volatile gint timed_out;
+	/*! HTTP status code of the response. */
+	gint status;
+} _HttpClientAsyncRequest;
+
+/*! Mutex protecting the worker pool processing asynchronous requests. */
+static GStaticMutex _http_client_async_mutex = G_STATIC_MUTEX_INIT;
+/*! Worker pool processing asynchronous requests. */
+static GThreadPool *_http_client_async_pool = NULL;
+
+/*! Mutex protecting the connection pool. */
+static GStaticMutex _http_client_pool_mutex = G_STATIC_MUTEX_INIT;
+/*! Idle connections, grouped by scheme, hostname & port. */
+static GHashTable *_http_client_pool = NULL;
+
 /*
  *	helpers:
  */
@@ -135,26 +203,240 @@ _http_client_reset(HttpClient *client)
 	_http_client_free_headers(client);
 }
 
+/**
+ * \param stream a stream to close
+ *
+ * Closes a connection & frees the stream.
+ */
+static void
+_http_client_close_stream(GTcpStream *stream)
+{
+	g_io_stream_close(G_IO_STREAM(stream), NULL, NULL);
+	g_object_unref(stream);
+}
+
+/**
+ * \param queue a queue containing idle connections
+ *
+ * Closes all connections found in the queue & frees the queue.
+ */
+static void
+_http_client_pool_free_queue(GQueue *queue)
+{
+	_HttpClientIdleConnection *conn;
+
+	while((conn = (_HttpClientIdleConnection *)g_queue_pop_head(queue)))
+	{
+		_http_client_close_stream(conn->stream);
+		g_slice_free(_HttpClientIdleConnection, conn);
+	}
+
+	g_queue_free(queue);
+}
+
+/**
+ * \param connections a list of idle connections
+ *
+ * Closes all connections found in the list & frees the list. This function is called
+ * after unlocking the pool, so closing a stream doesn't block other threads.
+ */
+static void
+_http_client_pool_close_connections(GSList *connections)
+{
+	GSList *iter;
+	_HttpClientIdleConnection *conn;
+
+	for(iter = connections; iter; iter = iter->next)
+	{
+		conn = (_HttpClientIdleConnection *)iter->data;
+		_http_client_close_stream(conn->stream);
+		g_slice_free(_HttpClientIdleConnection, conn);
+	}
+
+	g_slist_free(connections);
+}
+
 /**
  * \param client an HttpClient instance
+ * \return a newly allocated string identifying the remote host
+ *
+ * Builds the key of the remote host in the connection pool.
+ */
+static gchar *
+_http_client_pool_key(HttpClient *client)
+{
+	gchar *hostname;
+	gchar *key;
+
+	hostname = g_ascii_strdown(client->priv->hostname, -1);
+	key = g_strdup_printf("%s://%s:%d", client->priv->ssl_enabled ? "https" : "http", hostname, client->priv->port);
+	g_free(hostname);
+
+	return key;
+}
+
+/**
+ * \param stream an idle stream
+ * \return TRUE if the connection seems to be usable
+ *
+ * An idle connection mustn't be readable. Data or a hangup indicates that the remote host
+ * has closed the connection.
+ */
+static gboolean
+_http_client_stream_is_alive(GTcpStream *stream)
+{
+	GSocket *socket;
+
+	if((socket = g_tcp_stream_get_socket(stream)))
+	{
+		return g_socket_condition_check(socket, G_IO_IN | G_IO_HUP | G_IO_ERR) ? FALSE : TRUE;
+	}
+
+	return FALSE;
+}
+
+/**
+ * \param client an HttpClient instance
+ * \return TRUE if an idle connection has been found
+ *
+ * Takes an idle connection to the remote host from the connection pool.
+ */
+static gboolean
+_http_client_pool_acquire(HttpClient *client)
+{
+	gchar *key;
+	GQueue *queue;
+	_HttpClientIdleConnection *conn;
+	GSList *dropped = NULL;
+	GTimeVal now;
+
+	g_return_val_if_fail(client->priv->stream == NULL, FALSE);
+
+	key = _http_client_pool_key(client);
+	g_get_current_time(&now);
+
+	g_static_mutex_lock(&_http_client_pool_mutex);
+
+	if(_http_client_pool && (queue = (GQueue *)g_hash_table_lookup(_http_client_pool, key)))
+	{
+		/* prefer the most recently used connection */
+		while(!client->priv->stream && (conn = (_HttpClientIdleConnection *)g_queue_pop_tail(queue)))
+		{
+			if(now.tv_sec - conn->released < HTTP_CLIENT_POOL_IDLE_TIMEOUT && _http_client_stream_is_alive(conn->stream))
+			{
+				client->priv->stream = conn->stream;
+				g_slice_free(_HttpClientIdleConnection, conn);
+			}
+			else
+			{
+				g_debug("Dropping idle connection: %s", key);
+				dropped = g_slist_prepend(dropped, conn);
+			}
+		}
+	}
+
+	g_static_mutex_unlock(&_http_client_pool_mutex);
+
+	_http_client_pool_close_connections(dropped);
+
+	if(client->priv->stream)
+	{
+		g_debug("Reusing connection: %s", key);
+	}
+
+	g_free(key);
+
+	return client->priv->stream ? TRUE : FALSE;
+}
+
+/**
+ * \param client an HttpClient instance
+ *
+ * Moves the current connection to the connection pool.
+ */
+static void
+_http_client_pool_release(HttpClient *client)
+{
+	gchar *key;
+	GQueue *queue;
+	_HttpClientIdleConnection *conn;
+	_HttpClientIdleConnection *drop = NULL;
+	GTimeVal now;
+
+	g_return_if_fail(client->priv->stream != NULL);
+
+	conn = g_slice_new(_HttpClientIdleConnection);
+	conn->stream = client->priv->stream;
+	g_get_current_time(&now);
+	conn->released = now.tv_sec;
+	client->priv->stream = NULL;
+
+	key = _http_client_pool_key(client);
+
+	g_static_mutex_lock(&_http_client_pool_mutex);
+
+	if(!_http_client_pool)
+	{
+		_http_client_pool = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, (GDestroyNotify)_http_client_pool_free_queue);
+	}
+
+	if(!(queue = (GQueue *)g_hash_table_lookup(_http_client_pool, key)))
+	{
+		queue = g_queue_new();
+		g_hash_table_insert(_http_client_pool, key, queue);
+		key = NULL;
+	}
+
+	/* remove the least recently used connection if the limit has been reached */
+	if(g_queue_get_length(queue) >= HTTP_CLIENT_POOL_MAX_IDLE_CONNECTIONS)
+	{
+		drop = (_HttpClientIdleConnection *)g_queue_pop_head(queue);
+	}
+
+	g_queue_push_tail(queue, conn);
+
+	g_static_mutex_unlock(&_http_client_pool_mutex);
+
+	/* close the removed connection without holding the lock */
+	if(drop)
+	{
+		_http_client_close_stream(drop->stream);
+		g_slice_free(_HttpClientIdleConnection, drop);
+	}
+
+	g_free(key);
+}
+
+/**
+ * \param client an HttpClient instance
+ * \param use_pool TRUE to take an idle connection from the pool if possible
  * \param err holds failure messages
  * \return TRUE on success
  *
  * Tries to establish a connection to the specified remote host.
  */
 static gboolean
-_http_client_connect(HttpClient *client, GError **err)
+_http_client_connect(HttpClient *client, gboolean use_pool, GError **err)
 {
 	GSocket *socket;
+	gchar *session_key;
 	gboolean success = FALSE;
 
 	g_return_val_if_fail(client->priv->status == HTTP_NONE, FALSE);
 	g_return_val_if_fail(client->priv->stream == NULL, FALSE);
 	g_return_val_if_fail(client->priv->hostname != NULL, FALSE);
 
+	/* try to reuse an idle connection */
+	if((client->priv->reused = use_pool && _http_client_pool_acquire(client)))
+	{
+		g_socket_set_timeout(g_tcp_stream_get_socket(client->priv->stream), client->priv->timeout);
+
+		return TRUE;
+	}
+
 	/* create socket */
 	g_debug("Connecting to remote host: %s", client->priv->hostname);
-	if(!(socket = network_util_create_tcp_socket(client->priv->hostname, client->priv->port, err)))
+	if(!(socket = network_util_create_tcp_socket(client->priv->hostname, client->priv->port, client->priv->cancellable, err)))
 	{
 		return FALSE;
 	}
@@ -162,7 +444,11 @@ _http_client_connect(HttpClient *client, GError **err)
 	/* create new stream */
 	if(client->priv->ssl_enabled)
 	{
-		if((client->priv->stream = g_tcp_stream_new_ssl(socket)))
+		session_key = g_strdup_printf("%s:%d", client->priv->hostname, client->priv->port);
+		client->priv->stream = g_tcp_stream_new_ssl(socket, session_key);
+		g_free(session_key);
+
+		if(client->priv->stream)
 		{
 			if(g_tcp_stream_ssl_client_init(client->priv->stream, err))
 			{
@@ -188,6 +474,12 @@ _http_client_connect(HttpClient *client, GError **err)
 		}
 	}
 
+	/* a stalled connection fails with G_IO_ERROR_TIMED_OUT */
+	if(success)
+	{
+		g_socket_set_timeout(socket, client->priv->timeout);
+	}
+
 	/* unref socket */
 	g_object_unref(socket);
 
@@ -205,11 +497,28 @@ _http_client_close(HttpClient *client)
 	g_return_if_fail(client->priv->stream != NULL);
 
 	g_debug("Closing connection");
-	g_io_stream_close(G_IO_STREAM(client->priv->stream), NULL, NULL);
-	g_object_unref(client->priv->stream);
+	_http_client_close_stream(client->priv->stream);
 	client->priv->stream = NULL;
 }
 
+/**
+ * \param client an HttpClient instance
+ *
+ * Moves the current connection to the connection pool if it can be reused or closes it.
+ */
+static void
+_http_client_release(HttpClient *client)
+{
+	if(client->priv->keep_alive)
+	{
+		_http_client_pool_release(client);
+	}
+	else
+	{
+		_http_client_close(client);
+	}
+}
+
 /**
  * \param client an HttpClient instance
  * \return the HTTP status code of the response or HTTP_NONE on failure
@@ -333,158 +642,684 @@ _http_client_parse_headers(HttpClient *client)
 }
 
 /**
- * \param buffer text to parse
- * \param length length of the buffer
+ * \struct _HttpClientBodyReader
+ * \brief State of the message body currently received.
+ */
+typedef struct
+{
+	/*! Stream to read from. */
+	GInputStream *in;
+	/*! Cancels blocking read operations. */
+	GCancellable *cancellable;
+	/*! Received data which hasn't been decoded yet. */
+	GString *window;
+	/*! Buffer to append the decoded message body to if no content function has been set. */
+	GString *body;
+	/*! Decompresses the message body or NULL. */
+	GConverter *decompressor;
+	/*! TRUE if the decompressor has reached the end of the compressed data. */
+	gboolean finished;
+	/*! Number of received (but possibly compressed) content bytes. */
+	guint64 encoded_bytes;
+	/*! Number of decoded content bytes. */
+	guint64 decoded_bytes;
+} _HttpClientBodyReader;
+
+/*! Mutex protecting the content statistics. */
+static GStaticMutex _http_client_statistics_mutex = G_STATIC_MUTEX_INIT;
+/*! Number of received content bytes. */
+static guint64 _http_client_encoded_bytes = 0;
+/*! Number of content bytes after decompression. */
+static guint64 _http_client_decoded_bytes = 0;
+
+/**
+ * \param buffer buffer to search
  * \param offset position to start from
- * \return position of the found CRLF or -1
+ * \param pattern text to search for
+ * \return position of the found pattern or -1
  *
- * Searches for the next line feed in the given buffer.
+ * Searches for a pattern in a buffer which may contain binary data.
  */
-static gint
-_http_client_find_next_crlf(const gchar *buffer, gint length, gint offset)
+static gssize
+_http_client_find(const GString *buffer, gsize offset, const gchar *pattern)
+{
+	gsize length = strlen(pattern);
+
+	while(offset + length <= buffer->len)
+	{
+		if(!memcmp(buffer->str + offset, pattern, length))
+		{
+			return offset;
+		}
+
+		++offset;
+	}
+
+	return -1;
+}
+
+/**
+ * \param in stream to read from
+ * \param cancellable a GCancellable or NULL
+ * \param response buffer to append received data to
+ * \param err holds failure messages
+ * \return TRUE if data has been received
+ *
+ * Reads the next block of data. Reaching the end of the stream is treated as failure.
+ */
+static gboolean
+_http_client_read_block(GInputStream *in, GCancellable *cancellable, GString *response, GError **err)
+{
+	gchar buffer[8192];
+	gssize bytes;
+
+	if((bytes = g_input_stream_read(in, buffer, 8192, cancellable, err)) > 0)
+	{
+		g_string_append_len(response, buffer, bytes);
+
+		return TRUE;
+	}
+
+	if(!bytes)
+	{
+		g_set_error(err, 0, 0, "Connection closed by remote host");
+	}
+
+	return FALSE;
+}
+
+/**
+ * \param in stream to read from
+ * \param cancellable a GCancellable or NULL
+ * \param response buffer to append received data to
+ * \param length expected length of the buffer
+ * \param err holds failure messages
+ * \return TRUE on success
+ *
+ * Reads data until the buffer has the expected length.
+ */
+static gboolean
+_http_client_read_until_length(GInputStream *in, GCancellable *cancellable, GString *response, gsize length, GError **err)
+{
+	while(response->len < length)
+	{
+		if(!_http_client_read_block(in, cancellable, response, err))
+		{
+			return FALSE;
+		}
+	}
+
+	return TRUE;
+}
+
+/**
+ * \param in stream to read from
+ * \param cancellable a GCancellable or NULL
+ * \param response buffer to append received data to
+ * \param offset position to start from
+ * \param err holds failure messages
+ * \return position of the next CRLF or -1 on failure
+ *
+ * Reads data until the buffer contains a line break after the given offset.
+ */
+static gssize
+_http_client_read_line(GInputStream *in, GCancellable *cancellable, GString *response, gsize offset, GError **err)
+{
+	gssize pos;
+
+	while((pos = _http_client_find(response, offset, "\r\n")) == -1)
+	{
+		if(!_http_client_read_block(in, cancellable, response, err))
+		{
+			return -1;
+		}
+	}
+
+	return pos;
+}
+
+/**
+ * \param client an HttpClient instance
+ * \param reader state of the message body
+ * \param data decoded data
+ * \param length length of the decoded data
+ * \param err holds failure messages
+ * \return TRUE on success
+ *
+ * Passes decoded data to the content function or appends it to the body buffer.
+ */
+static gboolean
+_http_client_emit(HttpClient *client, _HttpClientBodyReader *reader, const gchar *data, gsize length, GError **err)
+{
+	reader->decoded_bytes += length;
+
+	if(reader->body)
+	{
+		g_string_append_len(reader->body, data, length);
+	}
+	else if(!client->priv->content_func(client, data, length, client->priv->content_data))
+	{
+		g_set_error(err, 0, 0, "Reading the response has been aborted");
+
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+/**
+ * \param client an HttpClient instance
+ * \param reader state of the message body
+ * \param data received data
+ * \param length length of the received data
+ * \param err holds failure messages
+ * \return TRUE on success
+ *
+ * Decompresses received data (if necessary) & emits the result.
+ */
+static gboolean
+_http_client_decode(HttpClient *client, _HttpClientBodyReader *reader, const gchar *data, gsize length, GError **err)
+{
+	gchar buffer[8192];
+	gsize bytes_read;
+	gsize bytes_written;
+	GConverterResult result;
+	GError *failure = NULL;
+
+	reader->encoded_bytes += length;
+
+	if(!reader->decompressor)
+	{
+		return _http_client_emit(client, reader, data, length, err);
+	}
+
+	do
+	{
+		result = g_converter_convert(reader->decompressor, data, length, buffer, 8192, G_CONVERTER_NO_FLAGS, &bytes_read, &bytes_written, &failure);
+
+		if(result == G_CONVERTER_ERROR)
+		{
+			/* the decompressor needs more input */
+			if(g_error_matches(failure, G_IO_ERROR, G_IO_ERROR_PARTIAL_INPUT))
+			{
+				g_error_free(failure);
+
+				return TRUE;
+			}
+
+			g_propagate_error(err, failure);
+
+			return FALSE;
+		}
+
+		data += bytes_read;
+		length -= bytes_read;
+
+		if(bytes_written && !_http_client_emit(client, reader, buffer, bytes_written, err))
+		{
+			return FALSE;
+		}
+	} while(result != G_CONVERTER_FINISHED && (length || bytes_written == 8192));
+
+	if(result == G_CONVERTER_FINISHED)
+	{
+		reader->finished = TRUE;
+	}
+
+	return TRUE;
+}
+
+/**
+ * \param client an HttpClient instance
+ * \param reader state of the message body
+ * \param err holds failure messages
+ * 
+eturn TRUE on success
+ *
+ * Flushes the decompressor after the message body has been received. Fails if the
+ * compressed data is incomplete.
+ */
+static gboolean
+_http_client_finish_decoding(HttpClient *client, _HttpClientBodyReader *reader, GError **err)
 {
-	gint i = offset;
+	gchar buffer[8192];
+	gsize bytes_read;
+	gsize bytes_written;
+	GConverterResult result;
+	GError *failure = NULL;
 
-	g_debug("Detecting next CRLF");
-	while(i < length + 1)
+	while(!reader->finished)
+	{
+		result = g_converter_convert(reader->decompressor, "", 0, buffer, 8192, G_CONVERTER_INPUT_AT_END, &bytes_read, &bytes_written, &failure);
+
+		if(result == G_CONVERTER_ERROR)
+		{
+			if(g_error_matches(failure, G_IO_ERROR, G_IO_ERROR_PARTIAL_INPUT))
+			{
+				g_error_free(failure);
+				g_set_error(err, 0, 0, "Compressed message body is truncated");
+			}
+			else
+			{
+				g_propagate_error(err, failure);
+			}
+
+			return FALSE;
+		}
+
+		if(bytes_written && !_http_client_emit(client, reader, buffer, bytes_written, err))
+		{
+			return FALSE;
+		}
+
+		if(result == G_CONVERTER_FINISHED)
+		{
+			reader->finished = TRUE;
+		}
+		else if(!bytes_written)
+		{
+			g_set_error(err, 0, 0, "Compressed message body is truncated");
+
+			return FALSE;
+		}
+	}
+
+	return TRUE;
+}
+
+/**
+ * \param client an HttpClient instance
+ * \param reader state of the message body
+ * \param length number of bytes to decode
+ * \param err holds failure messages
+ * \return TRUE on success
+ *
+ * Decodes data from the window & removes it.
+ */
+static gboolean
+_http_client_consume(HttpClient *client, _HttpClientBodyReader *reader, gsize length, GError **err)
+{
+	if(length && !_http_client_decode(client, reader, reader->window->str, length, err))
+	{
+		return FALSE;
+	}
+
+	g_string_erase(reader->window, 0, length);
+
+	return TRUE;
+}
+
+/**
+ * \param client an HttpClient instance
+ * \param reader state of the message body
+ * \param length number of bytes to decode
+ * \param err holds failure messages
+ * \return TRUE on success
+ *
+ * Reads & decodes the given number of bytes.
+ */
+static gboolean
+_http_client_read_length(HttpClient *client, _HttpClientBodyReader *reader, gsize length, GError **err)
+{
+	gsize size;
+
+	while(length)
+	{
+		if(!reader->window->len && !_http_client_read_block(reader->in, reader->cancellable, reader->window, err))
+		{
+			return FALSE;
+		}
+
+		size = MIN(reader->window->len, length);
+
+		if(!_http_client_consume(client, reader, size, err))
+		{
+			return FALSE;
+		}
+
+		length -= size;
+	}
+
+	return TRUE;
+}
+
+/**
+ * \param client an HttpClient instance
+ * \param reader state of the message body
+ * \param err holds failure messages
+ * \return TRUE on success
+ *
+ * Reads & decodes a chunked message body including the trailer.
+ */
+static gboolean
+_http_client_read_chunked_body(HttpClient *client, _HttpClientBodyReader *reader, GError **err)
+{
+	gssize pos;
+	gsize block_size;
+	gchar *end;
+
+	/* read chunks */
+	do
+	{
+		if((pos = _http_client_read_line(reader->in, reader->cancellable, reader->window, 0, err)) == -1)
+		{
+			return FALSE;
+		}
+
+		/* the chunk size may only be followed by whitespace or chunk extensions */
+		errno = 0;
+		block_size = (gsize)g_ascii_strtoull(reader->window->str, &end, 16);
+
+		if(end == reader->window->str || errno == ERANGE ||
+		   (end < reader->window->str + pos && *end != ';' && *end != ' ' && *end != '\t'))
+		{
+			g_set_error(err, 0, 0, "Invalid chunk size");
+
+			return FALSE;
+		}
+
+		g_string_erase(reader->window, 0, pos + 2);
+
+		if(block_size)
+		{
+			if(!_http_client_read_length(client, reader, block_size, err) ||
+			   !_http_client_read_until_length(reader->in, reader->cancellable, reader->window, 2, err))
+			{
+				return FALSE;
+			}
+
+			g_string_erase(reader->window, 0, 2);
+		}
+	} while(block_size);
+
+	/* skip trailer (terminated by an empty line) */
+	do
+	{
+		if((pos = _http_client_read_line(reader->in, reader->cancellable, reader->window, 0, err)) == -1)
+		{
+			return FALSE;
+		}
+
+		g_string_erase(reader->window, 0, pos + 2);
+	} while(pos);
+
+	return TRUE;
+}
+
+/**
+ * \param client an HttpClient instance
+ * \param name name of the header to lookup
+ * \return value of the header or NULL
+ *
+ * Looks up a response header ignoring the case of its name.
+ */
+static const gchar *
+_http_client_lookup_header_nocase(HttpClient *client, const gchar *name)
+{
+	GHashTableIter iter;
+	gpointer key;
+	gpointer value;
+
+	g_hash_table_iter_init(&iter, client->priv->headers);
+
+	while(g_hash_table_iter_next(&iter, &key, &value))
+	{
+		if(!g_ascii_strcasecmp((const gchar *)key, name))
+		{
+			return (const gchar *)value;
+		}
+	}
+
+	return NULL;
+}
+
+/**
+ * \param client an HttpClient instance
+ * \param err holds failure messages
+ *
+ * Parses the reponse buffer.
+ */
+static void
+_http_client_handle_response(HttpClient *client, GError **err)
+{
+	g_return_if_fail(client->priv->response != NULL);
+	g_return_if_fail(client->priv->response_length > 0);
+
+	if((client->priv->status = _http_client_get_status_code(client)) != HTTP_NONE)
+	{
+		g_debug("HTTP status code: %d", client->priv->status);
+
+		/* read HTTP headers */
+		_http_client_parse_headers(client);
+	}
+	else
+	{
+		g_set_error(err, 0, 0, "Couldn't fetch HTTP status code");
+	}
+}
+
+
+/**
+ * \param client an HttpClient instance
+ * \return a new decompressor or NULL if the content isn't compressed
+ *
+ * Creates a decompressor matching the Content-Encoding header.
+ */
+static GConverter *
+_http_client_create_decompressor(HttpClient *client)
+{
+	const gchar *encoding;
+
+	if((encoding = _http_client_lookup_header_nocase(client, "Content-Encoding")))
+	{
+		g_debug("Content-Encoding: %s", encoding);
+
+		if(!g_ascii_strncasecmp(encoding, "gzip", 4) || !g_ascii_strncasecmp(encoding, "x-gzip", 6))
+		{
+			return G_CONVERTER(g_zlib_decompressor_new(G_ZLIB_COMPRESSOR_FORMAT_GZIP));
+		}
+
+		if(!g_ascii_strncasecmp(encoding, "deflate", 7))
+		{
+			return G_CONVERTER(g_zlib_decompressor_new(G_ZLIB_COMPRESSOR_FORMAT_ZLIB));
+		}
+	}
+
+	return NULL;
+}
+
+/**
+ * \param client an HttpClient instance
+ * \param in stream to read from
+ * \param response buffer containing the response header
+ * \param header_length length of the response header
+ * \param err holds failure messages
+ * \return TRUE on success
+ *
+ * Reads the message body, framed by Content-Length, chunked transfer encoding or the end of
+ * the stream, & decompresses it. The decoded body of a successful response is passed to the
+ * content function if set, otherwise it's appended to the response header.
+ */
+static gboolean
+_http_client_read_body(HttpClient *client, GInputStream *in, GString *response, gsize header_length, GError **err)
+{
+	_HttpClientBodyReader reader;
+	const gchar *value;
+	gboolean result = TRUE;
+
+	/* move data following the header to a separate buffer */
+	reader.in = in;
+	reader.cancellable = client->priv->cancellable;
+	reader.window = g_string_sized_new(8192);
+	g_string_append_len(reader.window, response->str + header_length, response->len - header_length);
+	g_string_truncate(response, header_length);
+	/* error responses are always stored, so the caller can read the error message */
+	reader.body = (client->priv->content_func && client->priv->status >= HTTP_OK && client->priv->status < 300) ? NULL : response;
+	reader.decompressor = _http_client_create_decompressor(client);
+	reader.finished = FALSE;
+	reader.encoded_bytes = 0;
+	reader.decoded_bytes = 0;
+
+	if(client->priv->status < HTTP_OK || client->priv->status == HTTP_NO_CONTENT || client->priv->status == HTTP_NOT_MODIFIED)
+	{
+		g_debug("Response has no message body");
+	}
+	else if((value = _http_client_lookup_header_nocase(client, "Transfer-Encoding")) && !g_ascii_strncasecmp(value, "chunked", 7))
 	{
-		if(buffer[i] == 0x0D && buffer[i + 1] == 0x0A)
+		g_debug("Reading chunked message body");
+		result = _http_client_read_chunked_body(client, &reader, err);
+	}
+	else if((value = _http_client_lookup_header_nocase(client, "Content-Length")))
+	{
+		g_debug("Reading message body: %s bytes", value);
+		result = _http_client_read_length(client, &reader, g_ascii_strtoull(value, NULL, 10), err);
+	}
+	else
+	{
+		/* message body is terminated by closing the connection */
+		g_debug("Reading message body until connection is closed");
+		while(result && (reader.window->len || _http_client_read_block(in, reader.cancellable, reader.window, NULL)))
 		{
-			g_debug("Offset: %d", i);
-			return i;
+			result = _http_client_consume(client, &reader, reader.window->len, err);
 		}
 
-		++i;
+		client->priv->keep_alive = FALSE;
 	}
 
+	/* a compressed body must end with the end of the compressed data */
+	if(result && reader.decompressor && reader.encoded_bytes)
+	{
+		result = _http_client_finish_decoding(client, &reader, err);
+	}
 
-	return -1;
+	/* the connection is out of sync if the server sent more data than announced */
+	if(!result || reader.window->len)
+	{
+		client->priv->keep_alive = FALSE;
+	}
+
+	if(reader.decompressor)
+	{
+		g_debug("Decompressed message body: %" G_GUINT64_FORMAT " => %" G_GUINT64_FORMAT " bytes", reader.encoded_bytes, reader.decoded_bytes);
+		g_object_unref(reader.decompressor);
+	}
+
+	g_string_free(reader.window, TRUE);
+
+	/* update statistics */
+	g_static_mutex_lock(&_http_client_statistics_mutex);
+	_http_client_encoded_bytes += reader.encoded_bytes;
+	_http_client_decoded_bytes += reader.decoded_bytes;
+	g_static_mutex_unlock(&_http_client_statistics_mutex);
+
+	return result;
 }
 
 /**
- * \param buffer text to parse
- * \param x start position of the header
- * \param y end position of the header
- * \return the converted header
+ * \param client an HttpClient instance
+ * \param in stream to read from
+ * \param response buffer to store the response
+ * \param err holds failure messages
+ * \return TRUE on success
  *
- * Extracts the size of the chunk block from its related header.
+ * Reads the response header & the message body. Afterwards keep_alive specifies if the
+ * connection can be reused.
  */
-static gint
-_http_client_parse_chunk_header(const gchar *buffer, gint x, gint y)
+static gboolean
+_http_client_receive_response(HttpClient *client, GInputStream *in, GString *response, GError **err)
 {
-	gint i = x;
-	gchar str[y - x + 1];
+	GCancellable *cancellable = client->priv->cancellable;
+	gssize pos;
+	gsize header_length;
+	const gchar *value;
 
-	g_debug("Parsing chunk header (x=%d, y=%d)", x, y);
-	while(i < y)
+	/* read header */
+	while((pos = _http_client_find(response, 0, "\r\n\r\n")) == -1)
 	{
-		str[i - x] = buffer[i];
-		if(!isxdigit(buffer[i]))
+		if(!_http_client_read_block(in, cancellable, response, err))
 		{
-			break;
+			return FALSE;
 		}
-
-		++i;
 	}
-	str[i - x] = '\0';
-	g_debug("block size=0x%s", str);
-
-	return strtol(str, NULL, 16);
-}
 
-/**
- * \param response response of the HTTP server
- * \param length length of the response
- * \param buffer pointer to a string which will hold the merged data
- * \return length of the buffer
- *
- * Merges memory chunks.
- */
-static gint
-_http_client_handle_chunked_transfer_encoding(const gchar *response, gint length, gchar **buffer)
-{
-	gint x = 0;
-	gint y;
-	gint block_size;
-	GString *content = g_string_new_len(NULL, 4096);
-	gint bytes = 0;
-	gboolean finished = FALSE;
+	header_length = pos + 4;
 
-	*buffer = NULL;
+	/* parse status code & headers */
+	client->priv->response = response->str;
+	client->priv->response_length = header_length;
+	_http_client_handle_response(client, err);
+	client->priv->response = NULL;
+	client->priv->response_length = 0;
 
-	while(!finished)
+	if(client->priv->status == HTTP_NONE)
 	{
-		/* find next line feed */
-		if((y = _http_client_find_next_crlf(response, length, x)) != -1)
-		{
-			/* read chunk header */
-			if((block_size = _http_client_parse_chunk_header(response, x, y)) > 0)
-			{
-				/* block size > 0 => copy data into content buffer */
-				x = y + 2;
-				content = g_string_append_len(content, response + x, block_size);
-				x += block_size + 2;
-			}
-			else
-			{
-				finished = TRUE;
-			}
-		}
-		else
-		{
-			g_warning("Couldn't merge memory blocks");
-			finished = TRUE;
-		}
+		return FALSE;
 	}
 
-	bytes = content->len;
-	*buffer = g_string_free(content, FALSE);
+	/* HTTP/1.1 connections are persistent unless the server wants to close them */
+	client->priv->keep_alive = g_str_has_prefix(response->str, "HTTP/1.1");
+
+	if((value = _http_client_lookup_header_nocase(client, "Connection")) && !g_ascii_strncasecmp(value, "close", 5))
+	{
+		client->priv->keep_alive = FALSE;
+	}
 
-	return bytes;
+	/* read message body */
+	return _http_client_read_body(client, in, response, header_length, err);
 }
 
 /**
  * \param client an HttpClient instance
  * \param request an HTTP request
+ * \param received set to TRUE if any data has been received
  * \param err holds failure messages
  * \return TRUE on success
  *
- * Sends an HTTP request to the specified remote host.
+ * Sends an HTTP request to the specified remote host & reads the response.
  */
 static gboolean
-_http_client_send_request(HttpClient *client, const gchar *request, GError **err)
+_http_client_send_request(HttpClient *client, const gchar *request, gboolean *received, GError **err)
 {
 	GInputStream *in;
 	GOutputStream *out;
 	gsize bytes;
-	gchar buffer[8192];
-	GString *response = g_string_new_len(NULL, 8192);
+	GString *response;
 	gboolean ret = FALSE;
 
 	g_return_val_if_fail(client->priv->status == HTTP_NONE, FALSE);
 	g_return_val_if_fail(client->priv->stream != NULL, FALSE);
 
+	*received = FALSE;
+	client->priv->keep_alive = FALSE;
+
 	if((out = g_io_stream_get_output_stream(G_IO_STREAM(client->priv->stream))))
 	{
 		g_debug("Sending request:\n%s", request);
-		if(g_output_stream_write_all(out, request, strlen(request), &bytes, NULL, NULL))
+		if(g_output_stream_write_all(out, request, strlen(request), &bytes, client->priv->cancellable, err) &&
+		   g_output_stream_flush(out, client->priv->cancellable, err))
 		{
 			g_debug("OK, sent %d bytes to host", (gint)bytes);
-			g_output_stream_flush(out, NULL, NULL);
 
 			/* read response */
 			if((in = g_io_stream_get_input_stream(G_IO_STREAM(client->priv->stream))))
 			{
-				while((bytes = g_input_stream_read(in, buffer, 8192, NULL, NULL)) > 0)
+				response = g_string_sized_new(8192);
+				ret = _http_client_receive_response(client, in, response, err);
+				*received = response->len ? TRUE : FALSE;
+
+				if(ret)
 				{
-					client->priv->response_length += bytes;
-					g_string_append_len(response, buffer, bytes);
+					g_debug("Received %d bytes from host", (gint)response->len);
+					client->priv->response_length = response->len;
+					client->priv->response = g_string_free(response, FALSE);
+				}
+				else
+				{
+					g_string_free(response, TRUE);
+					client->priv->status = HTTP_NONE;
+					client->priv->keep_alive = FALSE;
+					_http_client_free_headers(client);
 				}
-
-				g_debug("Received %d bytes from host", client->priv->response_length);
-				client->priv->response = response->str;
-				g_string_free(response, FALSE);
-				ret = TRUE;
 			}
 		}
 	}
@@ -494,29 +1329,177 @@ _http_client_send_request(HttpClient *client, const gchar *request, GError **err
 
 /**
  * \param client an HttpClient instance
+ * \param request an HTTP request
+ * \param idempotent TRUE if the request can be sent more than once (GET, HEAD)
  * \param err holds failure messages
+ * \return TRUE on success
  *
- * Parses the reponse buffer.
+ * Connects to the remote host, sends the request & reads the response. If a connection
+ * taken from the pool has been closed by the remote host before any data could be
+ * received an idempotent request is sent once again using a new connection. Other
+ * requests may already have been processed by the server, so they fail.
+ */
+static gboolean
+_http_client_process_request(HttpClient *client, const gchar *request, gboolean idempotent, GError **err)
+{
+	GError *failure = NULL;
+	gboolean received;
+	gboolean retry;
+	gboolean result = FALSE;
+
+	if(_http_client_connect(client, TRUE, err))
+	{
+		do
+		{
+			retry = FALSE;
+
+			if(_http_client_send_request(client, request, &received, &failure))
+			{
+				result = TRUE;
+				_http_client_release(client);
+			}
+			else
+			{
+				_http_client_close(client);
+
+				if(idempotent && client->priv->reused && !received && !g_cancellable_is_cancelled(client->priv->cancellable))
+				{
+					g_debug("Idle connection has been closed by remote host, reconnecting");
+					g_clear_error(&failure);
+					retry = _http_client_connect(client, FALSE, &failure);
+				}
+			}
+		} while(retry);
+
+		if(failure)
+		{
+			g_propagate_error(err, failure);
+		}
+	}
+
+	return result;
+}
+
+/**
+ * \param request request to free
+ *
+ * Frees an asynchronous request.
  */
 static void
-_http_client_handle_response(HttpClient *client, GError **err)
+_http_client_async_request_free(_HttpClientAsyncRequest *request)
 {
-	g_return_if_fail(client->priv->response != NULL);
-	g_return_if_fail(client->priv->response_length > 0);
+	if(request->user_cancellable)
+	{
+		g_cancellable_disconnect(request->user_cancellable, request->cancelled_id);
+		g_object_unref(request->user_cancellable);
+	}
 
-	if((client->priv->status = _http_client_get_status_code(client)) != HTTP_NONE)
+	if(request->timeout)
 	{
-		g_debug("HTTP status code: %d", client->priv->status);
+		g_source_destroy(request->timeout);
+		g_source_unref(request->timeout);
+	}
 
-		/* read HTTP headers */
-		_http_client_parse_headers(client);
+	g_object_unref(request->client);
+	g_object_unref(request->cancellable);
+	g_free(request->path);
+	g_slice_free(_HttpClientAsyncRequest, request);
+}
+
+/**
+ * \param cancellable the caller's cancellable
+ * \param request the cancelled request
+ *
+ * Forwards cancellation to the internal cancellable of a request.
+ */
+static void
+_http_client_async_cancelled(GCancellable *cancellable, _HttpClientAsyncRequest *request)
+{
+	g_cancellable_cancel(request->cancellable);
+}
+
+/**
+ * \param request request which has timed out
+ * \return FALSE to remove the source
+ *
+ * Cancels a request when its timeout has been reached.
+ */
+static gboolean
+_http_client_async_timeout(_HttpClientAsyncRequest *request)
+{
+	g_debug("Request timed out: %s", request->path);
+	g_atomic_int_set(&request->timed_out, 1);
+	g_cancellable_cancel(request->cancellable);
+
+	return FALSE;
+}
+
+/**
+ * \param result result of the asynchronous request
+ * \param user_data unused
+ *
+ * Processes an asynchronous request in the worker pool & completes it in the main context
+ * of the caller.
+ */
+static void
+_http_client_async_worker(GSimpleAsyncResult *result, gpointer user_data)
+{
+	_HttpClientAsyncRequest *request;
+	GError *err = NULL;
+
+	request = g_simple_async_result_get_op_res_gpointer(result);
+
+	/* the request has its own client, the caller's client isn't touched by the worker */
+	if(!g_cancellable_set_error_if_cancelled(request->cancellable, &err))
+	{
+		request->status = http_client_get(request->client, request->path, &err);
 	}
-	else
+
+	if(err)
 	{
-		g_set_error(err, 0, 0, "Couldn't fetch HTTP status code");
+		if(g_atomic_int_get(&request->timed_out))
+		{
+			g_simple_async_result_set_error(result, G_IO_ERROR, G_IO_ERROR_TIMED_OUT, "Request timed out");
+		}
+		else
+		{
+			g_simple_async_result_set_from_error(result, err);
+		}
+
+		g_error_free(err);
+	}
+
+	if(request->timeout)
+	{
+		g_source_destroy(request->timeout);
 	}
+
+	g_simple_async_result_complete_in_idle(result);
+
+	g_object_unref(result);
 }
 
+/**
+ * \param err holds failure messages
+ * \return the worker pool or NULL on failure
+ *
+ * Gets the worker pool processing asynchronous requests. It's created on first use.
+ */
+static GThreadPool *
+_http_client_async_get_pool(GError **err)
+{
+	g_static_mutex_lock(&_http_client_async_mutex);
+
+	if(!_http_client_async_pool)
+	{
+		g_debug("Creating HTTP worker pool (max. %d threads)", HTTP_CLIENT_ASYNC_MAX_THREADS);
+		_http_client_async_pool = g_thread_pool_new((GFunc)_http_client_async_worker, NULL, HTTP_CLIENT_ASYNC_MAX_THREADS, FALSE, err);
+	}
+
+	g_static_mutex_unlock(&_http_client_async_mutex);
+
+	return _http_client_async_pool;
+}
 
 /*
  *	implementation:
@@ -533,36 +1516,26 @@ _http_client_get(HttpClient *client, const gchar *path, GError **err)
 	/* initialize internal data */
 	_http_client_reset(client);
 
-	/* connect to server */
-	if(_http_client_connect(client, err))
-	{
-		/* build request */
-		g_string_printf(request, "GET %s HTTP/1.1\n"
-		                         "User-Agent: %s\n"
-		                         "Host: %s\n"
-		                         "Accept: %s\n\n",
-		                         path,
-		                         client->priv->header_user_agent,
-		                         client->priv->hostname,
-		                         client->priv->header_accept);
+	/* build request */
+	g_string_printf(request, "GET %s HTTP/1.1\r\n"
+	                         "User-Agent: %s\r\n"
+	                         "Host: %s\r\n"
+	                         "Accept: %s\r\n"
+	                         "Accept-Encoding: " HTTP_CLIENT_ACCEPT_ENCODING "\r\n",
+	                         path,
+	                         client->priv->header_user_agent,
+	                         client->priv->hostname,
+	                         client->priv->header_accept);
 
-		if(client->priv->header_authorization)
-		{
-			g_string_append_printf(request, "Authorization: %s\n", client->priv->header_authorization);
-		}
+	if(client->priv->header_authorization)
+	{
+		g_string_append_printf(request, "Authorization: %s\r\n", client->priv->header_authorization);
+	}
 
-		g_string_append_printf(request, "Connection : close\n\n");
+	g_string_append(request, "Connection: keep-alive\r\n\r\n");
 
-		/* handle request */
-		if(_http_client_send_request(client, request->str, err))
-		{
-			/* handle response */
-			_http_client_handle_response(client, err);
-		}
-		
-		/* close connection */
-		_http_client_close(client);
-	}
+	/* handle request */
+	_http_client_process_request(client, request->str, TRUE, err);
 
 	/* free memory */
 	g_string_free(request, TRUE);
@@ -570,6 +1543,105 @@ _http_client_get(HttpClient *client, const gchar *path, GError **err)
 	return client->priv->status;
 }
 
+static void
+_http_client_get_async(HttpClient *client, const gchar *path, guint timeout, GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
+{
+	GSimpleAsyncResult *result;
+	_HttpClientAsyncRequest *request;
+	GThreadPool *pool;
+	GError *err = NULL;
+
+	g_return_if_fail(path != NULL);
+
+	if(!(pool = _http_client_async_get_pool(&err)))
+	{
+		g_simple_async_report_gerror_in_idle(G_OBJECT(client), callback, user_data, err);
+		g_error_free(err);
+
+		return;
+	}
+
+	request = g_slice_new0(_HttpClientAsyncRequest);
+	request->path = g_strdup(path);
+	request->cancellable = g_cancellable_new();
+	request->client = http_client_new("hostname", client->priv->hostname,
+	                                  "port", client->priv->port,
+	                                  "ssl-enabled", client->priv->ssl_enabled,
+	                                  "header-user-agent", client->priv->header_user_agent,
+	                                  "header-accept", client->priv->header_accept,
+	                                  "header-authorization", client->priv->header_authorization,
+	                                  "timeout", client->priv->timeout,
+	                                  "cancellable", request->cancellable,
+	                                  NULL);
+
+	if(cancellable)
+	{
+		request->user_cancellable = g_object_ref(cancellable);
+		request->cancelled_id = g_cancellable_connect(cancellable, G_CALLBACK(_http_client_async_cancelled), request, NULL);
+	}
+
+	if(timeout)
+	{
+		request->timeout = g_timeout_source_new_seconds(timeout);
+		g_source_set_callback(request->timeout, (GSourceFunc)_http_client_async_timeout, request, NULL);
+		g_source_attach(request->timeout, g_main_context_get_thread_default());
+	}
+
+	result = g_simple_async_result_new(G_OBJECT(client), callback, user_data, _http_client_get_async);
+	g_simple_async_result_set_op_res_gpointer(result, request, (GDestroyNotify)_http_client_async_request_free);
+
+	/* the worker releases the result after completion */
+	g_thread_pool_push(pool, result, NULL);
+}
+
+static gint
+_http_client_get_finish(HttpClient *client, GAsyncResult *result, GError **err)
+{
+	GSimpleAsyncResult *simple = G_SIMPLE_ASYNC_RESULT(result);
+	_HttpClientAsyncRequest *request;
+
+	if(g_simple_async_result_propagate_error(simple, err))
+	{
+		return HTTP_NONE;
+	}
+
+	g_return_val_if_fail(g_simple_async_result_get_source_tag(simple) == _http_client_get_async, HTTP_NONE);
+
+	request = g_simple_async_result_get_op_res_gpointer(simple);
+
+	/* move the response to the caller's client */
+	_http_client_reset(client);
+
+	client->priv->status = request->status;
+	client->priv->response = request->client->priv->response;
+	client->priv->response_length = request->client->priv->response_length;
+	client->priv->headers = request->client->priv->headers;
+	client->priv->header_offset = request->client->priv->header_offset;
+
+	request->client->priv->response = NULL;
+	request->client->priv->response_length = 0;
+	request->client->priv->headers = NULL;
+	request->client->priv->header_offset = -1;
+
+	return request->status;
+}
+
+static gint
+_http_client_get_stream(HttpClient *client, const gchar *path, HttpClientContentFunc func, gpointer user_data, GError **err)
+{
+	gint status;
+
+	g_return_val_if_fail(func != NULL, HTTP_NONE);
+
+	client->priv->content_func = func;
+	client->priv->content_data = user_data;
+	status = _http_client_get(client, path, err);
+	client->priv->content_func = NULL;
+	client->priv->content_data = NULL;
+
+	return status;
+}
+
 static gint
 _http_client_post(HttpClient *client, const gchar *path, const gchar * restrict keys[], const gchar * restrict values[], gint argc, GError **err)
 {
@@ -606,42 +1678,29 @@ _http_client_post(HttpClient *client, const gchar *path, const gchar * restrict
 		}
 	}
 
-	/* connect to server */
-	if(_http_client_connect(client, err))
-	{
-		/* build request */
-		g_string_printf(request, "POST %s HTTP/1.1\n"
-		                         "User-Agent: %s\n"
-		                         "Content-Type: application/x-www-form-urlencoded\n"
-		                         "Content-Length: %d\n"
-		                         "Host: %s\n"
-		                         "Accept: %s\n",
-		                         path,
-		                         client->priv->header_user_agent,
-		                         (gint)params->len,
-		                         client->priv->hostname,
-		                         client->priv->header_accept);
-
-		if(client->priv->header_authorization)
-		{
-			g_string_append_printf(request, "Authorization: %s\n", client->priv->header_authorization);
-		}
-
-		g_string_append_printf(request, "Connection : close\n\n%s\n", params->str);
+	/* build request */
+	g_string_printf(request, "POST %s HTTP/1.1\r\n"
+	                         "User-Agent: %s\r\n"
+	                         "Content-Type: application/x-www-form-urlencoded\r\n"
+	                         "Content-Length: %d\r\n"
+	                         "Host: %s\r\n"
+	                         "Accept: %s\r\n"
+	                         "Accept-Encoding: " HTTP_CLIENT_ACCEPT_ENCODING "\r\n",
+	                         path,
+	                         client->priv->header_user_agent,
+	                         (gint)params->len,
+	                         client->priv->hostname,
+	                         client->priv->header_accept);
 
+	if(client->priv->header_authorization)
+	{
+		g_string_append_printf(request, "Authorization: %s\r\n", client->priv->header_authorization);
+	}
 
-//printf("%s", request->str);exit(0);
-
-		/* handle request */
-		if(_http_client_send_request(client, request->str, err))
-		{
-			/* handle response */
-			_http_client_handle_response(client, err);
-		}
+	g_string_append_printf(request, "Connection: keep-alive\r\n\r\n%s", params->str);
 
-		/* cleanup */
-		_http_client_close(client);
-	}
+	/* handle request */
+	_http_client_process_request(client, request->str, FALSE, err);
 
 	/* free memory allocated for parameters */
 	g_string_free(params, TRUE);
@@ -711,27 +1770,18 @@ _http_client_lookup_header_int(HttpClient *client, const gchar *name)
 static gint
 _http_client_get_content_length(HttpClient *client)
 {
-	gint length;
-
 	g_return_val_if_fail(client->priv->status != HTTP_NONE, -1);
 	g_return_val_if_fail(client->priv->response_length > 0, -1);
 	g_return_val_if_fail(client->priv->header_offset != -1, -1);
 	g_return_val_if_fail(client->priv->header_offset <= client->priv->response_length, -1);
 
-	if((length = http_client_lookup_header_int(client, "Content-Length")) == 0)
-	{
-		length = client->priv->response_length - client->priv->header_offset;
-	}
-
-	return length;
+	/* the stored message body has already been decoded */
+	return client->priv->response_length - client->priv->header_offset;
 }
 
 static void
 _http_client_read_content(HttpClient *client, gchar **buffer, gint *length)
 {
-	const gchar * restrict encoding;
-	gboolean chunked = FALSE;
-
 	*length = -1;
 
 	g_return_if_fail(client->priv->status != HTTP_NONE);
@@ -740,32 +1790,10 @@ _http_client_read_content(HttpClient *client, gchar **buffer, gint *length)
 	g_return_if_fail(client->priv->header_offset != -1);
 	g_return_if_fail(client->priv->header_offset <= client->priv->response_length);
 
-	/* check transfer encoding */
-	g_debug("Testing HTTP transfer encoding");
-	if((encoding = http_client_lookup_header(client, "Transfer-Encoding")))
-	{
-		g_debug("Transfer-Encoding: %s", encoding);
-		if(!g_ascii_strncasecmp(encoding, "chunked", 8))
-		{
-			chunked = TRUE;
-		}
-	}
-
-	if(chunked)
-	{
-		/* merge chunks */
-		g_debug("Parsing chunked data");
-		*length = _http_client_handle_chunked_transfer_encoding(client->priv->response + client->priv->header_offset,
-		                                                        client->priv->response_length - client->priv->header_offset,
-		                                                        buffer);
-	}
-	else
-	{
-		/* copy data */
-		*length = http_client_get_content_length(client);
-		*buffer = (gchar *)g_malloc(*length);
-		memcpy(*buffer, client->priv->response + client->priv->header_offset, *length);
-	}
+	/* copy data */
+	*length = http_client_get_content_length(client);
+	*buffer = (gchar *)g_malloc(*length);
+	memcpy(*buffer, client->priv->response + client->priv->header_offset, *length);
 }
 
 static gboolean
@@ -836,6 +1864,14 @@ _http_client_get_property(GObject *object, guint prop_id, GValue *value, GParamS
 			g_value_set_boolean(value, client->priv->auto_escape);
 			break;
 
+		case PROP_TIMEOUT:
+			g_value_set_uint(value, client->priv->timeout);
+			break;
+
+		case PROP_CANCELLABLE:
+			g_value_set_object(value, client->priv->cancellable);
+			break;
+
 		default:
 			G_OBJECT_WARN_INVALID_PROPERTY_ID(object, prop_id, pspec);
 	}
@@ -892,6 +1928,18 @@ _http_client_set_property(GObject *object, guint prop_id, const GValue *value, G
 			client->priv->auto_escape = g_value_get_boolean(value);
 			break;
 
+		case PROP_TIMEOUT:
+			client->priv->timeout = g_value_get_uint(value);
+			break;
+
+		case PROP_CANCELLABLE:
+			if(client->priv->cancellable)
+			{
+				g_object_unref(client->priv->cancellable);
+			}
+			client->priv->cancellable = g_value_dup_object(value);
+			break;
+
 		default:
 			 G_OBJECT_WARN_INVALID_PROPERTY_ID(object, prop_id, pspec);
 	}
@@ -906,6 +1954,24 @@ http_client_get(HttpClient *client, const gchar *path, GError **err)
 	return HTTP_CLIENT_GET_CLASS(client)->get(client, path, err);
 }
 
+void
+http_client_get_async(HttpClient *client, const gchar *path, guint timeout, GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
+{
+	HTTP_CLIENT_GET_CLASS(client)->get_async(client, path, timeout, cancellable, callback, user_data);
+}
+
+gint
+http_client_get_finish(HttpClient *client, GAsyncResult *result, GError **err)
+{
+	return HTTP_CLIENT_GET_CLASS(client)->get_finish(client, result, err);
+}
+
+gint
+http_client_get_stream(HttpClient *client, const gchar *path, HttpClientContentFunc func, gpointer user_data, GError **err)
+{
+	return HTTP_CLIENT_GET_CLASS(client)->get_stream(client, path, func, user_data, err);
+}
+
 gint
 http_client_post(HttpClient *client, const gchar *path, const gchar * restrict keys[], const gchar * restrict values[], gint argc, GError **err)
 {
@@ -973,6 +2039,33 @@ http_client_new(const gchar *first_property_name, ...)
 	return client;
 }
 
+void
+http_client_get_content_statistics(guint64 *encoded_bytes, guint64 *decoded_bytes)
+{
+	g_static_mutex_lock(&_http_client_statistics_mutex);
+	*encoded_bytes = _http_client_encoded_bytes;
+	*decoded_bytes = _http_client_decoded_bytes;
+	g_static_mutex_unlock(&_http_client_statistics_mutex);
+}
+
+void
+http_client_close_idle_connections(void)
+{
+	GHashTable *pool;
+
+	/* detach the pool & close its connections without holding the lock */
+	g_static_mutex_lock(&_http_client_pool_mutex);
+	pool = _http_client_pool;
+	_http_client_pool = NULL;
+	g_static_mutex_unlock(&_http_client_pool_mutex);
+
+	if(pool)
+	{
+		g_debug("Closing idle connections");
+		g_hash_table_destroy(pool);
+	}
+}
+
 /*
  *	initialization/finalization:
  */
@@ -1001,6 +2094,11 @@ _http_client_finalize(GObject *object)
 		g_free(client->priv->header_authorization);
 	}
 
+	if(client->priv->cancellable)
+	{
+		g_object_unref(client->priv->cancellable);
+	}
+
 	_http_client_free_buffer(client);
 	_http_client_free_headers(client);
 
@@ -1022,6 +2120,9 @@ http_client_class_init(HttpClientClass *klass)
 	gobject_class->set_property = _http_client_set_property;
 
 	klass->get = _http_client_get;
+	klass->get_async = _http_client_get_async;
+	klass->get_finish = _http_client_get_finish;
+	klass->get_stream = _http_client_get_stream;
 	klass->post = _http_client_post;
 	klass->set_basic_authorization = _http_client_set_basic_authorization;
 	klass->get_status = _http_client_get_status;
@@ -1050,6 +2151,10 @@ http_client_class_init(HttpClientClass *klass)
 	                                g_param_spec_int("status", NULL, NULL, -1, 600, HTTP_NONE, G_PARAM_READABLE));
 	g_object_class_install_property(gobject_class, PROP_AUTO_ESCAPE,
 	                                g_param_spec_boolean("auto-escape", NULL, NULL, TRUE, G_PARAM_READWRITE));
+	g_object_class_install_property(gobject_class, PROP_TIMEOUT,
+	                                g_param_spec_uint("timeout", NULL, NULL, 0, G_MAXUINT, NETUTIL_DEFAULT_SOCKET_TIMEOUT, G_PARAM_READWRITE));
+	g_object_class_install_property(gobject_class, PROP_CANCELLABLE,
+	                                g_param_spec_object("cancellable", NULL, NULL, G_TYPE_CANCELLABLE, G_PARAM_READWRITE));
 }
 
 static void
@@ -1062,6 +2167,7 @@ http_client_init(HttpClient *client)
 	client->priv->header_user_agent = g_strdup(HTTP_CLIENT_DEFAULT_HEADER_USER_AGENT);
 	client->priv->header_accept = g_strdup(HTTP_CLIENT_DEFAULT_HEADER_ACCEPT);
 	client->priv->auto_escape = TRUE;
+	client->priv->timeout = NETUTIL_DEFAULT_SOCKET_TIMEOUT;
 
 	/* reset internal data */
 	_http_client_reset(client);
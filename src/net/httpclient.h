@@ -58,10 +58,23 @@ typedef struct _HttpClientClass               HttpClientClass;
 /*! A type definition for _HttpClient. */
 typedef struct _HttpClient                    HttpClient;
 
+/**
+ * \param client HttpClient instance
+ * \param data received data
+ * \param length length of the received data
+ * \param user_data user data
+ * \return FALSE to abort the request
+ *
+ * Receives the message body of a response while it's read from the network.
+ */
+typedef gboolean (* HttpClientContentFunc)(HttpClient *client, const gchar *data, gsize length, gpointer user_data);
+
 /*! The default User-Agent header. */
 #define HTTP_CLIENT_DEFAULT_HEADER_USER_AGENT "Mozilla/5.0"
 /*! The default Accept header. */
 #define HTTP_CLIENT_DEFAULT_HEADER_ACCEPT     "text/html, image/jpeg, image/png, image/gif, image/bmp, text/css text/javascript application/rss"
+/*! Supported content encodings. */
+#define HTTP_CLIENT_ACCEPT_ENCODING           "gzip, deflate"
 
 /**
  * \struct _HttpClientClass
@@ -75,7 +88,9 @@ typedef struct _HttpClient                    HttpClient;
  * - \b header-accept: the Accept header sent in the request (string, rw)\n
  * - \b headers: an hashtable containing all headers found in the response (GHashTable, ro)\n
  * - \b status: HTTP status code of the response (integer, ro)
- * - \b auto-escape: escape post values automatically (boolean, rw)
+ * - \b auto-escape: escape post values automatically (boolean, rw)\n
+ * - \b timeout: seconds a blocking read or write on a plain connection may take, 0 to wait forever; defaults to NETUTIL_DEFAULT_SOCKET_TIMEOUT (integer, rw)\n
+ * - \b cancellable: a GCancellable aborting running requests (GCancellable, rw)
  */
 struct _HttpClientClass
 {
@@ -92,6 +107,46 @@ struct _HttpClientClass
 	 */
 	gint (* get)(HttpClient *client, const gchar *path, GError **err);
 
+	/**
+	 * \param client HttpClient instance
+	 * \param path a path to the content you are interested in
+	 * \param timeout seconds until the request is cancelled or 0
+	 * \param cancellable a GCancellable or NULL
+	 * \param callback function called when the response has been received
+	 * \param user_data user data passed to callback
+	 *
+	 * Sends a GET request to a remote host without blocking. The request is processed by a
+	 * shared worker pool using a copy of the client's settings, so several requests can be
+	 * started with the same client. callback is invoked in the thread-default main context
+	 * of the caller. Call get_finish() in the callback to get the result.
+	 */
+	void (* get_async)(HttpClient *client, const gchar *path, guint timeout, GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data);
+
+	/**
+	 * \param client HttpClient instance
+	 * \param result the GAsyncResult passed to the callback
+	 * \param err holds failure messages
+	 * \return the HTTP status code of the response or HTTP_NONE on failure
+	 *
+	 * Finishes a request started with get_async(). The response is moved to the client & can
+	 * be read with the usual accessor functions afterwards.
+	 */
+	gint (* get_finish)(HttpClient *client, GAsyncResult *result, GError **err);
+
+	/**
+	 * \param client HttpClient instance
+	 * \param path a path to the content you are interested in
+	 * \param func function receiving the message body
+	 * \param user_data user data passed to func
+	 * \param err holds failure messages
+	 * \return the HTTP status code of the response or HTTP_NONE on failure
+	 *
+	 * Sends a GET request to a remote host. The message body of a successful (2xx) response
+	 * isn't stored, it's passed to func block by block after the transfer encoding has been
+	 * removed. The body of any other response is stored & can be read with read_content().
+	 */
+	gint (* get_stream)(HttpClient *client, const gchar *path, HttpClientContentFunc func, gpointer user_data, GError **err);
+
 	/**
 	 * \param client HttpClient instance
 	 * \param path a path to the content you are interested in
@@ -193,6 +248,12 @@ struct _HttpClient
 
 /*! See _HttpClientClass::get() for further information. */
 gint http_client_get(HttpClient *client, const gchar *path, GError **err);
+/*! See _HttpClientClass::get_async() for further information. */
+void http_client_get_async(HttpClient *client, const gchar *path, guint timeout, GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data);
+/*! See _HttpClientClass::get_finish() for further information. */
+gint http_client_get_finish(HttpClient *client, GAsyncResult *result, GError **err);
+/*! See _HttpClientClass::get_stream() for further information. */
+gint http_client_get_stream(HttpClient *client, const gchar *path, HttpClientContentFunc func, gpointer user_data, GError **err);
 /*! See _HttpClientClass::post() for further information. */
 gint http_client_post(HttpClient *client, const gchar *path, const gchar * restrict keys[], const gchar * restrict values[], gint argc, GError **err);
 /*! See _HttpClientClass::set_basic_authorization() for further information. */
@@ -221,6 +282,21 @@ gboolean http_client_dump(HttpClient *client, const gchar *filename, GError **er
  */
 HttpClient *http_client_new(const gchar *first_property_name, ...);
 
+/*!
+ * \param encoded_bytes location to store the number of received content bytes
+ * \param decoded_bytes location to store the number of content bytes after decompression
+ *
+ * Gets the number of message body bytes received by all HttpClient instances before & after
+ * removing the content encoding.
+ */
+void http_client_get_content_statistics(guint64 *encoded_bytes, guint64 *decoded_bytes);
+
+/*!
+ * Closes all idle connections stored in the connection pool. HttpClient instances keep
+ * HTTP/1.1 connections open & share them by hostname, port & SSL setting.
+ */
+void http_client_close_idle_connections(void);
+
 /**
  * @}
  * @}
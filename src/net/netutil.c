@@ -29,58 +29,415 @@
  * @{
  */
 
-GSocket *
-network_util_create_tcp_socket(const gchar *hostname, guint port, GError **err)
+/**
+ * \struct _NetworkUtilDnsEntry
+ * \brief A cached hostname lookup.
+ */
+typedef struct
+{
+	/*! List containing GInetAddress instances. */
+	GList *addresses;
+	/*! Time (in seconds) the entry expires. */
+	glong expires;
+} _NetworkUtilDnsEntry;
+
+/*! Mutex protecting the DNS cache. */
+static GStaticMutex _network_util_dns_mutex = G_STATIC_MUTEX_INIT;
+/*! Maps hostnames to _NetworkUtilDnsEntry instances. */
+static GHashTable *_network_util_dns_cache = NULL;
+
+/**
+ * \param addresses list containing GInetAddress instances
+ * \return a copy of the list
+ *
+ * Copies a list of addresses & increments their reference counts.
+ */
+static GList *
+_network_util_copy_addresses(GList *addresses)
+{
+	GList *copy = g_list_copy(addresses);
+
+	g_list_foreach(copy, (GFunc)g_object_ref, NULL);
+
+	return copy;
+}
+
+/**
+ * \param entry entry to free
+ *
+ * Frees a cached hostname lookup.
+ */
+static void
+_network_util_dns_entry_free(_NetworkUtilDnsEntry *entry)
+{
+	g_resolver_free_addresses(entry->addresses);
+	g_slice_free(_NetworkUtilDnsEntry, entry);
+}
+
+/**
+ * \param addresses list containing GInetAddress instances
+ * \return the sorted list
+ *
+ * Sorts addresses alternating by family, starting with the family of the first address.
+ */
+static GList *
+_network_util_interleave_addresses(GList *addresses)
+{
+	GList *preferred = NULL;
+	GList *other = NULL;
+	GList *iter;
+	GList *result = NULL;
+	GSocketFamily family;
+
+	if(!addresses)
+	{
+		return NULL;
+	}
+
+	family = g_inet_address_get_family(addresses->data);
+
+	for(iter = addresses; iter; iter = iter->next)
+	{
+		if(g_inet_address_get_family(iter->data) == family)
+		{
+			preferred = g_list_prepend(preferred, iter->data);
+		}
+		else
+		{
+			other = g_list_prepend(other, iter->data);
+		}
+	}
+
+	g_list_free(addresses);
+	preferred = g_list_reverse(preferred);
+	other = g_list_reverse(other);
+
+	for(iter = preferred; iter; iter = iter->next)
+	{
+		result = g_list_prepend(result, iter->data);
+
+		if(other)
+		{
+			result = g_list_prepend(result, other->data);
+			other = g_list_delete_link(other, other);
+		}
+	}
+
+	for(iter = other; iter; iter = iter->next)
+	{
+		result = g_list_prepend(result, iter->data);
+	}
+
+	g_list_free(preferred);
+	g_list_free(other);
+
+	return g_list_reverse(result);
+}
+
+/**
+ * \param hostname name or ip address of the desired host
+ * \param cancellable a GCancellable or NULL
+ * \param err holds failure messages
+ * \return a list containing GInetAddress instances or NULL on failure
+ *
+ * Resolves a hostname. Results are cached for NETUTIL_DNS_CACHE_TTL seconds. The returned
+ * list has to be freed with g_resolver_free_addresses().
+ */
+static GList *
+_network_util_resolve(const gchar *hostname, GCancellable *cancellable, GError **err)
+{
+	_NetworkUtilDnsEntry *entry;
+	GResolver *resolver;
+	GList *addresses = NULL;
+	GTimeVal now;
+
+	g_get_current_time(&now);
+
+	/* search cache */
+	g_static_mutex_lock(&_network_util_dns_mutex);
+
+	if(_network_util_dns_cache && (entry = g_hash_table_lookup(_network_util_dns_cache, hostname)))
+	{
+		if(entry->expires > now.tv_sec)
+		{
+			addresses = _network_util_copy_addresses(entry->addresses);
+		}
+		else
+		{
+			g_hash_table_remove(_network_util_dns_cache, hostname);
+		}
+	}
+
+	g_static_mutex_unlock(&_network_util_dns_mutex);
+
+	if(addresses)
+	{
+		g_debug("Found cached addresses: %s", hostname);
+
+		return addresses;
+	}
+
+	/* lookup hostname */
+	g_debug("Resolving hostname: %s", hostname);
+	resolver = g_resolver_get_default();
+	addresses = g_resolver_lookup_by_name(resolver, hostname, cancellable, err);
+	g_object_unref(resolver);
+
+	if(addresses)
+	{
+		addresses = _network_util_interleave_addresses(addresses);
+
+		/* update cache */
+		entry = g_slice_new(_NetworkUtilDnsEntry);
+		entry->addresses = _network_util_copy_addresses(addresses);
+		entry->expires = now.tv_sec + NETUTIL_DNS_CACHE_TTL;
+
+		g_static_mutex_lock(&_network_util_dns_mutex);
+
+		if(!_network_util_dns_cache)
+		{
+			_network_util_dns_cache = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, (GDestroyNotify)_network_util_dns_entry_free);
+		}
+
+		g_hash_table_replace(_network_util_dns_cache, g_strdup(hostname), entry);
+
+		g_static_mutex_unlock(&_network_util_dns_mutex);
+	}
+
+	return addresses;
+}
+
+/**
+ * \param hostname hostname to remove
+ *
+ * Removes a hostname from the DNS cache.
+ */
+static void
+_network_util_invalidate(const gchar *hostname)
+{
+	g_static_mutex_lock(&_network_util_dns_mutex);
+
+	if(_network_util_dns_cache)
+	{
+		g_hash_table_remove(_network_util_dns_cache, hostname);
+	}
+
+	g_static_mutex_unlock(&_network_util_dns_mutex);
+}
+
+/**
+ * \param address address of the remote host
+ * \param port port of the remote host
+ * \return a non-blocking GSocket instance or NULL on failure
+ *
+ * Starts connecting to a remote host without waiting for the result.
+ */
+static GSocket *
+_network_util_start_connect(GInetAddress *address, guint port)
 {
-	GSocketConnectable *addr;
-	GSocketAddressEnumerator *enumerator;
 	GSocketAddress *sockaddr;
-	GSocket *socket = NULL;
+	GSocket *socket;
 	GError *failure = NULL;
+	gchar *text;
 
-	g_debug("Resolving hostname: %s", hostname);
-	if((addr = g_network_address_parse(hostname, port, err)))
+	text = g_inet_address_to_string(address);
+	g_debug("Connecting to %s (port %d)", text, port);
+	g_free(text);
+
+	if(!(socket = g_socket_new(g_inet_address_get_family(address), G_SOCKET_TYPE_STREAM, G_SOCKET_PROTOCOL_TCP, &failure)))
 	{
-		enumerator = g_socket_connectable_enumerate(addr);
-		while(!socket && (sockaddr = g_socket_address_enumerator_next(enumerator, NULL, err)))
+		g_debug("Couldn't create socket: %s", failure->message);
+		g_error_free(failure);
+
+		return NULL;
+	}
+
+	g_socket_set_keepalive(socket, TRUE);
+	g_socket_set_blocking(socket, FALSE);
+
+	sockaddr = g_inet_socket_address_new(address, port);
+
+	if(!g_socket_connect(socket, sockaddr, NULL, &failure))
+	{
+		if(!g_error_matches(failure, G_IO_ERROR, G_IO_ERROR_PENDING))
 		{
-			g_debug("Creating socket");
-			socket = g_socket_new(g_socket_address_get_family(sockaddr), G_SOCKET_TYPE_STREAM, G_SOCKET_PROTOCOL_TCP, NULL);
+			g_debug("Couldn't connect to server: %s", failure->message);
+			g_object_unref(socket);
+			socket = NULL;
+		}
+
+		g_error_free(failure);
+	}
+
+	g_object_unref(sockaddr);
+
+	return socket;
+}
 
-			g_socket_set_keepalive(socket, TRUE);
+/**
+ * \param pending array containing sockets with pending connection attempts
+ * \param timeout maximum time to wait in milliseconds
+ * \param cancellable a GCancellable or NULL
+ * \return the first connected GSocket instance or NULL
+ *
+ * Waits until a pending connection attempt succeeds, the timeout is reached or the
+ * operation is cancelled. Failed attempts are removed from the array. Returns early if an
+ * attempt failed.
+ */
+static GSocket *
+_network_util_wait_for_connect(GPtrArray *pending, gint timeout, GCancellable *cancellable)
+{
+	GPollFD *fds;
+	guint count;
+	gboolean pollable = FALSE;
+	GSocket *socket = NULL;
+	GError *failure = NULL;
+	guint i;
+
+	/* the last descriptor (if any) wakes up the poll when the operation is cancelled */
+	fds = g_new0(GPollFD, pending->len + 1);
+	count = pending->len;
 
-			#if GLIB_MAJOR_VERSION >= 2 && GLIB_MINOR_VERSION >= 26 && GLIB_MICRO_VERSION >= 1
-			g_socket_set_timeout(socket, NETUTIL_DEFAULT_SOCKET_TIMEOUT);
-			#endif
+	for(i = 0; i < pending->len; ++i)
+	{
+		fds[i].fd = g_socket_get_fd(g_ptr_array_index(pending, i));
+		fds[i].events = G_IO_OUT | G_IO_ERR | G_IO_HUP;
+	}
+
+	if(cancellable && (pollable = g_cancellable_make_pollfd(cancellable, &fds[count])))
+	{
+		++count;
+	}
 
-			if(!g_socket_connect(socket, sockaddr, NULL, &failure))
+	if(g_poll(fds, count, timeout) > 0 && !g_cancellable_is_cancelled(cancellable))
+	{
+		for(i = pending->len; i > 0; --i)
+		{
+			if(fds[i - 1].revents)
 			{
-				if(failure)
+				if(!socket && g_socket_check_connect_result(g_ptr_array_index(pending, i - 1), &failure))
 				{
-					g_debug("Couldn't connect to server: %s", failure->message);
-					g_error_free(failure);
+					socket = g_ptr_array_remove_index(pending, i - 1);
 				}
-				else
+				else if(failure)
 				{
 					g_debug("Couldn't connect to server: %s", failure->message);
+					g_clear_error(&failure);
+					g_object_unref(g_ptr_array_remove_index(pending, i - 1));
 				}
-
-				g_object_unref(socket);
-				socket = NULL;
 			}
-			else
+		}
+	}
+
+	if(pollable)
+	{
+		g_cancellable_release_fd(cancellable);
+	}
+
+	g_free(fds);
+
+	return socket;
+}
+
+/**
+ * \param from start time
+ * \return number of milliseconds passed since the start time
+ *
+ * Calculates the elapsed time.
+ */
+static glong
+_network_util_elapsed(const GTimeVal *from)
+{
+	GTimeVal now;
+
+	g_get_current_time(&now);
+
+	return (now.tv_sec - from->tv_sec) * 1000 + (now.tv_usec - from->tv_usec) / 1000;
+}
+
+GSocket *
+network_util_create_tcp_socket(const gchar *hostname, guint port, GCancellable *cancellable, GError **err)
+{
+	GList *addresses;
+	GList *next;
+	GPtrArray *pending;
+	GSocket *socket = NULL;
+	GSocket *attempt;
+	GTimeVal start;
+	glong remaining;
+	guint i;
+
+	if(!(addresses = _network_util_resolve(hostname, cancellable, err)))
+	{
+		return NULL;
+	}
+
+	/* start connection attempts in a staggered way, the first established connection wins */
+	pending = g_ptr_array_new();
+	next = addresses;
+	g_get_current_time(&start);
+
+	while(!socket && (next || pending->len) && !g_cancellable_is_cancelled(cancellable) &&
+	      (remaining = NETUTIL_DEFAULT_SOCKET_TIMEOUT * 1000 - _network_util_elapsed(&start)) > 0)
+	{
+		if(next)
+		{
+			if((attempt = _network_util_start_connect(next->data, port)))
 			{
-				g_debug("Connection established successfully");
+				g_ptr_array_add(pending, attempt);
 			}
+
+			next = next->next;
 		}
 
-		g_object_unref(enumerator);
-		g_object_unref(addr);
+		if(pending->len)
+		{
+			socket = _network_util_wait_for_connect(pending, next ? MIN(NETUTIL_CONNECT_ATTEMPT_DELAY, remaining) : remaining, cancellable);
+		}
+	}
+
+	/* abort remaining attempts */
+	for(i = 0; i < pending->len; ++i)
+	{
+		g_object_unref(g_ptr_array_index(pending, i));
+	}
+
+	g_ptr_array_free(pending, TRUE);
+	g_resolver_free_addresses(addresses);
+
+	if(socket)
+	{
+		g_debug("Connection established successfully");
+		g_socket_set_blocking(socket, TRUE);
+
+		#if GLIB_MAJOR_VERSION >= 2 && GLIB_MINOR_VERSION >= 26 && GLIB_MICRO_VERSION >= 1
+		g_socket_set_timeout(socket, NETUTIL_DEFAULT_SOCKET_TIMEOUT);
+		#endif
+	}
+	else if(!g_cancellable_set_error_if_cancelled(cancellable, err))
+	{
+		/* the host may have moved, resolve it again next time */
+		_network_util_invalidate(hostname);
+		g_set_error(err, 0, 0, "Couldn't connect to %s", hostname);
 	}
 
 	return socket;
 }
 
+void
+network_util_clear_dns_cache(void)
+{
+	g_static_mutex_lock(&_network_util_dns_mutex);
+
+	if(_network_util_dns_cache)
+	{
+		g_hash_table_destroy(_network_util_dns_cache);
+		_network_util_dns_cache = NULL;
+	}
+
+	g_static_mutex_unlock(&_network_util_dns_mutex);
+}
+
 /**
  * @}
  */
@@ -34,16 +34,29 @@
 
 /*! Default socket timeout in seconds. */
 #define NETUTIL_DEFAULT_SOCKET_TIMEOUT 60
+/*! Time (in seconds) resolved hostnames are cached. */
+#define NETUTIL_DNS_CACHE_TTL          300
+/*! Delay (in milliseconds) before the next address is tried while a connection attempt is pending. */
+#define NETUTIL_CONNECT_ATTEMPT_DELAY  250
 
 /**
  * \param hostname name or ip address of the desired host
  * \param port port of the remote host
+ * \param cancellable a GCancellable or NULL
  * \param err holds failure messages
  * \return a new GSocket instance or NULL on failure
  *
- * Establishes a TCP connection to a remote host.
+ * Establishes a TCP connection to a remote host. Resolved addresses are cached. If the
+ * host has multiple addresses the next one is tried after NETUTIL_CONNECT_ATTEMPT_DELAY
+ * milliseconds while earlier attempts are still pending. Pending attempts are aborted
+ * as soon as the operation is cancelled.
  */
-GSocket *network_util_create_tcp_socket(const gchar *hostname, guint port, GError **err);
+GSocket *network_util_create_tcp_socket(const gchar *hostname, guint port, GCancellable *cancellable, GError **err);
+
+/**
+ * Removes all entries from the DNS cache.
+ */
+void network_util_clear_dns_cache(void);
 
 /**
  * @}
@@ -29,11 +29,47 @@
  * @{
  */
 
+/*! Mutex protecting the shared OpenSSL state. */
+static GStaticMutex openssl_mutex = G_STATIC_MUTEX_INIT;
+/*! Indicates if the library has been initialized. */
 static gboolean openssl_initialized = FALSE;
+/*! Mutexes used by the OpenSSL locking callback. */
+static GMutex **openssl_locks = NULL;
+/*! The process-wide client context. */
+static SSL_CTX *openssl_client_ctx = NULL;
+/*! Maps session keys to SSL_SESSION instances. */
+static GHashTable *openssl_sessions = NULL;
+/*! Number of full handshakes. */
+static guint openssl_full_handshakes = 0;
+/*! Number of resumed handshakes. */
+static guint openssl_resumed_handshakes = 0;
+
+static void
+_openssl_locking_callback(gint mode, gint n, const gchar *file, gint line)
+{
+	if(mode & CRYPTO_LOCK)
+	{
+		g_mutex_lock(openssl_locks[n]);
+	}
+	else
+	{
+		g_mutex_unlock(openssl_locks[n]);
+	}
+}
+
+static unsigned long
+_openssl_thread_id(void)
+{
+	return (unsigned long)g_thread_self();
+}
 
 gboolean
 openssl_init(void)
 {
+	gint i;
+
+	g_static_mutex_lock(&openssl_mutex);
+
 	if(!openssl_initialized)
 	{
 		g_debug("Initializing OpenSSL");
@@ -41,12 +77,150 @@ openssl_init(void)
 		SSL_library_init();
 		SSL_load_error_strings();
 		OpenSSL_add_all_algorithms();
+
+		/* the client context is shared by all threads */
+		openssl_locks = g_new(GMutex *, CRYPTO_num_locks());
+
+		for(i = 0; i < CRYPTO_num_locks(); ++i)
+		{
+			openssl_locks[i] = g_mutex_new();
+		}
+
+		CRYPTO_set_id_callback(_openssl_thread_id);
+		CRYPTO_set_locking_callback(_openssl_locking_callback);
+
 		openssl_initialized = TRUE;
 	}
 
+	g_static_mutex_unlock(&openssl_mutex);
+
 	return TRUE;
 }
 
+SSL_CTX *
+openssl_get_client_context(GError **err)
+{
+	g_static_mutex_lock(&openssl_mutex);
+
+	if(!openssl_client_ctx)
+	{
+		g_debug("Creating SSL client context");
+
+		if((openssl_client_ctx = SSL_CTX_new(SSLv23_client_method())))
+		{
+			/* sessions are stored in openssl_sessions */
+			SSL_CTX_set_session_cache_mode(openssl_client_ctx, SSL_SESS_CACHE_CLIENT | SSL_SESS_CACHE_NO_INTERNAL);
+			openssl_sessions = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, (GDestroyNotify)SSL_SESSION_free);
+		}
+		else
+		{
+			g_set_error(err, 0, 0, "Couldn't allocate memory for SSL context");
+		}
+	}
+
+	g_static_mutex_unlock(&openssl_mutex);
+
+	return openssl_client_ctx;
+}
+
+void
+openssl_resume_session(SSL *ssl, const gchar *key)
+{
+	SSL_SESSION *session;
+
+	g_static_mutex_lock(&openssl_mutex);
+
+	if(openssl_sessions && (session = g_hash_table_lookup(openssl_sessions, key)))
+	{
+		g_debug("Found cached SSL session: %s", key);
+		SSL_set_session(ssl, session);
+	}
+
+	g_static_mutex_unlock(&openssl_mutex);
+}
+
+void
+openssl_register_handshake(SSL *ssl, const gchar *key, gdouble seconds)
+{
+	SSL_SESSION *session;
+	gboolean reused;
+
+	reused = SSL_session_reused(ssl) ? TRUE : FALSE;
+	session = SSL_get1_session(ssl);
+
+	g_static_mutex_lock(&openssl_mutex);
+
+	if(reused)
+	{
+		++openssl_resumed_handshakes;
+	}
+	else
+	{
+		++openssl_full_handshakes;
+	}
+
+	if(session)
+	{
+		if(key && openssl_sessions)
+		{
+			g_hash_table_replace(openssl_sessions, g_strdup(key), session);
+		}
+		else
+		{
+			SSL_SESSION_free(session);
+		}
+	}
+
+	g_debug("SSL handshake (%s): %.3f seconds (full: %u, resumed: %u)", reused ? "resumed" : "full",
+	        seconds, openssl_full_handshakes, openssl_resumed_handshakes);
+
+	g_static_mutex_unlock(&openssl_mutex);
+}
+
+void
+openssl_remove_session(const gchar *key)
+{
+	g_static_mutex_lock(&openssl_mutex);
+
+	if(openssl_sessions)
+	{
+		g_hash_table_remove(openssl_sessions, key);
+	}
+
+	g_static_mutex_unlock(&openssl_mutex);
+}
+
+void
+openssl_get_handshake_statistics(guint *full_handshakes, guint *resumed_handshakes)
+{
+	g_static_mutex_lock(&openssl_mutex);
+	*full_handshakes = openssl_full_handshakes;
+	*resumed_handshakes = openssl_resumed_handshakes;
+	g_static_mutex_unlock(&openssl_mutex);
+}
+
+void
+openssl_cleanup(void)
+{
+	g_static_mutex_lock(&openssl_mutex);
+
+	if(openssl_sessions)
+	{
+		g_hash_table_destroy(openssl_sessions);
+		openssl_sessions = NULL;
+	}
+
+	if(openssl_client_ctx)
+	{
+		g_debug("Freeing SSL client context (full handshakes: %u, resumed handshakes: %u)",
+		        openssl_full_handshakes, openssl_resumed_handshakes);
+		SSL_CTX_free(openssl_client_ctx);
+		openssl_client_ctx = NULL;
+	}
+
+	g_static_mutex_unlock(&openssl_mutex);
+}
+
 gsize
 openssl_write(SSL *ssl, const gchar *buffer, gsize count, GCancellable *cancellable, GError **err)
 {
@@ -44,6 +44,52 @@
  */
 gboolean openssl_init(void);
 
+/**
+ * \param err holds failure messages
+ * \return the shared SSL_CTX or NULL on failure
+ *
+ * Gets the client context shared by all SSL connections. It's created on first use & must
+ * not be freed.
+ */
+SSL_CTX *openssl_get_client_context(GError **err);
+
+/**
+ * \param ssl an OpenSSL handle
+ * \param key identifies the remote host, e.g. "hostname:port"
+ *
+ * Lets a connection resume a cached session of the given host.
+ */
+void openssl_resume_session(SSL *ssl, const gchar *key);
+
+/**
+ * \param ssl an OpenSSL handle
+ * \param key identifies the remote host or NULL
+ * \param seconds duration of the handshake
+ *
+ * Counts a successful handshake & stores its session for resumption.
+ */
+void openssl_register_handshake(SSL *ssl, const gchar *key, gdouble seconds);
+
+/**
+ * \param key identifies the remote host
+ *
+ * Removes the cached session of a host.
+ */
+void openssl_remove_session(const gchar *key);
+
+/**
+ * \param full_handshakes location to store the number of full handshakes
+ * \param resumed_handshakes location to store the number of resumed handshakes
+ *
+ * Gets the number of full & resumed handshakes.
+ */
+void openssl_get_handshake_statistics(guint *full_handshakes, guint *resumed_handshakes);
+
+/**
+ * Frees the client context & all cached sessions.
+ */
+void openssl_cleanup(void);
+
 /**
  * \param ssl an OpenSSL handle
  * \param buffer data to write
@@ -0,0 +1,334 @@
+/***************************************************************************
+    begin........: March 2010
+    copyright....: Sebastian Fedrau
+    email........: lord-kefir@arcor.de
+ ***************************************************************************/
+
+/***************************************************************************
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+    General Public License for more details.
+ ***************************************************************************/
+/*!
+ * \file twitterratelimit.c
+ * \brief Per-account scheduling of Twitter API requests.
+ * \author Sebastian Fedrau <lord-kefir@arcor.de>
+ * \version 0.1.0
+ * \date 17. October 2011
+ */
+
+#include "twitterratelimit.h"
+
+/**
+ * @addtogroup Net
+ * @{
+ * 	@addtogroup Twitter
+ * 	@{
+ */
+
+/**
+ * \struct _TwitterRateLimitBucket
+ * \brief Budget of an account.
+ */
+typedef struct
+{
+	/*! Number of requests allowed per window or 0 if unknown. */
+	gint limit;
+	/*! Number of remaining requests or -1 if unknown. */
+	gint remaining;
+	/*! Time the window is reset (seconds since the epoch) or 0 if unknown. */
+	glong reset;
+	/*! Number of background requests which can be sent immediately. */
+	gdouble tokens;
+	/*! Time the tokens have been refilled. */
+	gdouble updated;
+} _TwitterRateLimitBucket;
+
+/*! Mutex protecting the budgets. */
+static GStaticMutex _twitter_rate_limit_mutex = G_STATIC_MUTEX_INIT;
+/*! Maps account names to _TwitterRateLimitBucket instances. */
+static GHashTable *_twitter_rate_limit_buckets = NULL;
+
+/*
+ *	helpers:
+ */
+static gdouble
+_twitter_rate_limit_now(void)
+{
+	GTimeVal now;
+
+	g_get_current_time(&now);
+
+	return now.tv_sec + now.tv_usec / 1000000.0;
+}
+
+static void
+_twitter_rate_limit_bucket_free(_TwitterRateLimitBucket *bucket)
+{
+	g_slice_free(_TwitterRateLimitBucket, bucket);
+}
+
+static _TwitterRateLimitBucket *
+_twitter_rate_limit_get_bucket(const gchar *account)
+{
+	_TwitterRateLimitBucket *bucket;
+	gchar *key;
+
+	if(!_twitter_rate_limit_buckets)
+	{
+		_twitter_rate_limit_buckets = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, (GDestroyNotify)_twitter_rate_limit_bucket_free);
+	}
+
+	key = g_ascii_strdown(account, -1);
+
+	if(!(bucket = g_hash_table_lookup(_twitter_rate_limit_buckets, key)))
+	{
+		bucket = g_slice_new(_TwitterRateLimitBucket);
+		bucket->limit = 0;
+		bucket->remaining = -1;
+		bucket->reset = 0;
+		bucket->tokens = TWITTER_RATE_LIMIT_BURST;
+		bucket->updated = _twitter_rate_limit_now();
+
+		g_hash_table_insert(_twitter_rate_limit_buckets, key, bucket);
+	}
+	else
+	{
+		g_free(key);
+	}
+
+	return bucket;
+}
+
+static gint
+_twitter_rate_limit_get_reserve(const _TwitterRateLimitBucket *bucket)
+{
+	return MAX(TWITTER_RATE_LIMIT_MIN_RESERVE, bucket->limit * TWITTER_RATE_LIMIT_RESERVE_PERCENT / 100);
+}
+
+static gdouble
+_twitter_rate_limit_get_rate(const _TwitterRateLimitBucket *bucket, gdouble now)
+{
+	gdouble seconds;
+	gint budget;
+
+	/* spread the budget available to background requests over the rest of the window */
+	seconds = bucket->reset ? MAX(1.0, bucket->reset - now) : 3600.0;
+	budget = MAX(0, bucket->remaining - _twitter_rate_limit_get_reserve(bucket));
+
+	return budget / seconds;
+}
+
+static void
+_twitter_rate_limit_refill(_TwitterRateLimitBucket *bucket, gdouble now)
+{
+	if(bucket->reset && now >= bucket->reset)
+	{
+		/* a new window has started */
+		bucket->remaining = bucket->limit ? bucket->limit : -1;
+		bucket->reset = 0;
+	}
+
+	if(bucket->remaining == -1)
+	{
+		bucket->tokens = TWITTER_RATE_LIMIT_BURST;
+	}
+	else
+	{
+		bucket->tokens = MIN(TWITTER_RATE_LIMIT_BURST, bucket->tokens + _twitter_rate_limit_get_rate(bucket, now) * (now - bucket->updated));
+	}
+
+	bucket->updated = now;
+}
+
+/*
+ *	public:
+ */
+gboolean
+twitter_rate_limit_acquire(const gchar *account, TwitterRateLimitPriority priority, GCancellable *cancellable, GError **err)
+{
+	_TwitterRateLimitBucket *bucket;
+	gdouble now;
+	gdouble rate;
+	gdouble wait;
+
+	g_return_val_if_fail(account != NULL, TRUE);
+
+	while(1)
+	{
+		g_static_mutex_lock(&_twitter_rate_limit_mutex);
+
+		bucket = _twitter_rate_limit_get_bucket(account);
+		now = _twitter_rate_limit_now();
+		_twitter_rate_limit_refill(bucket, now);
+
+		wait = 0;
+
+		if(bucket->remaining == -1)
+		{
+			/* budget is unknown until the first response has been received */
+		}
+		else if(priority == TWITTER_RATE_LIMIT_PRIORITY_INTERACTIVE)
+		{
+			if(!bucket->remaining)
+			{
+				wait = bucket->reset - now;
+			}
+		}
+		else if(bucket->remaining <= _twitter_rate_limit_get_reserve(bucket))
+		{
+			wait = bucket->reset ? bucket->reset - now : TWITTER_RATE_LIMIT_PENALTY;
+		}
+		else if(bucket->tokens < 1)
+		{
+			rate = _twitter_rate_limit_get_rate(bucket, now);
+			wait = (1 - bucket->tokens) / rate;
+		}
+
+		if(wait <= 0)
+		{
+			if(bucket->remaining > 0)
+			{
+				--bucket->remaining;
+			}
+
+			if(priority == TWITTER_RATE_LIMIT_PRIORITY_BACKGROUND)
+			{
+				bucket->tokens = MAX(0, bucket->tokens - 1);
+			}
+
+			g_static_mutex_unlock(&_twitter_rate_limit_mutex);
+
+			return TRUE;
+		}
+
+		g_static_mutex_unlock(&_twitter_rate_limit_mutex);
+
+		if(wait > TWITTER_RATE_LIMIT_MAX_WAIT)
+		{
+			g_warning("Rate limit of account \"%s\" exceeded, next request possible in %d seconds", account, (gint)wait);
+			g_set_error(err, 0, 0, "Rate limit exceeded, please try again in %d minute(s).", (gint)wait / 60 + 1);
+
+			return FALSE;
+		}
+
+		g_debug("Delaying request of account \"%s\" (%.1f seconds)", account, wait);
+
+		/* sleep in short steps to abort the request when it gets cancelled */
+		for(wait *= 1000; wait > 0; wait -= TWITTER_RATE_LIMIT_POLL_INTERVAL)
+		{
+			if(g_cancellable_set_error_if_cancelled(cancellable, err))
+			{
+				g_debug("Delayed request of account \"%s\" has been cancelled", account);
+
+				return FALSE;
+			}
+
+			g_usleep((gulong)(MIN(wait, TWITTER_RATE_LIMIT_POLL_INTERVAL) * 1000));
+		}
+	}
+}
+
+void
+twitter_rate_limit_update(const gchar *account, gint limit, gint remaining, glong reset)
+{
+	_TwitterRateLimitBucket *bucket;
+
+	g_return_if_fail(account != NULL);
+
+	g_static_mutex_lock(&_twitter_rate_limit_mutex);
+
+	bucket = _twitter_rate_limit_get_bucket(account);
+	_twitter_rate_limit_refill(bucket, _twitter_rate_limit_now());
+
+	if(limit > 0)
+	{
+		bucket->limit = limit;
+	}
+
+	bucket->remaining = MAX(0, remaining);
+	bucket->reset = reset;
+
+	g_debug("Rate limit of account \"%s\": %d/%d requests remaining", account, bucket->remaining, bucket->limit);
+
+	g_static_mutex_unlock(&_twitter_rate_limit_mutex);
+}
+
+void
+twitter_rate_limit_exhaust(const gchar *account)
+{
+	_TwitterRateLimitBucket *bucket;
+	gdouble now;
+
+	g_return_if_fail(account != NULL);
+
+	g_static_mutex_lock(&_twitter_rate_limit_mutex);
+
+	bucket = _twitter_rate_limit_get_bucket(account);
+	now = _twitter_rate_limit_now();
+
+	bucket->remaining = 0;
+	bucket->tokens = 0;
+
+	if(!bucket->reset || bucket->reset < now)
+	{
+		bucket->reset = (glong)now + TWITTER_RATE_LIMIT_PENALTY;
+	}
+
+	g_static_mutex_unlock(&_twitter_rate_limit_mutex);
+}
+
+gint
+twitter_rate_limit_get_remaining(const gchar *account, gint *limit, glong *reset)
+{
+	_TwitterRateLimitBucket *bucket;
+	gint remaining;
+
+	g_return_val_if_fail(account != NULL, -1);
+
+	g_static_mutex_lock(&_twitter_rate_limit_mutex);
+
+	bucket = _twitter_rate_limit_get_bucket(account);
+	_twitter_rate_limit_refill(bucket, _twitter_rate_limit_now());
+
+	remaining = bucket->remaining;
+
+	if(limit)
+	{
+		*limit = bucket->limit;
+	}
+
+	if(reset)
+	{
+		*reset = bucket->reset;
+	}
+
+	g_static_mutex_unlock(&_twitter_rate_limit_mutex);
+
+	return remaining;
+}
+
+void
+twitter_rate_limit_cleanup(void)
+{
+	g_static_mutex_lock(&_twitter_rate_limit_mutex);
+
+	if(_twitter_rate_limit_buckets)
+	{
+		g_hash_table_destroy(_twitter_rate_limit_buckets);
+		_twitter_rate_limit_buckets = NULL;
+	}
+
+	g_static_mutex_unlock(&_twitter_rate_limit_mutex);
+}
+
+/**
+ * @}
+ * @}
+ */
+
@@ -0,0 +1,117 @@
+/***************************************************************************
+    begin........: March 2010
+    copyright....: Sebastian Fedrau
+    email........: lord-kefir@arcor.de
+ ***************************************************************************/
+
+/***************************************************************************
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+    General Public License for more details.
+ ***************************************************************************/
+/*!
+ * \file twitterratelimit.h
+ * \brief Per-account scheduling of Twitter API requests.
+ * \author Sebastian Fedrau <lord-kefir@arcor.de>
+ * \version 0.1.0
+ * \date 17. October 2011
+ */
+
+#ifndef __TWITTER_RATE_LIMIT_H__
+#define __TWITTER_RATE_LIMIT_H__
+
+#include <glib.h>
+#include <gio/gio.h>
+
+/**
+ * @addtogroup Net
+ * @{
+ * 	@addtogroup Twitter
+ * 	@{
+ */
+
+/*! Status code sent by Twitter if an application has been rate limited. */
+#define TWITTER_RATE_LIMIT_ENHANCE_YOUR_CALM  420
+/*! Number of background requests which can be sent without delay. */
+#define TWITTER_RATE_LIMIT_BURST              15
+/*! Percentage of the hourly limit reserved for interactive requests. */
+#define TWITTER_RATE_LIMIT_RESERVE_PERCENT    10
+/*! Minimum number of requests reserved for interactive requests. */
+#define TWITTER_RATE_LIMIT_MIN_RESERVE        5
+/*! Maximum time (in seconds) a request is delayed before it fails. */
+#define TWITTER_RATE_LIMIT_MAX_WAIT           30
+/*! Time (in seconds) an account is blocked if it has been rate limited without reset time. */
+#define TWITTER_RATE_LIMIT_PENALTY            60
+/*! Interval (in milliseconds) the cancellable is checked while a request is delayed. */
+#define TWITTER_RATE_LIMIT_POLL_INTERVAL      100
+
+/**
+ * \enum TwitterRateLimitPriority
+ * \brief Priority of a request.
+ */
+typedef enum
+{
+	/*! A request triggered by the user, e.g. opening a timeline. */
+	TWITTER_RATE_LIMIT_PRIORITY_INTERACTIVE,
+	/*! A request sent by the synchronization. */
+	TWITTER_RATE_LIMIT_PRIORITY_BACKGROUND
+} TwitterRateLimitPriority;
+
+/**
+ * \param account name of the account
+ * \param priority priority of the request
+ * \param cancellable a GCancellable or NULL
+ * \param err holds failure messages
+ * \return TRUE if the request can be sent
+ *
+ * Takes a request from the budget of an account. Background requests are spread over the
+ * current rate limit window & can't use the share reserved for interactive requests. If
+ * the budget is exhausted the function blocks up to TWITTER_RATE_LIMIT_MAX_WAIT seconds
+ * before it fails. If the cancellable is cancelled while waiting G_IO_ERROR_CANCELLED
+ * is set.
+ */
+gboolean twitter_rate_limit_acquire(const gchar *account, TwitterRateLimitPriority priority, GCancellable *cancellable, GError **err);
+
+/**
+ * \param account name of the account
+ * \param limit number of requests allowed per window (X-RateLimit-Limit)
+ * \param remaining number of remaining requests (X-RateLimit-Remaining)
+ * \param reset time the window is reset in seconds since the epoch (X-RateLimit-Reset)
+ *
+ * Updates the budget of an account with the values sent by the server.
+ */
+void twitter_rate_limit_update(const gchar *account, gint limit, gint remaining, glong reset);
+
+/**
+ * \param account name of the account
+ *
+ * Blocks an account after the server refused a request because of the rate limit.
+ */
+void twitter_rate_limit_exhaust(const gchar *account);
+
+/**
+ * \param account name of the account
+ * \param limit location to store the number of requests allowed per window or NULL
+ * \param reset location to store the time the window is reset or NULL
+ * \return number of remaining requests or -1 if the budget is unknown
+ *
+ * Gets the remaining budget of an account.
+ */
+gint twitter_rate_limit_get_remaining(const gchar *account, gint *limit, glong *reset);
+
+/**
+ * Frees all stored budgets.
+ */
+void twitter_rate_limit_cleanup(void);
+
+/**
+ * @}
+ * @}
+ */
+#endif
+
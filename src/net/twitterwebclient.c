@@ -28,6 +28,7 @@
 
 #include "twitterwebclient.h"
 #include "httpclient.h"
+#include "twitterratelimit.h"
 #include "../oauth/oauth.h"
 
 /**
@@ -49,7 +50,13 @@ enum
 	PROP_OAUTH_ACCESS_KEY,
 	PROP_OAUTH_ACCESS_SECRET,
 	PROP_FORMAT,
-	PROP_STATUS_COUNT
+	PROP_STATUS_COUNT,
+	PROP_SINCE_ID,
+	PROP_MAX_ID,
+	PROP_BACKGROUND,
+	PROP_STREAM_HOSTNAME,
+	PROP_STREAM_PORT,
+	PROP_CANCELLABLE
 };
 
 /**
@@ -72,6 +79,22 @@ struct _TwitterWebClientPrivate
 	gchar *format;
 	/*! Number of statuses to receive. */
 	gint status_count;
+	/*! Only receive statuses newer than this id. */
+	gchar *since_id;
+	/*! Only receive statuses older than or equal to this id. */
+	gchar *max_id;
+	/*! TRUE if requests are sent in background, e.g. by the synchronization. */
+	gboolean background;
+	/*! Host serving the user stream. */
+	gchar *stream_hostname;
+	/*! Port of the user stream host. */
+	gint stream_port;
+	/*! Aborts running requests. */
+	GCancellable *cancellable;
+	/*! Receives the content of responses in streaming mode. */
+	TwitterWebClientContentFunc content_func;
+	/*! User data passed to content_func. */
+	gpointer content_data;
 	/*! Holds error messages. */
 	GError *err;
 };
@@ -127,6 +150,65 @@ _twitter_web_client_extract_key_and_value(const gchar *text, gchar **key, gchar
 	*value = g_strdup(text + pos + 1);
 }
 
+static gchar *
+_twitter_web_client_build_timeline_path(TwitterWebClient *twitterwebclient, const gchar *prefix)
+{
+	GString *url;
+
+	url = g_string_new(prefix);
+	g_string_append_printf(url, "count=%d", twitterwebclient->priv->status_count);
+
+	if(twitterwebclient->priv->since_id)
+	{
+		g_string_append(url, "&since_id=");
+		g_string_append_uri_escaped(url, twitterwebclient->priv->since_id, NULL, TRUE);
+	}
+
+	if(twitterwebclient->priv->max_id)
+	{
+		g_string_append(url, "&max_id=");
+		g_string_append_uri_escaped(url, twitterwebclient->priv->max_id, NULL, TRUE);
+	}
+
+	return g_string_free(url, FALSE);
+}
+
+static gboolean
+_twitter_web_client_forward_content(HttpClient *client, const gchar *data, gsize length, gpointer user_data)
+{
+	TwitterWebClient *twitterwebclient = (TwitterWebClient *)user_data;
+
+	/* error messages aren't passed to the content function */
+	if(http_client_get_status(client) != HTTP_OK)
+	{
+		return TRUE;
+	}
+
+	return twitterwebclient->priv->content_func(data, length, twitterwebclient->priv->content_data);
+}
+
+static void
+_twitter_web_client_update_rate_limit(TwitterWebClient *twitterwebclient, HttpClient *client, gint status)
+{
+	/* no response has been received */
+	if(!twitterwebclient->priv->username || status == HTTP_NONE)
+	{
+		return;
+	}
+
+	if(http_client_has_header(client, "X-RateLimit-Remaining"))
+	{
+		twitter_rate_limit_update(twitterwebclient->priv->username,
+		                          http_client_lookup_header_int(client, "X-RateLimit-Limit"),
+		                          http_client_lookup_header_int(client, "X-RateLimit-Remaining"),
+		                          http_client_lookup_header_int(client, "X-RateLimit-Reset"));
+	}
+	else if(status == TWITTER_RATE_LIMIT_ENHANCE_YOUR_CALM)
+	{
+		twitter_rate_limit_exhaust(twitterwebclient->priv->username);
+	}
+}
+
 static gboolean
 _twitter_web_client_send_request(TwitterWebClient *twitterwebclient, const gchar *path, gchar * restrict keys[], gchar * restrict values[], gint argc, gboolean post, gchar **buffer, gint *length)
 {
@@ -139,13 +221,22 @@ _twitter_web_client_send_request(TwitterWebClient *twitterwebclient, const gchar
 	gchar **post_keys = NULL;
 	gchar **post_values = NULL;
 	HttpClient *client;
+	gboolean stream = FALSE;
 	gint status;
 
-	//_twitter_web_client_test_rate_limit(twitterwebclient);
-
 	/* clear last error */
 	_twitter_web_client_clear_last_error(twitterwebclient);
 
+	/* wait for the rate limit scheduler (POST requests don't count against the limit) */
+	if(!post && twitterwebclient->priv->username &&
+	   !twitter_rate_limit_acquire(twitterwebclient->priv->username,
+	                               twitterwebclient->priv->background ? TWITTER_RATE_LIMIT_PRIORITY_BACKGROUND : TWITTER_RATE_LIMIT_PRIORITY_INTERACTIVE,
+	                               twitterwebclient->priv->cancellable,
+	                               &twitterwebclient->priv->err))
+	{
+		return FALSE;
+	}
+
 	/* build API url */
 	api_url = g_strdup_printf("http://api.twitter.com%s", path);
 
@@ -185,27 +276,40 @@ _twitter_web_client_send_request(TwitterWebClient *twitterwebclient, const gchar
 	                              twitterwebclient->priv->access_secret);
 	}
 
-	client = http_client_new("hostname", TWITTER_API_HOSTNAME, "port", HTTP_DEFAULT_PORT, NULL);
-	
+	client = http_client_new("hostname", TWITTER_API_HOSTNAME, "port", HTTP_DEFAULT_PORT, "cancellable", twitterwebclient->priv->cancellable, NULL);
+
 	if(post)
 	{
 		g_object_set(client, "auto-escape", FALSE, NULL);
 		status = http_client_post(client, url + 22, (const gchar **)post_keys, (const gchar **)post_values, array_length, &twitterwebclient->priv->err);
 	}
+	else if(twitterwebclient->priv->content_func)
+	{
+		/* pass content to the content function */
+		*buffer = NULL;
+		*length = 0;
+		stream = TRUE;
+		status = http_client_get_stream(client, url + 22, _twitter_web_client_forward_content, twitterwebclient, &twitterwebclient->priv->err);
+	}
 	else
 	{
 		status = http_client_get(client, url + 22, &twitterwebclient->priv->err);
 	}
 
+	_twitter_web_client_update_rate_limit(twitterwebclient, client, status);
+
 	if(status == HTTP_OK)
 	{
 		/* read response */
-		http_client_read_content(client, buffer, length);
-
-		if(*length == -1 && *buffer)
+		if(!stream)
 		{
-			g_free(*buffer);
-			*buffer = NULL;
+			http_client_read_content(client, buffer, length);
+
+			if(*length == -1 && *buffer)
+			{
+				g_free(*buffer);
+				*buffer = NULL;
+			}
 		}
 	}
 	else
@@ -276,14 +380,25 @@ _twitter_web_client_set_format(TwitterWebClient *twitterwebclient, const gchar *
 	g_object_set(G_OBJECT(twitterwebclient), "format", format, NULL);
 }
 
+static void
+_twitter_web_client_set_content_func(TwitterWebClient *twitterwebclient, TwitterWebClientContentFunc func, gpointer user_data)
+{
+	twitterwebclient->priv->content_func = func;
+	twitterwebclient->priv->content_data = user_data;
+}
+
 static gboolean
 _twitter_web_client_get_home_timeline(TwitterWebClient *twitterwebclient, gchar **buffer, gint *length)
 {
-	gchar path[48];
+	gchar *prefix;
+	gchar *path;
 	gboolean result;
 
-	sprintf(path, "/1/statuses/home_timeline.%s?count=%d", twitterwebclient->priv->format, twitterwebclient->priv->status_count);
+	prefix = g_strdup_printf("/1/statuses/home_timeline.%s?", twitterwebclient->priv->format);
+	path = _twitter_web_client_build_timeline_path(twitterwebclient, prefix);
 	result = _twitter_web_client_send_request(twitterwebclient, path, NULL, NULL, 0, FALSE, buffer, length);
+	g_free(path);
+	g_free(prefix);
 
 	return result;
 }
@@ -291,11 +406,15 @@ _twitter_web_client_get_home_timeline(TwitterWebClient *twitterwebclient, gchar
 static gboolean
 _twitter_web_client_get_mentions(TwitterWebClient *twitterwebclient, gchar **buffer, gint *length)
 {
-	gchar path[48];
+	gchar *prefix;
+	gchar *path;
 	gboolean result;
 
-	sprintf(path, "/1/statuses/mentions.%s?count=%d", twitterwebclient->priv->format, twitterwebclient->priv->status_count);
+	prefix = g_strdup_printf("/1/statuses/mentions.%s?", twitterwebclient->priv->format);
+	path = _twitter_web_client_build_timeline_path(twitterwebclient, prefix);
 	result = _twitter_web_client_send_request(twitterwebclient, path, NULL, NULL, 0, FALSE, buffer, length);
+	g_free(path);
+	g_free(prefix);
 
 	return result;
 }
@@ -315,6 +434,7 @@ _twitter_web_client_get_direct_messages(TwitterWebClient *twitterwebclient, gcha
 static gboolean
 _twitter_web_client_get_user_timeline(TwitterWebClient *twitterwebclient, const gchar *username, gchar **buffer, gint *length)
 {
+	gchar *prefix;
 	gchar *path;
 	gboolean result;
 
@@ -323,9 +443,11 @@ _twitter_web_client_get_user_timeline(TwitterWebClient *twitterwebclient, const
 		username = twitterwebclient->priv->username;
 	}
 
-	path = g_markup_printf_escaped("/1/statuses/user_timeline.%s?screen_name=%s&count=%d", twitterwebclient->priv->format, username, twitterwebclient->priv->status_count);
+	prefix = g_markup_printf_escaped("/1/statuses/user_timeline.%s?screen_name=%s&", twitterwebclient->priv->format, username);
+	path = _twitter_web_client_build_timeline_path(twitterwebclient, prefix);
 	result = _twitter_web_client_send_request(twitterwebclient, path, NULL, NULL, 0, FALSE, buffer, length);
 	g_free(path);
+	g_free(prefix);
 
 	return result;
 }
@@ -346,6 +468,7 @@ _twitter_web_client_get_status(TwitterWebClient *twitterwebclient, const gchar *
 static gboolean
 _twitter_web_client_get_timeline_from_list(TwitterWebClient *twitterwebclient, const gchar * restrict username, const gchar * restrict listname, gchar **buffer, gint *length)
 {
+	gchar *prefix;
 	gchar *path;
 	const gchar *user = username;
 	gboolean result;
@@ -355,9 +478,11 @@ _twitter_web_client_get_timeline_from_list(TwitterWebClient *twitterwebclient, c
 		user = twitterwebclient->priv->username;
 	}
 
-	path = g_markup_printf_escaped("/1/%s/lists/%s/statuses.%s?count=%d", user, listname, twitterwebclient->priv->format, twitterwebclient->priv->status_count);
+	prefix = g_markup_printf_escaped("/1/%s/lists/%s/statuses.%s?", user, listname, twitterwebclient->priv->format);
+	path = _twitter_web_client_build_timeline_path(twitterwebclient, prefix);
 	result = _twitter_web_client_send_request(twitterwebclient, path, NULL, NULL, 0, FALSE, buffer, length);
 	g_free(path);
+	g_free(prefix);
 
 	return result;
 }
@@ -638,6 +763,33 @@ _twitter_web_client_get_user_details_by_id(TwitterWebClient *twitterwebclient, c
 	return result;
 }
 
+static gboolean
+_twitter_web_client_lookup_users(TwitterWebClient *twitterwebclient, const gchar **ids, gint count, gchar **buffer, gint *length)
+{
+	GString *path;
+	gboolean result;
+
+	g_return_val_if_fail(count > 0 && count <= TWITTER_MAX_LOOKUP_USERS, FALSE);
+
+	path = g_string_sized_new(32 + count * 21);
+	g_string_printf(path, "/1/users/lookup.%s?user_id=", twitterwebclient->priv->format);
+
+	for(gint i = 0; i < count; ++i)
+	{
+		if(i)
+		{
+			g_string_append_c(path, ',');
+		}
+
+		g_string_append_uri_escaped(path, ids[i], NULL, TRUE);
+	}
+
+	result = _twitter_web_client_send_request(twitterwebclient, path->str, NULL, NULL, 0, FALSE, buffer, length);
+	g_string_free(path, TRUE);
+
+	return result;
+}
+
 static gboolean
 _twitter_web_client_post_tweet(TwitterWebClient *twitterwebclient, const gchar *text, const gchar *prev_status, gchar **buffer, gint *length)
 {
@@ -700,6 +852,74 @@ _twitter_web_client_retweet(TwitterWebClient *twitterwebclient, const gchar *id,
 	return result;
 }
 
+static gboolean
+_twitter_web_client_get_user_stream(TwitterWebClient *twitterwebclient, GCancellable *cancellable)
+{
+	gchar *prefix;
+	gchar *api_url;
+	gchar *url;
+	HttpClient *client;
+	gint status;
+
+	g_return_val_if_fail(twitterwebclient->priv->content_func != NULL, FALSE);
+
+	/* clear last error */
+	_twitter_web_client_clear_last_error(twitterwebclient);
+
+	/* build & sign stream url */
+	if(twitterwebclient->priv->stream_port == HTTP_DEFAULT_PORT)
+	{
+		prefix = g_strdup_printf("http://%s", twitterwebclient->priv->stream_hostname);
+	}
+	else
+	{
+		prefix = g_strdup_printf("http://%s:%d", twitterwebclient->priv->stream_hostname, twitterwebclient->priv->stream_port);
+	}
+
+	api_url = g_strconcat(prefix, TWITTER_USER_STREAM_PATH, NULL);
+	url = oauth_sign_url2(api_url,
+	                      NULL,
+	                      OA_HMAC,
+	                      NULL,
+	                      twitterwebclient->priv->consumer_key,
+	                      twitterwebclient->priv->consumer_secret,
+	                      twitterwebclient->priv->access_key,
+	                      twitterwebclient->priv->access_secret);
+
+	/* Twitter sends a newline at least every 30 seconds, a longer pause means the connection has stalled */
+	client = http_client_new("hostname", twitterwebclient->priv->stream_hostname, "port", twitterwebclient->priv->stream_port,
+	                         "timeout", TWITTER_USER_STREAM_STALL_TIMEOUT, "cancellable", cancellable, NULL);
+
+	g_debug("Opening user stream: %s:%d", twitterwebclient->priv->stream_hostname, twitterwebclient->priv->stream_port);
+	status = http_client_get_stream(client, url + strlen(prefix), _twitter_web_client_forward_content, twitterwebclient, &twitterwebclient->priv->err);
+
+	if(status == HTTP_UNAUTHORIZED || status == HTTP_FORBIDDEN)
+	{
+		_twitter_web_client_set_last_error(twitterwebclient, status, "Couldn't connect to %s: user is not authorized.", twitterwebclient->priv->stream_hostname);
+	}
+	else if(status != HTTP_OK && status != HTTP_NONE)
+	{
+		_twitter_web_client_set_last_error(twitterwebclient, status, "Couldn't connect to %s, please try again later.", twitterwebclient->priv->stream_hostname);
+	}
+	else if(status == HTTP_NONE && !twitterwebclient->priv->err)
+	{
+		_twitter_web_client_set_last_error(twitterwebclient, 0, "Couldn't connect to %s.", twitterwebclient->priv->stream_hostname);
+	}
+	else if(twitterwebclient->priv->err)
+	{
+		/* network errors are reported with code 0 */
+		twitterwebclient->priv->err->code = 0;
+	}
+
+	/* free memory */
+	g_object_unref(client);
+	g_free(prefix);
+	g_free(api_url);
+	free(url);
+
+	return (status == HTTP_OK && !twitterwebclient->priv->err) ? TRUE : FALSE;
+}
+
 static void
 _twitter_web_client_get_property(GObject *object, guint prop_id, GValue *value, GParamSpec *pspec)
 {
@@ -734,6 +954,30 @@ _twitter_web_client_get_property(GObject *object, guint prop_id, GValue *value,
 		case PROP_STATUS_COUNT:
 			g_value_set_int(value, twitterwebclient->priv->status_count);
 			break;
+
+		case PROP_SINCE_ID:
+			g_value_set_string(value, twitterwebclient->priv->since_id);
+			break;
+
+		case PROP_MAX_ID:
+			g_value_set_string(value, twitterwebclient->priv->max_id);
+			break;
+
+		case PROP_BACKGROUND:
+			g_value_set_boolean(value, twitterwebclient->priv->background);
+			break;
+
+		case PROP_STREAM_HOSTNAME:
+			g_value_set_string(value, twitterwebclient->priv->stream_hostname);
+			break;
+
+		case PROP_STREAM_PORT:
+			g_value_set_int(value, twitterwebclient->priv->stream_port);
+			break;
+
+		case PROP_CANCELLABLE:
+			g_value_set_object(value, twitterwebclient->priv->cancellable);
+			break;
 	
 		default:
 			G_OBJECT_WARN_INVALID_PROPERTY_ID(object, prop_id, pspec);
@@ -799,6 +1043,46 @@ _twitter_web_client_set_property(GObject *object, guint prop_id, const GValue *v
 			twitterwebclient->priv->status_count = g_value_get_int(value);
 			break;
 
+		case PROP_SINCE_ID:
+			if(twitterwebclient->priv->since_id)
+			{
+				g_free(twitterwebclient->priv->since_id);
+			}
+			twitterwebclient->priv->since_id = g_value_dup_string(value);
+			break;
+
+		case PROP_MAX_ID:
+			if(twitterwebclient->priv->max_id)
+			{
+				g_free(twitterwebclient->priv->max_id);
+			}
+			twitterwebclient->priv->max_id = g_value_dup_string(value);
+			break;
+
+		case PROP_BACKGROUND:
+			twitterwebclient->priv->background = g_value_get_boolean(value);
+			break;
+
+		case PROP_STREAM_HOSTNAME:
+			if(twitterwebclient->priv->stream_hostname)
+			{
+				g_free(twitterwebclient->priv->stream_hostname);
+			}
+			twitterwebclient->priv->stream_hostname = g_value_dup_string(value);
+			break;
+
+		case PROP_STREAM_PORT:
+			twitterwebclient->priv->stream_port = g_value_get_int(value);
+			break;
+
+		case PROP_CANCELLABLE:
+			if(twitterwebclient->priv->cancellable)
+			{
+				g_object_unref(twitterwebclient->priv->cancellable);
+			}
+			twitterwebclient->priv->cancellable = g_value_dup_object(value);
+			break;
+
 		default:
 			G_OBJECT_WARN_INVALID_PROPERTY_ID(object, prop_id, pspec);
 	}
@@ -837,6 +1121,12 @@ twitter_web_client_set_format(TwitterWebClient *twitterwebclient, const gchar *f
 	TWITTER_WEB_CLIENT_GET_CLASS(twitterwebclient)->set_format(twitterwebclient, format);
 }
 
+void
+twitter_web_client_set_content_func(TwitterWebClient *twitterwebclient, TwitterWebClientContentFunc func, gpointer user_data)
+{
+	TWITTER_WEB_CLIENT_GET_CLASS(twitterwebclient)->set_content_func(twitterwebclient, func, user_data);
+}
+
 gboolean
 twitter_web_client_get_home_timeline(TwitterWebClient *twitterwebclient, gchar **buffer, gint *length)
 {
@@ -964,6 +1254,12 @@ twitter_web_client_get_user_details_by_id(TwitterWebClient *twitterwebclient, co
 	return TWITTER_WEB_CLIENT_GET_CLASS(twitterwebclient)->get_user_details_by_id(twitterwebclient, id, buffer, length);
 }
 
+gboolean
+twitter_web_client_lookup_users(TwitterWebClient *twitterwebclient, const gchar **ids, gint count, gchar **buffer, gint *length)
+{
+	return TWITTER_WEB_CLIENT_GET_CLASS(twitterwebclient)->lookup_users(twitterwebclient, ids, count, buffer, length);
+}
+
 gboolean
 twitter_web_client_post_tweet(TwitterWebClient *twitterwebclient, const gchar *text, const gchar *prev_status, gchar **buffer, gint *length)
 {
@@ -982,6 +1278,12 @@ twitter_web_client_retweet(TwitterWebClient *twitterwebclient, const gchar *id,
 	return TWITTER_WEB_CLIENT_GET_CLASS(twitterwebclient)->retweet(twitterwebclient, id, buffer, length);
 }
 
+gboolean
+twitter_web_client_get_user_stream(TwitterWebClient *twitterwebclient, GCancellable *cancellable)
+{
+	return TWITTER_WEB_CLIENT_GET_CLASS(twitterwebclient)->get_user_stream(twitterwebclient, cancellable);
+}
+
 TwitterWebClient *
 twitter_web_client_new(void)
 {
@@ -1030,6 +1332,26 @@ _twitter_web_client_finalize(GObject *object)
 		g_free(twitterwebclient->priv->format);
 	}
 
+	if(twitterwebclient->priv->since_id)
+	{
+		g_free(twitterwebclient->priv->since_id);
+	}
+
+	if(twitterwebclient->priv->max_id)
+	{
+		g_free(twitterwebclient->priv->max_id);
+	}
+
+	if(twitterwebclient->priv->stream_hostname)
+	{
+		g_free(twitterwebclient->priv->stream_hostname);
+	}
+
+	if(twitterwebclient->priv->cancellable)
+	{
+		g_object_unref(twitterwebclient->priv->cancellable);
+	}
+
 	if(twitterwebclient->priv->err)
 	{
 		g_error_free(twitterwebclient->priv->err);
@@ -1057,6 +1379,7 @@ twitter_web_client_class_init(TwitterWebClientClass *klass)
 	klass->get_username = _twitter_web_client_get_username;
 	klass->set_oauth_authorization = _twitter_web_client_set_oauth_authorization;
 	klass->set_format = _twitter_web_client_set_format;
+	klass->set_content_func = _twitter_web_client_set_content_func;
 	klass->get_home_timeline = _twitter_web_client_get_home_timeline;
 	klass->get_mentions = _twitter_web_client_get_mentions;
 	klass->get_direct_messages = _twitter_web_client_get_direct_messages;
@@ -1078,9 +1401,11 @@ twitter_web_client_class_init(TwitterWebClientClass *klass)
 	klass->block_user = _twitter_web_client_block_user;
 	klass->get_user_details = _twitter_web_client_get_user_details;
 	klass->get_user_details_by_id = _twitter_web_client_get_user_details_by_id;
+	klass->lookup_users = _twitter_web_client_lookup_users;
 	klass->post_tweet = _twitter_web_client_post_tweet;
 	klass->remove_tweet = _twitter_web_client_remove_tweet;
 	klass->retweet = _twitter_web_client_retweet;
+	klass->get_user_stream = _twitter_web_client_get_user_stream;
 
 	g_object_class_install_property(gobject_class, PROP_USERNAME,
 	                                g_param_spec_string("username", NULL, NULL, NULL, G_PARAM_READWRITE));
@@ -1096,6 +1421,18 @@ twitter_web_client_class_init(TwitterWebClientClass *klass)
 	                                g_param_spec_string("format", NULL, NULL, NULL, G_PARAM_READWRITE));
 	g_object_class_install_property(gobject_class, PROP_STATUS_COUNT,
 	                                g_param_spec_int("status-count", NULL, NULL, 20, 200, 20, G_PARAM_READWRITE));
+	g_object_class_install_property(gobject_class, PROP_SINCE_ID,
+	                                g_param_spec_string("since-id", NULL, NULL, NULL, G_PARAM_READWRITE));
+	g_object_class_install_property(gobject_class, PROP_MAX_ID,
+	                                g_param_spec_string("max-id", NULL, NULL, NULL, G_PARAM_READWRITE));
+	g_object_class_install_property(gobject_class, PROP_BACKGROUND,
+	                                g_param_spec_boolean("background", NULL, NULL, FALSE, G_PARAM_READWRITE));
+	g_object_class_install_property(gobject_class, PROP_STREAM_HOSTNAME,
+	                                g_param_spec_string("stream-hostname", NULL, NULL, TWITTER_USER_STREAM_HOSTNAME, G_PARAM_READWRITE));
+	g_object_class_install_property(gobject_class, PROP_STREAM_PORT,
+	                                g_param_spec_int("stream-port", NULL, NULL, 1, 65535, HTTP_DEFAULT_PORT, G_PARAM_READWRITE));
+	g_object_class_install_property(gobject_class, PROP_CANCELLABLE,
+	                                g_param_spec_object("cancellable", NULL, NULL, G_TYPE_CANCELLABLE, G_PARAM_READWRITE));
 }
 
 static void
@@ -1104,6 +1441,8 @@ twitter_web_client_init(TwitterWebClient *twitterwebclient)
 	/* register private data */
 	twitterwebclient->priv = G_TYPE_INSTANCE_GET_PRIVATE(twitterwebclient, TWITTER_WEB_CLIENT_TYPE, TwitterWebClientPrivate);
 	twitterwebclient->priv->status_count = 20;
+	twitterwebclient->priv->stream_hostname = g_strdup(TWITTER_USER_STREAM_HOSTNAME);
+	twitterwebclient->priv->stream_port = HTTP_DEFAULT_PORT;
 }
 
 /**
@@ -51,6 +51,14 @@
 #define TWITTER_API_HOSTNAME               "api.twitter.com"
 /*! Hostname of the Twitter search server. */
 #define TWITTER_SEARCH_API_HOSTNAME        "search.twitter.com"
+/*! Maximum number of users which can be looked up with a single request. */
+#define TWITTER_MAX_LOOKUP_USERS           100
+/*! Hostname of the Twitter user stream server. */
+#define TWITTER_USER_STREAM_HOSTNAME       "userstream.twitter.com"
+/*! Path of the user stream. */
+#define TWITTER_USER_STREAM_PATH           "/2/user.json"
+/*! Seconds without data (including keep-alive newlines) until a user stream is treated as stalled. */
+#define TWITTER_USER_STREAM_STALL_TIMEOUT  90
 
 /*!A type definition for _TwitterWebClientPrivate. */
 typedef struct _TwitterWebClientPrivate TwitterWebClientPrivate;
@@ -61,6 +69,16 @@ typedef struct _TwitterWebClientClass TwitterWebClientClass;
 /*!A type definition for _TwitterWebClient. */
 typedef struct _TwitterWebClient TwitterWebClient;
 
+/**
+ * \param data received data
+ * \param length length of the received data
+ * \param user_data user data
+ * \return FALSE to abort the request
+ *
+ * Receives the content of a successful response while it's read from the network.
+ */
+typedef gboolean (* TwitterWebClientContentFunc)(const gchar *data, gsize length, gpointer user_data);
+
 /**
  * \struct _TwitterWebClientClass
  * \brief The _TwitterWebClient class structure.
@@ -70,7 +88,13 @@ typedef struct _TwitterWebClient TwitterWebClient;
  * - \b username: Name of the user account. (string, rw)\n
  * - \b password: Password of the user account. (string, rw)\n
  * - \b format: The desired data format. (string, rw)\n
- * - \b status-count: Number of statuses to receive. (integer, rw)
+ * - \b status-count: Number of statuses to receive. (integer, rw)\n
+ * - \b since-id: Timelines only contain statuses newer than this id, NULL to disable. (string, rw)\n
+ * - \b max-id: Timelines only contain statuses older than or equal to this id, NULL to disable. (string, rw)\n
+ * - \b background: Requests are scheduled with background priority by the rate limit scheduler. (boolean, rw)\n
+ * - \b stream-hostname: Host serving the user stream. (string, rw)\n
+ * - \b stream-port: Port of the user stream host. (integer, rw)\n
+ * - \b cancellable: Aborts running requests, including requests delayed by the rate limit scheduler. (GCancellable, rw)
  */
 struct _TwitterWebClientClass
 {
@@ -120,6 +144,17 @@ struct _TwitterWebClientClass
 	 */
 	void (* set_format)(TwitterWebClient *twitterwebclient, const gchar *format);
 
+	/**
+	 * \param twitterwebclient TwitterWebClient instance
+	 * \param func function receiving the content of subsequent GET requests or NULL
+	 * \param user_data user data passed to func
+	 *
+	 * Enables streaming mode: the content of a response is passed to func while it's read from
+	 * the network instead of being copied to the buffer of the request, which is set to NULL.
+	 * Pass NULL to disable streaming mode.
+	 */
+	void (* set_content_func)(TwitterWebClient *twitterwebclient, TwitterWebClientContentFunc func, gpointer user_data);
+
 	/**
 	 * \param twitterwebclient TwitterWebClient instance
 	 * \param buffer a buffer
@@ -359,6 +394,18 @@ struct _TwitterWebClientClass
 	 */
 	gboolean (* get_user_details_by_id)(TwitterWebClient *twitterwebclient, const gchar *id, gchar **buffer, gint *length);
 
+	/**
+	 * \param twitterwebclient TwitterWebClient instance
+	 * \param ids guids of users
+	 * \param count number of guids (at most TWITTER_MAX_LOOKUP_USERS)
+	 * \param buffer a buffer
+	 * \param length length of the buffer
+	 * \return TRUE on success
+	 *
+	 * Gets details of multiple users with a single request.
+	 */
+	gboolean (* lookup_users)(TwitterWebClient *twitterwebclient, const gchar **ids, gint count, gchar **buffer, gint *length);
+
 	/**
 	 * \param twitterwebclient TwitterWebClient instance
 	 * \param text text of the status to post
@@ -392,6 +439,19 @@ struct _TwitterWebClientClass
 	 * Retweets a status.
 	 */
 	gboolean (* retweet)(TwitterWebClient *twitterwebclient, const gchar *id, gchar **buffer, gint *length);
+
+	/**
+	 * \param twitterwebclient TwitterWebClient instance
+	 * \param cancellable a GCancellable closing the stream or NULL
+	 * \return TRUE if the stream has been closed by the remote host
+	 *
+	 * Opens the user stream & passes the received newline-delimited JSON messages to the
+	 * function set with set_content_func(). Blocks until the stream is closed, cancelled or
+	 * hasn't sent any data for TWITTER_USER_STREAM_STALL_TIMEOUT seconds. On failure the code
+	 * of the last error is the HTTP status of the response (or 0 on network errors). The user
+	 * stream doesn't count against the rate limit.
+	 */
+	gboolean (* get_user_stream)(TwitterWebClient *twitterwebclient, GCancellable *cancellable);
 };
 
 /**
@@ -419,6 +479,8 @@ const gchar *twitter_web_client_get_username(TwitterWebClient *twitterwebclient)
 void twitter_web_client_set_oauth_authorization(TwitterWebClient *twitterwebclient, const gchar * restrict consumer_key, const gchar * restrict consumer_secret, const gchar * restrict access_key, const gchar * restrict access_secret);
 /*! See _TwitterWebClientClass::set_format for further information. */
 void twitter_web_client_set_format(TwitterWebClient *twitterwebclient, const gchar *format);
+/*! See _TwitterWebClientClass::set_content_func for further information. */
+void twitter_web_client_set_content_func(TwitterWebClient *twitterwebclient, TwitterWebClientContentFunc func, gpointer user_data);
 /*! See _TwitterWebClientClass::get_home_timeline for further information. */
 gboolean twitter_web_client_get_home_timeline(TwitterWebClient *twitterwebclient, gchar **buffer, gint *length);
 /*! See _TwitterWebClientClass::get_mentions for further information. */
@@ -461,12 +523,16 @@ gboolean twitter_web_client_block_user(TwitterWebClient *twitterwebclient, const
 gboolean twitter_web_client_get_user_details(TwitterWebClient *twitterwebclient, const gchar *friend, gchar **buffer, gint *length);
 /*! See _TwitterWebClientClass::get_user_details_by_id for further information. */
 gboolean twitter_web_client_get_user_details_by_id(TwitterWebClient *twitterwebclient, const gchar *friend, gchar **buffer, gint *length);
+/*! See _TwitterWebClientClass::lookup_users for further information. */
+gboolean twitter_web_client_lookup_users(TwitterWebClient *twitterwebclient, const gchar **ids, gint count, gchar **buffer, gint *length);
 /*! See _TwitterWebClientClass::post_tweet for further information. */
 gboolean twitter_web_client_post_tweet(TwitterWebClient *twitterwebclient, const gchar *text, const gchar *prev_status, gchar **buffer, gint *length);
 /*! See _TwitterWebClientClass::remove_tweet for further information. */
 gboolean twitter_web_client_remove_tweet(TwitterWebClient *twitterwebclient, const gchar *id, gchar **buffer, gint *length);
 /*! See _TwitterWebClientClass::retweet for further information. */
 gboolean twitter_web_client_retweet(TwitterWebClient *twitterwebclient, const gchar *id, gchar **buffer, gint *length);
+/*! See _TwitterWebClientClass::get_user_stream for further information. */
+gboolean twitter_web_client_get_user_stream(TwitterWebClient *twitterwebclient, GCancellable *cancellable);
 
 /**
  * \return a GType
@@ -65,8 +65,29 @@ struct _PixbufLoaderPrivate
 	GAsyncQueue *queue;
 	/*! A cancellable. */
 	GCancellable *cancellable;
+	/*! Mutex protecting the running downloads. */
+	GMutex *mutex_downloads;
+	/*! Urls of running downloads. */
+	GHashTable *downloads;
+	/*! Downloaded images which couldn't be saved in the cache directory. */
+	GHashTable *downloaded;
 };
 
+/*! Seconds until a download is cancelled. */
+#define PIXBUF_LOADER_DOWNLOAD_TIMEOUT 30
+
+/**
+ * \struct _PixbufLoaderDownload
+ * \brief Holds data of a running download.
+ */
+typedef struct
+{
+	/*! The pixbuf loader. */
+	PixbufLoader *pixbuf_loader;
+	/*! Url of the image. */
+	gchar *url;
+} _PixbufLoaderDownload;
+
 /**
  * \struct _PixbufLoaderCallbackData
  * \brief Holds callback data.
@@ -268,54 +289,188 @@ _pixbuf_loader_save_image(const gchar *cache_dir, const gchar *url, const gchar
 	return ret;
 }
 
-/*
- *	HTTP functions:
- */
 static GdkPixbuf *
-_pixbuf_loader_get_from_server(const gchar *cache_dir, const gchar *url)
+_pixbuf_loader_load_from_buffer(const gchar *url, const gchar *buffer, gint length)
 {
-	gchar *scheme = NULL;
-	gchar *hostname = NULL;
-	gchar *path = NULL;
-	HttpClient *client;
-	gchar *buffer = NULL;
-	gint length;
-	GError *err = NULL;
+	GdkPixbufLoader *loader;
 	GdkPixbuf *pixbuf = NULL;
+	GError *err = NULL;
 
-	g_assert(cache_dir != NULL);
 	g_assert(url != NULL);
+	g_assert(buffer != NULL);
+	g_assert(length > 0);
 
-	if(uri_parse(url, &scheme, &hostname, &path))
+	g_debug("Loading image from memory: \"%s\"", url);
+	loader = gdk_pixbuf_loader_new();
+	gdk_pixbuf_loader_set_size(loader, 48, 48);
+
+	if(gdk_pixbuf_loader_write(loader, (const guchar *)buffer, length, &err))
 	{
-		client = http_client_new("hostname", hostname, "port", HTTP_DEFAULT_PORT, NULL);
-		if(http_client_get(client, path, &err) == HTTP_OK)
+		if(gdk_pixbuf_loader_close(loader, &err))
 		{
-			http_client_read_content(client, &buffer, &length);
-			if(_pixbuf_loader_save_image(cache_dir, url, buffer, length))
+			if((pixbuf = gdk_pixbuf_loader_get_pixbuf(loader)))
 			{
-				pixbuf = _pixbuf_loader_get_from_cache_dir(cache_dir, url);
+				g_object_ref(pixbuf);
 			}
+		}
+	}
+	else
+	{
+		gdk_pixbuf_loader_close(loader, NULL);
+	}
+
+	if(err)
+	{
+		g_warning("%s", err->message);
+		g_error_free(err);
+	}
 
-			if(buffer)
+	g_object_unref(loader);
+
+	return pixbuf;
+}
+
+static GdkPixbuf *
+_pixbuf_loader_take_downloaded(PixbufLoader *pixbuf_loader, const gchar *url)
+{
+	PixbufLoaderPrivate *priv = pixbuf_loader->priv;
+	gpointer key;
+	gpointer pixbuf = NULL;
+
+	g_mutex_lock(priv->mutex_downloads);
+
+	if(g_hash_table_lookup_extended(priv->downloaded, url, &key, &pixbuf))
+	{
+		g_hash_table_steal(priv->downloaded, url);
+		g_free(key);
+	}
+
+	g_mutex_unlock(priv->mutex_downloads);
+
+	return (GdkPixbuf *)pixbuf;
+}
+
+/*
+ *	HTTP functions:
+ */
+static void
+_pixbuf_loader_download_finished(HttpClient *client, GAsyncResult *result, _PixbufLoaderDownload *download)
+{
+	PixbufLoaderPrivate *priv = download->pixbuf_loader->priv;
+	gchar *buffer = NULL;
+	gint length = 0;
+	GdkPixbuf *pixbuf = NULL;
+	gboolean loaded = FALSE;
+	GError *err = NULL;
+
+	if(http_client_get_finish(client, result, &err) == HTTP_OK)
+	{
+		http_client_read_content(client, &buffer, &length);
+
+		if(buffer && length > 0)
+		{
+			if(!(loaded = _pixbuf_loader_save_image(priv->cache_dir, download->url, buffer, length)))
 			{
-				g_free(buffer);
+				/* keep the image in memory if the cache directory isn't writable */
+				loaded = (pixbuf = _pixbuf_loader_load_from_buffer(download->url, buffer, length)) != NULL;
 			}
 		}
 
-		if(err)
+		g_free(buffer);
+	}
+
+	if(err)
+	{
+		if(g_error_matches(err, G_IO_ERROR, G_IO_ERROR_CANCELLED))
+		{
+			g_debug("Download cancelled: \"%s\"", download->url);
+		}
+		else
 		{
 			g_warning("%s", err->message);
-			g_error_free(err);
 		}
 
-		g_object_unref(client);
+		g_error_free(err);
+	}
+
+	g_mutex_lock(priv->mutex_downloads);
+	g_hash_table_remove(priv->downloads, download->url);
+
+	if(pixbuf)
+	{
+		g_hash_table_insert(priv->downloaded, g_strdup(download->url), pixbuf);
+	}
+
+	g_mutex_unlock(priv->mutex_downloads);
+
+	/* send url to the worker again, it takes the image from memory or loads it from the cache directory */
+	if(loaded)
+	{
+		g_mutex_lock(priv->mutex_running);
+
+		if(priv->running)
+		{
+			g_async_queue_push(priv->queue, g_strdup(download->url));
+		}
+
+		g_mutex_unlock(priv->mutex_running);
+	}
+
+	/* cleanup */
+	g_object_unref(client);
+	g_object_unref(download->pixbuf_loader);
+	g_free(download->url);
+	g_slice_free(_PixbufLoaderDownload, download);
+}
+
+static void
+_pixbuf_loader_download(PixbufLoader *pixbuf_loader, const gchar *url)
+{
+	PixbufLoaderPrivate *priv = pixbuf_loader->priv;
+	gchar *scheme = NULL;
+	gchar *hostname = NULL;
+	gchar *path = NULL;
+	HttpClient *client;
+	_PixbufLoaderDownload *download;
+	gboolean running;
+
+	g_assert(url != NULL);
+
+	/* don't download an image twice */
+	g_mutex_lock(priv->mutex_downloads);
+
+	if(!(running = g_hash_table_lookup_extended(priv->downloads, url, NULL, NULL)))
+	{
+		g_hash_table_insert(priv->downloads, g_strdup(url), NULL);
+	}
+
+	g_mutex_unlock(priv->mutex_downloads);
+
+	if(running)
+	{
+		return;
+	}
+
+	if(uri_parse(url, &scheme, &hostname, &path))
+	{
+		download = g_slice_new(_PixbufLoaderDownload);
+		download->pixbuf_loader = g_object_ref(pixbuf_loader);
+		download->url = g_strdup(url);
+
+		g_debug("Downloading image: \"%s\"", url);
+		client = http_client_new("hostname", hostname, "port", HTTP_DEFAULT_PORT, NULL);
+		http_client_get_async(client, path, PIXBUF_LOADER_DOWNLOAD_TIMEOUT, priv->cancellable, (GAsyncReadyCallback)_pixbuf_loader_download_finished, download);
+
 		g_free(scheme);
 		g_free(hostname);
 		g_free(path);
 	}
-
-	return pixbuf;
+	else
+	{
+		g_mutex_lock(priv->mutex_downloads);
+		g_hash_table_remove(priv->downloads, url);
+		g_mutex_unlock(priv->mutex_downloads);
+	}
 }
 
 /*
@@ -327,7 +482,6 @@ _pixbuf_loader_worker(PixbufLoader *pixbuf_loader)
 	PixbufLoaderPrivate *priv = pixbuf_loader->priv;
 	gchar *url;
 	GTimeVal tv;
-	gboolean use_cache_dir;
 	GdkPixbuf *pixbuf = NULL;
 	GHashTable *pixbufs;
 	GList *callbacks, *iter;
@@ -337,7 +491,7 @@ _pixbuf_loader_worker(PixbufLoader *pixbuf_loader)
 	gboolean from_queue;
 	gboolean free_url;
 
-	use_cache_dir = _pixbuf_loader_prepare_cache_dir(priv->cache_dir);
+	_pixbuf_loader_prepare_cache_dir(priv->cache_dir);
 	urls = g_queue_new();
 
 	pixbufs = g_hash_table_new_full(g_str_hash, g_str_equal, NULL, (GDestroyNotify)g_object_unref); /* a temporarily pixbuf cache */
@@ -371,28 +525,21 @@ _pixbuf_loader_worker(PixbufLoader *pixbuf_loader)
 				/* try to load image from table */
 				if(!(pixbuf = g_hash_table_lookup(pixbufs, url)))
 				{
-					if(use_cache_dir)
+					/* try to get image from memory or cache directory */
+					if(!(pixbuf = _pixbuf_loader_take_downloaded(pixbuf_loader, url)) &&
+					   !(pixbuf = _pixbuf_loader_get_from_cache_dir(priv->cache_dir, url)))
 					{
-						/* try to load image from cache directory */
-						if(!(pixbuf = _pixbuf_loader_get_from_cache_dir(priv->cache_dir, url)))
+						if(!from_queue)
 						{
-							if(!from_queue)
-							{
-								/* push url to queue if it cannot be found in cache directory */
-								g_queue_push_head(urls, url);
-								free_url = FALSE;
-							}
-							else
-							{
-								/* get image from server */
-								pixbuf = _pixbuf_loader_get_from_server(priv->cache_dir, url);
-							}
+							/* push url to queue if it cannot be found in cache directory */
+							g_queue_push_head(urls, url);
+							free_url = FALSE;
+						}
+						else
+						{
+							/* get image from server, the url is received again when the image has been saved */
+							_pixbuf_loader_download(pixbuf_loader, url);
 						}
-					}
-					else
-					{
-						/* get image from server */
-						pixbuf = _pixbuf_loader_get_from_server(priv->cache_dir, url);
 					}
 
 					if(pixbuf)
@@ -581,6 +728,7 @@ _pixbuf_loader_stop(PixbufLoader *pixbuf_loader)
 	g_thread_join(priv->thread);
 
 	g_debug("Cleaning up");
+	priv->running = FALSE;
 	priv->thread = NULL;
 	g_object_unref(priv->cancellable);
 	priv->cancellable = NULL;
@@ -711,6 +859,21 @@ _pixbuf_loader_finalize(GObject *object)
 		g_async_queue_unref(pixbuf_loader->priv->queue);
 	}
 
+	if(pixbuf_loader->priv->downloads)
+	{
+		g_hash_table_destroy(pixbuf_loader->priv->downloads);
+	}
+
+	if(pixbuf_loader->priv->downloaded)
+	{
+		g_hash_table_destroy(pixbuf_loader->priv->downloaded);
+	}
+
+	if(pixbuf_loader->priv->mutex_downloads)
+	{
+		g_mutex_free(pixbuf_loader->priv->mutex_downloads);
+	}
+
 	if(G_OBJECT_CLASS(pixbuf_loader_parent_class)->finalize)
 	{
 		(*G_OBJECT_CLASS(pixbuf_loader_parent_class)->finalize)(object);
@@ -754,6 +917,11 @@ pixbuf_loader_init(PixbufLoader *pixbuf_loader)
 
 	/* create mutex */
 	pixbuf_loader->priv->mutex_callbacks = g_mutex_new();
+
+	/* running downloads */
+	pixbuf_loader->priv->downloads = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+	pixbuf_loader->priv->downloaded = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, (GDestroyNotify)g_object_unref);
+	pixbuf_loader->priv->mutex_downloads = g_mutex_new();
 }
 
 /**
@@ -24,6 +24,7 @@
 
 #include "settings.h"
 #include "pathbuilder.h"
+#include "application.h"
 
 /**
  * @addtogroup Core
@@ -199,6 +200,10 @@ settings_set_default_settings(Config *config, gboolean overwrite)
 	}
 
 	_settings_set_default_bool(section, "first-account-initialized", FALSE, overwrite);
+	_settings_set_default_int32(section, "sync-threads", SYNC_THREADS, overwrite);
+	_settings_set_default_bool(section, "stream-mode", SYNC_STREAM_MODE, overwrite);
+	_settings_set_default_string(section, "stream-hostname", SYNC_STREAM_HOSTNAME, overwrite);
+	_settings_set_default_int32(section, "stream-port", SYNC_STREAM_PORT, overwrite);
 
 	/* window preferences */
 	if(!(section = section_find_first_child(root, "Window")))
@@ -220,6 +225,17 @@ settings_set_default_settings(Config *config, gboolean overwrite)
 	_settings_set_default_bool(section, "show-notification-area", TRUE, overwrite);
 	_settings_set_default_int32(section, "notification-area-level", 1, overwrite);
 	_settings_set_default_string(section, "tweet-background-color", SETTINGS_DEFAULT_TWEET_BACKGROUND_COLOR, overwrite);
+
+	/* database preferences */
+	if(!(section = section_find_first_child(root, "Database")))
+	{
+		section = section_append_child(root, "Database");
+	}
+
+	_settings_set_default_int32(section, "pool-size", DATABASE_POOL_SIZE, overwrite);
+	_settings_set_default_int32(section, "max-timeline-statuses", DATABASE_RETENTION_TIMELINE_LIMIT, overwrite);
+	_settings_set_default_int32(section, "max-list-statuses", DATABASE_RETENTION_LIST_LIMIT, overwrite);
+	_settings_set_default_int32(section, "max-status-age", DATABASE_RETENTION_MAX_AGE, overwrite);
 }
 
 /**
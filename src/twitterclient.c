@@ -324,7 +324,8 @@ _twitter_client_map_username(TwitterClient *twitter_client, TwitterDbHandle *han
 }
 
 static gboolean
-_twitter_client_process_timline_from_db(TwitterClientTimelineType type, const gchar *username, TwitterProcessStatusFunc func, gpointer user_data, GCancellable *cancellable, GError **err)
+_twitter_client_process_timline_from_db(TwitterClientTimelineType type, const gchar *username, TwitterProcessStatusFunc func,
+                                        gint before_timestamp, const gchar *before_guid, gint count, gpointer user_data, GCancellable *cancellable, GError **err)
 {
 	TwitterDbHandle *handle;
 	gboolean result = FALSE;
@@ -337,15 +338,15 @@ _twitter_client_process_timline_from_db(TwitterClientTimelineType type, const gc
 	switch(type)
 	{
 		case TWITTER_CLIENT_PUBLIC_TIMELINE:
-			result = twitterdb_foreach_status_in_public_timeline(handle, username, func, FALSE, user_data, cancellable, err);
+			result = twitterdb_foreach_status_in_public_timeline(handle, username, func, FALSE, before_timestamp, before_guid, count, user_data, cancellable, err);
 			break;
 
 		case TWITTER_CLIENT_REPLIES:
-			result = twitterdb_foreach_status_in_replies(handle, username, func, FALSE, user_data, cancellable, err);
+			result = twitterdb_foreach_status_in_replies(handle, username, func, FALSE, before_timestamp, before_guid, count, user_data, cancellable, err);
 			break;
 
 		case TWITTER_CLIENT_USER_TIMELINE:
-			result = twitterdb_foreach_status_in_usertimeline(handle, username, func, FALSE, user_data, cancellable, err);
+			result = twitterdb_foreach_status_in_usertimeline(handle, username, func, FALSE, before_timestamp, before_guid, count, user_data, cancellable, err);
 			break;
 
 		default:
@@ -413,7 +414,8 @@ _twitter_client_process_usertimeline_from_server(TwitterClient *twitter_client,
 }
 
 static gboolean
-_twitter_client_process_list_from_db(const gchar *username, const gchar *list, TwitterProcessStatusFunc func, gpointer user_data, GCancellable *cancellable, GError **err)
+_twitter_client_process_list_from_db(const gchar *username, const gchar *list, TwitterProcessStatusFunc func,
+                                     gint before_timestamp, const gchar *before_guid, gint count, gpointer user_data, GCancellable *cancellable, GError **err)
 {
 	TwitterDbHandle *handle;
 	gboolean result = FALSE;
@@ -423,7 +425,7 @@ _twitter_client_process_list_from_db(const gchar *username, const gchar *list, T
 		return FALSE;
 	}
 
-	result = twitterdb_foreach_status_in_list(handle, username, list, func, user_data, cancellable, err);
+	result = twitterdb_foreach_status_in_list(handle, username, list, func, before_timestamp, before_guid, count, user_data, cancellable, err);
 	twitterdb_close_handle(handle);
 
 	return result;
@@ -806,21 +808,24 @@ _twitter_client_clear_accounts(TwitterClient *twitter_client)
 
 static gboolean
 _twitter_client_process_public_timeline(TwitterClient *twitter_client, const gchar *username, TwitterProcessStatusFunc func,
+                                        gint before_timestamp, const gchar *before_guid, gint count,
                                         gpointer user_data, GCancellable *cancellable, GError **err)
 
 {
-	return _twitter_client_process_timline_from_db(TWITTER_CLIENT_PUBLIC_TIMELINE, username, func, user_data, cancellable, err);
+	return _twitter_client_process_timline_from_db(TWITTER_CLIENT_PUBLIC_TIMELINE, username, func, before_timestamp, before_guid, count, user_data, cancellable, err);
 }
 
 static gboolean
 _twitter_client_process_replies(TwitterClient *twitter_client, const gchar *username, TwitterProcessStatusFunc func,
+                                gint before_timestamp, const gchar *before_guid, gint count,
                                 gpointer user_data, GCancellable *cancellable, GError **err)
 {
-	return _twitter_client_process_timline_from_db(TWITTER_CLIENT_REPLIES, username, func, user_data, cancellable, err);
+	return _twitter_client_process_timline_from_db(TWITTER_CLIENT_REPLIES, username, func, before_timestamp, before_guid, count, user_data, cancellable, err);
 }
 
 static gboolean
 _twitter_client_process_usertimeline(TwitterClient *twitter_client, const gchar *username, TwitterProcessStatusFunc func,
+                                     gint before_timestamp, const gchar *before_guid, gint count,
                                      gpointer user_data, GCancellable *cancellable, GError **err)
 {
 	/* check if specified username is registered as account */
@@ -828,7 +833,13 @@ _twitter_client_process_usertimeline(TwitterClient *twitter_client, const gchar
 	{
 		/* given username is an account => get tweets from database */
 		g_debug("Fetching tweets from database");
-		return _twitter_client_process_timline_from_db(TWITTER_CLIENT_USER_TIMELINE, username, func, user_data, cancellable, err);
+		return _twitter_client_process_timline_from_db(TWITTER_CLIENT_USER_TIMELINE, username, func, before_timestamp, before_guid, count, user_data, cancellable, err);
+	}
+	else if(before_timestamp > 0)
+	{
+		/* the Twitter service only delivers the newest page of a foreign usertimeline */
+		g_debug("Paging is not supported for foreign usertimelines");
+		return TRUE;
 	}
 	else
 	{
@@ -842,14 +853,15 @@ _twitter_client_process_usertimeline(TwitterClient *twitter_client, const gchar
 
 static gboolean
 _twitter_client_process_list(TwitterClient *twitter_client, const gchar * restrict username, const gchar * restrict list,
-                             TwitterProcessStatusFunc func, gpointer user_data, GCancellable *cancellable, GError **err)
+                             TwitterProcessStatusFunc func, gint before_timestamp, const gchar *before_guid, gint count,
+                             gpointer user_data, GCancellable *cancellable, GError **err)
 {
 	/* check if specified username is registered as account */
 	if(_twitter_client_account_exists(twitter_client->priv->accounts, username))
 	{
 		/* given username is an account => get tweets from database */
 		g_debug("Fetching tweets from database");
-		return _twitter_client_process_list_from_db(username, list, func, user_data, cancellable, err);
+		return _twitter_client_process_list_from_db(username, list, func, before_timestamp, before_guid, count, user_data, cancellable, err);
 	}
 	else
 	{
@@ -952,10 +964,30 @@ _twitter_client_search(TwitterClient *twitter_client, const gchar * restrict use
 {
 	gchar *key;
 	TwitterWebClient *client = NULL;
+	TwitterDbHandle *handle;
 	gchar *buffer = NULL;
 	gint length;
+	GError *db_err = NULL;
 	gboolean result = FALSE;
 
+	/* show matching tweets from the local database first, remote results are merged by the caller */
+	if((handle = twitterdb_get_handle(&db_err)))
+	{
+		twitterdb_foreach_status_matching(handle, query, func, TWITTER_CLIENT_SEARCH_STATUS_COUNT, user_data, cancellable, &db_err);
+		twitterdb_close_handle(handle);
+	}
+
+	if(db_err)
+	{
+		g_warning("%s", db_err->message);
+		g_error_free(db_err);
+	}
+
+	if(cancellable && g_cancellable_is_cancelled(cancellable))
+	{
+		return FALSE;
+	}
+
 	/* try to get data from cache */
 	key = g_strdup_printf("search.%s.%s", username, query);
 	g_debug("Searching for \"%s\" in cache", key);
@@ -1328,30 +1360,34 @@ twitter_client_clear_accounts(TwitterClient *twitter_client)
 
 gboolean
 twitter_client_process_public_timeline(TwitterClient *twitter_client, const gchar *username, TwitterProcessStatusFunc func,
+                                       gint before_timestamp, const gchar *before_guid, gint count,
                                        gpointer user_data, GCancellable *cancellable, GError **err)
 {
-	return TWITTER_CLIENT_GET_CLASS(twitter_client)->process_public_timeline(twitter_client, username, func, user_data, cancellable, err);
+	return TWITTER_CLIENT_GET_CLASS(twitter_client)->process_public_timeline(twitter_client, username, func, before_timestamp, before_guid, count, user_data, cancellable, err);
 }
 
 gboolean
 twitter_client_process_replies(TwitterClient *twitter_client, const gchar *username, TwitterProcessStatusFunc func,
+                               gint before_timestamp, const gchar *before_guid, gint count,
                                gpointer user_data, GCancellable *cancellable, GError **err)
 {
-	return TWITTER_CLIENT_GET_CLASS(twitter_client)->process_replies(twitter_client, username, func, user_data, cancellable, err);
+	return TWITTER_CLIENT_GET_CLASS(twitter_client)->process_replies(twitter_client, username, func, before_timestamp, before_guid, count, user_data, cancellable, err);
 }
 
 gboolean
 twitter_client_process_usertimeline(TwitterClient *twitter_client, const gchar *username, TwitterProcessStatusFunc func,
+                                    gint before_timestamp, const gchar *before_guid, gint count,
                                     gpointer user_data, GCancellable *cancellable, GError **err)
 {
-	return TWITTER_CLIENT_GET_CLASS(twitter_client)->process_usertimeline(twitter_client, username, func, user_data, cancellable, err);
+	return TWITTER_CLIENT_GET_CLASS(twitter_client)->process_usertimeline(twitter_client, username, func, before_timestamp, before_guid, count, user_data, cancellable, err);
 }
 
 gboolean
 twitter_client_process_list(TwitterClient *twitter_client, const gchar * restrict username, const gchar * restrict list,
-                            TwitterProcessStatusFunc func, gpointer user_data, GCancellable *cancellable, GError **err)
+                            TwitterProcessStatusFunc func, gint before_timestamp, const gchar *before_guid, gint count,
+                            gpointer user_data, GCancellable *cancellable, GError **err)
 {
-	return TWITTER_CLIENT_GET_CLASS(twitter_client)->process_list(twitter_client, username, list, func, user_data, cancellable, err);
+	return TWITTER_CLIENT_GET_CLASS(twitter_client)->process_list(twitter_client, username, list, func, before_timestamp, before_guid, count, user_data, cancellable, err);
 }
 
 gboolean
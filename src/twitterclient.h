@@ -59,6 +59,8 @@
 #define TWITTER_CLIENT_SEARCH_CACHE_LIFETIME  30
 /*! Status count for search results. */
 #define TWITTER_CLIENT_SEARCH_STATUS_COUNT    50
+/*! Default number of statuses read from a timeline at once. */
+#define TWITTER_CLIENT_DEFAULT_PAGE_SIZE      50
 
 /*!A type definition for _TwitterClientPrivate. */
 typedef struct _TwitterClientPrivate TwitterClientPrivate;
@@ -104,6 +106,9 @@ struct _TwitterClientClass
 	 * \param twitterclient TwitterClient instance
 	 * \param username a username
 	 * \param func callback function
+	 * \param before_timestamp only get tweets older than this timestamp (0 to start with the newest tweet)
+	 * \param before_guid guid of the last tweet of the previous page or NULL
+	 * \param count maximum number of tweets
 	 * \param user_data  user data
 	 * \param cancellable a GCancellable to abort the operation
 	 * \param err structure to store failure messages
@@ -112,12 +117,16 @@ struct _TwitterClientClass
 	 * Gets tweets from a public timeline.
 	 */
 	gboolean (* process_public_timeline)(TwitterClient *twitterclient, const gchar *username, TwitterProcessStatusFunc func,
+	                                     gint before_timestamp, const gchar *before_guid, gint count,
 	                                     gpointer user_data, GCancellable *cancellable, GError **err);
 
 	/**
 	 * \param twitterclient TwitterClient instance
 	 * \param username a username
 	 * \param func callback function
+	 * \param before_timestamp only get tweets older than this timestamp (0 to start with the newest tweet)
+	 * \param before_guid guid of the last tweet of the previous page or NULL
+	 * \param count maximum number of tweets
 	 * \param user_data  user data
 	 * \param cancellable a GCancellable to abort the operation
 	 * \param err structure to store failure messages
@@ -126,12 +135,16 @@ struct _TwitterClientClass
 	 * Gets replies.
 	 */
 	gboolean (* process_replies)(TwitterClient *twitterclient, const gchar *username, TwitterProcessStatusFunc func,
+	                             gint before_timestamp, const gchar *before_guid, gint count,
 	                             gpointer user_data, GCancellable *cancellable, GError **err);
 
 	/**
 	 * \param twitterclient TwitterClient instance
 	 * \param username a username
 	 * \param func callback function
+	 * \param before_timestamp only get tweets older than this timestamp (0 to start with the newest tweet)
+	 * \param before_guid guid of the last tweet of the previous page or NULL
+	 * \param count maximum number of tweets
 	 * \param user_data  user data
 	 * \param cancellable a GCancellable to abort the operation
 	 * \param err structure to store failure messages
@@ -140,6 +153,7 @@ struct _TwitterClientClass
 	 * Gets tweets from a usertimline.
 	 */
 	gboolean (* process_usertimeline)(TwitterClient *twitterclient, const gchar *username, TwitterProcessStatusFunc func,
+	                                  gint before_timestamp, const gchar *before_guid, gint count,
 	                                  gpointer user_data, GCancellable *cancellable, GError **err);
 
 	/**
@@ -147,6 +161,9 @@ struct _TwitterClientClass
 	 * \param username a username
 	 * \param list a list
 	 * \param func callback function
+	 * \param before_timestamp only get tweets older than this timestamp (0 to start with the newest tweet)
+	 * \param before_guid guid of the last tweet of the previous page or NULL
+	 * \param count maximum number of tweets
 	 * \param user_data  user data
 	 * \param cancellable a GCancellable to abort the operation
 	 * \param err structure to store failure messages
@@ -155,7 +172,8 @@ struct _TwitterClientClass
 	 * Gets tweets from a list.
 	 */
 	gboolean (* process_list)(TwitterClient *twitterclient, const gchar * restrict username, const gchar * restrict list,
-	                          TwitterProcessStatusFunc func, gpointer user_data, GCancellable *cancellable, GError **err);
+	                          TwitterProcessStatusFunc func, gint before_timestamp, const gchar *before_guid, gint count,
+	                          gpointer user_data, GCancellable *cancellable, GError **err);
 
 	/**
 	 * \param twitterclient TwitterClient instance
@@ -180,7 +198,8 @@ struct _TwitterClientClass
 	 * \param err structure to store failure messages
 	 * \return TRUE on success
 	 
-	 * Gets tweets from a search query.
+	 * Gets tweets from a search query. Matching tweets from the local database are passed to
+	 * the callback function first, followed by the result of the Twitter service.
 	 */
 	gboolean (* search)(TwitterClient *twitterclient, const gchar * restrict username, const gchar * restrict query,
 	                    TwitterProcessStatusFunc func, gpointer user_data, GCancellable *cancellable, GError **err);
@@ -324,16 +343,20 @@ void twitter_client_add_account(TwitterClient *twitter_client, const gchar * res
 void twitter_client_clear_accounts(TwitterClient *client);
 /*! See _TwitterClientClass::process_public_timeline for further information. */
 gboolean twitter_client_process_public_timeline(TwitterClient *twitter_client, const gchar *username, TwitterProcessStatusFunc func,
+                                                gint before_timestamp, const gchar *before_guid, gint count,
                                                 gpointer user_data, GCancellable *cancellable, GError **err);
 /*! See _TwitterClientClass::process_replies for further information. */
 gboolean twitter_client_process_replies(TwitterClient *twitter_client, const gchar *username, TwitterProcessStatusFunc func,
+                                        gint before_timestamp, const gchar *before_guid, gint count,
                                         gpointer user_data, GCancellable *cancellable, GError **err);
 /*! See _TwitterClientClass::process_usertimeline for further information. */
 gboolean twitter_client_process_usertimeline(TwitterClient *twitter_client, const gchar *username, TwitterProcessStatusFunc func,
+                                             gint before_timestamp, const gchar *before_guid, gint count,
                                              gpointer user_data, GCancellable *cancellable, GError **err);
 /*! See _TwitterClientClass::process_list for further information. */
 gboolean twitter_client_process_list(TwitterClient *twitter_client, const gchar * restrict username, const gchar * restrict list,
-                                     TwitterProcessStatusFunc func, gpointer user_data, GCancellable *cancellable, GError **err);
+                                     TwitterProcessStatusFunc func, gint before_timestamp, const gchar *before_guid, gint count,
+                                     gpointer user_data, GCancellable *cancellable, GError **err);
 /*! See _TwitterClientClass::get_status for further information. */
 gboolean twitter_client_get_status(TwitterClient *twitterclient, const gchar * restrict username, const gchar * restrict guid, TwitterStatus *status, TwitterUser *user, GError **err);
 /*! See _TwitterClientClass::search for further information. */
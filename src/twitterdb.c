@@ -36,21 +36,135 @@
  * 	@{
  */
 
-enum
-{
-	TWITTERDB_TIMELINE_TYPE_PUBLIC = 1,
-	TWITTERDB_TIMELINE_TYPE_USER_TIMELINE = 2,
-	TWITTERDB_TIMELINE_TYPE_REPLIES = 3
+/**
+ * \struct _TwitterDbHandle
+ * \brief A database connection and its prepared statements.
+ */
+struct _TwitterDbHandle
+{
+	/*! The SQLite connection. */
+	sqlite3 *db;
+	/*! Prepared statements which are currently not in use (SQL => sqlite3_stmt). */
+	GHashTable *statements;
+	/*! Serializes access to the connection & its statement cache. */
+	GMutex *mutex;
+	/*! Nesting depth of batch operations. */
+	gint batch_depth;
+	/*! TRUE if a nested batch has been rolled back. */
+	gboolean batch_failed;
+	/*! The thread which used the connection last. */
+	GThread *thread;
+	/*! Cancels waiting for a locked database. */
+	GCancellable *cancellable;
+	/*! FALSE to fail immediately if the database is locked. */
+	gboolean busy_retry;
+	/*! Milliseconds the current statement has been waiting for a lock. */
+	gint busy_wait;
 };
 
+/*! Initial delay (in milliseconds) when the database is locked. */
+#define TWITTERDB_BUSY_MIN_DELAY 2
+/*! Maximum delay (in milliseconds) between two attempts to access a locked database. */
+#define TWITTERDB_BUSY_MAX_DELAY 250
+/*! Maximum time (in milliseconds) to wait for a locked database. */
+#define TWITTERDB_BUSY_TIMEOUT   30000
+
+/*! Seconds to wait for a free connection before opening an additional one. */
+#define TWITTERDB_POOL_WAIT_TIMEOUT 5
+
+/**
+ * \struct _TwitterDbPool
+ * \brief Pool of database connections.
+ */
+typedef struct
+{
+	/*! Maximum number of pooled connections. */
+	gint size;
+	/*! Number of open connections. */
+	gint count;
+	/*! Connections which are currently not in use. */
+	GQueue *idle;
+	/*! Signals that a connection has been returned to the pool. */
+	GCond *cond;
+	/*! Filename of the database. */
+	gchar *filename;
+	/*! Pool statistics. */
+	TwitterDbPoolStats stats;
+} _TwitterDbPool;
+
+/*! The connection pool. */
+static _TwitterDbPool twitterdb_pool = { DATABASE_POOL_SIZE, 0, NULL, NULL, NULL, { 0 } };
+
+/*! Protects the connection pool. */
 static GStaticMutex mutex_twitterdb = G_STATIC_MUTEX_INIT;
 
+/*! Lock wait statistics (SQL => TwitterDbBusyStats). */
+static GHashTable *twitterdb_busy_stats = NULL;
+
+/*! Protects the lock wait statistics. */
+static GStaticMutex mutex_twitterdb_busy_stats = G_STATIC_MUTEX_INIT;
+
 /*
  *	helpers:
  */
 /*! Copy string from sqlite3_column to destination buffer. */
 #define TWITTERDB_COPY_TEXT_COLUMN(dest, index, size) if(sqlite3_column_text(stmt, index)) g_strlcpy(dest, (const gchar *)sqlite3_column_text(stmt, index), size)
 
+static void
+_twitterdb_bind_guid(sqlite3_stmt *stmt, gint index, const gchar *guid)
+{
+	gint64 id;
+	gchar *end = NULL;
+
+	if(guid && *guid)
+	{
+		/* Twitter ids are stored as 64bit integers */
+		id = g_ascii_strtoll(guid, &end, 10);
+
+		if(end && !*end)
+		{
+			sqlite3_bind_int64(stmt, index, (sqlite3_int64)id);
+		}
+		else
+		{
+			g_warning("Invalid guid: \"%s\"", guid);
+			sqlite3_bind_text(stmt, index, guid, -1, NULL);
+		}
+	}
+	else
+	{
+		sqlite3_bind_null(stmt, index);
+	}
+}
+
+static void
+_twitterdb_bind_page(sqlite3_stmt *stmt, gint index, gint before_timestamp, const gchar *before_guid, gint count)
+{
+	/* keyset pagination: (timestamp, guid) < (before_timestamp, before_guid) */
+	if(before_timestamp > 0)
+	{
+		sqlite3_bind_int(stmt, index, before_timestamp);
+		sqlite3_bind_int(stmt, index + 1, before_timestamp);
+
+		if(before_guid && *before_guid)
+		{
+			_twitterdb_bind_guid(stmt, index + 2, before_guid);
+		}
+		else
+		{
+			sqlite3_bind_int64(stmt, index + 2, 0);
+		}
+	}
+	else
+	{
+		sqlite3_bind_int64(stmt, index, G_MAXINT64);
+		sqlite3_bind_int64(stmt, index + 1, G_MAXINT64);
+		sqlite3_bind_int64(stmt, index + 2, G_MAXINT64);
+	}
+
+	sqlite3_bind_int(stmt, index + 3, count);
+}
+
 static void
 _twitterdb_set_error(GError **err, TwitterDbHandle *handle)
 {
@@ -58,7 +172,7 @@ _twitterdb_set_error(GError **err, TwitterDbHandle *handle)
 
 	if(err)
 	{
-		g_set_error(err, 0, 0, "database failure: \"%s\"", sqlite3_errmsg(handle));
+		g_set_error(err, 0, 0, "database failure: \"%s\"", sqlite3_errmsg(handle->db));
 	}
 }
 
@@ -80,7 +194,10 @@ _twitterdb_execute_non_query(TwitterDbHandle *handle, const gchar *query, GError
 	g_assert(handle != NULL);
 	g_assert(query != NULL);
 
-	if(sqlite3_exec(handle, query, NULL, NULL, &message) == SQLITE_OK)
+	handle->busy_retry = TRUE;
+	handle->busy_wait = 0;
+
+	if(sqlite3_exec(handle->db, query, NULL, NULL, &message) == SQLITE_OK)
 	{
 		result = TRUE;
 	}
@@ -106,16 +223,17 @@ _twitterdb_prepare_statement(TwitterDbHandle *handle, const gchar *sql, sqlite3_
 	g_assert(handle != NULL);
 	g_assert(stmt != NULL);
 
-	do
+	/* reuse a cached statement */
+	if((*stmt = (sqlite3_stmt *)g_hash_table_lookup(handle->statements, sql)))
 	{
-		result = sqlite3_prepare_v2(handle, sql, -1, stmt, NULL);
+		g_hash_table_steal(handle->statements, sql);
 
-		if(result == SQLITE_LOCKED || result == SQLITE_BUSY)
-		{
-			g_usleep(50000);
-		}
+		return TRUE;
+	}
 
-	} while(result == SQLITE_LOCKED || result == SQLITE_BUSY);
+	handle->busy_retry = TRUE;
+	handle->busy_wait = 0;
+	result = sqlite3_prepare_v2(handle->db, sql, -1, stmt, NULL);
 
 	if(result != SQLITE_OK)
 	{
@@ -126,6 +244,103 @@ _twitterdb_prepare_statement(TwitterDbHandle *handle, const gchar *sql, sqlite3_
 	return success;
 }
 
+static void
+_twitterdb_release_statement(TwitterDbHandle *handle, sqlite3_stmt *stmt)
+{
+	const gchar *sql;
+
+	g_assert(handle != NULL);
+
+	if(!stmt)
+	{
+		return;
+	}
+
+	sql = sqlite3_sql(stmt);
+
+	if(g_hash_table_lookup(handle->statements, sql))
+	{
+		/* the query has been prepared twice (nested usage) => keep only one instance */
+		sqlite3_finalize(stmt);
+	}
+	else
+	{
+		/* reset statement & store it in the cache */
+		sqlite3_reset(stmt);
+		sqlite3_clear_bindings(stmt);
+		g_hash_table_insert(handle->statements, (gpointer)sql, stmt);
+	}
+}
+
+static void
+_twitterdb_register_busy_wait(const gchar *sql, gint milliseconds)
+{
+	TwitterDbBusyStats *stats;
+	gint bucket = 0;
+	gint limit = 10;
+
+	g_static_mutex_lock(&mutex_twitterdb_busy_stats);
+
+	if(!twitterdb_busy_stats)
+	{
+		twitterdb_busy_stats = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free);
+	}
+
+	if(!(stats = (TwitterDbBusyStats *)g_hash_table_lookup(twitterdb_busy_stats, sql)))
+	{
+		stats = g_new0(TwitterDbBusyStats, 1);
+		g_hash_table_insert(twitterdb_busy_stats, g_strdup(sql), stats);
+	}
+
+	/* find histogram bucket: <10ms, <100ms, <1s, <10s, >=10s */
+	while(bucket < TWITTERDB_BUSY_HISTOGRAM_SIZE - 1 && milliseconds >= limit)
+	{
+		++bucket;
+		limit *= 10;
+	}
+
+	++stats->count;
+	stats->total_milliseconds += milliseconds;
+	stats->max_milliseconds = MAX(stats->max_milliseconds, milliseconds);
+	++stats->histogram[bucket];
+
+	g_static_mutex_unlock(&mutex_twitterdb_busy_stats);
+}
+
+static int
+_twitterdb_busy_handler(void *data, int count)
+{
+	TwitterDbHandle *handle = (TwitterDbHandle *)data;
+	gint delay;
+
+	if(!handle->busy_retry)
+	{
+		return 0;
+	}
+
+	if(handle->cancellable && g_cancellable_is_cancelled(handle->cancellable))
+	{
+		g_debug("%s: cancelled", __func__);
+		return 0;
+	}
+
+	if(handle->busy_wait >= TWITTERDB_BUSY_TIMEOUT)
+	{
+		g_warning("Database is locked, giving up after %d ms", handle->busy_wait);
+		return 0;
+	}
+
+	/* exponential backoff */
+	delay = (count < 8) ? (TWITTERDB_BUSY_MIN_DELAY << count) : TWITTERDB_BUSY_MAX_DELAY;
+	delay = MIN(delay, TWITTERDB_BUSY_MAX_DELAY);
+	delay = MIN(delay, TWITTERDB_BUSY_TIMEOUT - handle->busy_wait);
+
+	g_usleep(delay * 1000);
+	handle->busy_wait += delay;
+
+	return 1;
+}
+
 static gint
 _twitterdb_execute_statement(TwitterDbHandle *handle, sqlite3_stmt *stmt, gboolean retry, GError **err)
 {
@@ -134,16 +349,11 @@ _twitterdb_execute_statement(TwitterDbHandle *handle, sqlite3_stmt *stmt, gboole
 	g_assert(handle != NULL);
 	g_assert(stmt != NULL);
 
+	handle->busy_retry = retry;
+	handle->busy_wait = 0;
+
 	switch((result = sqlite3_step(stmt)))
 	{
-		case SQLITE_BUSY:
-			if(retry)
-			{
-				g_usleep(5000000);
-				return _twitterdb_execute_statement(handle, stmt, retry, err);
-			}
-			break;
-
 		case SQLITE_DONE:
 		case SQLITE_ROW:
 			break;
@@ -153,7 +363,12 @@ _twitterdb_execute_statement(TwitterDbHandle *handle, sqlite3_stmt *stmt, gboole
 			break;
 
 		default:
-			g_set_error(err, 0, 0, "Couldn't execute statement: \"%s\"", sqlite3_errmsg(handle));
+			g_set_error(err, 0, 0, "Couldn't execute statement: \"%s\"", sqlite3_errmsg(handle->db));
+	}
+
+	if(handle->busy_wait)
+	{
+		_twitterdb_register_busy_wait(sqlite3_sql(stmt), handle->busy_wait);
 	}
 
 	return result;
@@ -177,15 +392,15 @@ _twitterdb_update_follower(TwitterDbHandle *handle, const gchar * restrict user1
 
 	if(_twitterdb_prepare_statement(handle, query, &stmt, err))
 	{
-		sqlite3_bind_text(stmt, 1, user1_guid, -1, NULL);
-		sqlite3_bind_text(stmt, 2, user2_guid, -1, NULL);
+		_twitterdb_bind_guid(stmt, 1, user1_guid);
+		_twitterdb_bind_guid(stmt, 2, user2_guid);
 
 		if(_twitterdb_execute_statement(handle, stmt, TRUE, err) == SQLITE_DONE)
 		{
 			result = TRUE;
 		}
 
-		sqlite3_finalize(stmt);
+		_twitterdb_release_statement(handle, stmt);
 	}
 
 	return result;
@@ -199,14 +414,14 @@ _twitterdb_remove_followers(TwitterDbHandle *handle, const gchar *user_guid, gbo
 
 	if(_twitterdb_prepare_statement(handle, friend ? twitterdb_queries_remove_friends_from_user : twitterdb_queries_remove_followers_from_user, &stmt, err))
 	{
-		sqlite3_bind_text(stmt, 1, user_guid, -1, NULL);
+		_twitterdb_bind_guid(stmt, 1, user_guid);
 
 		if(_twitterdb_execute_statement(handle, stmt, TRUE, err) == SQLITE_DONE)
 		{
 			result = TRUE;
 		}
 
-		sqlite3_finalize(stmt);
+		_twitterdb_release_statement(handle, stmt);
 	}
 
 	return result;
@@ -218,18 +433,19 @@ _twitterdb_add_status_to_timeline(TwitterDbHandle *handle, const gchar * restric
 	sqlite3_stmt *stmt;
 	gboolean result = FALSE;
 
-	if(_twitterdb_prepare_statement(handle, twitterdb_queries_replace_status_into_timeline, &stmt, err))
+	if(_twitterdb_prepare_statement(handle, twitterdb_queries_insert_status_into_timeline, &stmt, err))
 	{
-		sqlite3_bind_text(stmt, 1, user_guid, -1, NULL);
-		sqlite3_bind_text(stmt, 2, status_guid, -1, NULL);
+		_twitterdb_bind_guid(stmt, 1, user_guid);
+		_twitterdb_bind_guid(stmt, 2, status_guid);
 		sqlite3_bind_int(stmt, 3, type);
+		_twitterdb_bind_guid(stmt, 4, status_guid);
 
 		if(_twitterdb_execute_statement(handle, stmt, TRUE, err) == SQLITE_DONE)
 		{
 			result = TRUE;
 		}
 
-		sqlite3_finalize(stmt);
+		_twitterdb_release_statement(handle, stmt);
 	}
 
 	return result;
@@ -253,15 +469,15 @@ _twitterdb_update_list_member(TwitterDbHandle *handle, const gchar * restrict li
 
 	if(_twitterdb_prepare_statement(handle, query, &stmt, err))
 	{
-		sqlite3_bind_text(stmt, 1, list_guid, -1, NULL);
-		sqlite3_bind_text(stmt, 2, user_guid, -1, NULL);
+		_twitterdb_bind_guid(stmt, 1, list_guid);
+		_twitterdb_bind_guid(stmt, 2, user_guid);
 
 		if(_twitterdb_execute_statement(handle, stmt, TRUE, err) == SQLITE_DONE)
 		{
 			result = TRUE;
 		}
 
-		sqlite3_finalize(stmt);
+		_twitterdb_release_statement(handle, stmt);
 	}
 
 	return result;
@@ -275,7 +491,7 @@ _twitterdb_get_user(TwitterDbHandle *handle, const gchar *guid, TwitterUser *use
 
 	if(_twitterdb_prepare_statement(handle, twitterdb_queries_get_user, &stmt, err))
 	{
-		sqlite3_bind_text(stmt, 1, guid, -1, NULL);
+		_twitterdb_bind_guid(stmt, 1, guid);
 
 		if(_twitterdb_execute_statement(handle, stmt, TRUE, err) == SQLITE_ROW)
 		{
@@ -289,7 +505,7 @@ _twitterdb_get_user(TwitterDbHandle *handle, const gchar *guid, TwitterUser *use
 			result = TRUE;
 		}
 
-		sqlite3_finalize(stmt);
+		_twitterdb_release_statement(handle, stmt);
 	}
 
 	return result;
@@ -303,7 +519,7 @@ _twitterdb_get_list(TwitterDbHandle *handle, const gchar *guid, TwitterList *lis
 
 	if(_twitterdb_prepare_statement(handle, twitterdb_queries_get_list, &stmt, err))
 	{
-		sqlite3_bind_text(stmt, 1, guid, -1, NULL);
+		_twitterdb_bind_guid(stmt, 1, guid);
 
 		if(_twitterdb_execute_statement(handle, stmt, TRUE, err) == SQLITE_ROW)
 		{
@@ -318,7 +534,7 @@ _twitterdb_get_list(TwitterDbHandle *handle, const gchar *guid, TwitterList *lis
 			result = TRUE;
 		}
 
-		sqlite3_finalize(stmt);
+		_twitterdb_release_statement(handle, stmt);
 	}
 
 	return result;
@@ -343,8 +559,8 @@ _twitterdb_fetch_tweets(TwitterDbHandle *handle, sqlite3_stmt *stmt, GList **twe
 
 		if(status == SQLITE_ROW)
 		{
-			tweet = (TwitterStatus *)g_slice_alloc(sizeof(TwitterStatus));
-			user = (TwitterUser *)g_slice_alloc(sizeof(TwitterUser));
+			tweet = (TwitterStatus *)g_slice_alloc0(sizeof(TwitterStatus));
+			user = (TwitterUser *)g_slice_alloc0(sizeof(TwitterUser));
 
 			/* fill status & user structure */
 			TWITTERDB_COPY_TEXT_COLUMN(tweet->id, 0, 32);
@@ -409,7 +625,8 @@ _twitterdb_free_list(GList *list, gint element_size)
 }
 
 static gboolean
-_twitterdb_foreach_status_in_timeline_locked(TwitterDbHandle *handle, const gchar *username, gint list, TwitterProcessStatusFunc func, gboolean ignore_old, gpointer user_data, GCancellable *cancellable, GError **err)
+_twitterdb_foreach_status_in_timeline_locked(TwitterDbHandle *handle, const gchar *username, gint list, TwitterProcessStatusFunc func, gboolean ignore_old,
+                                             gint before_timestamp, const gchar *before_guid, gint count, gpointer user_data, GCancellable *cancellable, GError **err)
 {
 	sqlite3_stmt *stmt;
 	GList *tweets = NULL;
@@ -420,20 +637,23 @@ _twitterdb_foreach_status_in_timeline_locked(TwitterDbHandle *handle, const gcha
 	g_assert(username != NULL);
 	g_assert(func != NULL);
 
-	g_static_mutex_lock(&mutex_twitterdb);
+	g_return_val_if_fail(count > 0, FALSE);
 
-	/* get tweets */
-	if(_twitterdb_prepare_statement(handle, twitterdb_queries_get_tweets_from_timeline, &stmt, err))
+	g_mutex_lock(handle->mutex);
+
+	/* get tweets, new tweets are newer than the read mark of the timeline */
+	if(_twitterdb_prepare_statement(handle, ignore_old ? twitterdb_queries_get_new_tweets_from_timeline : twitterdb_queries_get_tweets_from_timeline, &stmt, err))
 	{
 		sqlite3_bind_int(stmt, 1, list);
 		sqlite3_bind_text(stmt, 2, username, -1, NULL);
+		_twitterdb_bind_page(stmt, 3, before_timestamp, before_guid, count);
 		result = TRUE;
 
 		result = _twitterdb_fetch_tweets(handle, stmt, &tweets, &users, cancellable, err);
-		sqlite3_finalize(stmt);
+		_twitterdb_release_statement(handle, stmt);
 	}
 
-	g_static_mutex_unlock(&mutex_twitterdb);
+	g_mutex_unlock(handle->mutex);
 
 	/* iterate result */
 	if(result)
@@ -447,6 +667,45 @@ _twitterdb_foreach_status_in_timeline_locked(TwitterDbHandle *handle, const gcha
 	return result;
 }
 
+static gchar *
+_twitterdb_build_match_expression(const gchar *query)
+{
+	GString *expr;
+	GString *term;
+	const gchar *ptr = query;
+	gunichar c;
+
+	expr = g_string_new(NULL);
+	term = g_string_new(NULL);
+
+	/* build a phrase from each word of the query, punctuation (e.g. '#' or '@') is dropped */
+	while(ptr && *ptr)
+	{
+		c = g_utf8_get_char(ptr);
+		ptr = g_utf8_next_char(ptr);
+
+		if(g_unichar_isalnum(c) || c == '_')
+		{
+			g_string_append_unichar(term, c);
+		}
+		else if(term->len && term->str[term->len - 1] != ' ')
+		{
+			g_string_append_c(term, ' ');
+		}
+
+		if((g_unichar_isspace(c) || !*ptr) && term->len)
+		{
+			g_strchomp(term->str);
+			g_string_append_printf(expr, "%s\"%s\"", expr->len ? " " : "", term->str);
+			g_string_truncate(term, 0);
+		}
+	}
+
+	g_string_free(term, TRUE);
+
+	return g_string_free(expr, expr->len ? FALSE : TRUE);
+}
+
 static GList *
 _twitterdb_get_followers(TwitterDbHandle *handle, const gchar *user_guid, gboolean friends, GError **err)
 {
@@ -461,7 +720,7 @@ _twitterdb_get_followers(TwitterDbHandle *handle, const gchar *user_guid, gboole
 	/* get follower guids from database */
 	if(_twitterdb_prepare_statement(handle, friends ? twitterdb_queries_get_friends : twitterdb_queries_get_followers, &stmt, err))
 	{
-		sqlite3_bind_text(stmt, 1, user_guid, -1, NULL);
+		_twitterdb_bind_guid(stmt, 1, user_guid);
 		success = TRUE;
 
 		while((status = _twitterdb_execute_statement(handle, stmt, TRUE, err)) != SQLITE_DONE)
@@ -478,7 +737,7 @@ _twitterdb_get_followers(TwitterDbHandle *handle, const gchar *user_guid, gboole
 			}
 		}
 
-		sqlite3_finalize(stmt);
+		_twitterdb_release_statement(handle, stmt);
 	}
 
 	/* free list on failure */
@@ -492,21 +751,13 @@ _twitterdb_get_followers(TwitterDbHandle *handle, const gchar *user_guid, gboole
 	return followers;
 }
 
-/*
- *	public:
- */
-TwitterDbHandle *
-twitterdb_get_handle(GError **err)
+static gchar *
+_twitterdb_build_filename(GError **err)
 {
 	gchar *directory;
 	gchar *filename = NULL;
-	sqlite3 *handle = NULL;
 	gboolean directory_exists = FALSE;
 
-	g_static_mutex_lock(&mutex_twitterdb);
-
-	g_debug("Creating new database handle");
-
 	/* test database folder */
 	directory = g_build_filename(pathbuilder_get_user_application_directory(), G_DIR_SEPARATOR_S, TWTTER_DATABASE_FOLDER, NULL);
 	g_debug("Testing folder: \"%s\"", directory);
@@ -531,509 +782,594 @@ twitterdb_get_handle(GError **err)
 		}
 	}
 
-	/* connect to database */
 	if(directory_exists)
 	{
 		filename = g_build_filename(directory, G_DIR_SEPARATOR_S, TWITTER_DATABASE_FILE, NULL);
-		g_debug("Connecting to database: \"%s\"", filename);
-	
-		if(sqlite3_open_v2(filename, &handle, SQLITE_OPEN_READWRITE | SQLITE_OPEN_NOMUTEX | SQLITE_OPEN_CREATE, NULL) == SQLITE_OK)
-		{
-			/* activate foreign keys */
-			_twitterdb_execute_non_query(handle, "PRAGMA foreign_keys=ON", NULL);
-
-			/* activate asynchronous mode */
-			_twitterdb_execute_non_query(handle, "PRAGMA synchronous=OFF", NULL);
-		}
-		else
-		{
-			_twitterdb_set_error(err, handle);
-			sqlite3_close(handle);
-			handle = NULL;
-		}
 	}
 
-	/* free memory */
 	g_free(directory);
 
-	if(filename)
+	return filename;
+}
+
+static TwitterDbHandle *
+_twitterdb_open_handle(const gchar *filename, GError **err)
+{
+	sqlite3 *db = NULL;
+	TwitterDbHandle *handle = NULL;
+
+	g_debug("Connecting to database: \"%s\"", filename);
+
+	if(sqlite3_open_v2(filename, &db, SQLITE_OPEN_READWRITE | SQLITE_OPEN_NOMUTEX | SQLITE_OPEN_CREATE, NULL) == SQLITE_OK)
 	{
-		g_free(filename);
-	}
+		handle = (TwitterDbHandle *)g_slice_alloc(sizeof(TwitterDbHandle));
+		handle->db = db;
+		handle->statements = g_hash_table_new_full(g_str_hash, g_str_equal, NULL, (GDestroyNotify)sqlite3_finalize);
+		handle->mutex = g_mutex_new();
+		handle->batch_depth = 0;
+		handle->batch_failed = FALSE;
+		handle->thread = NULL;
+		handle->cancellable = NULL;
+		handle->busy_retry = TRUE;
+		handle->busy_wait = 0;
 
-	g_static_mutex_unlock(&mutex_twitterdb);
+		/* wait with exponential backoff if the database is locked */
+		sqlite3_busy_handler(db, _twitterdb_busy_handler, handle);
+
+		/*
+		 * Release unused pages with incremental_vacuum. SQLite ignores this pragma once the
+		 * database has been switched to WAL, so it has to be set first. It has no effect on
+		 * existing databases.
+		 */
+		_twitterdb_execute_non_query(handle, "PRAGMA auto_vacuum=INCREMENTAL", NULL);
+
+		/* enable write-ahead logging: readers don't block writers (and vice versa) */
+		_twitterdb_execute_non_query(handle, "PRAGMA journal_mode=WAL", NULL);
+
+		/* activate foreign keys */
+		_twitterdb_execute_non_query(handle, "PRAGMA foreign_keys=ON", NULL);
+
+		/* activate asynchronous mode */
+		_twitterdb_execute_non_query(handle, "PRAGMA synchronous=OFF", NULL);
+	}
+	else
+	{
+		g_set_error(err, 0, 0, "database failure: \"%s\"", sqlite3_errmsg(db));
+		sqlite3_close(db);
+	}
 
 	return handle;
 }
 
-void
-twitterdb_close_handle(TwitterDbHandle *handle)
+static void
+_twitterdb_free_handle(TwitterDbHandle *handle)
 {
-	g_static_mutex_lock(&mutex_twitterdb);
+	g_debug("Closing database connection");
 
-	g_assert(handle != NULL);
+	/* finalize cached statements */
+	g_hash_table_destroy(handle->statements);
 
-	if(sqlite3_close(handle) != SQLITE_OK)
+	if(sqlite3_close(handle->db) != SQLITE_OK)
 	{
-		g_warning("Couldn't close database connection: %s", sqlite3_errmsg(handle));
+		g_warning("Couldn't close database connection: %s", sqlite3_errmsg(handle->db));
 	}
 
-	g_static_mutex_unlock(&mutex_twitterdb);
+	if(handle->cancellable)
+	{
+		g_object_unref(handle->cancellable);
+	}
+
+	g_mutex_free(handle->mutex);
+	g_slice_free1(sizeof(TwitterDbHandle), handle);
 }
 
-gboolean
-twitterdb_table_exists(TwitterDbHandle *handle, const gchar *table, GError **err)
+static void
+_twitterdb_pool_init(void)
 {
-	gint count;
-	sqlite3_stmt *stmt;
-	gboolean result = FALSE;
+	if(!twitterdb_pool.idle)
+	{
+		twitterdb_pool.idle = g_queue_new();
+		twitterdb_pool.cond = g_cond_new();
+	}
+}
 
-	g_static_mutex_lock(&mutex_twitterdb);
+static TwitterDbHandle *
+_twitterdb_pool_take_idle_handle(void)
+{
+	GList *iter;
+	TwitterDbHandle *handle;
+	GThread *self = g_thread_self();
 
-	g_assert(handle != NULL);
+	/* prefer the connection which has been used by the current thread */
+	for(iter = twitterdb_pool.idle->head; iter && ((TwitterDbHandle *)iter->data)->thread != self; iter = iter->next);
 
-	/* check if table does exist */
-	if(_twitterdb_prepare_statement(handle, twitterdb_queries_count_table, &stmt, err))
+	if(iter)
 	{
-		sqlite3_bind_text(stmt, 1, table, -1, NULL);
-
-		if(_twitterdb_execute_statement(handle, stmt, TRUE, err) == SQLITE_ROW)
-		{
-			if((count = sqlite3_column_int(stmt, 0)))
-			{
-				result = TRUE;
-			}
-		}
-
-		sqlite3_finalize(stmt);
+		handle = (TwitterDbHandle *)iter->data;
+		g_queue_delete_link(twitterdb_pool.idle, iter);
+		++twitterdb_pool.stats.affinity_hits;
+	}
+	else
+	{
+		handle = (TwitterDbHandle *)g_queue_pop_head(twitterdb_pool.idle);
 	}
 
-	g_static_mutex_unlock(&mutex_twitterdb);
+	++twitterdb_pool.stats.hits;
 
-	return result;
+	return handle;
 }
 
-gboolean
-twitterdb_init(TwitterDbHandle *handle, gint major_version, gint minor_version, gboolean set_version, GError **err)
+static gboolean
+_twitterdb_create_indexes(TwitterDbHandle *handle, GError **err)
 {
 	gint i = 0;
-	sqlite3_stmt *stmt;
 	gboolean result = TRUE;
 
+	while(twitterdb_queries_create_indexes[i] && result)
+	{
+		g_debug("Creating index: \"%s\"", twitterdb_queries_create_indexes[i]);
+		result = _twitterdb_execute_non_query(handle, twitterdb_queries_create_indexes[i], err);
+		++i;
+	}
+
+	return result;
+}
+
+/*
+ *	public:
+ */
+TwitterDbHandle *
+twitterdb_get_handle(GError **err)
+{
+	TwitterDbHandle *handle = NULL;
+	gchar *filename = NULL;
+	gboolean open_handle = FALSE;
+	GTimeVal timeout;
+	GTimer *timer;
+	gdouble seconds;
+
 	g_static_mutex_lock(&mutex_twitterdb);
 
-	while(twitterdb_queries_create_tables[i] && result)
+	_twitterdb_pool_init();
+
+	/* test database folder & build filename only once */
+	if(!twitterdb_pool.filename)
 	{
-		result = _twitterdb_execute_non_query(handle, twitterdb_queries_create_tables[i], err);
-		++i;
+		twitterdb_pool.filename = _twitterdb_build_filename(err);
 	}
 
-	if(result && set_version)
+	if(twitterdb_pool.filename)
 	{
-		if(_twitterdb_prepare_statement(handle, twitterdb_queries_replace_version, &stmt, err))
+		while(!handle && !open_handle)
 		{
-			sqlite3_bind_int(stmt, 1, major_version);
-			sqlite3_bind_int(stmt, 2, minor_version);
-	
-			if(_twitterdb_execute_statement(handle, stmt, TRUE, err) == SQLITE_DONE)
+			if(!g_queue_is_empty(twitterdb_pool.idle))
 			{
-				result = TRUE;
+				handle = _twitterdb_pool_take_idle_handle();
+			}
+			else if(twitterdb_pool.count < twitterdb_pool.size)
+			{
+				open_handle = TRUE;
+			}
+			else
+			{
+				/* wait for a free connection, open an additional one on timeout */
+				g_debug("Waiting for a free database connection");
+				++twitterdb_pool.stats.waits;
+
+				g_get_current_time(&timeout);
+				g_time_val_add(&timeout, TWITTERDB_POOL_WAIT_TIMEOUT * G_USEC_PER_SEC);
+
+				if(!g_cond_timed_wait(twitterdb_pool.cond, g_static_mutex_get_mutex(&mutex_twitterdb), &timeout) &&
+				   g_queue_is_empty(twitterdb_pool.idle))
+				{
+					g_warning("Database connection pool exhausted (size=%d), opening additional connection", twitterdb_pool.size);
+					open_handle = TRUE;
+				}
 			}
+		}
 
-			sqlite3_finalize(stmt);
+		if(open_handle)
+		{
+			/* reserve slot */
+			++twitterdb_pool.count;
+			filename = g_strdup(twitterdb_pool.filename);
 		}
 	}
 
 	g_static_mutex_unlock(&mutex_twitterdb);
 
-	return result;
-}
+	if(open_handle)
+	{
+		/* connect to database */
+		g_debug("Creating new database handle");
 
-gboolean
-twitterdb_get_version(TwitterDbHandle *handle, gint *major_version, gint *minor_version, GError **err)
-{
-	sqlite3_stmt *stmt;
-	gboolean result = FALSE;
+		timer = g_timer_new();
+		handle = _twitterdb_open_handle(filename, err);
+		seconds = g_timer_elapsed(timer, NULL);
+		g_timer_destroy(timer);
 
-	g_static_mutex_lock(&mutex_twitterdb);
+		g_static_mutex_lock(&mutex_twitterdb);
 
-	if(_twitterdb_prepare_statement(handle, twitterdb_queries_get_version, &stmt, err))
-	{
-		if(_twitterdb_execute_statement(handle, stmt, TRUE, err) == SQLITE_ROW)
+		++twitterdb_pool.stats.opened;
+		twitterdb_pool.stats.open_seconds += seconds;
+
+		if(seconds > twitterdb_pool.stats.max_open_seconds)
 		{
-			*major_version = (gint)sqlite3_column_int(stmt, 0);
-			*minor_version = (gint)sqlite3_column_int(stmt, 1);
-			result = TRUE;
+			twitterdb_pool.stats.max_open_seconds = seconds;
 		}
 
-		sqlite3_finalize(stmt);
+		if(!handle)
+		{
+			/* release reserved slot */
+			--twitterdb_pool.count;
+			g_cond_signal(twitterdb_pool.cond);
+		}
+
+		g_static_mutex_unlock(&mutex_twitterdb);
+
+		g_free(filename);
 	}
 
-	g_static_mutex_unlock(&mutex_twitterdb);
+	if(handle)
+	{
+		handle->thread = g_thread_self();
+	}
 
-	return result;
+	return handle;
 }
 
-gboolean
-twitterdb_map_username(TwitterDbHandle *handle, const gchar *username, gchar *guid, gint size, GError **err)
+void
+twitterdb_close_handle(TwitterDbHandle *handle)
 {
-	sqlite3_stmt *stmt;
-	gboolean result = FALSE;
+	g_assert(handle != NULL);
+
+	/* rollback unfinished batch */
+	g_mutex_lock(handle->mutex);
+
+	if(handle->batch_depth)
+	{
+		g_warning("Closing database handle with %d unfinished batch(es)", handle->batch_depth);
+		_twitterdb_execute_non_query(handle, twitterdb_queries_rollback_transaction, NULL);
+		handle->batch_depth = 0;
+		handle->batch_failed = FALSE;
+	}
+
+	g_mutex_unlock(handle->mutex);
+
+	twitterdb_set_cancellable(handle, NULL);
 
 	g_static_mutex_lock(&mutex_twitterdb);
 
-	if(_twitterdb_prepare_statement(handle, twitterdb_queries_map_username, &stmt, err))
+	if(!twitterdb_pool.idle || twitterdb_pool.count > twitterdb_pool.size)
 	{
-		sqlite3_bind_text(stmt, 1, username, -1, NULL);
+		/* close additional connection */
+		--twitterdb_pool.count;
+		g_static_mutex_unlock(&mutex_twitterdb);
 
-		if(_twitterdb_execute_statement(handle, stmt, TRUE, err) == SQLITE_ROW)
-		{
-			g_strlcpy(guid, (const gchar *)sqlite3_column_text(stmt, 0), size);
-			result = TRUE;
-		}
+		_twitterdb_free_handle(handle);
+	}
+	else
+	{
+		/* return connection to pool */
+		g_queue_push_head(twitterdb_pool.idle, handle);
+		g_cond_signal(twitterdb_pool.cond);
 
-		sqlite3_finalize(stmt);
+		g_static_mutex_unlock(&mutex_twitterdb);
 	}
+}
 
-	g_static_mutex_unlock(&mutex_twitterdb);
+void
+twitterdb_set_filename(const gchar *filename)
+{
+	g_return_if_fail(filename != NULL);
 
-	return result;
+	g_static_mutex_lock(&mutex_twitterdb);
+
+	if(!twitterdb_pool.count)
+	{
+		g_debug("Setting database file: \"%s\"", filename);
+		g_free(twitterdb_pool.filename);
+		twitterdb_pool.filename = g_strdup(filename);
+	}
+	else
+	{
+		g_warning("Database file cannot be changed while connections are open");
+	}
+
+	g_static_mutex_unlock(&mutex_twitterdb);
 }
 
-gboolean
-twitterdb_save_user(TwitterDbHandle *handle, const gchar * restrict guid, const gchar * restrict username, const gchar * restrict realname, 
-                   const gchar * restrict image, const gchar * restrict location, const gchar * restrict website, const gchar * restrict description, GError **err)
+void
+twitterdb_set_pool_size(gint size)
 {
-	sqlite3_stmt *stmt;
-	gboolean success = FALSE;
-	gint count = 0;
-	gboolean result = FALSE;
+	GList *handles = NULL;
+	GList *iter;
+
+	g_return_if_fail(size > 0);
 
 	g_static_mutex_lock(&mutex_twitterdb);
 
-	/* check if user does exist */
-	if(_twitterdb_prepare_statement(handle, twitterdb_queries_user_exists, &stmt, err))
-	{
-		sqlite3_bind_text(stmt, 1, guid, -1, NULL);
+	g_debug("Setting database pool size: %d", size);
+	twitterdb_pool.size = size;
 
-		if(_twitterdb_execute_statement(handle, stmt, TRUE, err) == SQLITE_ROW)
+	/* close surplus idle connections */
+	if(twitterdb_pool.idle)
+	{
+		while(twitterdb_pool.count > twitterdb_pool.size && !g_queue_is_empty(twitterdb_pool.idle))
 		{
-			count = sqlite3_column_int(stmt, 0);
-			success = TRUE;
+			handles = g_list_prepend(handles, g_queue_pop_tail(twitterdb_pool.idle));
+			--twitterdb_pool.count;
 		}
-
-		sqlite3_finalize(stmt);
 	}
 
-	if(success)
+	g_static_mutex_unlock(&mutex_twitterdb);
+
+	for(iter = handles; iter; iter = iter->next)
 	{
-		/* create or update user */
-		success = FALSE;
+		_twitterdb_free_handle((TwitterDbHandle *)iter->data);
+	}
 
-		if(count == 0)
+	g_list_free(handles);
+}
+
+gboolean
+twitterdb_warm_up(gint count, GError **err)
+{
+	TwitterDbHandle **handles;
+	gint i;
+	gint opened = 0;
+	gboolean result = TRUE;
+
+	g_return_val_if_fail(count > 0, FALSE);
+
+	g_static_mutex_lock(&mutex_twitterdb);
+	count = MIN(count, twitterdb_pool.size);
+	g_static_mutex_unlock(&mutex_twitterdb);
+
+	g_debug("Warming up database pool (%d connection(s))", count);
+
+	/* take connections from pool (they are opened if necessary) & return them */
+	handles = (TwitterDbHandle **)g_malloc(sizeof(TwitterDbHandle *) * count);
+
+	for(i = 0; i < count && result; ++i)
+	{
+		if((handles[i] = twitterdb_get_handle(err)))
 		{
-			g_debug("Creating user (\"%s\")", username);
-			if((success = _twitterdb_prepare_statement(handle, twitterdb_queries_insert_user, &stmt, err)))
-			{
-				sqlite3_bind_text(stmt, 1, guid, -1, NULL);
-				sqlite3_bind_text(stmt, 2, username, -1, NULL);
-				sqlite3_bind_text(stmt, 3, realname, -1, NULL);
-				sqlite3_bind_text(stmt, 4, image, -1, NULL);
-				sqlite3_bind_text(stmt, 5, location, -1, NULL);
-				sqlite3_bind_text(stmt, 6, website, -1, NULL);
-				sqlite3_bind_text(stmt, 7, description, -1, NULL);
-			}
+			++opened;
 		}
 		else
 		{
-			g_debug("Updating user (\"%s\")", username);
-			if((success = _twitterdb_prepare_statement(handle, twitterdb_queries_update_user, &stmt, err)))
-			{
-				sqlite3_bind_text(stmt, 1, username, -1, NULL);
-				sqlite3_bind_text(stmt, 2, realname, -1, NULL);
-				sqlite3_bind_text(stmt, 3, image, -1, NULL);
-				sqlite3_bind_text(stmt, 4, location, -1, NULL);
-				sqlite3_bind_text(stmt, 5, website, -1, NULL);
-				sqlite3_bind_text(stmt, 6, description, -1, NULL);
-				sqlite3_bind_text(stmt, 7, guid, -1, NULL);
-			}
+			result = FALSE;
 		}
 	}
 
-	if(success)
+	for(i = 0; i < opened; ++i)
 	{
-		if(_twitterdb_execute_statement(handle, stmt, TRUE, err) == SQLITE_DONE)
-		{
-			result = TRUE;
-		}
-
-		sqlite3_finalize(stmt);
+		twitterdb_close_handle(handles[i]);
 	}
 
-	g_static_mutex_unlock(&mutex_twitterdb);
+	g_free(handles);
 
 	return result;
 }
 
-gboolean
-twitterdb_get_user_by_name(TwitterDbHandle *handle, const gchar *username, TwitterUser *user, GError **err)
+void
+twitterdb_get_pool_stats(TwitterDbPoolStats *stats)
 {
-	gchar guid[32];
-	gboolean result = FALSE;
-
-	if(twitterdb_map_username(handle, username, guid, 32, err))
-	{
-		g_static_mutex_lock(&mutex_twitterdb);
-		result = _twitterdb_get_user(handle, guid, user, err);
-		g_static_mutex_unlock(&mutex_twitterdb);
-	}
+	g_assert(stats != NULL);
 
-	return result;
+	g_static_mutex_lock(&mutex_twitterdb);
+	*stats = twitterdb_pool.stats;
+	stats->size = twitterdb_pool.size;
+	stats->open = twitterdb_pool.count;
+	g_static_mutex_unlock(&mutex_twitterdb);
 }
 
-gboolean
-twitterdb_user_exists(TwitterDbHandle *handle, const gchar *user_guid, GError **err)
+void
+twitterdb_cleanup(void)
 {
-	sqlite3_stmt *stmt;
-	gboolean result = FALSE;
+	TwitterDbHandle *handle;
 
 	g_static_mutex_lock(&mutex_twitterdb);
 
-	if(_twitterdb_prepare_statement(handle, twitterdb_queries_user_exists, &stmt, err))
+	g_debug("Closing pooled database connections");
+
+	if(twitterdb_pool.idle)
 	{
-		sqlite3_bind_text(stmt, 1, user_guid, -1, NULL);
+		while((handle = (TwitterDbHandle *)g_queue_pop_head(twitterdb_pool.idle)))
+		{
+			_twitterdb_free_handle(handle);
+			--twitterdb_pool.count;
+		}
 
-		if(_twitterdb_execute_statement(handle, stmt, TRUE, err) == SQLITE_ROW)
+		if(twitterdb_pool.count)
 		{
-			 if(sqlite3_column_int(stmt, 0) > 0)
-			 {
-				 result = TRUE;
-			 }
+			g_warning("%d database connection(s) still in use", twitterdb_pool.count);
 		}
 
-		sqlite3_finalize(stmt);
+		g_queue_free(twitterdb_pool.idle);
+		twitterdb_pool.idle = NULL;
+
+		g_cond_free(twitterdb_pool.cond);
+		twitterdb_pool.cond = NULL;
 	}
 
+	g_free(twitterdb_pool.filename);
+	twitterdb_pool.filename = NULL;
+
 	g_static_mutex_unlock(&mutex_twitterdb);
 
-	return result;
+	/* free lock wait statistics */
+	g_static_mutex_lock(&mutex_twitterdb_busy_stats);
+
+	if(twitterdb_busy_stats)
+	{
+		g_hash_table_destroy(twitterdb_busy_stats);
+		twitterdb_busy_stats = NULL;
+	}
+
+	g_static_mutex_unlock(&mutex_twitterdb_busy_stats);
 }
 
-gboolean
-twitterdb_save_status(TwitterDbHandle *handle, const gchar * restrict guid, const gchar * restrict prev_status, const gchar * restrict user_guid, const gchar * restrict text, gint64 timestamp, gint *count, GError **err)
+void
+twitterdb_set_cancellable(TwitterDbHandle *handle, GCancellable *cancellable)
 {
-	sqlite3_stmt *stmt;
-	gboolean exists = FALSE;
-	gboolean result = FALSE;
+	g_assert(handle != NULL);
 
-	g_static_mutex_lock(&mutex_twitterdb);
+	g_mutex_lock(handle->mutex);
 
-	/* check if status does already exist */
-	if(_twitterdb_prepare_statement(handle, twitterdb_queries_status_exists, &stmt, err))
+	if(handle->cancellable)
 	{
-		sqlite3_bind_text(stmt, 1, guid, -1, NULL);
-
-		if(_twitterdb_execute_statement(handle, stmt, TRUE, err) == SQLITE_ROW)
-		{
-			if(sqlite3_column_int(stmt, 0) == 0)
-			{
-				++(*count);
-			}
-			else
-			{
-				exists = TRUE;
-			}
-
-			result = TRUE;
-		}
-
-		sqlite3_finalize(stmt);
+		g_object_unref(handle->cancellable);
 	}
 
-	/* insert status */
-	if(!exists && result)
+	if((handle->cancellable = cancellable))
 	{
-		result = FALSE;
-
-		if(_twitterdb_prepare_statement(handle, twitterdb_queries_insert_status, &stmt, err))
-		{
-			sqlite3_bind_text(stmt, 1, guid, -1, NULL);
-			sqlite3_bind_text(stmt, 2, prev_status, -1, NULL);
-			sqlite3_bind_text(stmt, 3, text, -1, NULL);
-			sqlite3_bind_text(stmt, 4, user_guid, -1, NULL);
-			sqlite3_bind_int(stmt, 5, (sqlite3_int64)timestamp);
-			if(!(result = (_twitterdb_execute_statement(handle, stmt, TRUE, err) == SQLITE_DONE) ? TRUE : FALSE))
-			{
-				_twitterdb_set_error(err, handle);
-			}
-
-			sqlite3_finalize(stmt);
-		}
+		g_object_ref(cancellable);
 	}
 
-	g_static_mutex_unlock(&mutex_twitterdb);
-
-	return result;
+	g_mutex_unlock(handle->mutex);
 }
 
-gboolean
-twitterdb_remove_status(TwitterDbHandle *handle, const gchar *guid, GError **err)
+void
+twitterdb_foreach_busy_stats(TwitterDbProcessBusyStatsFunc func, gpointer user_data)
 {
-	sqlite3_stmt *stmt;
-	gboolean result = FALSE;
+	GHashTableIter iter;
+	gpointer key;
+	gpointer value;
 
-	g_static_mutex_lock(&mutex_twitterdb);
+	g_assert(func != NULL);
 
-	if(_twitterdb_prepare_statement(handle, twitterdb_queries_delete_status, &stmt, err))
+	g_static_mutex_lock(&mutex_twitterdb_busy_stats);
+
+	if(twitterdb_busy_stats)
 	{
-		sqlite3_bind_text(stmt, 1, guid, -1, NULL);
+		g_hash_table_iter_init(&iter, twitterdb_busy_stats);
 
-		if(_twitterdb_execute_statement(handle, stmt, TRUE, err) == SQLITE_DONE)
+		while(g_hash_table_iter_next(&iter, &key, &value))
 		{
-			result = TRUE;
+			func((const gchar *)key, (const TwitterDbBusyStats *)value, user_data);
 		}
 	}
 
-	sqlite3_finalize(stmt);
-
-	g_static_mutex_unlock(&mutex_twitterdb);
-
-	return result;
+	g_static_mutex_unlock(&mutex_twitterdb_busy_stats);
 }
 
 gboolean
-twitterdb_mark_statuses_read(TwitterDbHandle *handle, GError **err)
+twitterdb_begin_batch(TwitterDbHandle *handle, GError **err)
 {
-	gboolean result;
-
-	g_static_mutex_lock(&mutex_twitterdb);
-	result = _twitterdb_execute_non_query(handle, twitterdb_queries_mark_statuses_read, err);
-	g_static_mutex_unlock(&mutex_twitterdb);
-
-	return result;
-}
+	gboolean result = TRUE;
 
-GList *
-twitterdb_get_friends(TwitterDbHandle *handle, const gchar *user_guid, GError **err)
-{
-	GList *result;
+	g_assert(handle != NULL);
 
-	g_static_mutex_lock(&mutex_twitterdb);
-	result = _twitterdb_get_followers(handle, user_guid, TRUE, err);
-	g_static_mutex_unlock(&mutex_twitterdb);
+	g_mutex_lock(handle->mutex);
 
-	return result;
-}
+	if(!handle->batch_depth)
+	{
+		/*
+		 * Take the write lock when the batch starts: SQLite doesn't invoke the busy handler
+		 * when a deferred transaction is upgraded from read to write.
+		 */
+		g_debug("Starting database transaction");
+		result = _twitterdb_execute_non_query(handle, twitterdb_queries_begin_immediate_transaction, err);
+		handle->batch_failed = FALSE;
+	}
 
-GList *
-twitterdb_get_followers(TwitterDbHandle *handle, const gchar *user_guid, GError **err)
-{
-	GList *result;
+	if(result)
+	{
+		++handle->batch_depth;
+	}
 
-	g_static_mutex_lock(&mutex_twitterdb);
-	result = _twitterdb_get_followers(handle, user_guid, FALSE, err);
-	g_static_mutex_unlock(&mutex_twitterdb);
+	g_mutex_unlock(handle->mutex);
 
 	return result;
 }
 
 gboolean
-twitterdb_foreach_follower(TwitterDbHandle *handle, const gchar *user_guid, gboolean get_friends, TwitterProcessUserFunc func, gpointer user_data, GError **err)
+twitterdb_commit_batch(TwitterDbHandle *handle, GError **err)
 {
-	GList *ids;
-	GList *iter;
-	TwitterUser user;
 	gboolean result = TRUE;
 
-	g_static_mutex_lock(&mutex_twitterdb);
+	g_assert(handle != NULL);
 
-	if((iter = ids = _twitterdb_get_followers(handle, user_guid, get_friends, err)))
+	g_mutex_lock(handle->mutex);
+
+	/* the batch depth is guarded by the handle's mutex */
+	if(handle->batch_depth <= 0)
 	{
-		while(iter && !*err && result)
+		g_mutex_unlock(handle->mutex);
+		g_return_val_if_reached(FALSE);
+	}
+
+	if(!--handle->batch_depth)
+	{
+		if(handle->batch_failed)
 		{
-			if((result = _twitterdb_get_user(handle, (const gchar *)iter->data, &user, err)))
+			g_debug("Rolling back database transaction");
+			_twitterdb_execute_non_query(handle, twitterdb_queries_rollback_transaction, NULL);
+			g_set_error(err, 0, 0, "Transaction has been rolled back");
+			result = FALSE;
+		}
+		else
+		{
+			g_debug("Committing database transaction");
+			if(!(result = _twitterdb_execute_non_query(handle, twitterdb_queries_commit_transaction, err)))
 			{
-				func(user, user_data);
+				_twitterdb_execute_non_query(handle, twitterdb_queries_rollback_transaction, NULL);
 			}
-					
-			iter = iter->next;
 		}
 
-		g_list_foreach(ids, (GFunc)&g_free, NULL);
-		g_list_free(ids);
+		handle->batch_failed = FALSE;
 	}
 
-	g_static_mutex_unlock(&mutex_twitterdb);
-
-	if(result && *err)
-	{
-		result = FALSE;
-	}
-
-	return result;
-}
-
-gboolean
-twitterdb_add_follower(TwitterDbHandle *handle, const gchar * restrict user1_guid, const gchar * restrict user2_guid, GError **err)
-{
-	gboolean result;
-
-	g_static_mutex_lock(&mutex_twitterdb);
-	result = _twitterdb_update_follower(handle, user1_guid, user2_guid, FALSE, err);
-	g_static_mutex_unlock(&mutex_twitterdb);
-
-	return result;
-}
-
-gboolean
-twitterdb_remove_follower(TwitterDbHandle *handle, const gchar * restrict user1_guid, const gchar * restrict user2_guid, GError **err)
-{
-	gboolean result;
-
-	g_static_mutex_lock(&mutex_twitterdb);
-	result = _twitterdb_update_follower(handle, user1_guid, user2_guid, TRUE, err);
-	g_static_mutex_unlock(&mutex_twitterdb);
+	g_mutex_unlock(handle->mutex);
 
 	return result;
 }
 
-gboolean
-twitterdb_remove_friends(TwitterDbHandle *handle, const gchar *user_guid, GError **err)
+void
+twitterdb_rollback_batch(TwitterDbHandle *handle)
 {
-	gboolean result;
-
-	g_static_mutex_lock(&mutex_twitterdb);
-	result = _twitterdb_remove_followers(handle, user_guid, TRUE, err);
-	g_static_mutex_unlock(&mutex_twitterdb);
+	g_assert(handle != NULL);
 
-	return result;
-}
+	g_mutex_lock(handle->mutex);
 
-gboolean
-twitterdb_remove_followers(TwitterDbHandle *handle, const gchar *user_guid, GError **err)
-{
-	gboolean result;
+	if(handle->batch_depth <= 0)
+	{
+		g_mutex_unlock(handle->mutex);
+		g_return_if_reached();
+	}
 
-	g_static_mutex_lock(&mutex_twitterdb);
-	result = _twitterdb_remove_followers(handle, user_guid, FALSE, err);
-	g_static_mutex_unlock(&mutex_twitterdb);
+	if(--handle->batch_depth)
+	{
+		/* rollback when outermost batch ends */
+		handle->batch_failed = TRUE;
+	}
+	else
+	{
+		g_debug("Rolling back database transaction");
+		_twitterdb_execute_non_query(handle, twitterdb_queries_rollback_transaction, NULL);
+		handle->batch_failed = FALSE;
+	}
 
-	return result;
+	g_mutex_unlock(handle->mutex);
 }
 
 gboolean
-twitterdb_is_follower(TwitterDbHandle *handle, const gchar * restrict user1, const gchar * restrict user2, GError **err)
+twitterdb_table_exists(TwitterDbHandle *handle, const gchar *table, GError **err)
 {
-	sqlite3_stmt *stmt;
 	gint count;
+	sqlite3_stmt *stmt;
 	gboolean result = FALSE;
 
-	g_static_mutex_lock(&mutex_twitterdb);
+	g_mutex_lock(handle->mutex);
 
-	if(_twitterdb_prepare_statement(handle, twitterdb_queries_is_follower, &stmt, err))
+	g_assert(handle != NULL);
+
+	/* check if table does exist */
+	if(_twitterdb_prepare_statement(handle, twitterdb_queries_count_table, &stmt, err))
 	{
-		sqlite3_bind_text(stmt, 1, user1, -1, NULL);
-		sqlite3_bind_text(stmt, 2, user2, -1, NULL);
+		sqlite3_bind_text(stmt, 1, table, -1, NULL);
 
 		if(_twitterdb_execute_statement(handle, stmt, TRUE, err) == SQLITE_ROW)
 		{
@@ -1043,132 +1379,92 @@ twitterdb_is_follower(TwitterDbHandle *handle, const gchar * restrict user1, con
 			}
 		}
 
-		sqlite3_finalize(stmt);
+		_twitterdb_release_statement(handle, stmt);
 	}
 
-	g_static_mutex_unlock(&mutex_twitterdb);
+	g_mutex_unlock(handle->mutex);
 
 	return result;
 }
 
 gboolean
-twitterdb_save_list(TwitterDbHandle *handle, const gchar * restrict guid, const gchar * restrict user_guid, const gchar * restrict listname, const gchar * restrict fullname,
-                    const gchar * restrict uri, const gchar * restrict description, gboolean protected, gint subscriber_count, gint member_count,
-                    GError **err)
+twitterdb_init(TwitterDbHandle *handle, gint major_version, gint minor_version, gboolean set_version, GError **err)
 {
+	gint i = 0;
 	sqlite3_stmt *stmt;
-	gboolean result = FALSE;
-	gboolean success = FALSE;
-	gint count = 0;
+	gboolean result = TRUE;
 
-	g_static_mutex_lock(&mutex_twitterdb);
+	g_mutex_lock(handle->mutex);
 
-	/* check if list does exist */
-	if(_twitterdb_prepare_statement(handle, twitterdb_queries_list_exists, &stmt, err))
+	/* auto_vacuum has already been enabled by _twitterdb_open_handle() */
+	while(twitterdb_queries_create_tables[i] && result)
 	{
-		sqlite3_bind_text(stmt, 1, guid, -1, NULL);
-
-		if(_twitterdb_execute_statement(handle, stmt, TRUE, err) == SQLITE_ROW)
-		{
-			count = sqlite3_column_int(stmt, 0);
-			success = TRUE;
-		}
-
-		sqlite3_finalize(stmt);
+		result = _twitterdb_execute_non_query(handle, twitterdb_queries_create_tables[i], err);
+		++i;
 	}
 
-	if(success)
+	if(result)
 	{
-		/* create or update list*/
-		success = FALSE;
+		result = _twitterdb_create_indexes(handle, err);
+	}
 
-		if(count == 0)
-		{
-			g_debug("Creating list (\"%s\")", fullname);
-			if((success = _twitterdb_prepare_statement(handle, twitterdb_queries_insert_list, &stmt, err)))
-			{
-				sqlite3_bind_text(stmt, 1, guid, -1, NULL);
-				sqlite3_bind_text(stmt, 2, user_guid, -1, NULL);
-				sqlite3_bind_text(stmt, 3, listname, -1, NULL);
-				sqlite3_bind_text(stmt, 4, fullname, -1, NULL);
-				sqlite3_bind_int(stmt, 5, protected);
-				sqlite3_bind_text(stmt, 6, uri, -1, NULL);
-				sqlite3_bind_text(stmt, 7, description, -1, NULL);
-				sqlite3_bind_int(stmt, 8, subscriber_count);
-				sqlite3_bind_int(stmt, 9, member_count);
-			}
-		}
-		else
+	if(result && set_version)
+	{
+		if(_twitterdb_prepare_statement(handle, twitterdb_queries_replace_version, &stmt, err))
 		{
-			g_debug("Updating list (\"%s\")", fullname);
-			if((success = _twitterdb_prepare_statement(handle, twitterdb_queries_update_list, &stmt, err)))
+			sqlite3_bind_int(stmt, 1, major_version);
+			sqlite3_bind_int(stmt, 2, minor_version);
+	
+			if(_twitterdb_execute_statement(handle, stmt, TRUE, err) == SQLITE_DONE)
 			{
-				sqlite3_bind_text(stmt, 1, user_guid, -1, NULL);
-				sqlite3_bind_text(stmt, 2, listname, -1, NULL);
-				sqlite3_bind_text(stmt, 3, fullname, -1, NULL);
-				sqlite3_bind_int(stmt, 4, protected);
-				sqlite3_bind_text(stmt, 5, uri, -1, NULL);
-				sqlite3_bind_text(stmt, 6, description, -1, NULL);
-				sqlite3_bind_int(stmt, 7, subscriber_count);
-				sqlite3_bind_int(stmt, 8, member_count);
-				sqlite3_bind_text(stmt, 9, guid, -1, NULL);
+				result = TRUE;
 			}
-		}
-
 
-		if(_twitterdb_execute_statement(handle, stmt, TRUE, err) == SQLITE_DONE)
-		{
-			result = TRUE;
+			_twitterdb_release_statement(handle, stmt);
 		}
 	}
 
-	if(success)
-	{
-		sqlite3_finalize(stmt);
-	}
-
-	g_static_mutex_unlock(&mutex_twitterdb);
+	g_mutex_unlock(handle->mutex);
 
 	return result;
 }
 
 gboolean
-twitterdb_remove_list(TwitterDbHandle *handle, const gchar *guid, GError **err)
+twitterdb_get_version(TwitterDbHandle *handle, gint *major_version, gint *minor_version, GError **err)
 {
 	sqlite3_stmt *stmt;
 	gboolean result = FALSE;
 
-	g_static_mutex_lock(&mutex_twitterdb);
+	g_mutex_lock(handle->mutex);
 
-	if(_twitterdb_prepare_statement(handle, twitterdb_queries_delete_list, &stmt, err))
+	if(_twitterdb_prepare_statement(handle, twitterdb_queries_get_version, &stmt, err))
 	{
-		sqlite3_bind_text(stmt, 1, guid, -1, NULL);
-
-		if(_twitterdb_execute_statement(handle, stmt, TRUE, err) == SQLITE_DONE)
+		if(_twitterdb_execute_statement(handle, stmt, TRUE, err) == SQLITE_ROW)
 		{
+			*major_version = (gint)sqlite3_column_int(stmt, 0);
+			*minor_version = (gint)sqlite3_column_int(stmt, 1);
 			result = TRUE;
 		}
 
-		sqlite3_finalize(stmt);
+		_twitterdb_release_statement(handle, stmt);
 	}
 
-	g_static_mutex_unlock(&mutex_twitterdb);
+	g_mutex_unlock(handle->mutex);
 
 	return result;
 }
 
 gboolean
-twitterdb_map_listname(TwitterDbHandle *handle, const gchar * restrict owner, const gchar * restrict listname, gchar *guid, gint size, GError **err)
+twitterdb_map_username(TwitterDbHandle *handle, const gchar *username, gchar *guid, gint size, GError **err)
 {
 	sqlite3_stmt *stmt;
 	gboolean result = FALSE;
 
-	g_static_mutex_lock(&mutex_twitterdb);
+	g_mutex_lock(handle->mutex);
 
-	if(_twitterdb_prepare_statement(handle, twitterdb_queries_get_list_guid, &stmt, err))
+	if(_twitterdb_prepare_statement(handle, twitterdb_queries_map_username, &stmt, err))
 	{
-		sqlite3_bind_text(stmt, 1, listname, -1, NULL);
-		sqlite3_bind_text(stmt, 2, owner, -1, NULL);
+		sqlite3_bind_text(stmt, 1, username, -1, NULL);
 
 		if(_twitterdb_execute_statement(handle, stmt, TRUE, err) == SQLITE_ROW)
 		{
@@ -1176,782 +1472,2215 @@ twitterdb_map_listname(TwitterDbHandle *handle, const gchar * restrict owner, co
 			result = TRUE;
 		}
 
-		sqlite3_finalize(stmt);
+		_twitterdb_release_statement(handle, stmt);
 	}
 
-	g_static_mutex_unlock(&mutex_twitterdb);
+	g_mutex_unlock(handle->mutex);
 
 	return result;
 }
 
-GList *
-twitterdb_get_lists(TwitterDbHandle *handle, const gchar *user_guid, TwitterUser *user, GError **err)
+static void
+_twitterdb_bind_user(sqlite3_stmt *stmt, const gchar * restrict guid, const gchar * restrict username, const gchar * restrict realname, 
+                     const gchar * restrict image, const gchar * restrict location, const gchar * restrict website, const gchar * restrict description)
+{
+	_twitterdb_bind_guid(stmt, 1, guid);
+	sqlite3_bind_text(stmt, 2, username, -1, NULL);
+	sqlite3_bind_text(stmt, 3, realname, -1, NULL);
+	sqlite3_bind_text(stmt, 4, image, -1, NULL);
+	sqlite3_bind_text(stmt, 5, location, -1, NULL);
+	sqlite3_bind_text(stmt, 6, website, -1, NULL);
+	sqlite3_bind_text(stmt, 7, description, -1, NULL);
+}
+
+gboolean
+twitterdb_save_user(TwitterDbHandle *handle, const gchar * restrict guid, const gchar * restrict username, const gchar * restrict realname, 
+                   const gchar * restrict image, const gchar * restrict location, const gchar * restrict website, const gchar * restrict description, GError **err)
 {
 	sqlite3_stmt *stmt;
-	gint status;
-	TwitterList *list;
-	GList *lists = NULL;
-	static gint list_size = 0;
-	gboolean success = FALSE;
+	gboolean created = FALSE;
+	gboolean result = FALSE;
 
-	g_assert(handle != NULL);
-	g_assert(user_guid != NULL);
+	g_mutex_lock(handle->mutex);
 
-	if(!list_size)
+	/* create user if guid is unknown */
+	if(_twitterdb_prepare_statement(handle, twitterdb_queries_insert_user, &stmt, err))
 	{
-		list_size = sizeof(TwitterList);
-	}
+		_twitterdb_bind_user(stmt, guid, username, realname, image, location, website, description);
 
-	g_static_mutex_lock(&mutex_twitterdb);
+		if(_twitterdb_execute_statement(handle, stmt, TRUE, err) == SQLITE_DONE)
+		{
+			if((created = (sqlite3_changes(handle->db) > 0) ? TRUE : FALSE))
+			{
+				g_debug("Created user (\"%s\")", username);
+			}
 
-	/* get user details */
-	if(_twitterdb_get_user(handle, user_guid, user, err))
+			result = TRUE;
+		}
+
+		_twitterdb_release_statement(handle, stmt);
+	}
+
+	/* update existing user, the statement doesn't touch the row if the profile hasn't changed */
+	if(result && !created)
 	{
-		/* get list guids from database */
-		if(_twitterdb_prepare_statement(handle, twitterdb_queries_get_list_guids_from_user, &stmt, err))
+		result = FALSE;
+
+		if(_twitterdb_prepare_statement(handle, twitterdb_queries_update_user, &stmt, err))
 		{
-			sqlite3_bind_text(stmt, 1, user_guid, -1, NULL);
-			success = TRUE;
+			_twitterdb_bind_user(stmt, guid, username, realname, image, location, website, description);
 
-			while((status = _twitterdb_execute_statement(handle, stmt, TRUE, err)) != SQLITE_DONE)
+			if(_twitterdb_execute_statement(handle, stmt, TRUE, err) == SQLITE_DONE)
 			{
-				if(status == SQLITE_ROW)
-				{
-					/* get list details */
-					g_debug("Found list: %s", sqlite3_column_text(stmt, 0));
-					list = g_slice_alloc(list_size);
-			
-					if(_twitterdb_get_list(handle, (const gchar *)sqlite3_column_text(stmt, 0), list, err))
-					{
-						/* append details to list */
-						lists = g_list_append(lists, list);
-					}
-					else
-					{
-						g_slice_free1(list_size, list);
-						break;
-					}
-				}
-				else
+				if(sqlite3_changes(handle->db) > 0)
 				{
-					success = FALSE;
-					break;
+					g_debug("Updated user (\"%s\")", username);
 				}
+
+				result = TRUE;
 			}
 
-			sqlite3_finalize(stmt);
+			_twitterdb_release_statement(handle, stmt);
 		}
 	}
 
-	g_static_mutex_unlock(&mutex_twitterdb);
-
-	/* free list on failure */
-	if(!success && lists)
-	{
-		twitterdb_free_get_lists_result(lists);
-		lists = NULL;
-	}
+	g_mutex_unlock(handle->mutex);
 
-	return lists;
+	return result;
 }
 
 gboolean
-twitterdb_get_list(TwitterDbHandle *handle, const gchar * restrict owner, const gchar * restrict listname, TwitterList *list, GError **err)
+twitterdb_get_user_by_name(TwitterDbHandle *handle, const gchar *username, TwitterUser *user, GError **err)
 {
-	gchar guid[16];
+	gchar guid[32];
 	gboolean result = FALSE;
 
-
-	if(twitterdb_map_listname(handle, owner, listname, guid, 16, err))
+	if(twitterdb_map_username(handle, username, guid, 32, err))
 	{
-		g_static_mutex_lock(&mutex_twitterdb);
-		result = _twitterdb_get_list(handle, guid, list, err);
-		g_static_mutex_unlock(&mutex_twitterdb);
-
+		g_mutex_lock(handle->mutex);
+		result = _twitterdb_get_user(handle, guid, user, err);
+		g_mutex_unlock(handle->mutex);
 	}
 
 	return result;
 }
 
-void
-twitterdb_free_get_lists_result(GList *list)
+gboolean
+twitterdb_user_exists(TwitterDbHandle *handle, const gchar *user_guid, GError **err)
 {
-	GList *iter;
-	static gint list_size = 0;
+	sqlite3_stmt *stmt;
+	gboolean result = FALSE;
 
-	if(!list_size)
-	{
-		list_size = sizeof(TwitterList);
-	}
+	g_mutex_lock(handle->mutex);
 
-	if((iter = list))
+	if(_twitterdb_prepare_statement(handle, twitterdb_queries_user_exists, &stmt, err))
 	{
-		while(iter)
+		_twitterdb_bind_guid(stmt, 1, user_guid);
+
+		if(_twitterdb_execute_statement(handle, stmt, TRUE, err) == SQLITE_ROW)
 		{
-			g_slice_free1(list_size, iter->data);
-			iter = iter->next;
+			 if(sqlite3_column_int(stmt, 0) > 0)
+			 {
+				 result = TRUE;
+			 }
 		}
 
-		g_list_free(list);
+		_twitterdb_release_statement(handle, stmt);
 	}
+
+	g_mutex_unlock(handle->mutex);
+
+	return result;
 }
 
-gint
-twitterdb_get_list_membership(TwitterDbHandle *handle, const gchar *username, gchar ***accounts, gchar ***lists, GError **err)
+gboolean
+twitterdb_save_status(TwitterDbHandle *handle, const gchar * restrict guid, const gchar * restrict prev_status, const gchar * restrict user_guid, const gchar * restrict text, gint64 timestamp, gint *count, GError **err)
 {
 	sqlite3_stmt *stmt;
-	gint dbstatus;
-	gboolean count = -1;
-
-	g_assert(handle != NULL);
-	g_assert(username != NULL);
+	gboolean created = FALSE;
+	gboolean result = FALSE;
 
-	g_static_mutex_lock(&mutex_twitterdb);
+	g_mutex_lock(handle->mutex);
 
-	if(_twitterdb_prepare_statement(handle, twitterdb_queries_get_list_membership, &stmt, err))
+	/* insert status, existing statuses are ignored */
+	if(_twitterdb_prepare_statement(handle, twitterdb_queries_insert_status, &stmt, err))
 	{
-		sqlite3_bind_text(stmt, 1, username, -1, NULL);
-		count = 0;
+		_twitterdb_bind_guid(stmt, 1, guid);
+		_twitterdb_bind_guid(stmt, 2, prev_status);
+		sqlite3_bind_text(stmt, 3, text, -1, NULL);
+		_twitterdb_bind_guid(stmt, 4, user_guid);
+		sqlite3_bind_int(stmt, 5, (sqlite3_int64)timestamp);
 
-		while((dbstatus = _twitterdb_execute_statement(handle, stmt, TRUE, err)) != SQLITE_DONE)
+		if(_twitterdb_execute_statement(handle, stmt, TRUE, err) == SQLITE_DONE)
 		{
-			if(dbstatus == SQLITE_ROW)
+			if((created = (sqlite3_changes(handle->db) > 0) ? TRUE : FALSE))
 			{
-				++count;
-
-				*accounts = (gchar **)g_realloc(*accounts, sizeof(gchar **) * count);
-				*lists = (gchar **)g_realloc(*lists, sizeof(gchar **) * count);
-
-				(*accounts)[count - 1] = g_strdup((const gchar *)sqlite3_column_text(stmt, 0));
-				(*lists)[count - 1] = g_strdup((const gchar *)sqlite3_column_text(stmt, 1));
+				++(*count);
 			}
-			else
-			{
-				for(gint i = 0; i < count; ++count)
-				{
-					g_free((*accounts)[i]);
-					g_free((*lists)[i]);
-				}
-
-				g_free(*accounts);
-				g_free(*lists);
-				count = -1;
 
-				break;
-			}
+			result = TRUE;
 		}
 
-		sqlite3_finalize(stmt);
+		_twitterdb_release_statement(handle, stmt);
 	}
 
-	g_static_mutex_unlock(&mutex_twitterdb);
+	/* update full-text index */
+	if(created && _twitterdb_prepare_statement(handle, twitterdb_queries_insert_status_search, &stmt, err))
+	{
+		_twitterdb_bind_guid(stmt, 1, guid);
+		result = (_twitterdb_execute_statement(handle, stmt, TRUE, err) == SQLITE_DONE) ? TRUE : FALSE;
+		_twitterdb_release_statement(handle, stmt);
+	}
 
-	return count;
+	g_mutex_unlock(handle->mutex);
+
+	return result;
 }
 
 gboolean
-twitterdb_user_is_list_member(TwitterDbHandle *handle, const gchar * restrict owner, const gchar * restrict listname, const gchar * restrict username, GError **err)
+twitterdb_remove_status(TwitterDbHandle *handle, const gchar *guid, GError **err)
 {
 	sqlite3_stmt *stmt;
-	gint dbstatus;
-	gint count = 0;
-
-	g_assert(handle != NULL);
-	g_assert(username != NULL);
-	g_assert(listname != NULL);
+	gboolean result = FALSE;
 
-	g_static_mutex_lock(&mutex_twitterdb);
+	g_mutex_lock(handle->mutex);
 
-	if(_twitterdb_prepare_statement(handle, twitterdb_queries_user_is_list_member, &stmt, err))
+	if(_twitterdb_prepare_statement(handle, twitterdb_queries_delete_status, &stmt, err))
 	{
-		sqlite3_bind_text(stmt, 1, username, -1, NULL);
-		sqlite3_bind_text(stmt, 2, listname, -1, NULL);
-		sqlite3_bind_text(stmt, 3, owner, -1, NULL);
-		count = 0;
+		_twitterdb_bind_guid(stmt, 1, guid);
 
-		if((dbstatus = _twitterdb_execute_statement(handle, stmt, TRUE, err)) == SQLITE_ROW)
+		if(_twitterdb_execute_statement(handle, stmt, TRUE, err) == SQLITE_DONE)
 		{
-			count = sqlite3_column_int(stmt, 0);
+			result = TRUE;
 		}
-
-		sqlite3_finalize(stmt);
 	}
 
-	g_static_mutex_unlock(&mutex_twitterdb);
+	_twitterdb_release_statement(handle, stmt);
 
-	return count ? TRUE : FALSE;
+	g_mutex_unlock(handle->mutex);
+
+	return result;
 }
 
-gchar **
-twitterdb_get_lists_following_user(TwitterDbHandle *handle, const gchar *user_guid, GError **err)
+gboolean
+twitterdb_mark_timeline_read(TwitterDbHandle *handle, const gchar *username, TwitterDbTimelineType type, gint64 timestamp, GError **err)
 {
 	sqlite3_stmt *stmt;
-	gint status;
-	gboolean success = FALSE;
-	gint count = 0;
-	gchar **list_guids = NULL;
+	gboolean result = FALSE;
 
-	if(_twitterdb_prepare_statement(handle, twitterdb_queries_get_lists_following_user, &stmt, err))
+	g_mutex_lock(handle->mutex);
+
+	if(_twitterdb_prepare_statement(handle, twitterdb_queries_mark_timeline_read, &stmt, err))
 	{
-		sqlite3_bind_text(stmt, 1, user_guid, -1, NULL);
-		success = TRUE;
+		sqlite3_bind_int(stmt, 1, type);
+		sqlite3_bind_text(stmt, 2, username, -1, NULL);
+		sqlite3_bind_int64(stmt, 3, (sqlite3_int64)timestamp);
 
-		while((status = _twitterdb_execute_statement(handle, stmt, TRUE, err)) != SQLITE_DONE)
+		if(_twitterdb_execute_statement(handle, stmt, TRUE, err) == SQLITE_DONE)
 		{
-			if(status == SQLITE_ROW)
-			{
-				g_debug("Found list: %s", sqlite3_column_text(stmt, 0));
-				++count;
-				list_guids = (gchar **)g_realloc(list_guids, sizeof(gchar **) * count);
-				list_guids[count - 1] = g_strdup((gchar *)sqlite3_column_text(stmt, 0));
-			}
-			else
-			{
-				success = FALSE;
-				break;
-			}
+			result = TRUE;
 		}
 
-		sqlite3_finalize(stmt);
-
-		list_guids = (gchar **)g_realloc(list_guids, sizeof(gchar **) * (count + 1));
-		list_guids[count] = NULL;
-	}
-
-	if(!success && list_guids)
-	{
-		g_strfreev(list_guids);
-		list_guids = NULL;
+		_twitterdb_release_statement(handle, stmt);
 	}
 
-	return list_guids;
-}
-
-gboolean
-twitterdb_append_status_to_public_timeline(TwitterDbHandle *handle, const gchar * restrict user_guid, const gchar * restrict status_guid, GError **err)
-{
-	gboolean result;
-
-	g_static_mutex_lock(&mutex_twitterdb);
-	result = _twitterdb_add_status_to_timeline(handle, user_guid, status_guid, TWITTERDB_TIMELINE_TYPE_PUBLIC, err);
-	g_static_mutex_unlock(&mutex_twitterdb);
-
-	return result;
-}
-
-gboolean
-twitterdb_append_status_to_replies(TwitterDbHandle *handle, const gchar * restrict user_guid, const gchar * restrict status_guid, GError **err)
-{
-	gboolean result;
-
-	g_static_mutex_lock(&mutex_twitterdb);
-	result = _twitterdb_add_status_to_timeline(handle, user_guid, status_guid, TWITTERDB_TIMELINE_TYPE_REPLIES, err);
-	g_static_mutex_unlock(&mutex_twitterdb);
-
-	return result;
-}
-
-gboolean
-twitterdb_append_status_to_user_timeline(TwitterDbHandle *handle, const gchar * restrict user_guid, const gchar * restrict status_guid, GError **err)
-{
-	gboolean result;
-
-	g_static_mutex_lock(&mutex_twitterdb);
-	result = _twitterdb_add_status_to_timeline(handle, user_guid, status_guid, TWITTERDB_TIMELINE_TYPE_USER_TIMELINE, err);
-	g_static_mutex_unlock(&mutex_twitterdb);
+	g_mutex_unlock(handle->mutex);
 
 	return result;
 }
 
 gboolean
-twitterdb_append_status_to_list(TwitterDbHandle *handle, const gchar * restrict list_guid, const gchar * restrict status_guid, GError **err)
+twitterdb_mark_list_read(TwitterDbHandle *handle, const gchar * restrict username, const gchar * restrict list, gint64 timestamp, GError **err)
 {
 	sqlite3_stmt *stmt;
 	gboolean result = FALSE;
 
-	g_static_mutex_lock(&mutex_twitterdb);
+	g_mutex_lock(handle->mutex);
 
-	if(_twitterdb_prepare_statement(handle, twitterdb_queries_replace_into_list_timeline, &stmt, err))
+	if(_twitterdb_prepare_statement(handle, twitterdb_queries_mark_list_read, &stmt, err))
 	{
-		sqlite3_bind_text(stmt, 1, list_guid, -1, NULL);
-		sqlite3_bind_text(stmt, 2, status_guid, -1, NULL);
+		sqlite3_bind_text(stmt, 1, username, -1, NULL);
+		sqlite3_bind_text(stmt, 2, list, -1, NULL);
+		sqlite3_bind_int64(stmt, 3, (sqlite3_int64)timestamp);
 
 		if(_twitterdb_execute_statement(handle, stmt, TRUE, err) == SQLITE_DONE)
 		{
 			result = TRUE;
 		}
-	}
 
-	sqlite3_finalize(stmt);
+		_twitterdb_release_statement(handle, stmt);
+	}
 
-	g_static_mutex_unlock(&mutex_twitterdb);
+	g_mutex_unlock(handle->mutex);
 
 	return result;
 }
 
-gboolean
-twitterdb_status_exists(TwitterDbHandle *handle, const gchar *guid, GError **err)
+gint
+twitterdb_count_unread_in_timeline(TwitterDbHandle *handle, const gchar *username, TwitterDbTimelineType type, GError **err)
 {
 	sqlite3_stmt *stmt;
-	gboolean result = FALSE;
+	gint count = 0;
 
-	g_static_mutex_lock(&mutex_twitterdb);
+	g_mutex_lock(handle->mutex);
 
-	if(_twitterdb_prepare_statement(handle, twitterdb_queries_status_exists, &stmt, err))
+	if(_twitterdb_prepare_statement(handle, twitterdb_queries_count_unread_in_timeline, &stmt, err))
 	{
-		sqlite3_bind_text(stmt, 1, guid, -1, NULL);
+		sqlite3_bind_int(stmt, 1, type);
+		sqlite3_bind_text(stmt, 2, username, -1, NULL);
 
 		if(_twitterdb_execute_statement(handle, stmt, TRUE, err) == SQLITE_ROW)
 		{
-			 if(sqlite3_column_int(stmt, 0) > 0)
-			 {
-				 result = TRUE;
-			 }
+			count = sqlite3_column_int(stmt, 0);
 		}
 
-		sqlite3_finalize(stmt);
+		_twitterdb_release_statement(handle, stmt);
 	}
 
-	g_static_mutex_unlock(&mutex_twitterdb);
+	g_mutex_unlock(handle->mutex);
 
-	return result;
+	return count;
 }
 
-gboolean
-twitterdb_get_status(TwitterDbHandle *handle, const gchar *guid, TwitterStatus *status, TwitterUser *user, GError **err)
+gint
+twitterdb_count_unread_in_list(TwitterDbHandle *handle, const gchar * restrict username, const gchar * restrict list, GError **err)
 {
 	sqlite3_stmt *stmt;
-	gchar user_guid[32];
-	gboolean result = FALSE;
+	gint count = 0;
 
-	g_static_mutex_lock(&mutex_twitterdb);
+	g_mutex_lock(handle->mutex);
 
-	if(_twitterdb_prepare_statement(handle, twitterdb_queries_get_status, &stmt, err))
+	if(_twitterdb_prepare_statement(handle, twitterdb_queries_count_unread_in_list, &stmt, err))
 	{
-		memset(status, 0, sizeof(TwitterStatus));
-		sqlite3_bind_text(stmt, 1, guid, -1, NULL);
+		sqlite3_bind_text(stmt, 1, username, -1, NULL);
+		sqlite3_bind_text(stmt, 2, list, -1, NULL);
 
 		if(_twitterdb_execute_statement(handle, stmt, TRUE, err) == SQLITE_ROW)
 		{
-			g_strlcpy(status->id, guid, 32);
-			TWITTERDB_COPY_TEXT_COLUMN(user_guid, 1, 32);
-			status->timestamp = sqlite3_column_int(stmt, 1);
-			TWITTERDB_COPY_TEXT_COLUMN(status->text, 0, 280);
-			TWITTERDB_COPY_TEXT_COLUMN(status->prev_status, 3, 32);
-			result = TRUE;
+			count = sqlite3_column_int(stmt, 0);
 		}
 
-		sqlite3_finalize(stmt);
+		_twitterdb_release_statement(handle, stmt);
 	}
 
-	g_static_mutex_unlock(&mutex_twitterdb);
+	g_mutex_unlock(handle->mutex);
 
-	if(result)
-	{
-		result = _twitterdb_get_user(handle, user_guid, user, err);
-	}
+	return count;
+}
+
+GList *
+twitterdb_get_friends(TwitterDbHandle *handle, const gchar *user_guid, GError **err)
+{
+	GList *result;
+
+	g_mutex_lock(handle->mutex);
+	result = _twitterdb_get_followers(handle, user_guid, TRUE, err);
+	g_mutex_unlock(handle->mutex);
 
 	return result;
 }
 
-gboolean
-twitterdb_append_user_to_list(TwitterDbHandle *handle, const gchar * restrict list_guid, const gchar * restrict user_guid, GError **err)
+GList *
+twitterdb_get_followers(TwitterDbHandle *handle, const gchar *user_guid, GError **err)
 {
-	gboolean result;
+	GList *result;
 
-	g_static_mutex_lock(&mutex_twitterdb);
-	result = _twitterdb_update_list_member(handle, list_guid, user_guid, FALSE, err);
-	g_static_mutex_unlock(&mutex_twitterdb);
+	g_mutex_lock(handle->mutex);
+	result = _twitterdb_get_followers(handle, user_guid, FALSE, err);
+	g_mutex_unlock(handle->mutex);
 
 	return result;
 }
 
 gboolean
-twitterdb_remove_user_from_list(TwitterDbHandle *handle, const gchar * restrict list_guid, const gchar * restrict user_guid, GError **err)
+twitterdb_foreach_follower(TwitterDbHandle *handle, const gchar *user_guid, gboolean get_friends, TwitterProcessUserFunc func, gpointer user_data, GError **err)
 {
-	sqlite3_stmt *stmt;
-	gboolean result;
+	GList *ids;
+	GList *iter;
+	TwitterUser user;
+	gboolean result = TRUE;
 
-	g_static_mutex_lock(&mutex_twitterdb);
+	g_mutex_lock(handle->mutex);
 
-	/* remove list member */
-	if((result = _twitterdb_update_list_member(handle, list_guid, user_guid, TRUE, err)))
+	if((iter = ids = _twitterdb_get_followers(handle, user_guid, get_friends, err)))
 	{
-		/* remove obsolete statuses */
-		if(_twitterdb_prepare_statement(handle, twitterdb_queries_remove_obsolete_statuses_from_list, &stmt, err))
+		while(iter && !*err && result)
 		{
-			sqlite3_bind_text(stmt, 1, list_guid, -1, NULL);
-			sqlite3_bind_text(stmt, 2, list_guid, -1, NULL);
-			sqlite3_bind_text(stmt, 3, list_guid, -1, NULL);
-
-			if(_twitterdb_execute_statement(handle, stmt, TRUE, err) == SQLITE_DONE)
+			if((result = _twitterdb_get_user(handle, (const gchar *)iter->data, &user, err)))
 			{
-				result = TRUE;
+				func(user, user_data);
 			}
+					
+			iter = iter->next;
 		}
 
-		sqlite3_finalize(stmt);
+		g_list_foreach(ids, (GFunc)&g_free, NULL);
+		g_list_free(ids);
 	}
 
-	g_static_mutex_unlock(&mutex_twitterdb);
+	g_mutex_unlock(handle->mutex);
+
+	if(result && *err)
+	{
+		result = FALSE;
+	}
 
 	return result;
 }
 
 gboolean
-twitterdb_remove_users_from_list(TwitterDbHandle *handle, const gchar *list_guid, GError **err)
+twitterdb_add_follower(TwitterDbHandle *handle, const gchar * restrict user1_guid, const gchar * restrict user2_guid, GError **err)
 {
-	sqlite3_stmt *stmt;
-	gboolean result = FALSE;
-
-	g_static_mutex_lock(&mutex_twitterdb);
-
-	if(_twitterdb_prepare_statement(handle, twitterdb_queries_delete_list_members, &stmt, err))
-	{
-		sqlite3_bind_text(stmt, 1, list_guid, -1, NULL);
-
-		if(_twitterdb_execute_statement(handle, stmt, TRUE, err) == SQLITE_DONE)
-		{
-			result = TRUE;
-		}
-	}
-
-	sqlite3_finalize(stmt);
+	gboolean result;
 
-	g_static_mutex_unlock(&mutex_twitterdb);
+	g_mutex_lock(handle->mutex);
+	result = _twitterdb_update_follower(handle, user1_guid, user2_guid, FALSE, err);
+	g_mutex_unlock(handle->mutex);
 
 	return result;
 }
 
 gboolean
-twitterdb_list_exists(TwitterDbHandle *handle, const gchar * restrict owner, const gchar * restrict listname, GError **err)
-{
-	gchar guid[32];
-
-	return twitterdb_map_listname(handle, owner, listname, guid, 32, err);
-}
-
-gboolean
-twitterdb_save_direct_message(TwitterDbHandle *handle, const gchar * restrict guid, const gchar * restrict text, gint64 timestamp,
-                              const gchar * restrict sender_guid, const gchar * restrict receiver_guid, gint *count, GError **err)
+twitterdb_remove_follower(TwitterDbHandle *handle, const gchar * restrict user1_guid, const gchar * restrict user2_guid, GError **err)
 {
-	sqlite3_stmt *stmt;
-	gboolean exists = FALSE;
-	gboolean result = FALSE;
-
-	g_static_mutex_lock(&mutex_twitterdb);
-
-	/* check if direct message does already exist */
-	if(_twitterdb_prepare_statement(handle, twitterdb_queries_direct_message_exists, &stmt, err))
-	{
-		sqlite3_bind_text(stmt, 1, guid, -1, NULL);
-
-		if(_twitterdb_execute_statement(handle, stmt, TRUE, err) == SQLITE_ROW)
-		{
-			if(sqlite3_column_int(stmt, 0) == 0)
-			{
-				++(*count);
-			}
-			else
-			{
-				exists = TRUE;
-			}
-
-			result = TRUE;
-		}
-
-		sqlite3_finalize(stmt);
-	}
-
-	/* insert direct message */
-	if(!exists && result)
-	{
-		result = FALSE;
-
-		if(_twitterdb_prepare_statement(handle, twitterdb_queries_insert_direct_message, &stmt, err))
-		{
-			sqlite3_bind_text(stmt, 1, guid, -1, NULL);
-			sqlite3_bind_text(stmt, 2, text, -1, NULL);
-			sqlite3_bind_int(stmt, 3, (sqlite3_int64)timestamp);
-			sqlite3_bind_text(stmt, 4, sender_guid, -1, NULL);
-			sqlite3_bind_text(stmt, 5, receiver_guid, -1, NULL);
-			if(!(result = (_twitterdb_execute_statement(handle, stmt, TRUE, err) == SQLITE_DONE) ? TRUE : FALSE))
-			{
-				_twitterdb_set_error(err, handle);
-			}
-		}
-
-		sqlite3_finalize(stmt);
-	}
+	gboolean result;
 
-	g_static_mutex_unlock(&mutex_twitterdb);
+	g_mutex_lock(handle->mutex);
+	result = _twitterdb_update_follower(handle, user1_guid, user2_guid, TRUE, err);
+	g_mutex_unlock(handle->mutex);
 
 	return result;
 }
 
 gboolean
-twitterdb_foreach_status_in_public_timeline(TwitterDbHandle *handle, const gchar *username, TwitterProcessStatusFunc func, gboolean ignore_old, gpointer user_data, GCancellable *cancellable, GError **err)
+twitterdb_remove_friends(TwitterDbHandle *handle, const gchar *user_guid, GError **err)
 {
 	gboolean result;
 
-	result = _twitterdb_foreach_status_in_timeline_locked(handle, username, TWITTERDB_TIMELINE_TYPE_PUBLIC, func, ignore_old, user_data, cancellable, err);
+	g_mutex_lock(handle->mutex);
+	result = _twitterdb_remove_followers(handle, user_guid, TRUE, err);
+	g_mutex_unlock(handle->mutex);
 
 	return result;
 }
 
 gboolean
-twitterdb_foreach_status_in_replies(TwitterDbHandle *handle, const gchar *username, TwitterProcessStatusFunc func, gboolean ignore_old, gpointer user_data, GCancellable *cancellable, GError **err)
+twitterdb_remove_followers(TwitterDbHandle *handle, const gchar *user_guid, GError **err)
 {
 	gboolean result;
 
-	result = _twitterdb_foreach_status_in_timeline_locked(handle, username, TWITTERDB_TIMELINE_TYPE_REPLIES, func, ignore_old, user_data, cancellable, err);
+	g_mutex_lock(handle->mutex);
+	result = _twitterdb_remove_followers(handle, user_guid, FALSE, err);
+	g_mutex_unlock(handle->mutex);
 
 	return result;
-
 }
 
 gboolean
-twitterdb_foreach_status_in_usertimeline(TwitterDbHandle *handle, const gchar *username, TwitterProcessStatusFunc func, gboolean ignore_old, gpointer user_data, GCancellable *cancellable, GError **err)
+twitterdb_clear_staged_followers(TwitterDbHandle *handle, GError **err)
 {
-	gboolean result;
+	gboolean result = FALSE;
+
+	g_mutex_lock(handle->mutex);
+
+	if(_twitterdb_execute_non_query(handle, twitterdb_queries_create_staged_followers, err))
+	{
+		result = _twitterdb_execute_non_query(handle, twitterdb_queries_clear_staged_followers, err);
+	}
 
-	result = _twitterdb_foreach_status_in_timeline_locked(handle, username, TWITTERDB_TIMELINE_TYPE_USER_TIMELINE, func, ignore_old, user_data, cancellable, err);
+	g_mutex_unlock(handle->mutex);
 
 	return result;
 }
 
 gboolean
-twitterdb_foreach_status_in_list(TwitterDbHandle *handle, const gchar * restrict username, const gchar * restrict list, TwitterProcessStatusFunc func, gpointer user_data, GCancellable *cancellable, GError **err)
+twitterdb_stage_follower(TwitterDbHandle *handle, const gchar *user_guid, GError **err)
 {
 	sqlite3_stmt *stmt;
-	GList *tweets = NULL;
-	GList *users = NULL;
 	gboolean result = FALSE;
 
-	g_assert(handle != NULL);
-	g_assert(username != NULL);
-	g_assert(func != NULL);
-
-	/* get tweets */
-	g_static_mutex_lock(&mutex_twitterdb);
+	g_mutex_lock(handle->mutex);
 
-	if(_twitterdb_prepare_statement(handle, twitterdb_queries_get_tweets_from_list, &stmt, err))
+	if(_twitterdb_prepare_statement(handle, twitterdb_queries_insert_staged_follower, &stmt, err))
 	{
-		sqlite3_bind_text(stmt, 1, username, -1, NULL);
-		sqlite3_bind_text(stmt, 2, list, -1, NULL);
-		result = TRUE;
-
-		result = _twitterdb_fetch_tweets(handle, stmt, &tweets, &users, cancellable, err);
-		sqlite3_finalize(stmt);
-	}
+		_twitterdb_bind_guid(stmt, 1, user_guid);
 
-	g_static_mutex_unlock(&mutex_twitterdb);
+		if(_twitterdb_execute_statement(handle, stmt, TRUE, err) == SQLITE_DONE)
+		{
+			result = TRUE;
+		}
 
-	/* iterate result */
-	if(result)
-	{
-		_twitterdb_foreach_status(tweets, users, func, user_data, cancellable);
+		_twitterdb_release_statement(handle, stmt);
 	}
 
-	_twitterdb_free_list(tweets, sizeof(TwitterStatus));
-	_twitterdb_free_list(users, sizeof(TwitterUser));
+	g_mutex_unlock(handle->mutex);
 
 	return result;
 }
 
 gboolean
-twitterdb_foreach_list_member(TwitterDbHandle *handle, const gchar * restrict username, const gchar * restrict list, TwitterProcessListMemberFunc func, gpointer user_data, GCancellable *cancellable, GError **err)
+twitterdb_reconcile_followers(TwitterDbHandle *handle, const gchar *user_guid, gboolean friends, guint *added, guint *removed, GError **err)
 {
 	sqlite3_stmt *stmt;
-	gint dbstatus;
-	TwitterUser user;
 	gboolean result = FALSE;
 
 	g_assert(handle != NULL);
-	g_assert(username != NULL);
-	g_assert(func != NULL);
+	g_assert(user_guid != NULL);
 
-	g_static_mutex_lock(&mutex_twitterdb);
+	*added = 0;
+	*removed = 0;
 
-	memset(&user, 0, sizeof(user));
+	g_mutex_lock(handle->mutex);
 
-	if(_twitterdb_prepare_statement(handle, twitterdb_queries_get_list_members, &stmt, err))
+	/* remove friends/followers which haven't been fetched */
+	if(_twitterdb_prepare_statement(handle, friends ? twitterdb_queries_delete_unstaged_friends : twitterdb_queries_delete_unstaged_followers, &stmt, err))
 	{
-		sqlite3_bind_text(stmt, 1, username, -1, NULL);
-		sqlite3_bind_text(stmt, 2, list, -1, NULL);
-		result = TRUE;
+		_twitterdb_bind_guid(stmt, 1, user_guid);
 
-		while((dbstatus = _twitterdb_execute_statement(handle, stmt, TRUE, err)) != SQLITE_DONE)
+		if(_twitterdb_execute_statement(handle, stmt, TRUE, err) == SQLITE_DONE)
 		{
-			if(cancellable && g_cancellable_is_cancelled(cancellable))
-			{
-				g_debug("%s: cancelled", __func__);
-				result = FALSE;
-				break;
-			}
+			*removed = sqlite3_changes(handle->db);
+			result = TRUE;
+		}
 
-			if(dbstatus == SQLITE_ROW)
-			{
-				/* copy data */
-				TWITTERDB_COPY_TEXT_COLUMN(user.id, 0, 32);
-				TWITTERDB_COPY_TEXT_COLUMN(user.screen_name, 1, 64);
-				TWITTERDB_COPY_TEXT_COLUMN(user.name, 2, 64);
-				TWITTERDB_COPY_TEXT_COLUMN(user.image, 3, 256);
-				TWITTERDB_COPY_TEXT_COLUMN(user.location, 4, 64);
-				TWITTERDB_COPY_TEXT_COLUMN(user.url, 5, 256);
-				TWITTERDB_COPY_TEXT_COLUMN(user.description, 6, 280);
+		_twitterdb_release_statement(handle, stmt);
+	}
 
-				/* invoke callback */
-				func(user, user_data);
-			}
-			else
+	/* add fetched friends/followers with known user details */
+	if(result)
+	{
+		result = FALSE;
+
+		if(_twitterdb_prepare_statement(handle, friends ? twitterdb_queries_insert_staged_friends : twitterdb_queries_insert_staged_followers, &stmt, err))
+		{
+			_twitterdb_bind_guid(stmt, 1, user_guid);
+
+			if(_twitterdb_execute_statement(handle, stmt, TRUE, err) == SQLITE_DONE)
 			{
-				result = FALSE;
-				break;
+				*added = sqlite3_changes(handle->db);
+				result = TRUE;
 			}
-		}
 
-		sqlite3_finalize(stmt);
+			_twitterdb_release_statement(handle, stmt);
+		}
 	}
 
-	g_static_mutex_unlock(&mutex_twitterdb);
+	g_mutex_unlock(handle->mutex);
 
 	return result;
 }
 
-gint
-twitterdb_count_tweets_from_list(TwitterDbHandle *handle, const gchar *list_guid, GError **err)
+GList *
+twitterdb_get_unknown_staged_followers(TwitterDbHandle *handle, GError **err)
 {
 	sqlite3_stmt *stmt;
-	gint count = 0;
+	gint status;
+	GList *users = NULL;
+	gboolean success = FALSE;
 
-	g_static_mutex_lock(&mutex_twitterdb);
+	g_mutex_lock(handle->mutex);
 
-	if(_twitterdb_prepare_statement(handle, twitterdb_queries_count_tweets_from_list, &stmt, err))
+	if(_twitterdb_prepare_statement(handle, twitterdb_queries_get_unknown_staged_followers, &stmt, err))
 	{
-		sqlite3_bind_text(stmt, 1, list_guid, -1, NULL);
+		success = TRUE;
 
-		if(_twitterdb_execute_statement(handle, stmt, TRUE, err) == SQLITE_ROW)
+		while((status = _twitterdb_execute_statement(handle, stmt, TRUE, err)) != SQLITE_DONE)
 		{
-			count = sqlite3_column_int(stmt, 0);
+			if(status == SQLITE_ROW)
+			{
+				users = g_list_prepend(users, g_strdup((const gchar *)sqlite3_column_text(stmt, 0)));
+			}
+			else
+			{
+				success = FALSE;
+				break;
+			}
 		}
 
-		sqlite3_finalize(stmt);
+		_twitterdb_release_statement(handle, stmt);
 	}
 
-	g_static_mutex_unlock(&mutex_twitterdb);
+	g_mutex_unlock(handle->mutex);
 
-	return count;
+	/* free list on failure */
+	if(!success && users)
+	{
+		g_list_foreach(users, (GFunc)&g_free, NULL);
+		g_list_free(users);
+		users = NULL;
+	}
+
+	return users;
 }
 
-gint
-twitterdb_get_last_sync(TwitterDbHandle *handle, TwitterDbSyncSource source, const gchar *user_guid, gint default_val)
+gboolean
+twitterdb_is_follower(TwitterDbHandle *handle, const gchar * restrict user1, const gchar * restrict user2, GError **err)
 {
 	sqlite3_stmt *stmt;
-	gint result = default_val;
-	GError *err = NULL;
+	gint count;
+	gboolean result = FALSE;
 
-	g_static_mutex_lock(&mutex_twitterdb);
+	g_mutex_lock(handle->mutex);
 
-	if(_twitterdb_prepare_statement(handle, twitterdb_queries_get_sync_seconds, &stmt, &err))
+	if(_twitterdb_prepare_statement(handle, twitterdb_queries_is_follower, &stmt, err))
 	{
-		sqlite3_bind_int(stmt, 1, source);
-		sqlite3_bind_text(stmt, 2, user_guid, -1, NULL);
+		sqlite3_bind_text(stmt, 1, user1, -1, NULL);
+		sqlite3_bind_text(stmt, 2, user2, -1, NULL);
 
-		if(_twitterdb_execute_statement(handle, stmt, TRUE, &err) == SQLITE_ROW)
+		if(_twitterdb_execute_statement(handle, stmt, TRUE, err) == SQLITE_ROW)
 		{
-			result = sqlite3_column_int(stmt, 0);
+			if((count = sqlite3_column_int(stmt, 0)))
+			{
+				result = TRUE;
+			}
 		}
 
-		sqlite3_finalize(stmt);
+		_twitterdb_release_statement(handle, stmt);
 	}
 
-	g_static_mutex_unlock(&mutex_twitterdb);
-
-	if(err)
-	{
-		g_warning("%s", err->message);
-		g_error_free(err);
-	}
+	g_mutex_unlock(handle->mutex);
 
 	return result;
 }
 
-void
-twitterdb_set_last_sync(TwitterDbHandle *handle, TwitterDbSyncSource source, const gchar *user_guid, gint seconds)
+gboolean
+twitterdb_save_list(TwitterDbHandle *handle, const gchar * restrict guid, const gchar * restrict user_guid, const gchar * restrict listname, const gchar * restrict fullname,
+                    const gchar * restrict uri, const gchar * restrict description, gboolean protected, gint subscriber_count, gint member_count,
+                    GError **err)
 {
 	sqlite3_stmt *stmt;
-	GError *err = NULL;
+	gboolean result = FALSE;
+	gboolean success = FALSE;
+	gint count = 0;
 
-	g_static_mutex_lock(&mutex_twitterdb);
+	g_mutex_lock(handle->mutex);
 
-	if(_twitterdb_prepare_statement(handle, twitterdb_queries_replace_sync_seconds, &stmt, &err))
+	/* check if list does exist */
+	if(_twitterdb_prepare_statement(handle, twitterdb_queries_list_exists, &stmt, err))
 	{
-		sqlite3_bind_int(stmt, 1, source);
-		sqlite3_bind_text(stmt, 2, user_guid, -1, NULL);
-		sqlite3_bind_int(stmt, 3, seconds);
-		_twitterdb_execute_statement(handle, stmt, TRUE, &err);
-		sqlite3_finalize(stmt);
-	}
+		_twitterdb_bind_guid(stmt, 1, guid);
 
-	g_static_mutex_unlock(&mutex_twitterdb);
+		if(_twitterdb_execute_statement(handle, stmt, TRUE, err) == SQLITE_ROW)
+		{
+			count = sqlite3_column_int(stmt, 0);
+			success = TRUE;
+		}
 
-	if(err)
-	{
-		g_warning("%s", err->message);
-		g_error_free(err);
+		_twitterdb_release_statement(handle, stmt);
 	}
-}
 
-gboolean
-twitterdb_remove_last_sync_source(TwitterDbHandle *handle, TwitterDbSyncSource source, GError **err)
-{
+	if(success)
+	{
+		/* create or update list*/
+		success = FALSE;
+
+		if(count == 0)
+		{
+			g_debug("Creating list (\"%s\")", fullname);
+			if((success = _twitterdb_prepare_statement(handle, twitterdb_queries_insert_list, &stmt, err)))
+			{
+				_twitterdb_bind_guid(stmt, 1, guid);
+				_twitterdb_bind_guid(stmt, 2, user_guid);
+				sqlite3_bind_text(stmt, 3, listname, -1, NULL);
+				sqlite3_bind_text(stmt, 4, fullname, -1, NULL);
+				sqlite3_bind_int(stmt, 5, protected);
+				sqlite3_bind_text(stmt, 6, uri, -1, NULL);
+				sqlite3_bind_text(stmt, 7, description, -1, NULL);
+				sqlite3_bind_int(stmt, 8, subscriber_count);
+				sqlite3_bind_int(stmt, 9, member_count);
+			}
+		}
+		else
+		{
+			g_debug("Updating list (\"%s\")", fullname);
+			if((success = _twitterdb_prepare_statement(handle, twitterdb_queries_update_list, &stmt, err)))
+			{
+				_twitterdb_bind_guid(stmt, 1, user_guid);
+				sqlite3_bind_text(stmt, 2, listname, -1, NULL);
+				sqlite3_bind_text(stmt, 3, fullname, -1, NULL);
+				sqlite3_bind_int(stmt, 4, protected);
+				sqlite3_bind_text(stmt, 5, uri, -1, NULL);
+				sqlite3_bind_text(stmt, 6, description, -1, NULL);
+				sqlite3_bind_int(stmt, 7, subscriber_count);
+				sqlite3_bind_int(stmt, 8, member_count);
+				_twitterdb_bind_guid(stmt, 9, guid);
+			}
+		}
+
+
+		if(_twitterdb_execute_statement(handle, stmt, TRUE, err) == SQLITE_DONE)
+		{
+			result = TRUE;
+		}
+	}
+
+	if(success)
+	{
+		_twitterdb_release_statement(handle, stmt);
+	}
+
+	g_mutex_unlock(handle->mutex);
+
+	return result;
+}
+
+gboolean
+twitterdb_remove_list(TwitterDbHandle *handle, const gchar *guid, GError **err)
+{
 	sqlite3_stmt *stmt;
 	gboolean result = FALSE;
 
-	g_static_mutex_lock(&mutex_twitterdb);
+	g_mutex_lock(handle->mutex);
 
-	if(_twitterdb_prepare_statement(handle, twitterdb_queries_remove_sync_seconds, &stmt, err))
+	if(_twitterdb_prepare_statement(handle, twitterdb_queries_delete_list, &stmt, err))
 	{
-		sqlite3_bind_int(stmt, 1, source);
+		_twitterdb_bind_guid(stmt, 1, guid);
 
 		if(_twitterdb_execute_statement(handle, stmt, TRUE, err) == SQLITE_DONE)
 		{
 			result = TRUE;
 		}
+
+		_twitterdb_release_statement(handle, stmt);
 	}
 
-	sqlite3_finalize(stmt);
+	/* a list created later with the same guid has to be synchronized from scratch */
+	if(result && _twitterdb_prepare_statement(handle, twitterdb_queries_remove_since_id, &stmt, err))
+	{
+		sqlite3_bind_int(stmt, 1, TWITTERDB_SYNC_SOURCE_LIST_TIMELINE);
+		_twitterdb_bind_guid(stmt, 2, guid);
 
-	g_static_mutex_unlock(&mutex_twitterdb);
+		if(_twitterdb_execute_statement(handle, stmt, TRUE, err) != SQLITE_DONE)
+		{
+			result = FALSE;
+		}
+
+		_twitterdb_release_statement(handle, stmt);
+	}
+
+	if(result && _twitterdb_prepare_statement(handle, twitterdb_queries_remove_sync_gap, &stmt, err))
+	{
+		sqlite3_bind_int(stmt, 1, TWITTERDB_SYNC_SOURCE_LIST_TIMELINE);
+		_twitterdb_bind_guid(stmt, 2, guid);
+
+		if(_twitterdb_execute_statement(handle, stmt, TRUE, err) != SQLITE_DONE)
+		{
+			result = FALSE;
+		}
+
+		_twitterdb_release_statement(handle, stmt);
+	}
+
+	g_mutex_unlock(handle->mutex);
 
 	return result;
 }
 
 gboolean
-twitterdb_upgrade_0_1_to_0_2(TwitterDbHandle *handle, GError **err)
+twitterdb_map_listname(TwitterDbHandle *handle, const gchar * restrict owner, const gchar * restrict listname, gchar *guid, gint size, GError **err)
 {
 	sqlite3_stmt *stmt;
 	gboolean result = FALSE;
 
-	g_debug("Altering status table: \"%s\"", twitterdb_queries_add_prev_status_column);
-	if(_twitterdb_execute_non_query(handle, twitterdb_queries_add_prev_status_column, err))
+	g_mutex_lock(handle->mutex);
+
+	if(_twitterdb_prepare_statement(handle, twitterdb_queries_get_list_guid, &stmt, err))
 	{
-		g_debug("Updating version to 0.2");
-		if(_twitterdb_prepare_statement(handle, twitterdb_queries_replace_version, &stmt, err))
+		sqlite3_bind_text(stmt, 1, listname, -1, NULL);
+		sqlite3_bind_text(stmt, 2, owner, -1, NULL);
+
+		if(_twitterdb_execute_statement(handle, stmt, TRUE, err) == SQLITE_ROW)
 		{
-			sqlite3_bind_int(stmt, 1, 0);
-			sqlite3_bind_int(stmt, 2, 2);
-	
-			if(_twitterdb_execute_statement(handle, stmt, TRUE, err) == SQLITE_DONE)
+			g_strlcpy(guid, (const gchar *)sqlite3_column_text(stmt, 0), size);
+			result = TRUE;
+		}
+
+		_twitterdb_release_statement(handle, stmt);
+	}
+
+	g_mutex_unlock(handle->mutex);
+
+	return result;
+}
+
+GList *
+twitterdb_get_lists(TwitterDbHandle *handle, const gchar *user_guid, TwitterUser *user, GError **err)
+{
+	sqlite3_stmt *stmt;
+	gint status;
+	TwitterList *list;
+	GList *lists = NULL;
+	static gint list_size = 0;
+	gboolean success = FALSE;
+
+	g_assert(handle != NULL);
+	g_assert(user_guid != NULL);
+
+	if(!list_size)
+	{
+		list_size = sizeof(TwitterList);
+	}
+
+	g_mutex_lock(handle->mutex);
+
+	/* get user details */
+	if(_twitterdb_get_user(handle, user_guid, user, err))
+	{
+		/* get list guids from database */
+		if(_twitterdb_prepare_statement(handle, twitterdb_queries_get_list_guids_from_user, &stmt, err))
+		{
+			_twitterdb_bind_guid(stmt, 1, user_guid);
+			success = TRUE;
+
+			while((status = _twitterdb_execute_statement(handle, stmt, TRUE, err)) != SQLITE_DONE)
 			{
-				result = TRUE;
+				if(status == SQLITE_ROW)
+				{
+					/* get list details */
+					g_debug("Found list: %s", sqlite3_column_text(stmt, 0));
+					list = g_slice_alloc(list_size);
+			
+					if(_twitterdb_get_list(handle, (const gchar *)sqlite3_column_text(stmt, 0), list, err))
+					{
+						/* append details to list */
+						lists = g_list_append(lists, list);
+					}
+					else
+					{
+						g_slice_free1(list_size, list);
+						break;
+					}
+				}
+				else
+				{
+					success = FALSE;
+					break;
+				}
+			}
+
+			_twitterdb_release_statement(handle, stmt);
+		}
+	}
+
+	g_mutex_unlock(handle->mutex);
+
+	/* free list on failure */
+	if(!success && lists)
+	{
+		twitterdb_free_get_lists_result(lists);
+		lists = NULL;
+	}
+
+	return lists;
+}
+
+gboolean
+twitterdb_get_list(TwitterDbHandle *handle, const gchar * restrict owner, const gchar * restrict listname, TwitterList *list, GError **err)
+{
+	gchar guid[16];
+	gboolean result = FALSE;
+
+
+	if(twitterdb_map_listname(handle, owner, listname, guid, 16, err))
+	{
+		g_mutex_lock(handle->mutex);
+		result = _twitterdb_get_list(handle, guid, list, err);
+		g_mutex_unlock(handle->mutex);
+
+	}
+
+	return result;
+}
+
+void
+twitterdb_free_get_lists_result(GList *list)
+{
+	GList *iter;
+	static gint list_size = 0;
+
+	if(!list_size)
+	{
+		list_size = sizeof(TwitterList);
+	}
+
+	if((iter = list))
+	{
+		while(iter)
+		{
+			g_slice_free1(list_size, iter->data);
+			iter = iter->next;
+		}
+
+		g_list_free(list);
+	}
+}
+
+gint
+twitterdb_get_list_membership(TwitterDbHandle *handle, const gchar *username, gchar ***accounts, gchar ***lists, GError **err)
+{
+	sqlite3_stmt *stmt;
+	gint dbstatus;
+	gboolean count = -1;
+	gint i;
+
+	g_assert(handle != NULL);
+	g_assert(username != NULL);
+
+	g_mutex_lock(handle->mutex);
+
+	if(_twitterdb_prepare_statement(handle, twitterdb_queries_get_list_membership, &stmt, err))
+	{
+		sqlite3_bind_text(stmt, 1, username, -1, NULL);
+		count = 0;
+
+		while((dbstatus = _twitterdb_execute_statement(handle, stmt, TRUE, err)) != SQLITE_DONE)
+		{
+			if(dbstatus == SQLITE_ROW)
+			{
+				++count;
+
+				*accounts = (gchar **)g_realloc(*accounts, sizeof(gchar **) * count);
+				*lists = (gchar **)g_realloc(*lists, sizeof(gchar **) * count);
+
+				(*accounts)[count - 1] = g_strdup((const gchar *)sqlite3_column_text(stmt, 0));
+				(*lists)[count - 1] = g_strdup((const gchar *)sqlite3_column_text(stmt, 1));
 			}
+			else
+			{
+				for(i = 0; i < count; ++i)
+				{
+					g_free((*accounts)[i]);
+					g_free((*lists)[i]);
+				}
+
+				g_free(*accounts);
+				g_free(*lists);
+				count = -1;
 
-			sqlite3_finalize(stmt);
+				break;
+			}
 		}
+
+		_twitterdb_release_statement(handle, stmt);
 	}
 
+	g_mutex_unlock(handle->mutex);
+
+	return count;
+}
+
+gboolean
+twitterdb_user_is_list_member(TwitterDbHandle *handle, const gchar * restrict owner, const gchar * restrict listname, const gchar * restrict username, GError **err)
+{
+	sqlite3_stmt *stmt;
+	gint dbstatus;
+	gint count = 0;
+
+	g_assert(handle != NULL);
+	g_assert(username != NULL);
+	g_assert(listname != NULL);
+
+	g_mutex_lock(handle->mutex);
+
+	if(_twitterdb_prepare_statement(handle, twitterdb_queries_user_is_list_member, &stmt, err))
+	{
+		sqlite3_bind_text(stmt, 1, username, -1, NULL);
+		sqlite3_bind_text(stmt, 2, listname, -1, NULL);
+		sqlite3_bind_text(stmt, 3, owner, -1, NULL);
+		count = 0;
+
+		if((dbstatus = _twitterdb_execute_statement(handle, stmt, TRUE, err)) == SQLITE_ROW)
+		{
+			count = sqlite3_column_int(stmt, 0);
+		}
+
+		_twitterdb_release_statement(handle, stmt);
+	}
+
+	g_mutex_unlock(handle->mutex);
+
+	return count ? TRUE : FALSE;
+}
+
+gchar **
+twitterdb_get_lists_following_user(TwitterDbHandle *handle, const gchar *user_guid, GError **err)
+{
+	sqlite3_stmt *stmt;
+	gint status;
+	gboolean success = FALSE;
+	gint count = 0;
+	gchar **list_guids = NULL;
+
+	g_mutex_lock(handle->mutex);
+
+	if(_twitterdb_prepare_statement(handle, twitterdb_queries_get_lists_following_user, &stmt, err))
+	{
+		_twitterdb_bind_guid(stmt, 1, user_guid);
+		success = TRUE;
+
+		while((status = _twitterdb_execute_statement(handle, stmt, TRUE, err)) != SQLITE_DONE)
+		{
+			if(status == SQLITE_ROW)
+			{
+				g_debug("Found list: %s", sqlite3_column_text(stmt, 0));
+				++count;
+				list_guids = (gchar **)g_realloc(list_guids, sizeof(gchar **) * count);
+				list_guids[count - 1] = g_strdup((gchar *)sqlite3_column_text(stmt, 0));
+			}
+			else
+			{
+				success = FALSE;
+				break;
+			}
+		}
+
+		_twitterdb_release_statement(handle, stmt);
+
+		list_guids = (gchar **)g_realloc(list_guids, sizeof(gchar **) * (count + 1));
+		list_guids[count] = NULL;
+	}
+
+	g_mutex_unlock(handle->mutex);
+
+	if(!success && list_guids)
+	{
+		g_strfreev(list_guids);
+		list_guids = NULL;
+	}
+
+	return list_guids;
+}
+
+gboolean
+twitterdb_append_status_to_public_timeline(TwitterDbHandle *handle, const gchar * restrict user_guid, const gchar * restrict status_guid, GError **err)
+{
+	gboolean result;
+
+	g_mutex_lock(handle->mutex);
+	result = _twitterdb_add_status_to_timeline(handle, user_guid, status_guid, TWITTERDB_TIMELINE_TYPE_PUBLIC, err);
+	g_mutex_unlock(handle->mutex);
+
+	return result;
+}
+
+gboolean
+twitterdb_append_status_to_replies(TwitterDbHandle *handle, const gchar * restrict user_guid, const gchar * restrict status_guid, GError **err)
+{
+	gboolean result;
+
+	g_mutex_lock(handle->mutex);
+	result = _twitterdb_add_status_to_timeline(handle, user_guid, status_guid, TWITTERDB_TIMELINE_TYPE_REPLIES, err);
+	g_mutex_unlock(handle->mutex);
+
+	return result;
+}
+
+gboolean
+twitterdb_append_status_to_user_timeline(TwitterDbHandle *handle, const gchar * restrict user_guid, const gchar * restrict status_guid, GError **err)
+{
+	gboolean result;
+
+	g_mutex_lock(handle->mutex);
+	result = _twitterdb_add_status_to_timeline(handle, user_guid, status_guid, TWITTERDB_TIMELINE_TYPE_USER_TIMELINE, err);
+	g_mutex_unlock(handle->mutex);
+
+	return result;
+}
+
+gboolean
+twitterdb_append_status_to_list(TwitterDbHandle *handle, const gchar * restrict list_guid, const gchar * restrict status_guid, GError **err)
+{
+	sqlite3_stmt *stmt;
+	gboolean result = FALSE;
+
+	g_mutex_lock(handle->mutex);
+
+	if(_twitterdb_prepare_statement(handle, twitterdb_queries_insert_into_list_timeline, &stmt, err))
+	{
+		_twitterdb_bind_guid(stmt, 1, list_guid);
+		_twitterdb_bind_guid(stmt, 2, status_guid);
+		_twitterdb_bind_guid(stmt, 3, status_guid);
+
+		if(_twitterdb_execute_statement(handle, stmt, TRUE, err) == SQLITE_DONE)
+		{
+			result = TRUE;
+		}
+	}
+
+	_twitterdb_release_statement(handle, stmt);
+
+	g_mutex_unlock(handle->mutex);
+
+	return result;
+}
+
+gboolean
+twitterdb_status_exists(TwitterDbHandle *handle, const gchar *guid, GError **err)
+{
+	sqlite3_stmt *stmt;
+	gboolean result = FALSE;
+
+	g_mutex_lock(handle->mutex);
+
+	if(_twitterdb_prepare_statement(handle, twitterdb_queries_status_exists, &stmt, err))
+	{
+		_twitterdb_bind_guid(stmt, 1, guid);
+
+		if(_twitterdb_execute_statement(handle, stmt, TRUE, err) == SQLITE_ROW)
+		{
+			 if(sqlite3_column_int(stmt, 0) > 0)
+			 {
+				 result = TRUE;
+			 }
+		}
+
+		_twitterdb_release_statement(handle, stmt);
+	}
+
+	g_mutex_unlock(handle->mutex);
+
+	return result;
+}
+
+gboolean
+twitterdb_get_status(TwitterDbHandle *handle, const gchar *guid, TwitterStatus *status, TwitterUser *user, GError **err)
+{
+	sqlite3_stmt *stmt;
+	gchar user_guid[32];
+	gboolean result = FALSE;
+
+	g_mutex_lock(handle->mutex);
+
+	if(_twitterdb_prepare_statement(handle, twitterdb_queries_get_status, &stmt, err))
+	{
+		memset(status, 0, sizeof(TwitterStatus));
+		_twitterdb_bind_guid(stmt, 1, guid);
+
+		if(_twitterdb_execute_statement(handle, stmt, TRUE, err) == SQLITE_ROW)
+		{
+			g_strlcpy(status->id, guid, 32);
+			TWITTERDB_COPY_TEXT_COLUMN(user_guid, 1, 32);
+			status->timestamp = sqlite3_column_int(stmt, 1);
+			TWITTERDB_COPY_TEXT_COLUMN(status->text, 0, 280);
+			TWITTERDB_COPY_TEXT_COLUMN(status->prev_status, 3, 32);
+			result = TRUE;
+		}
+
+		_twitterdb_release_statement(handle, stmt);
+	}
+
+	if(result)
+	{
+		result = _twitterdb_get_user(handle, user_guid, user, err);
+	}
+
+	g_mutex_unlock(handle->mutex);
+
+	return result;
+}
+
+gboolean
+twitterdb_append_user_to_list(TwitterDbHandle *handle, const gchar * restrict list_guid, const gchar * restrict user_guid, GError **err)
+{
+	gboolean result;
+
+	g_mutex_lock(handle->mutex);
+	result = _twitterdb_update_list_member(handle, list_guid, user_guid, FALSE, err);
+	g_mutex_unlock(handle->mutex);
+
+	return result;
+}
+
+gboolean
+twitterdb_remove_user_from_list(TwitterDbHandle *handle, const gchar * restrict list_guid, const gchar * restrict user_guid, GError **err)
+{
+	sqlite3_stmt *stmt;
+	gboolean result;
+
+	g_mutex_lock(handle->mutex);
+
+	/* remove list member */
+	if((result = _twitterdb_update_list_member(handle, list_guid, user_guid, TRUE, err)))
+	{
+		/* remove obsolete statuses */
+		if(_twitterdb_prepare_statement(handle, twitterdb_queries_remove_obsolete_statuses_from_list, &stmt, err))
+		{
+			_twitterdb_bind_guid(stmt, 1, list_guid);
+			_twitterdb_bind_guid(stmt, 2, list_guid);
+			_twitterdb_bind_guid(stmt, 3, list_guid);
+
+			if(_twitterdb_execute_statement(handle, stmt, TRUE, err) == SQLITE_DONE)
+			{
+				result = TRUE;
+			}
+		}
+
+		_twitterdb_release_statement(handle, stmt);
+	}
+
+	g_mutex_unlock(handle->mutex);
+
+	return result;
+}
+
+gboolean
+twitterdb_remove_users_from_list(TwitterDbHandle *handle, const gchar *list_guid, GError **err)
+{
+	sqlite3_stmt *stmt;
+	gboolean result = FALSE;
+
+	g_mutex_lock(handle->mutex);
+
+	if(_twitterdb_prepare_statement(handle, twitterdb_queries_delete_list_members, &stmt, err))
+	{
+		_twitterdb_bind_guid(stmt, 1, list_guid);
+
+		if(_twitterdb_execute_statement(handle, stmt, TRUE, err) == SQLITE_DONE)
+		{
+			result = TRUE;
+		}
+	}
+
+	_twitterdb_release_statement(handle, stmt);
+
+	g_mutex_unlock(handle->mutex);
+
+	return result;
+}
+
+gboolean
+twitterdb_clear_staged_list_members(TwitterDbHandle *handle, const gchar *list_guid, GError **err)
+{
+	sqlite3_stmt *stmt;
+	gboolean result = FALSE;
+
+	g_mutex_lock(handle->mutex);
+
+	if(_twitterdb_execute_non_query(handle, twitterdb_queries_create_staged_list_members, err))
+	{
+		if(_twitterdb_prepare_statement(handle, twitterdb_queries_clear_staged_list_members, &stmt, err))
+		{
+			_twitterdb_bind_guid(stmt, 1, list_guid);
+
+			if(_twitterdb_execute_statement(handle, stmt, TRUE, err) == SQLITE_DONE)
+			{
+				result = TRUE;
+			}
+
+			_twitterdb_release_statement(handle, stmt);
+		}
+	}
+
+	g_mutex_unlock(handle->mutex);
+
+	return result;
+}
+
+gboolean
+twitterdb_stage_list_member(TwitterDbHandle *handle, const gchar * restrict list_guid, const gchar * restrict user_guid, GError **err)
+{
+	sqlite3_stmt *stmt;
+	gboolean result = FALSE;
+
+	g_mutex_lock(handle->mutex);
+
+	if(_twitterdb_prepare_statement(handle, twitterdb_queries_insert_staged_list_member, &stmt, err))
+	{
+		_twitterdb_bind_guid(stmt, 1, list_guid);
+		_twitterdb_bind_guid(stmt, 2, user_guid);
+
+		if(_twitterdb_execute_statement(handle, stmt, TRUE, err) == SQLITE_DONE)
+		{
+			result = TRUE;
+		}
+
+		_twitterdb_release_statement(handle, stmt);
+	}
+
+	g_mutex_unlock(handle->mutex);
+
+	return result;
+}
+
+gboolean
+twitterdb_reconcile_list_members(TwitterDbHandle *handle, const gchar *list_guid, guint *added, guint *removed, GError **err)
+{
+	sqlite3_stmt *stmt;
+	gboolean result = FALSE;
+
+	g_assert(handle != NULL);
+	g_assert(list_guid != NULL);
+
+	*added = 0;
+	*removed = 0;
+
+	g_mutex_lock(handle->mutex);
+
+	/* remove members which haven't been fetched */
+	if(_twitterdb_prepare_statement(handle, twitterdb_queries_delete_unstaged_list_members, &stmt, err))
+	{
+		_twitterdb_bind_guid(stmt, 1, list_guid);
+
+		if(_twitterdb_execute_statement(handle, stmt, TRUE, err) == SQLITE_DONE)
+		{
+			*removed = sqlite3_changes(handle->db);
+			result = TRUE;
+		}
+
+		_twitterdb_release_statement(handle, stmt);
+	}
+
+	/* add fetched members with known user details */
+	if(result)
+	{
+		result = FALSE;
+
+		if(_twitterdb_prepare_statement(handle, twitterdb_queries_insert_staged_list_members, &stmt, err))
+		{
+			_twitterdb_bind_guid(stmt, 1, list_guid);
+
+			if(_twitterdb_execute_statement(handle, stmt, TRUE, err) == SQLITE_DONE)
+			{
+				*added = sqlite3_changes(handle->db);
+				result = TRUE;
+			}
+
+			_twitterdb_release_statement(handle, stmt);
+		}
+	}
+
+	g_mutex_unlock(handle->mutex);
+
+	return result;
+}
+
+gboolean
+twitterdb_list_exists(TwitterDbHandle *handle, const gchar * restrict owner, const gchar * restrict listname, GError **err)
+{
+	gchar guid[32];
+
+	return twitterdb_map_listname(handle, owner, listname, guid, 32, err);
+}
+
+gboolean
+twitterdb_save_direct_message(TwitterDbHandle *handle, const gchar * restrict guid, const gchar * restrict text, gint64 timestamp,
+                              const gchar * restrict sender_guid, const gchar * restrict receiver_guid, gint *count, GError **err)
+{
+	sqlite3_stmt *stmt;
+	gboolean exists = FALSE;
+	gboolean result = FALSE;
+
+	g_mutex_lock(handle->mutex);
+
+	/* check if direct message does already exist */
+	if(_twitterdb_prepare_statement(handle, twitterdb_queries_direct_message_exists, &stmt, err))
+	{
+		_twitterdb_bind_guid(stmt, 1, guid);
+
+		if(_twitterdb_execute_statement(handle, stmt, TRUE, err) == SQLITE_ROW)
+		{
+			if(sqlite3_column_int(stmt, 0) == 0)
+			{
+				++(*count);
+			}
+			else
+			{
+				exists = TRUE;
+			}
+
+			result = TRUE;
+		}
+
+		_twitterdb_release_statement(handle, stmt);
+	}
+
+	/* insert direct message */
+	if(!exists && result)
+	{
+		result = FALSE;
+
+		if(_twitterdb_prepare_statement(handle, twitterdb_queries_insert_direct_message, &stmt, err))
+		{
+			_twitterdb_bind_guid(stmt, 1, guid);
+			sqlite3_bind_text(stmt, 2, text, -1, NULL);
+			sqlite3_bind_int(stmt, 3, (sqlite3_int64)timestamp);
+			_twitterdb_bind_guid(stmt, 4, sender_guid);
+			_twitterdb_bind_guid(stmt, 5, receiver_guid);
+			if(!(result = (_twitterdb_execute_statement(handle, stmt, TRUE, err) == SQLITE_DONE) ? TRUE : FALSE))
+			{
+				_twitterdb_set_error(err, handle);
+			}
+		}
+
+		_twitterdb_release_statement(handle, stmt);
+	}
+
+	g_mutex_unlock(handle->mutex);
+
+	return result;
+}
+
+gboolean
+twitterdb_foreach_status_in_public_timeline(TwitterDbHandle *handle, const gchar *username, TwitterProcessStatusFunc func, gboolean ignore_old,
+                                 gint before_timestamp, const gchar *before_guid, gint count, gpointer user_data, GCancellable *cancellable, GError **err)
+{
+	gboolean result;
+
+	result = _twitterdb_foreach_status_in_timeline_locked(handle, username, TWITTERDB_TIMELINE_TYPE_PUBLIC, func, ignore_old, before_timestamp, before_guid, count, user_data, cancellable, err);
+
+	return result;
+}
+
+gboolean
+twitterdb_foreach_status_in_replies(TwitterDbHandle *handle, const gchar *username, TwitterProcessStatusFunc func, gboolean ignore_old,
+                                 gint before_timestamp, const gchar *before_guid, gint count, gpointer user_data, GCancellable *cancellable, GError **err)
+{
+	gboolean result;
+
+	result = _twitterdb_foreach_status_in_timeline_locked(handle, username, TWITTERDB_TIMELINE_TYPE_REPLIES, func, ignore_old, before_timestamp, before_guid, count, user_data, cancellable, err);
+
+	return result;
+
+}
+
+gboolean
+twitterdb_foreach_status_in_usertimeline(TwitterDbHandle *handle, const gchar *username, TwitterProcessStatusFunc func, gboolean ignore_old,
+                                 gint before_timestamp, const gchar *before_guid, gint count, gpointer user_data, GCancellable *cancellable, GError **err)
+{
+	gboolean result;
+
+	result = _twitterdb_foreach_status_in_timeline_locked(handle, username, TWITTERDB_TIMELINE_TYPE_USER_TIMELINE, func, ignore_old, before_timestamp, before_guid, count, user_data, cancellable, err);
+
+	return result;
+}
+
+gboolean
+twitterdb_foreach_status_in_list(TwitterDbHandle *handle, const gchar * restrict username, const gchar * restrict list, TwitterProcessStatusFunc func,
+                                 gint before_timestamp, const gchar *before_guid, gint count, gpointer user_data, GCancellable *cancellable, GError **err)
+{
+	sqlite3_stmt *stmt;
+	GList *tweets = NULL;
+	GList *users = NULL;
+	gboolean result = FALSE;
+
+	g_assert(handle != NULL);
+	g_assert(username != NULL);
+	g_assert(func != NULL);
+
+	g_return_val_if_fail(count > 0, FALSE);
+
+	/* get tweets */
+	g_mutex_lock(handle->mutex);
+
+	if(_twitterdb_prepare_statement(handle, twitterdb_queries_get_tweets_from_list, &stmt, err))
+	{
+		sqlite3_bind_text(stmt, 1, username, -1, NULL);
+		sqlite3_bind_text(stmt, 2, list, -1, NULL);
+		_twitterdb_bind_page(stmt, 3, before_timestamp, before_guid, count);
+		result = TRUE;
+
+		result = _twitterdb_fetch_tweets(handle, stmt, &tweets, &users, cancellable, err);
+		_twitterdb_release_statement(handle, stmt);
+	}
+
+	g_mutex_unlock(handle->mutex);
+
+	/* iterate result */
+	if(result)
+	{
+		_twitterdb_foreach_status(tweets, users, func, user_data, cancellable);
+	}
+
+	_twitterdb_free_list(tweets, sizeof(TwitterStatus));
+	_twitterdb_free_list(users, sizeof(TwitterUser));
+
+	return result;
+}
+
+gboolean
+twitterdb_foreach_status_matching(TwitterDbHandle *handle, const gchar *query, TwitterProcessStatusFunc func, gint count, gpointer user_data, GCancellable *cancellable, GError **err)
+{
+	sqlite3_stmt *stmt;
+	gchar *expr;
+	GList *tweets = NULL;
+	GList *users = NULL;
+	gboolean result = FALSE;
+
+	g_assert(handle != NULL);
+	g_assert(query != NULL);
+	g_assert(func != NULL);
+
+	g_return_val_if_fail(count > 0, FALSE);
+
+	if(!(expr = _twitterdb_build_match_expression(query)))
+	{
+		/* query doesn't contain any searchable word */
+		return TRUE;
+	}
+
+	g_debug("Searching full-text index: %s", expr);
+
+	/* get tweets */
+	g_mutex_lock(handle->mutex);
+
+	if(_twitterdb_prepare_statement(handle, twitterdb_queries_search_statuses, &stmt, err))
+	{
+		sqlite3_bind_text(stmt, 1, expr, -1, NULL);
+		sqlite3_bind_int(stmt, 2, count);
+
+		result = _twitterdb_fetch_tweets(handle, stmt, &tweets, &users, cancellable, err);
+		_twitterdb_release_statement(handle, stmt);
+	}
+
+	g_mutex_unlock(handle->mutex);
+
+	/* iterate result */
+	if(result)
+	{
+		_twitterdb_foreach_status(tweets, users, func, user_data, cancellable);
+	}
+
+	_twitterdb_free_list(tweets, sizeof(TwitterStatus));
+	_twitterdb_free_list(users, sizeof(TwitterUser));
+	g_free(expr);
+
+	return result;
+}
+
+gboolean
+twitterdb_foreach_list_member(TwitterDbHandle *handle, const gchar * restrict username, const gchar * restrict list, TwitterProcessListMemberFunc func, gpointer user_data, GCancellable *cancellable, GError **err)
+{
+	sqlite3_stmt *stmt;
+	gint dbstatus;
+	TwitterUser user;
+	gboolean result = FALSE;
+
+	g_assert(handle != NULL);
+	g_assert(username != NULL);
+	g_assert(func != NULL);
+
+	g_mutex_lock(handle->mutex);
+
+	memset(&user, 0, sizeof(user));
+
+	if(_twitterdb_prepare_statement(handle, twitterdb_queries_get_list_members, &stmt, err))
+	{
+		sqlite3_bind_text(stmt, 1, username, -1, NULL);
+		sqlite3_bind_text(stmt, 2, list, -1, NULL);
+		result = TRUE;
+
+		while((dbstatus = _twitterdb_execute_statement(handle, stmt, TRUE, err)) != SQLITE_DONE)
+		{
+			if(cancellable && g_cancellable_is_cancelled(cancellable))
+			{
+				g_debug("%s: cancelled", __func__);
+				result = FALSE;
+				break;
+			}
+
+			if(dbstatus == SQLITE_ROW)
+			{
+				/* copy data */
+				TWITTERDB_COPY_TEXT_COLUMN(user.id, 0, 32);
+				TWITTERDB_COPY_TEXT_COLUMN(user.screen_name, 1, 64);
+				TWITTERDB_COPY_TEXT_COLUMN(user.name, 2, 64);
+				TWITTERDB_COPY_TEXT_COLUMN(user.image, 3, 256);
+				TWITTERDB_COPY_TEXT_COLUMN(user.location, 4, 64);
+				TWITTERDB_COPY_TEXT_COLUMN(user.url, 5, 256);
+				TWITTERDB_COPY_TEXT_COLUMN(user.description, 6, 280);
+
+				/* invoke callback */
+				func(user, user_data);
+			}
+			else
+			{
+				result = FALSE;
+				break;
+			}
+		}
+
+		_twitterdb_release_statement(handle, stmt);
+	}
+
+	g_mutex_unlock(handle->mutex);
+
+	return result;
+}
+
+gint
+twitterdb_count_tweets_from_list(TwitterDbHandle *handle, const gchar *list_guid, GError **err)
+{
+	sqlite3_stmt *stmt;
+	gint count = 0;
+
+	g_mutex_lock(handle->mutex);
+
+	if(_twitterdb_prepare_statement(handle, twitterdb_queries_count_tweets_from_list, &stmt, err))
+	{
+		_twitterdb_bind_guid(stmt, 1, list_guid);
+
+		if(_twitterdb_execute_statement(handle, stmt, TRUE, err) == SQLITE_ROW)
+		{
+			count = sqlite3_column_int(stmt, 0);
+		}
+
+		_twitterdb_release_statement(handle, stmt);
+	}
+
+	g_mutex_unlock(handle->mutex);
+
+	return count;
+}
+
+gint
+twitterdb_get_last_sync(TwitterDbHandle *handle, TwitterDbSyncSource source, const gchar *user_guid, gint default_val)
+{
+	sqlite3_stmt *stmt;
+	gint result = default_val;
+	GError *err = NULL;
+
+	g_mutex_lock(handle->mutex);
+
+	if(_twitterdb_prepare_statement(handle, twitterdb_queries_get_sync_seconds, &stmt, &err))
+	{
+		sqlite3_bind_int(stmt, 1, source);
+		_twitterdb_bind_guid(stmt, 2, user_guid);
+
+		if(_twitterdb_execute_statement(handle, stmt, TRUE, &err) == SQLITE_ROW)
+		{
+			result = sqlite3_column_int(stmt, 0);
+		}
+
+		_twitterdb_release_statement(handle, stmt);
+	}
+
+	g_mutex_unlock(handle->mutex);
+
+	if(err)
+	{
+		g_warning("%s", err->message);
+		g_error_free(err);
+	}
+
+	return result;
+}
+
+void
+twitterdb_set_last_sync(TwitterDbHandle *handle, TwitterDbSyncSource source, const gchar *user_guid, gint seconds)
+{
+	sqlite3_stmt *stmt;
+	GError *err = NULL;
+
+	g_mutex_lock(handle->mutex);
+
+	if(_twitterdb_prepare_statement(handle, twitterdb_queries_replace_sync_seconds, &stmt, &err))
+	{
+		sqlite3_bind_int(stmt, 1, source);
+		_twitterdb_bind_guid(stmt, 2, user_guid);
+		sqlite3_bind_int(stmt, 3, seconds);
+		_twitterdb_execute_statement(handle, stmt, TRUE, &err);
+		_twitterdb_release_statement(handle, stmt);
+	}
+
+	g_mutex_unlock(handle->mutex);
+
+	if(err)
+	{
+		g_warning("%s", err->message);
+		g_error_free(err);
+	}
+}
+
+gboolean
+twitterdb_remove_last_sync_source(TwitterDbHandle *handle, TwitterDbSyncSource source, GError **err)
+{
+	sqlite3_stmt *stmt;
+	gboolean result = FALSE;
+
+	g_mutex_lock(handle->mutex);
+
+	if(_twitterdb_prepare_statement(handle, twitterdb_queries_remove_sync_seconds, &stmt, err))
+	{
+		sqlite3_bind_int(stmt, 1, source);
+
+		if(_twitterdb_execute_statement(handle, stmt, TRUE, err) == SQLITE_DONE)
+		{
+			result = TRUE;
+		}
+	}
+
+	_twitterdb_release_statement(handle, stmt);
+
+	g_mutex_unlock(handle->mutex);
+
+	return result;
+}
+
+gint64
+twitterdb_get_since_id(TwitterDbHandle *handle, TwitterDbSyncSource source, const gchar *guid, GError **err)
+{
+	sqlite3_stmt *stmt;
+	gint64 result = 0;
+
+	g_mutex_lock(handle->mutex);
+
+	if(_twitterdb_prepare_statement(handle, twitterdb_queries_get_since_id, &stmt, err))
+	{
+		sqlite3_bind_int(stmt, 1, source);
+		_twitterdb_bind_guid(stmt, 2, guid);
+
+		if(_twitterdb_execute_statement(handle, stmt, TRUE, err) == SQLITE_ROW)
+		{
+			result = (gint64)sqlite3_column_int64(stmt, 0);
+		}
+
+		_twitterdb_release_statement(handle, stmt);
+	}
+
+	g_mutex_unlock(handle->mutex);
+
+	return result;
+}
+
+gboolean
+twitterdb_set_since_id(TwitterDbHandle *handle, TwitterDbSyncSource source, const gchar *guid, gint64 since_id, GError **err)
+{
+	sqlite3_stmt *stmt;
+	gboolean result = FALSE;
+
+	g_mutex_lock(handle->mutex);
+
+	if(_twitterdb_prepare_statement(handle, twitterdb_queries_replace_since_id, &stmt, err))
+	{
+		sqlite3_bind_int(stmt, 1, source);
+		_twitterdb_bind_guid(stmt, 2, guid);
+		sqlite3_bind_int64(stmt, 3, (sqlite3_int64)since_id);
+
+		if(_twitterdb_execute_statement(handle, stmt, TRUE, err) == SQLITE_DONE)
+		{
+			result = TRUE;
+		}
+
+		_twitterdb_release_statement(handle, stmt);
+	}
+
+	g_mutex_unlock(handle->mutex);
+
+	return result;
+}
+
+gboolean
+twitterdb_get_sync_gap(TwitterDbHandle *handle, TwitterDbSyncSource source, const gchar *guid, gint64 *since_id, gint64 *max_id, GError **err)
+{
+	sqlite3_stmt *stmt;
+	gint dbstatus;
+	gboolean result = FALSE;
+
+	*since_id = 0;
+	*max_id = 0;
+
+	g_mutex_lock(handle->mutex);
+
+	if(_twitterdb_prepare_statement(handle, twitterdb_queries_get_sync_gap, &stmt, err))
+	{
+		sqlite3_bind_int(stmt, 1, source);
+		_twitterdb_bind_guid(stmt, 2, guid);
+
+		if((dbstatus = _twitterdb_execute_statement(handle, stmt, TRUE, err)) == SQLITE_ROW)
+		{
+			*since_id = (gint64)sqlite3_column_int64(stmt, 0);
+			*max_id = (gint64)sqlite3_column_int64(stmt, 1);
+		}
+
+		result = (dbstatus == SQLITE_ROW || dbstatus == SQLITE_DONE) ? TRUE : FALSE;
+
+		_twitterdb_release_statement(handle, stmt);
+	}
+
+	g_mutex_unlock(handle->mutex);
+
+	return result;
+}
+
+gboolean
+twitterdb_set_sync_gap(TwitterDbHandle *handle, TwitterDbSyncSource source, const gchar *guid, gint64 since_id, gint64 max_id, GError **err)
+{
+	sqlite3_stmt *stmt;
+	gboolean result = FALSE;
+
+	g_mutex_lock(handle->mutex);
+
+	if(_twitterdb_prepare_statement(handle, max_id ? twitterdb_queries_replace_sync_gap : twitterdb_queries_remove_sync_gap, &stmt, err))
+	{
+		sqlite3_bind_int(stmt, 1, source);
+		_twitterdb_bind_guid(stmt, 2, guid);
+
+		if(max_id)
+		{
+			sqlite3_bind_int64(stmt, 3, (sqlite3_int64)since_id);
+			sqlite3_bind_int64(stmt, 4, (sqlite3_int64)max_id);
+		}
+
+		if(_twitterdb_execute_statement(handle, stmt, TRUE, err) == SQLITE_DONE)
+		{
+			result = TRUE;
+		}
+
+		_twitterdb_release_statement(handle, stmt);
+	}
+
+	g_mutex_unlock(handle->mutex);
+
+	return result;
+}
+
+static gint
+_twitterdb_retention_apply_limit(TwitterDbHandle *handle, const gchar *groups_sql, const gchar *cutoff_sql, const gchar *delete_sql,
+                                 gint limit, gint slice_size, GError **err)
+{
+	sqlite3_stmt *stmt;
+	GArray *keys;
+	gint nkeys = 0;
+	gint i;
+	gint j;
+	gint64 cutoff;
+	gboolean found;
+	gint deleted = 0;
+	gboolean success = FALSE;
+
+	keys = g_array_new(FALSE, FALSE, sizeof(gint64));
+
+	/* get groups (timelines or lists) */
+	if(_twitterdb_prepare_statement(handle, groups_sql, &stmt, err))
+	{
+		nkeys = sqlite3_column_count(stmt);
+
+		while(_twitterdb_execute_statement(handle, stmt, TRUE, err) == SQLITE_ROW)
+		{
+			for(i = 0; i < nkeys; ++i)
+			{
+				cutoff = sqlite3_column_int64(stmt, i);
+				g_array_append_val(keys, cutoff);
+			}
+		}
+
+		success = (err && *err) ? FALSE : TRUE;
+
+		_twitterdb_release_statement(handle, stmt);
+	}
+
+	/* remove statuses exceeding the limit */
+	for(i = 0; success && nkeys && i < (gint)keys->len / nkeys && deleted < slice_size; ++i)
+	{
+		found = FALSE;
+
+		/* get timestamp of first status exceeding the limit */
+		if((success = _twitterdb_prepare_statement(handle, cutoff_sql, &stmt, err)))
+		{
+			for(j = 0; j < nkeys; ++j)
+			{
+				sqlite3_bind_int64(stmt, j + 1, g_array_index(keys, gint64, i * nkeys + j));
+			}
+
+			sqlite3_bind_int(stmt, nkeys + 1, limit);
+
+			if(_twitterdb_execute_statement(handle, stmt, TRUE, err) == SQLITE_ROW)
+			{
+				cutoff = sqlite3_column_int64(stmt, 0);
+				found = TRUE;
+			}
+
+			_twitterdb_release_statement(handle, stmt);
+		}
+
+		/* remove statuses */
+		if(found && (success = _twitterdb_prepare_statement(handle, delete_sql, &stmt, err)))
+		{
+			for(j = 0; j < nkeys; ++j)
+			{
+				sqlite3_bind_int64(stmt, j + 1, g_array_index(keys, gint64, i * nkeys + j));
+			}
+
+			sqlite3_bind_int64(stmt, nkeys + 1, cutoff);
+			sqlite3_bind_int(stmt, nkeys + 2, slice_size - deleted);
+
+			if((success = (_twitterdb_execute_statement(handle, stmt, TRUE, err) == SQLITE_DONE)))
+			{
+				deleted += sqlite3_changes(handle->db);
+			}
+
+			_twitterdb_release_statement(handle, stmt);
+		}
+	}
+
+	g_array_free(keys, TRUE);
+
+	return success ? deleted : -1;
+}
+
+static gint
+_twitterdb_retention_delete(TwitterDbHandle *handle, const gchar *sql, gint64 *arg, gint slice_size, GError **err)
+{
+	sqlite3_stmt *stmt;
+	gint index = 1;
+	gint deleted = -1;
+
+	if(_twitterdb_prepare_statement(handle, sql, &stmt, err))
+	{
+		if(arg)
+		{
+			sqlite3_bind_int64(stmt, index++, *arg);
+		}
+
+		sqlite3_bind_int(stmt, index, slice_size);
+
+		if(_twitterdb_execute_statement(handle, stmt, TRUE, err) == SQLITE_DONE)
+		{
+			deleted = sqlite3_changes(handle->db);
+		}
+
+		_twitterdb_release_statement(handle, stmt);
+	}
+
+	return deleted;
+}
+
+static gint
+_twitterdb_get_auto_vacuum(TwitterDbHandle *handle, GError **err)
+{
+	sqlite3_stmt *stmt;
+	gint mode = -1;
+
+	if(_twitterdb_prepare_statement(handle, twitterdb_queries_get_auto_vacuum, &stmt, err))
+	{
+		if(_twitterdb_execute_statement(handle, stmt, TRUE, err) == SQLITE_ROW)
+		{
+			mode = sqlite3_column_int(stmt, 0);
+		}
+
+		_twitterdb_release_statement(handle, stmt);
+	}
+
+	return mode;
+}
+
+static gint
+_twitterdb_get_freelist_count(TwitterDbHandle *handle, GError **err)
+{
+	sqlite3_stmt *stmt;
+	gint count = -1;
+
+	if(_twitterdb_prepare_statement(handle, twitterdb_queries_get_freelist_count, &stmt, err))
+	{
+		if(_twitterdb_execute_statement(handle, stmt, TRUE, err) == SQLITE_ROW)
+		{
+			count = sqlite3_column_int(stmt, 0);
+		}
+
+		_twitterdb_release_statement(handle, stmt);
+	}
+
+	return count;
+}
+
+gboolean
+twitterdb_retention_slice(TwitterDbHandle *handle, const TwitterDbRetentionPolicy *policy, gint slice_size, TwitterDbRetentionStats *stats, gboolean *finished, GError **err)
+{
+	gint deleted = 0;
+	gint free_pages;
+	gint64 timestamp;
+	gchar *query;
+	GTimeVal now;
+
+	g_assert(handle != NULL);
+	g_assert(policy != NULL);
+	g_assert(stats != NULL);
+	g_assert(finished != NULL);
+
+	g_return_val_if_fail(slice_size > 0, FALSE);
+
+	*finished = FALSE;
+
+	g_mutex_lock(handle->mutex);
+
+	++stats->slices;
+
+	/* timeline limit */
+	if(policy->max_timeline_statuses > 0)
+	{
+		if((deleted = _twitterdb_retention_apply_limit(handle, twitterdb_queries_get_timeline_groups, twitterdb_queries_get_timeline_cutoff,
+		                                               twitterdb_queries_delete_old_timeline_entries, policy->max_timeline_statuses, slice_size, err)) > 0)
+		{
+			g_debug("Removed %d timeline entries", deleted);
+			stats->timeline_entries += deleted;
+		}
+	}
+
+	/* list limit */
+	if(!deleted && policy->max_list_statuses > 0)
+	{
+		if((deleted = _twitterdb_retention_apply_limit(handle, twitterdb_queries_get_list_timeline_groups, twitterdb_queries_get_list_timeline_cutoff,
+		                                               twitterdb_queries_delete_old_list_timeline_entries, policy->max_list_statuses, slice_size, err)) > 0)
+		{
+			g_debug("Removed %d list entries", deleted);
+			stats->list_entries += deleted;
+		}
+	}
+
+	/* age limit */
+	if(!deleted && policy->max_age > 0)
+	{
+		g_get_current_time(&now);
+		timestamp = now.tv_sec - policy->max_age;
+
+		if((deleted = _twitterdb_retention_delete(handle, twitterdb_queries_delete_expired_statuses, &timestamp, slice_size, err)) > 0)
+		{
+			g_debug("Removed %d expired statuses", deleted);
+			stats->statuses += deleted;
+		}
+	}
+
+	/* orphaned statuses */
+	if(!deleted)
+	{
+		if((deleted = _twitterdb_retention_delete(handle, twitterdb_queries_delete_orphaned_statuses, NULL, slice_size, err)) > 0)
+		{
+			g_debug("Removed %d orphaned statuses", deleted);
+			stats->statuses += deleted;
+		}
+	}
+
+	/* orphaned users */
+	if(!deleted)
+	{
+		if((deleted = _twitterdb_retention_delete(handle, twitterdb_queries_delete_orphaned_users, NULL, slice_size, err)) > 0)
+		{
+			g_debug("Removed %d orphaned users", deleted);
+			stats->users += deleted;
+		}
+	}
+
+	/* release unused pages */
+	if(!deleted)
+	{
+		if((free_pages = _twitterdb_get_freelist_count(handle, err)) > 0)
+		{
+			query = g_strdup_printf("PRAGMA incremental_vacuum(%d)", slice_size);
+
+			if(_twitterdb_execute_non_query(handle, query, err))
+			{
+				stats->free_pages = _twitterdb_get_freelist_count(handle, err);
+
+				if(stats->free_pages >= 0 && stats->free_pages < free_pages)
+				{
+					g_debug("Released %d database pages", free_pages - stats->free_pages);
+					stats->released_pages += free_pages - stats->free_pages;
+				}
+				else
+				{
+					g_warning("Couldn't release %d free database pages, auto_vacuum seems to be disabled", free_pages);
+					*finished = TRUE;
+				}
+			}
+			else
+			{
+				deleted = -1;
+			}
+
+			g_free(query);
+		}
+		else if(!free_pages)
+		{
+			stats->free_pages = 0;
+			*finished = TRUE;
+		}
+		else
+		{
+			deleted = -1;
+		}
+	}
+
+	g_mutex_unlock(handle->mutex);
+
+	return (deleted >= 0) ? TRUE : FALSE;
+}
+
+/*
+ * Runs the given statements & the optional finish function in a single transaction and
+ * updates the database version. The handle has to be locked by the caller.
+ */
+static gboolean
+_twitterdb_upgrade(TwitterDbHandle *handle, const gchar *description, const gchar *queries[], gboolean (* finish)(TwitterDbHandle *handle, GError **err),
+                   gint major, gint minor, GError **err)
+{
+	sqlite3_stmt *stmt;
+	gint i;
+	gboolean result = FALSE;
+
+	if(_twitterdb_execute_non_query(handle, twitterdb_queries_begin_transaction, err))
+	{
+		result = TRUE;
+
+		g_debug("%s", description);
+		for(i = 0; queries && queries[i] && result; ++i)
+		{
+			result = _twitterdb_execute_non_query(handle, queries[i], err);
+		}
+
+		if(result && finish)
+		{
+			result = finish(handle, err);
+		}
+
+		if(result)
+		{
+			result = FALSE;
+
+			g_debug("Updating version to %d.%d", major, minor);
+			if(_twitterdb_prepare_statement(handle, twitterdb_queries_replace_version, &stmt, err))
+			{
+				sqlite3_bind_int(stmt, 1, major);
+				sqlite3_bind_int(stmt, 2, minor);
+
+				if(_twitterdb_execute_statement(handle, stmt, TRUE, err) == SQLITE_DONE)
+				{
+					result = TRUE;
+				}
+
+				_twitterdb_release_statement(handle, stmt);
+			}
+		}
+
+		if(result)
+		{
+			result = _twitterdb_execute_non_query(handle, twitterdb_queries_commit_transaction, err);
+		}
+		else
+		{
+			_twitterdb_execute_non_query(handle, twitterdb_queries_rollback_transaction, NULL);
+		}
+	}
+
+	return result;
+}
+
+gboolean
+twitterdb_upgrade_0_1_to_0_2(TwitterDbHandle *handle, GError **err)
+{
+	const gchar *queries[] = { twitterdb_queries_add_prev_status_column, NULL };
+	gboolean result;
+
+	g_mutex_lock(handle->mutex);
+	result = _twitterdb_upgrade(handle, "Altering status table", queries, NULL, 0, 2, err);
+	g_mutex_unlock(handle->mutex);
+
+	return result;
+}
+
+gboolean
+twitterdb_upgrade_0_2_to_0_3(TwitterDbHandle *handle, GError **err)
+{
+	gboolean result;
+
+	g_mutex_lock(handle->mutex);
+	result = _twitterdb_upgrade(handle, "Creating indexes", NULL, _twitterdb_create_indexes, 0, 3, err);
+	g_mutex_unlock(handle->mutex);
+
+	return result;
+}
+
+gboolean
+twitterdb_upgrade_0_3_to_0_4(TwitterDbHandle *handle, GError **err)
+{
+	gboolean result;
+
+	g_mutex_lock(handle->mutex);
+
+	/* foreign keys have to be disabled while tables are rebuilt */
+	_twitterdb_execute_non_query(handle, "PRAGMA foreign_keys=OFF", NULL);
+
+	/* indexes have been dropped with the old tables */
+	result = _twitterdb_upgrade(handle, "Converting guids to integers", twitterdb_queries_upgrade_0_3_to_0_4, _twitterdb_create_indexes, 0, 4, err);
+
+	_twitterdb_execute_non_query(handle, "PRAGMA foreign_keys=ON", NULL);
+
+	/* release pages of the dropped tables */
+	if(result)
+	{
+		g_debug("Compacting database");
+		_twitterdb_execute_non_query(handle, "PRAGMA auto_vacuum=INCREMENTAL", NULL);
+		_twitterdb_execute_non_query(handle, "VACUUM", NULL);
+
+		/* the new auto_vacuum mode is only applied by VACUUM */
+		if(_twitterdb_get_auto_vacuum(handle, NULL) != 2)
+		{
+			g_warning("Couldn't enable incremental vacuum, unused database pages won't be released");
+		}
+	}
+
+	g_mutex_unlock(handle->mutex);
+
+	return result;
+}
+
+gboolean
+twitterdb_upgrade_0_4_to_0_5(TwitterDbHandle *handle, GError **err)
+{
+	gboolean result;
+
+	g_mutex_lock(handle->mutex);
+	result = _twitterdb_upgrade(handle, "Copying status timestamps to timelines", twitterdb_queries_upgrade_0_4_to_0_5, NULL, 0, 5, err);
+	g_mutex_unlock(handle->mutex);
+
+	return result;
+}
+
+gboolean
+twitterdb_upgrade_0_5_to_0_6(TwitterDbHandle *handle, GError **err)
+{
+	gboolean result;
+
+	g_mutex_lock(handle->mutex);
+	result = _twitterdb_upgrade(handle, "Building full-text index", twitterdb_queries_upgrade_0_5_to_0_6, NULL, 0, 6, err);
+	g_mutex_unlock(handle->mutex);
+
+	return result;
+}
+
+gboolean
+twitterdb_upgrade_0_6_to_0_7(TwitterDbHandle *handle, GError **err)
+{
+	gboolean result;
+
+	g_mutex_lock(handle->mutex);
+	result = _twitterdb_upgrade(handle, "Creating read marks", twitterdb_queries_upgrade_0_6_to_0_7, NULL, 0, 7, err);
+	g_mutex_unlock(handle->mutex);
+
+	return result;
+}
+
+gboolean
+twitterdb_upgrade_0_7_to_0_8(TwitterDbHandle *handle, GError **err)
+{
+	const gchar *queries[] = { twitterdb_queries_add_since_id_column, NULL };
+	gboolean result;
+
+	g_mutex_lock(handle->mutex);
+	result = _twitterdb_upgrade(handle, "Altering last_sync table", queries, NULL, 0, 8, err);
+	g_mutex_unlock(handle->mutex);
+
+	return result;
+}
+
+gboolean
+twitterdb_upgrade_0_8_to_0_9(TwitterDbHandle *handle, GError **err)
+{
+	gboolean result;
+
+	g_mutex_lock(handle->mutex);
+	result = _twitterdb_upgrade(handle, "Creating sync_gap table", twitterdb_queries_upgrade_0_8_to_0_9, NULL, 0, 9, err);
+	g_mutex_unlock(handle->mutex);
+
 	return result;
 }
 
@@ -47,27 +47,217 @@ typedef enum
 	TWITTERDB_SYNC_SOURCE_LIST_MEMBERS,
 	TWITTERDB_SYNC_SOURCE_DIRECT_MESSAGES,
 	TWITTERDB_SYNC_SOURCE_FRIENDS,
-	TWITTERDB_SYNC_SOURCE_FOLLOWERS
+	TWITTERDB_SYNC_SOURCE_FOLLOWERS,
+	TWITTERDB_SYNC_SOURCE_RETENTION,
+	TWITTERDB_SYNC_SOURCE_HOME_TIMELINE,
+	TWITTERDB_SYNC_SOURCE_REPLIES,
+	TWITTERDB_SYNC_SOURCE_USER_TIMELINE,
+	TWITTERDB_SYNC_SOURCE_LIST_TIMELINE
 } TwitterDbSyncSource;
 
+/*! Timeline types. */
+typedef enum
+{
+	TWITTERDB_TIMELINE_TYPE_PUBLIC = 1,
+	TWITTERDB_TIMELINE_TYPE_USER_TIMELINE = 2,
+	TWITTERDB_TIMELINE_TYPE_REPLIES = 3
+} TwitterDbTimelineType;
+
 /*! A database handle. */
-typedef sqlite3 TwitterDbHandle;
+typedef struct _TwitterDbHandle TwitterDbHandle;
+
+/**
+ * \struct TwitterDbPoolStats
+ * \brief Statistics of the database connection pool.
+ */
+typedef struct
+{
+	/*! Maximum number of pooled connections. */
+	gint size;
+	/*! Number of currently open connections. */
+	gint open;
+	/*! Number of requests served by an idle connection. */
+	guint hits;
+	/*! Number of requests served by an idle connection last used by the same thread. */
+	guint affinity_hits;
+	/*! Number of requests which had to wait for a free connection. */
+	guint waits;
+	/*! Number of opened connections. */
+	guint opened;
+	/*! Total time spent opening connections (in seconds). */
+	gdouble open_seconds;
+	/*! Maximum time spent opening a single connection (in seconds). */
+	gdouble max_open_seconds;
+} TwitterDbPoolStats;
+
+/*! Number of buckets in the lock wait histogram. */
+#define TWITTERDB_BUSY_HISTOGRAM_SIZE 5
+
+/**
+ * \struct TwitterDbBusyStats
+ * \brief Lock wait statistics of a query.
+ */
+typedef struct
+{
+	/*! Number of executions which had to wait for a lock. */
+	guint count;
+	/*! Total wait time (in milliseconds). */
+	guint64 total_milliseconds;
+	/*! Maximum wait time (in milliseconds). */
+	gint max_milliseconds;
+	/*! Wait time histogram: <10ms, <100ms, <1s, <10s, >=10s. */
+	guint histogram[TWITTERDB_BUSY_HISTOGRAM_SIZE];
+} TwitterDbBusyStats;
+
+/**
+ * \param sql the query
+ * \param stats lock wait statistics of the query
+ * \param user_data user data
+ *
+ * Processes lock wait statistics.
+ */
+typedef void (*TwitterDbProcessBusyStatsFunc)(const gchar *sql, const TwitterDbBusyStats *stats, gpointer user_data);
+
+/**
+ * \struct TwitterDbRetentionPolicy
+ * \brief Specifies which data should be removed from the database.
+ */
+typedef struct
+{
+	/*! Maximum number of statuses per timeline (0 = unlimited). */
+	gint max_timeline_statuses;
+	/*! Maximum number of statuses per list (0 = unlimited). */
+	gint max_list_statuses;
+	/*! Maximum age of statuses in seconds (0 = unlimited). */
+	gint max_age;
+} TwitterDbRetentionPolicy;
+
+/**
+ * \struct TwitterDbRetentionStats
+ * \brief Progress of the retention job.
+ */
+typedef struct
+{
+	/*! Number of removed timeline entries. */
+	guint timeline_entries;
+	/*! Number of removed list entries. */
+	guint list_entries;
+	/*! Number of removed statuses. */
+	guint statuses;
+	/*! Number of removed users. */
+	guint users;
+	/*! Number of released database pages. */
+	guint released_pages;
+	/*! Number of unused database pages. */
+	gint free_pages;
+	/*! Number of processed slices. */
+	guint slices;
+} TwitterDbRetentionStats;
 
 /**
  * \param err structure for storing error messages
  * \return a database handle or NULL on failure
  *
- * Open a connection to the database.
+ * Takes a connection from the connection pool. The connection last used by the calling
+ * thread is preferred. New connections are opened lazily until the pool size is reached,
+ * afterwards the function waits for a connection to be returned. The database is operated
+ * in WAL mode, so readers on one connection don't block a writer on another one.
  */
 TwitterDbHandle *twitterdb_get_handle(GError **err);
 
 /**
  * \param handle a database handle
  *
- * Closes a database connection.
+ * Returns a connection to the connection pool. Connections exceeding the pool size are
+ * closed and their prepared statements are finalized.
  */
 void twitterdb_close_handle(TwitterDbHandle *handle);
 
+/**
+ * \param filename database file to use
+ *
+ * Uses the given database file instead of the one in the user's application directory.
+ * Has to be called before the first connection is opened.
+ */
+void twitterdb_set_filename(const gchar *filename);
+
+/**
+ * \param size maximum number of pooled connections
+ *
+ * Sets the size of the connection pool.
+ */
+void twitterdb_set_pool_size(gint size);
+
+/**
+ * \param count number of connections to open
+ * \param err structure for storing error messages
+ * \return TRUE on success
+ *
+ * Opens connections in advance so that following twitterdb_get_handle() calls
+ * don't have to connect to the database.
+ */
+gboolean twitterdb_warm_up(gint count, GError **err);
+
+/**
+ * \param stats location to store the statistics
+ *
+ * Gets statistics of the connection pool.
+ */
+void twitterdb_get_pool_stats(TwitterDbPoolStats *stats);
+
+/**
+ * Closes all pooled connections.
+ */
+void twitterdb_cleanup(void);
+
+/**
+ * \param handle a database handle
+ * \param cancellable a GCancellable or NULL
+ *
+ * If the database is locked statements wait with exponential backoff until the lock is
+ * released or a timeout occurs. The given GCancellable aborts waiting. It's reset when
+ * the handle is returned to the pool.
+ */
+void twitterdb_set_cancellable(TwitterDbHandle *handle, GCancellable *cancellable);
+
+/**
+ * \param func function to call for each query
+ * \param user_data user data
+ *
+ * Iterates the lock wait statistics of all queries which had to wait for a lock.
+ */
+void twitterdb_foreach_busy_stats(TwitterDbProcessBusyStatsFunc func, gpointer user_data);
+
+/**
+ * \param handle a database handle
+ * \param err structure for storing error messages
+ * \return TRUE on success
+ *
+ * Starts a batch of write operations. All statements executed until the matching
+ * twitterdb_commit_batch() call are written in a single transaction. Batches
+ * can be nested, only the outermost batch opens and closes the transaction.
+ */
+gboolean twitterdb_begin_batch(TwitterDbHandle *handle, GError **err);
+
+/**
+ * \param handle a database handle
+ * \param err structure for storing error messages
+ * \return TRUE on success
+ *
+ * Ends a batch started with twitterdb_begin_batch(). If this is the outermost batch
+ * the transaction is committed. If a nested batch has been rolled back the whole
+ * transaction is rolled back instead and FALSE is returned.
+ */
+gboolean twitterdb_commit_batch(TwitterDbHandle *handle, GError **err);
+
+/**
+ * \param handle a database handle
+ *
+ * Aborts a batch started with twitterdb_begin_batch(). The transaction is rolled back
+ * when the outermost batch ends.
+ */
+void twitterdb_rollback_batch(TwitterDbHandle *handle);
+
 /**
  * \param handle a database handle
  * \param table name of the table to check
@@ -181,12 +371,49 @@ gboolean twitterdb_remove_status(TwitterDbHandle *handle, const gchar *guid, GEr
 
 /**
  * \param handle a database handle
+ * \param username owner of the timeline
+ * \param type type of the timeline
+ * \param timestamp timestamp of the newest read status
+ * \param err structure for storing error messages
+ * \return TRUE on success
+ *
+ * Sets the read mark of a timeline. Statuses up to the given timestamp are treated as read.
+ */
+gboolean twitterdb_mark_timeline_read(TwitterDbHandle *handle, const gchar *username, TwitterDbTimelineType type, gint64 timestamp, GError **err);
+
+/**
+ * \param handle a database handle
+ * \param username owner of the list
+ * \param list name of the list
+ * \param timestamp timestamp of the newest read status
  * \param err structure for storing error messages
  * \return TRUE on success
  *
- * Marks all stati read.
+ * Sets the read mark of a list. Statuses up to the given timestamp are treated as read.
+ */
+gboolean twitterdb_mark_list_read(TwitterDbHandle *handle, const gchar * restrict username, const gchar * restrict list, gint64 timestamp, GError **err);
+
+/**
+ * \param handle a database handle
+ * \param username owner of the timeline
+ * \param type type of the timeline
+ * \param err structure for storing error messages
+ * \return number of unread tweets
+ *
+ * Counts tweets of a timeline newer than its read mark.
+ */
+gint twitterdb_count_unread_in_timeline(TwitterDbHandle *handle, const gchar *username, TwitterDbTimelineType type, GError **err);
+
+/**
+ * \param handle a database handle
+ * \param username owner of the list
+ * \param list name of the list
+ * \param err structure for storing error messages
+ * \return number of unread tweets
+ *
+ * Counts tweets of a list newer than its read mark.
  */
-gboolean twitterdb_mark_statuses_read(TwitterDbHandle *handle, GError **err);
+gint twitterdb_count_unread_in_list(TwitterDbHandle *handle, const gchar * restrict username, const gchar * restrict list, GError **err);
 
 /**
  * \param handle a database handle
@@ -263,6 +490,49 @@ gboolean twitterdb_remove_friends(TwitterDbHandle *handle, const gchar *user_gui
  */
 gboolean twitterdb_remove_followers(TwitterDbHandle *handle, const gchar *user_guid, GError **err);
 
+/**
+ * \param handle a database handle
+ * \param err structure for storing error messages
+ * \return TRUE on success
+ *
+ * Removes all staged friend/follower ids. The ids are stored in a temporary table,
+ * so they are only visible to the given connection.
+ */
+gboolean twitterdb_clear_staged_followers(TwitterDbHandle *handle, GError **err);
+
+/**
+ * \param handle a database handle
+ * \param user_guid guid of a fetched friend/follower
+ * \param err structure for storing error messages
+ * \return TRUE on success
+ *
+ * Stages a fetched friend/follower id for twitterdb_reconcile_followers().
+ */
+gboolean twitterdb_stage_follower(TwitterDbHandle *handle, const gchar *user_guid, GError **err);
+
+/**
+ * \param handle a database handle
+ * \param user_guid guid of a user
+ * \param friends TRUE to reconcile friends, FALSE to reconcile followers
+ * \param added location to store the number of added relationships
+ * \param removed location to store the number of removed relationships
+ * \param err structure for storing error messages
+ * \return TRUE on success
+ *
+ * Replaces the friends/followers of the given user with the staged ids. Staged users
+ * without stored details are skipped, see twitterdb_get_unknown_staged_followers().
+ */
+gboolean twitterdb_reconcile_followers(TwitterDbHandle *handle, const gchar *user_guid, gboolean friends, guint *added, guint *removed, GError **err);
+
+/**
+ * \param handle a database handle
+ * \param err structure for storing error messages
+ * \return a doubly-linked list or NULL
+ *
+ * Gets staged friend/follower ids which aren't stored in the user table.
+ */
+GList *twitterdb_get_unknown_staged_followers(TwitterDbHandle *handle, GError **err);
+
 /**
  * \param handle a database handle
  * \param user1 name of a user
@@ -490,6 +760,41 @@ gboolean twitterdb_remove_user_from_list(TwitterDbHandle *handle, const gchar *
  */
 gboolean twitterdb_remove_users_from_list(TwitterDbHandle *handle, const gchar *list_guid, GError **err);
 
+/**
+ * \param handle a database handle
+ * \param list_guid guid of a list
+ * \param err structure for storing error messages
+ * \return TRUE on success
+ *
+ * Removes the staged member ids of a list. The ids are stored in a temporary table,
+ * so they are only visible to the given connection.
+ */
+gboolean twitterdb_clear_staged_list_members(TwitterDbHandle *handle, const gchar *list_guid, GError **err);
+
+/**
+ * \param handle a database handle
+ * \param list_guid guid of a list
+ * \param user_guid guid of a fetched list member
+ * \param err structure for storing error messages
+ * \return TRUE on success
+ *
+ * Stages a fetched list member id for twitterdb_reconcile_list_members().
+ */
+gboolean twitterdb_stage_list_member(TwitterDbHandle *handle, const gchar * restrict list_guid, const gchar * restrict user_guid, GError **err);
+
+/**
+ * \param handle a database handle
+ * \param list_guid guid of a list
+ * \param added location to store the number of added members
+ * \param removed location to store the number of removed members
+ * \param err structure for storing error messages
+ * \return TRUE on success
+ *
+ * Replaces the members of a list with the staged ids. Staged users without stored
+ * details are skipped.
+ */
+gboolean twitterdb_reconcile_list_members(TwitterDbHandle *handle, const gchar *list_guid, guint *added, guint *removed, GError **err);
+
 /**
  * \param handle a database handle
  * \param owner list owner
@@ -521,57 +826,91 @@ gboolean twitterdb_save_direct_message(TwitterDbHandle *handle, const gchar * re
  * \param handle a database handle
  * \param username a username 
  * \param func function invoked for each found status
- * \param ignore_old ignore old tweets
+ * \param ignore_old only get tweets newer than the read mark of the timeline
+ * \param before_timestamp only get tweets older than this timestamp (0 to start with the newest tweet)
+ * \param before_guid guid of the last tweet of the previous page or NULL
+ * \param count maximum number of tweets
  * \param user_data data passed to the given callback function
  * \param cancellable a GCancellable to abort the database operation
  * \param err structure for storing error messages
  * \return TRUE on success
  *
- * Gets tweets from public timeline.
+ * Gets tweets from public timeline. Tweets are ordered by timestamp (newest first). To get the next page pass the
+ * timestamp and guid of the last received tweet.
  */
-gboolean twitterdb_foreach_status_in_public_timeline(TwitterDbHandle *handle, const gchar *username, TwitterProcessStatusFunc func, gboolean ignore_old, gpointer user_data, GCancellable *cancellable, GError **err);
+gboolean twitterdb_foreach_status_in_public_timeline(TwitterDbHandle *handle, const gchar *username, TwitterProcessStatusFunc func, gboolean ignore_old,
+                                 gint before_timestamp, const gchar *before_guid, gint count, gpointer user_data, GCancellable *cancellable, GError **err);
 
 /**
  * \param handle a database handle
  * \param username a username 
  * \param func function invoked for each found status
- * \param ignore_old ignore old tweets
+ * \param ignore_old only get tweets newer than the read mark of the timeline
+ * \param before_timestamp only get tweets older than this timestamp (0 to start with the newest tweet)
+ * \param before_guid guid of the last tweet of the previous page or NULL
+ * \param count maximum number of tweets
  * \param user_data data passed to the given callback function
  * \param cancellable a GCancellable to abort the database operation
  * \param err structure for storing error messages
  * \return TRUE on success
  *
- * Gets replies.
+ * Gets replies. Tweets are ordered by timestamp (newest first). To get the next page pass the
+ * timestamp and guid of the last received tweet.
  */
-gboolean twitterdb_foreach_status_in_replies(TwitterDbHandle *handle, const gchar *username, TwitterProcessStatusFunc func, gboolean ignore_old, gpointer user_data, GCancellable *cancellable, GError **err);
+gboolean twitterdb_foreach_status_in_replies(TwitterDbHandle *handle, const gchar *username, TwitterProcessStatusFunc func, gboolean ignore_old,
+                                 gint before_timestamp, const gchar *before_guid, gint count, gpointer user_data, GCancellable *cancellable, GError **err);
 
 /**
  * \param handle a database handle
  * \param username a username 
  * \param func function invoked for each found status
- * \param ignore_old ignore old tweets
+ * \param ignore_old only get tweets newer than the read mark of the timeline
+ * \param before_timestamp only get tweets older than this timestamp (0 to start with the newest tweet)
+ * \param before_guid guid of the last tweet of the previous page or NULL
+ * \param count maximum number of tweets
  * \param user_data data passed to the given callback function
  * \param cancellable a GCancellable to abort the database operation
  * \param err structure for storing error messages
  * \return TRUE on success
  *
- * Gets a user timline.
+ * Gets a user timline. Tweets are ordered by timestamp (newest first). To get the next page pass the
+ * timestamp and guid of the last received tweet.
  */
-gboolean twitterdb_foreach_status_in_usertimeline(TwitterDbHandle *handle, const gchar *username, TwitterProcessStatusFunc func, gboolean ignore_old, gpointer user_data, GCancellable *cancellable, GError **err);
+gboolean twitterdb_foreach_status_in_usertimeline(TwitterDbHandle *handle, const gchar *username, TwitterProcessStatusFunc func, gboolean ignore_old,
+                                 gint before_timestamp, const gchar *before_guid, gint count, gpointer user_data, GCancellable *cancellable, GError **err);
 
 /**
  * \param handle a database handle
  * \param username a username 
  * \param list a list
  * \param func function invoked for each found status
+ * \param before_timestamp only get tweets older than this timestamp (0 to start with the newest tweet)
+ * \param before_guid guid of the last tweet of the previous page or NULL
+ * \param count maximum number of tweets
  * \param user_data data passed to the given callback function
  * \param cancellable a GCancellable to abort the database operation
  * \param err structure for storing error messages
  * \return TRUE on success
  *
- * Gets a list timline.
+ * Gets a list timline. See twitterdb_foreach_status_in_public_timeline() for paging.
  */
-gboolean twitterdb_foreach_status_in_list(TwitterDbHandle *handle, const gchar * restrict username, const gchar * restrict list, TwitterProcessStatusFunc func, gpointer user_data, GCancellable *cancellable, GError **err);
+gboolean twitterdb_foreach_status_in_list(TwitterDbHandle *handle, const gchar * restrict username, const gchar * restrict list, TwitterProcessStatusFunc func,
+                                 gint before_timestamp, const gchar *before_guid, gint count, gpointer user_data, GCancellable *cancellable, GError **err);
+
+/**
+ * \param handle a database handle
+ * \param query a search query
+ * \param func function invoked for each found status
+ * \param count maximum number of tweets
+ * \param user_data data passed to the given callback function
+ * \param cancellable a GCancellable to abort the database operation
+ * \param err structure for storing error messages
+ * \return TRUE on success
+ *
+ * Searches stored tweets for all words of the query (text, username & realname of the author).
+ * Tweets are ordered by timestamp (newest first).
+ */
+gboolean twitterdb_foreach_status_matching(TwitterDbHandle *handle, const gchar *query, TwitterProcessStatusFunc func, gint count, gpointer user_data, GCancellable *cancellable, GError **err);
 
 /**
  * \param handle a database handle
@@ -628,6 +967,72 @@ void twitterdb_set_last_sync(TwitterDbHandle *handle, TwitterDbSyncSource source
  */
 gboolean twitterdb_remove_last_sync_source(TwitterDbHandle *handle, TwitterDbSyncSource source, GError **err);
 
+/**
+ * \param handle a database handle
+ * \param source the source
+ * \param guid guid of the user or list
+ * \param err structure for storing error messages
+ * \return highest synchronized status id or 0
+ *
+ * Gets the id of the newest status received from the given source.
+ */
+gint64 twitterdb_get_since_id(TwitterDbHandle *handle, TwitterDbSyncSource source, const gchar *guid, GError **err);
+
+/**
+ * \param handle a database handle
+ * \param source the source
+ * \param guid guid of the user or list
+ * \param since_id id of the newest received status
+ * \param err structure for storing error messages
+ * \return TRUE on success
+ *
+ * Stores the id of the newest status received from the given source. The last
+ * synchronization timestamp of the source isn't changed.
+ */
+gboolean twitterdb_set_since_id(TwitterDbHandle *handle, TwitterDbSyncSource source, const gchar *guid, gint64 since_id, GError **err);
+
+/**
+ * \param handle a database handle
+ * \param source the source
+ * \param guid guid of the user or list
+ * \param since_id location to store the id of the newest status below the gap
+ * \param max_id location to store the id backfilling continues with, 0 if there's no gap
+ * \param err structure for storing error messages
+ * \return TRUE on success
+ *
+ * Gets the range of statuses which couldn't be received from the given source yet.
+ */
+gboolean twitterdb_get_sync_gap(TwitterDbHandle *handle, TwitterDbSyncSource source, const gchar *guid, gint64 *since_id, gint64 *max_id, GError **err);
+
+/**
+ * \param handle a database handle
+ * \param source the source
+ * \param guid guid of the user or list
+ * \param since_id id of the newest status below the gap
+ * \param max_id id backfilling continues with, 0 removes the gap
+ * \param err structure for storing error messages
+ * \return TRUE on success
+ *
+ * Stores the range of statuses which couldn't be received from the given source yet.
+ */
+gboolean twitterdb_set_sync_gap(TwitterDbHandle *handle, TwitterDbSyncSource source, const gchar *guid, gint64 since_id, gint64 max_id, GError **err);
+
+/**
+ * \param handle a database handle
+ * \param policy the retention policy
+ * \param slice_size maximum number of rows or pages to process
+ * \param stats location to accumulate statistics
+ * \param finished set to TRUE if there's nothing left to do
+ * \param err structure for storing error messages
+ * \return TRUE on success
+ *
+ * Performs a single, bounded step of the retention job. The first step with remaining work
+ * is processed: removing statuses exceeding the timeline limit, statuses exceeding the list
+ * limit, expired statuses, orphaned statuses, orphaned users and finally releasing unused
+ * pages with incremental_vacuum. Call it repeatedly until finished is TRUE.
+ */
+gboolean twitterdb_retention_slice(TwitterDbHandle *handle, const TwitterDbRetentionPolicy *policy, gint slice_size, TwitterDbRetentionStats *stats, gboolean *finished, GError **err);
+
 /**
  * \param handle a database handle
  * \param err structure for storing error messages
@@ -637,6 +1042,69 @@ gboolean twitterdb_remove_last_sync_source(TwitterDbHandle *handle, TwitterDbSyn
  */
 gboolean twitterdb_upgrade_0_1_to_0_2(TwitterDbHandle *handle, GError **err);
 
+/**
+ * \param handle a database handle
+ * \param err structure for storing error messages
+ * \return TRUE on success
+ *
+ * Upgrades database format from version 0.2 to 0.3 (secondary indexes).
+ */
+gboolean twitterdb_upgrade_0_2_to_0_3(TwitterDbHandle *handle, GError **err);
+
+/**
+ * \param handle a database handle
+ * \param err structure for storing error messages
+ * \return TRUE on success
+ *
+ * Upgrades database format from version 0.3 to 0.4 (guids are stored as integers).
+ */
+gboolean twitterdb_upgrade_0_3_to_0_4(TwitterDbHandle *handle, GError **err);
+
+/**
+ * \param handle a database handle
+ * \param err structure for storing error messages
+ * \return TRUE on success
+ *
+ * Upgrades database format from version 0.4 to 0.5 (timelines store status timestamps).
+ */
+gboolean twitterdb_upgrade_0_4_to_0_5(TwitterDbHandle *handle, GError **err);
+
+/**
+ * \param handle a database handle
+ * \param err structure for storing error messages
+ * \return TRUE on success
+ *
+ * Upgrades database format from version 0.5 to 0.6 (full-text index).
+ */
+gboolean twitterdb_upgrade_0_5_to_0_6(TwitterDbHandle *handle, GError **err);
+
+/**
+ * \param handle a database handle
+ * \param err structure for storing error messages
+ * \return TRUE on success
+ *
+ * Upgrades database format from version 0.6 to 0.7 (per-timeline read marks).
+ */
+gboolean twitterdb_upgrade_0_6_to_0_7(TwitterDbHandle *handle, GError **err);
+
+/**
+ * \param handle a database handle
+ * \param err structure for storing error messages
+ * \return TRUE on success
+ *
+ * Upgrades database format from version 0.7 to 0.8 (stores the newest synchronized status ids).
+ */
+gboolean twitterdb_upgrade_0_7_to_0_8(TwitterDbHandle *handle, GError **err);
+
+/**
+ * \param handle a database handle
+ * \param err structure for storing error messages
+ * \return TRUE on success
+ *
+ * Upgrades database format from version 0.8 to 0.9 (stores unfilled timeline gaps).
+ */
+gboolean twitterdb_upgrade_0_8_to_0_9(TwitterDbHandle *handle, GError **err);
+
 /**
  * @}
  * @}
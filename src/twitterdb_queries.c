@@ -36,69 +36,79 @@ const gchar *twitterdb_queries_create_tables[] =
 	"BEGIN TRANSACTION",
 
 	"CREATE TABLE IF NOT EXISTS user ("
-	"guid VARCHAR(32) NOT NULL, "
+	"guid INTEGER NOT NULL PRIMARY KEY, "
 	"username VARCHAR(64) NOT NULL, "
 	"realname VARCHAR(64) NOT NULL, "
 	"image VARCHAR(64) NOT NULL, "
 	"location VARCHAR(64) NOT NULL, "
 	"website VARCHAR(256) NOT NULL, "
-	"description VARCHAR(256) NOT NULL, "
-	"PRIMARY KEY(guid))",
+	"description VARCHAR(256) NOT NULL)",
 
 	"CREATE TABLE IF NOT EXISTS status ("
-	"guid VARCHAR(32) NOT NULL, "
-	"prev_status VARCHAR(32), "
+	"guid INTEGER NOT NULL PRIMARY KEY, "
+	"prev_status INTEGER, "
 	"text VARCHAR(140) NOT NULL, "
-	"user_guid VARCHAR(32) NOT NULL REFERENCES user(guid) ON DELETE CASCADE, "
+	"user_guid INTEGER NOT NULL REFERENCES user(guid) ON DELETE CASCADE, "
 	"timestamp INTEGER NOT NULL, "
-	"read BOOLEAN NOT NULL, "
-	"PRIMARY KEY(guid))",
+	"read BOOLEAN NOT NULL)",
 
 	"CREATE TABLE IF NOT EXISTS follower ("
-	"user1_guid VARCHAR(32) NOT NULL REFERENCES user(guid) ON DELETE CASCADE, "
-	"user2_guid VARCHAR(32) NOT NULL REFERENCES user(guid) ON DELETE CASCADE, "
+	"user1_guid INTEGER NOT NULL REFERENCES user(guid) ON DELETE CASCADE, "
+	"user2_guid INTEGER NOT NULL REFERENCES user(guid) ON DELETE CASCADE, "
 	"PRIMARY KEY(user1_guid, user2_guid))",
 	
 	"CREATE TABLE IF NOT EXISTS list("
-	"guid VARCHAR(16) NOT NULL, "
-	"user_guid VARCHAR(32) NOT NULL REFERENCES user(guid) ON DELETE CASCADE, "
+	"guid INTEGER NOT NULL PRIMARY KEY, "
+	"user_guid INTEGER NOT NULL REFERENCES user(guid) ON DELETE CASCADE, "
 	"name VARCHAR(64) NOT NULL, "
 	"fullname VARCHAR(64) NOT NULL, "
 	"uri VARCHAR(256) NOT NULL, "
 	"description VARCHAR(256) NOT NULL, "
 	"protected BOOLEAN NOT NULL, "
 	"subscriber_count INTEGER NOT NULL, "
-	"member_count INTEGER NOT NULL, "
-	"PRIMARY KEY(guid))",
+	"member_count INTEGER NOT NULL)",
 
 	"CREATE TABLE IF NOT EXISTS list_timeline ("
-	"list_guid VARCHAR(32) NOT NULL REFERENCES list(guid) ON DELETE CASCADE, "
-	"status_guid VARCHAR(32) NOT NULL REFERENCES status(guid) ON DELETE CASCADE, "
+	"list_guid INTEGER NOT NULL REFERENCES list(guid) ON DELETE CASCADE, "
+	"status_guid INTEGER NOT NULL REFERENCES status(guid) ON DELETE CASCADE, "
+	"timestamp INTEGER NOT NULL DEFAULT 0, "
 	"PRIMARY KEY(list_guid, status_guid))",
 
+	"CREATE INDEX IF NOT EXISTS list_timeline_page ON list_timeline(list_guid, timestamp, status_guid)",
+
 	"CREATE TABLE IF NOT EXISTS list_member ("
-	"list_guid VARCHAR(32) NOT NULL REFERENCES list(guid) ON DELETE CASCADE, "
-	"user_guid VARCHAR(32) NOT NULL REFERENCES user(guid) ON DELETE CASCADE, "
+	"list_guid INTEGER NOT NULL REFERENCES list(guid) ON DELETE CASCADE, "
+	"user_guid INTEGER NOT NULL REFERENCES user(guid) ON DELETE CASCADE, "
 	"PRIMARY KEY(list_guid, user_guid))",
 
 	"CREATE TABLE IF NOT EXISTS timeline ("
-	"user_guid VARCHAR(32) NOT NULL REFERENCES user(guid) ON DELETE CASCADE, "
-	"status_guid VARCHAR(32) NOT NULL REFERENCES status(guid) ON DELETE CASCADE, "
+	"user_guid INTEGER NOT NULL REFERENCES user(guid) ON DELETE CASCADE, "
+	"status_guid INTEGER NOT NULL REFERENCES status(guid) ON DELETE CASCADE, "
 	"type INTEGER NOT NULL, "
+	"timestamp INTEGER NOT NULL DEFAULT 0, "
 	"PRIMARY KEY(user_guid, status_guid, type))",
 
+	"CREATE INDEX IF NOT EXISTS timeline_page ON timeline(user_guid, type, timestamp, status_guid)",
+
  	"CREATE TABLE IF NOT EXISTS direct_message("
-	"guid VARCHAR(32) NOT NULL, "
+	"guid INTEGER NOT NULL PRIMARY KEY, "
 	"text VARCHAR(140) NOT NULL, "
 	"timestamp INTEGER NOT NULL, "
-	"sender_guid VARCHAR(32) NOT NULL REFERENCES user(guid) ON DELETE CASCADE, "
-	"receiver_guid VARCHAR(32) NOT NULL REFERENCES user(guid) ON DELETE CASCADE, "
-	"PRIMARY KEY(guid))",
+	"sender_guid INTEGER NOT NULL REFERENCES user(guid) ON DELETE CASCADE, "
+	"receiver_guid INTEGER NOT NULL REFERENCES user(guid) ON DELETE CASCADE)",
 
  	"CREATE TABLE IF NOT EXISTS last_sync("
 	"source INTEGER NOT NULL, "
-	"user_guid VARCHAR(32) NOT NULL, "
+	"user_guid INTEGER NOT NULL, "
 	"seconds INTEGER NOT NULL, "
+	"since_id INTEGER NOT NULL DEFAULT 0, "
+	"PRIMARY KEY(source, user_guid))",
+
+	"CREATE TABLE IF NOT EXISTS sync_gap("
+	"source INTEGER NOT NULL, "
+	"user_guid INTEGER NOT NULL, "
+	"since_id INTEGER NOT NULL, "
+	"max_id INTEGER NOT NULL, "
 	"PRIMARY KEY(source, user_guid))",
 
 	"CREATE TABLE IF NOT EXISTS version ("
@@ -107,11 +117,51 @@ const gchar *twitterdb_queries_create_tables[] =
 	"minor INTEGER NOT NULL, "
 	"PRIMARY KEY(id))",
 
+	"CREATE VIRTUAL TABLE status_search USING fts4(text, username, realname)",
+
+	"CREATE TRIGGER IF NOT EXISTS status_search_delete AFTER DELETE ON status "
+	"BEGIN DELETE FROM status_search WHERE docid=old.guid; END",
+
+	"CREATE TABLE IF NOT EXISTS timeline_read_mark ("
+	"user_guid INTEGER NOT NULL REFERENCES user(guid) ON DELETE CASCADE, "
+	"type INTEGER NOT NULL, "
+	"timestamp INTEGER NOT NULL, "
+	"PRIMARY KEY(user_guid, type))",
+
+	"CREATE TABLE IF NOT EXISTS list_read_mark ("
+	"list_guid INTEGER NOT NULL PRIMARY KEY REFERENCES list(guid) ON DELETE CASCADE, "
+	"timestamp INTEGER NOT NULL)",
+
 	"COMMIT",
 
 	NULL
 };
 
+const gchar *twitterdb_queries_create_indexes[] =
+{
+	"CREATE INDEX IF NOT EXISTS user_username ON user(username COLLATE NOCASE)",
+
+	"CREATE INDEX IF NOT EXISTS status_timestamp ON status(timestamp)",
+
+	"CREATE INDEX IF NOT EXISTS status_user ON status(user_guid)",
+
+	"CREATE INDEX IF NOT EXISTS follower_user2 ON follower(user2_guid, user1_guid)",
+
+	"CREATE INDEX IF NOT EXISTS list_user ON list(user_guid, name COLLATE NOCASE)",
+
+	"CREATE INDEX IF NOT EXISTS list_timeline_status ON list_timeline(status_guid)",
+
+	"CREATE INDEX IF NOT EXISTS list_member_user ON list_member(user_guid, list_guid)",
+
+	"CREATE INDEX IF NOT EXISTS timeline_status ON timeline(status_guid)",
+
+	"CREATE INDEX IF NOT EXISTS direct_message_sender ON direct_message(sender_guid)",
+
+	"CREATE INDEX IF NOT EXISTS direct_message_receiver ON direct_message(receiver_guid)",
+
+	NULL
+};
+
 const gchar *twitterdb_queries_replace_version = "REPLACE INTO version (id, major, minor) VALUES (1, ?, ?)";
 
 const gchar *twitterdb_queries_count_table = "SELECT COUNT(name) FROM sqlite_master WHERE name=? COLLATE NOCASE";
@@ -124,15 +174,52 @@ const gchar *twitterdb_queries_map_username = "SELECT guid FROM user WHERE usern
 
 const gchar *twitterdb_queries_user_exists = "SELECT COUNT(guid) FROM user WHERE guid=?";
 
-const gchar *twitterdb_queries_insert_user = "INSERT INTO user (guid, username, realname, image, location, website, description) VALUES (?, ?, ?, ?, ?, ?, ?)";
+const gchar *twitterdb_queries_insert_user =
+	"INSERT OR IGNORE INTO user (guid, username, realname, image, location, website, description) VALUES (?1, ?2, ?3, ?4, ?5, ?6, ?7)";
 
-const gchar *twitterdb_queries_update_user = "UPDATE user SET username=?, realname=?, image=?, location=?, website=?, description=? WHERE guid=?";
+const gchar *twitterdb_queries_update_user =
+	"UPDATE user SET username=?2, realname=?3, image=?4, location=?5, website=?6, description=?7 "
+	"WHERE guid=?1 AND (username IS NOT ?2 OR realname IS NOT ?3 OR image IS NOT ?4 OR location IS NOT ?5 OR website IS NOT ?6 OR description IS NOT ?7)";
 
-const gchar *twitterdb_queries_mark_statuses_read = "UPDATE status SET read=1";
+const gchar *twitterdb_queries_mark_timeline_read =
+	"REPLACE INTO timeline_read_mark (user_guid, type, timestamp) SELECT guid, ?1, ?3 FROM \"user\" WHERE username=?2 COLLATE NOCASE";
+
+const gchar *twitterdb_queries_mark_list_read =
+	"REPLACE INTO list_read_mark (list_guid, timestamp) SELECT list.guid, ?3 FROM list "
+	"INNER JOIN \"user\" AS owner ON owner.guid=list.user_guid "
+	"WHERE owner.username=?1 COLLATE NOCASE AND list.name=?2 COLLATE NOCASE";
+
+const gchar *twitterdb_queries_count_unread_in_timeline =
+	"SELECT COUNT(status_guid) FROM timeline "
+	"WHERE type=?1 AND user_guid=(SELECT guid FROM \"user\" WHERE username=?2 COLLATE NOCASE) "
+	"AND timestamp>IFNULL((SELECT timeline_read_mark.timestamp FROM timeline_read_mark "
+	"WHERE timeline_read_mark.type=?1 AND timeline_read_mark.user_guid=(SELECT guid FROM \"user\" WHERE username=?2 COLLATE NOCASE)), 0)";
+
+const gchar *twitterdb_queries_count_unread_in_list =
+	"SELECT COUNT(status_guid) FROM list_timeline "
+	"WHERE list_guid=(SELECT list.guid FROM list INNER JOIN \"user\" AS owner ON owner.guid=list.user_guid "
+	"WHERE owner.username=?1 COLLATE NOCASE AND list.name=?2 COLLATE NOCASE) "
+	"AND timestamp>IFNULL((SELECT list_read_mark.timestamp FROM list_read_mark "
+	"WHERE list_read_mark.list_guid=(SELECT list.guid FROM list INNER JOIN \"user\" AS owner ON owner.guid=list.user_guid "
+	"WHERE owner.username=?1 COLLATE NOCASE AND list.name=?2 COLLATE NOCASE)), 0)";
 
 const gchar *twitterdb_queries_status_exists = "SELECT COUNT(guid) FROM status WHERE guid=?";
 
-const gchar *twitterdb_queries_insert_status = "INSERT INTO status (guid, prev_status, text, user_guid, timestamp, read) VALUES (?, ?, ?, ?, ?, 0)";
+const gchar *twitterdb_queries_insert_status = "INSERT OR IGNORE INTO status (guid, prev_status, text, user_guid, timestamp, read) VALUES (?, ?, ?, ?, ?, 0)";
+
+const gchar *twitterdb_queries_insert_status_search =
+	"INSERT INTO status_search (docid, text, username, realname) "
+	"SELECT status.guid, status.text, author.username, author.realname FROM status "
+	"INNER JOIN \"user\" AS author ON author.guid=status.user_guid WHERE status.guid=?";
+
+const gchar *twitterdb_queries_search_statuses =
+	"SELECT status.guid, status.text, status.timestamp, status.read, status.user_guid, "
+	"publisher.username, publisher.realname, publisher.image, publisher.location, publisher.website, publisher.description, status.prev_status "
+	"FROM status_search "
+	"INNER JOIN status ON status.guid=status_search.docid "
+	"INNER JOIN \"user\" AS publisher ON publisher.guid=status.user_guid "
+	"WHERE status_search MATCH ? "
+	"ORDER BY status.timestamp DESC LIMIT ?";
 
 const gchar *twitterdb_queries_delete_status = "DELETE FROM status WHERE guid=?";
 
@@ -150,6 +237,33 @@ const gchar *twitterdb_queries_get_followers = "SELECT user1_guid FROM follower
 
 const gchar *twitterdb_queries_remove_followers_from_user = "DELETE FROM follower WHERE user2_guid=?";
 
+const gchar *twitterdb_queries_create_staged_followers =
+	"CREATE TEMP TABLE IF NOT EXISTS staged_follower (user_guid INTEGER NOT NULL PRIMARY KEY)";
+
+const gchar *twitterdb_queries_clear_staged_followers = "DELETE FROM temp.staged_follower";
+
+const gchar *twitterdb_queries_insert_staged_follower = "INSERT OR IGNORE INTO temp.staged_follower (user_guid) VALUES (?)";
+
+const gchar *twitterdb_queries_delete_unstaged_friends =
+	"DELETE FROM follower WHERE user1_guid=? AND "
+	"NOT EXISTS (SELECT 1 FROM temp.staged_follower AS staged WHERE staged.user_guid=follower.user2_guid)";
+
+const gchar *twitterdb_queries_delete_unstaged_followers =
+	"DELETE FROM follower WHERE user2_guid=? AND "
+	"NOT EXISTS (SELECT 1 FROM temp.staged_follower AS staged WHERE staged.user_guid=follower.user1_guid)";
+
+const gchar *twitterdb_queries_insert_staged_friends =
+	"INSERT OR IGNORE INTO follower (user1_guid, user2_guid) SELECT ?, staged.user_guid FROM temp.staged_follower AS staged "
+	"WHERE EXISTS (SELECT 1 FROM \"user\" WHERE \"user\".guid=staged.user_guid)";
+
+const gchar *twitterdb_queries_insert_staged_followers =
+	"INSERT OR IGNORE INTO follower (user1_guid, user2_guid) SELECT staged.user_guid, ? FROM temp.staged_follower AS staged "
+	"WHERE EXISTS (SELECT 1 FROM \"user\" WHERE \"user\".guid=staged.user_guid)";
+
+const gchar *twitterdb_queries_get_unknown_staged_followers =
+	"SELECT staged.user_guid FROM temp.staged_follower AS staged "
+	"WHERE NOT EXISTS (SELECT 1 FROM \"user\" WHERE \"user\".guid=staged.user_guid)";
+
 const gchar *twitterdb_queries_is_follower = "SELECT COUNT(user1_guid) FROM follower "
                                              "INNER JOIN \"user\" AS user1 ON follower.user1_guid=user1.guid "
                                              "INNER JOIN \"user\" AS user2 ON follower.user2_guid=user2.guid WHERE user1.username=? COLLATE NOCASE AND user2.username=? COLLATE NOCASE";
@@ -177,14 +291,31 @@ const gchar *twitterdb_queries_remove_obsolete_statuses_from_list =
 	"(SELECT status.guid FROM list_timeline INNER JOIN status ON status.guid=list_timeline.status_guid WHERE list_guid=? AND status.user_guid NOT IN "
 	"(SELECT list_member.user_guid FROM list_member WHERE list_member.list_guid=?))";
 
-const gchar *twitterdb_queries_replace_status_into_timeline = "REPLACE INTO timeline (user_guid, status_guid, type) VALUES (?, ?, ?)";
+const gchar *twitterdb_queries_insert_status_into_timeline =
+	"INSERT OR IGNORE INTO timeline (user_guid, status_guid, type, timestamp) VALUES (?, ?, ?, (SELECT timestamp FROM status WHERE guid=?))";
 
-const gchar *twitterdb_queries_replace_into_list_timeline = "REPLACE INTO list_timeline (list_guid, status_guid) VALUES (?, ?)";
+const gchar *twitterdb_queries_insert_into_list_timeline =
+	"INSERT OR IGNORE INTO list_timeline (list_guid, status_guid, timestamp) VALUES (?, ?, (SELECT timestamp FROM status WHERE guid=?))";
 
 const gchar *twitterdb_queries_delete_list_members = "DELETE FROM list_member WHERE list_guid=?";
 
 const gchar *twitterdb_queries_replace_into_list_member = "REPLACE INTO list_member (list_guid, user_guid) VALUES (?, ?)";
 
+const gchar *twitterdb_queries_create_staged_list_members =
+	"CREATE TEMP TABLE IF NOT EXISTS staged_list_member (list_guid INTEGER NOT NULL, user_guid INTEGER NOT NULL, PRIMARY KEY(list_guid, user_guid))";
+
+const gchar *twitterdb_queries_clear_staged_list_members = "DELETE FROM temp.staged_list_member WHERE list_guid=?";
+
+const gchar *twitterdb_queries_insert_staged_list_member = "INSERT OR IGNORE INTO temp.staged_list_member (list_guid, user_guid) VALUES (?, ?)";
+
+const gchar *twitterdb_queries_delete_unstaged_list_members =
+	"DELETE FROM list_member WHERE list_guid=? AND "
+	"NOT EXISTS (SELECT 1 FROM temp.staged_list_member AS staged WHERE staged.list_guid=list_member.list_guid AND staged.user_guid=list_member.user_guid)";
+
+const gchar *twitterdb_queries_insert_staged_list_members =
+	"INSERT OR IGNORE INTO list_member (list_guid, user_guid) SELECT staged.list_guid, staged.user_guid FROM temp.staged_list_member AS staged "
+	"WHERE staged.list_guid=? AND EXISTS (SELECT 1 FROM \"user\" WHERE \"user\".guid=staged.user_guid)";
+
 const gchar *twitterdb_queries_get_list_members =
 	"SELECT member.guid, member.username, member.realname, member.image, member.location, member.website, member.description FROM list_member "
 	"INNER JOIN list ON list.guid=list_member.list_guid "
@@ -199,35 +330,37 @@ const gchar *twitterdb_queries_direct_message_exists = "SELECT COUNT(guid) FROM
 const gchar *twitterdb_queries_insert_direct_message = "INSERT INTO direct_message (guid, text, timestamp, sender_guid, receiver_guid) VALUES (?, ?, ?, ?, ?)";
 
 const gchar *twitterdb_queries_get_tweets_from_timeline =
-	"SELECT status_guid, text, \"timestamp\", read, status.user_guid, "
+	"SELECT status_guid, text, status.timestamp, read, status.user_guid, "
 	"publisher.username, publisher.realname, publisher.image, publisher.location, publisher.website, publisher.description, status.prev_status "
 	"FROM timeline "
 	"INNER JOIN status ON status.guid=timeline.status_guid "
-	"INNER JOIN \"user\" AS owner ON owner.guid=timeline.user_guid "
 	"INNER JOIN \"user\" AS publisher ON publisher.guid=status.user_guid "
-	"WHERE type=? AND owner.username=? COLLATE NOCASE "
-	"ORDER BY \"timestamp\" DESC LIMIT 50";
+	"WHERE timeline.type=? AND timeline.user_guid=(SELECT guid FROM \"user\" WHERE username=? COLLATE NOCASE) "
+	"AND timeline.timestamp<=? AND (timeline.timestamp<? OR timeline.status_guid<?) "
+	"ORDER BY timeline.timestamp DESC, timeline.status_guid DESC LIMIT ?";
 
 const gchar *twitterdb_queries_get_new_tweets_from_timeline =
-	"SELECT status_guid, text, \"timestamp\", read, status.user_guid, "
+	"SELECT status_guid, text, status.timestamp, read, status.user_guid, "
 	"publisher.username, publisher.realname, publisher.image, publisher.location, publisher.website, publisher.description, status.prev_status "
 	"FROM timeline "
 	"INNER JOIN status ON status.guid=timeline.status_guid "
-	"INNER JOIN \"user\" AS owner ON owner.guid=timeline.user_guid "
 	"INNER JOIN \"user\" AS publisher ON publisher.guid=status.user_guid "
-	"WHERE type=? AND owner.username=? COLLATE NOCASE AND read=0 "
-	"ORDER BY \"timestamp\" DESC LIMIT 50";
+	"WHERE timeline.type=?1 AND timeline.user_guid=(SELECT guid FROM \"user\" WHERE username=?2 COLLATE NOCASE) "
+	"AND timeline.timestamp>IFNULL((SELECT timeline_read_mark.timestamp FROM timeline_read_mark "
+	"WHERE timeline_read_mark.type=?1 AND timeline_read_mark.user_guid=(SELECT guid FROM \"user\" WHERE username=?2 COLLATE NOCASE)), 0) "
+	"AND timeline.timestamp<=?3 AND (timeline.timestamp<?4 OR timeline.status_guid<?5) "
+	"ORDER BY timeline.timestamp DESC, timeline.status_guid DESC LIMIT ?6";
 
 const gchar *twitterdb_queries_get_tweets_from_list =
-	"SELECT status_guid, text, \"timestamp\", read, status.user_guid, "
+	"SELECT status_guid, text, status.timestamp, read, status.user_guid, "
 	"publisher.username, publisher.realname, publisher.image, publisher.location, publisher.website, publisher.description, status.prev_status "
 	"FROM list_timeline "
 	"INNER JOIN status ON status.guid=list_timeline.status_guid "
-	"INNER JOIN list ON list_timeline.list_guid=list.guid "
 	"INNER JOIN \"user\" AS publisher ON publisher.guid=status.user_guid "
-	"INNER JOIN \"user\" AS owner ON owner.guid=list.user_guid "
-	"WHERE owner.username=? COLLATE NOCASE AND list.name=? COLLATE NOCASE "
-	"ORDER BY \"timestamp\" DESC LIMIT 50";
+	"WHERE list_timeline.list_guid=(SELECT list.guid FROM list INNER JOIN \"user\" AS owner ON owner.guid=list.user_guid "
+	"WHERE owner.username=? COLLATE NOCASE AND list.name=? COLLATE NOCASE) "
+	"AND list_timeline.timestamp<=? AND (list_timeline.timestamp<? OR list_timeline.status_guid<?) "
+	"ORDER BY list_timeline.timestamp DESC, list_timeline.status_guid DESC LIMIT ?";
 
 const gchar *twitterdb_queries_get_list_membership =
 	"SELECT owner.username, list.name FROM list "
@@ -246,12 +379,270 @@ const gchar *twitterdb_queries_user_is_list_member =
 
 const gchar *twitterdb_queries_get_sync_seconds = "SELECT seconds FROM last_sync WHERE source=? AND user_guid=?";
 
-const gchar *twitterdb_queries_replace_sync_seconds = "REPLACE INTO last_sync (source, user_guid, seconds) VALUES (?, ?, ?)";
+const gchar *twitterdb_queries_replace_sync_seconds =
+	"REPLACE INTO last_sync (source, user_guid, seconds, since_id) VALUES (?1, ?2, ?3, "
+	"IFNULL((SELECT since_id FROM last_sync WHERE source=?1 AND user_guid=?2), 0))";
+
+const gchar *twitterdb_queries_get_since_id = "SELECT since_id FROM last_sync WHERE source=? AND user_guid=?";
+
+const gchar *twitterdb_queries_replace_since_id =
+	"REPLACE INTO last_sync (source, user_guid, seconds, since_id) VALUES (?1, ?2, "
+	"IFNULL((SELECT seconds FROM last_sync WHERE source=?1 AND user_guid=?2), 0), ?3)";
+
+const gchar *twitterdb_queries_remove_since_id = "DELETE FROM last_sync WHERE source=? AND user_guid=?";
+
+const gchar *twitterdb_queries_get_sync_gap = "SELECT since_id, max_id FROM sync_gap WHERE source=? AND user_guid=?";
+
+const gchar *twitterdb_queries_replace_sync_gap = "REPLACE INTO sync_gap (source, user_guid, since_id, max_id) VALUES (?, ?, ?, ?)";
+
+const gchar *twitterdb_queries_remove_sync_gap = "DELETE FROM sync_gap WHERE source=? AND user_guid=?";
 
 const gchar *twitterdb_queries_remove_sync_seconds = "DELETE FROM last_sync WHERE source=?";
 
 const gchar *twitterdb_queries_add_prev_status_column = "ALTER TABLE status ADD COLUMN prev_status VARCHAR(32)";
 
+const gchar *twitterdb_queries_add_since_id_column = "ALTER TABLE last_sync ADD COLUMN since_id INTEGER NOT NULL DEFAULT 0";
+
+const gchar *twitterdb_queries_upgrade_0_3_to_0_4[] =
+{
+	"CREATE TABLE new_user ("
+	"guid INTEGER NOT NULL PRIMARY KEY, "
+	"username VARCHAR(64) NOT NULL, "
+	"realname VARCHAR(64) NOT NULL, "
+	"image VARCHAR(64) NOT NULL, "
+	"location VARCHAR(64) NOT NULL, "
+	"website VARCHAR(256) NOT NULL, "
+	"description VARCHAR(256) NOT NULL)",
+
+	"INSERT INTO new_user SELECT CAST(guid AS INTEGER), username, realname, image, location, website, description FROM user",
+
+	"DROP TABLE user",
+
+	"ALTER TABLE new_user RENAME TO user",
+
+	"CREATE TABLE new_status ("
+	"guid INTEGER NOT NULL PRIMARY KEY, "
+	"prev_status INTEGER, "
+	"text VARCHAR(140) NOT NULL, "
+	"user_guid INTEGER NOT NULL REFERENCES user(guid) ON DELETE CASCADE, "
+	"timestamp INTEGER NOT NULL, "
+	"read BOOLEAN NOT NULL)",
+
+	"INSERT INTO new_status SELECT CAST(guid AS INTEGER), CAST(NULLIF(prev_status, '') AS INTEGER), text, CAST(user_guid AS INTEGER), timestamp, read FROM status",
+
+	"DROP TABLE status",
+
+	"ALTER TABLE new_status RENAME TO status",
+
+	"CREATE TABLE new_follower ("
+	"user1_guid INTEGER NOT NULL REFERENCES user(guid) ON DELETE CASCADE, "
+	"user2_guid INTEGER NOT NULL REFERENCES user(guid) ON DELETE CASCADE, "
+	"PRIMARY KEY(user1_guid, user2_guid))",
+
+	"INSERT INTO new_follower SELECT CAST(user1_guid AS INTEGER), CAST(user2_guid AS INTEGER) FROM follower",
+
+	"DROP TABLE follower",
+
+	"ALTER TABLE new_follower RENAME TO follower",
+
+	"CREATE TABLE new_list("
+	"guid INTEGER NOT NULL PRIMARY KEY, "
+	"user_guid INTEGER NOT NULL REFERENCES user(guid) ON DELETE CASCADE, "
+	"name VARCHAR(64) NOT NULL, "
+	"fullname VARCHAR(64) NOT NULL, "
+	"uri VARCHAR(256) NOT NULL, "
+	"description VARCHAR(256) NOT NULL, "
+	"protected BOOLEAN NOT NULL, "
+	"subscriber_count INTEGER NOT NULL, "
+	"member_count INTEGER NOT NULL)",
+
+	"INSERT INTO new_list SELECT CAST(guid AS INTEGER), CAST(user_guid AS INTEGER), name, fullname, uri, description, protected, subscriber_count, member_count FROM list",
+
+	"DROP TABLE list",
+
+	"ALTER TABLE new_list RENAME TO list",
+
+	"CREATE TABLE new_list_timeline ("
+	"list_guid INTEGER NOT NULL REFERENCES list(guid) ON DELETE CASCADE, "
+	"status_guid INTEGER NOT NULL REFERENCES status(guid) ON DELETE CASCADE, "
+	"PRIMARY KEY(list_guid, status_guid))",
+
+	"INSERT INTO new_list_timeline SELECT CAST(list_guid AS INTEGER), CAST(status_guid AS INTEGER) FROM list_timeline",
+
+	"DROP TABLE list_timeline",
+
+	"ALTER TABLE new_list_timeline RENAME TO list_timeline",
+
+	"CREATE TABLE new_list_member ("
+	"list_guid INTEGER NOT NULL REFERENCES list(guid) ON DELETE CASCADE, "
+	"user_guid INTEGER NOT NULL REFERENCES user(guid) ON DELETE CASCADE, "
+	"PRIMARY KEY(list_guid, user_guid))",
+
+	"INSERT INTO new_list_member SELECT CAST(list_guid AS INTEGER), CAST(user_guid AS INTEGER) FROM list_member",
+
+	"DROP TABLE list_member",
+
+	"ALTER TABLE new_list_member RENAME TO list_member",
+
+	"CREATE TABLE new_timeline ("
+	"user_guid INTEGER NOT NULL REFERENCES user(guid) ON DELETE CASCADE, "
+	"status_guid INTEGER NOT NULL REFERENCES status(guid) ON DELETE CASCADE, "
+	"type INTEGER NOT NULL, "
+	"PRIMARY KEY(user_guid, status_guid, type))",
+
+	"INSERT INTO new_timeline SELECT CAST(user_guid AS INTEGER), CAST(status_guid AS INTEGER), type FROM timeline",
+
+	"DROP TABLE timeline",
+
+	"ALTER TABLE new_timeline RENAME TO timeline",
+
+ 	"CREATE TABLE new_direct_message("
+	"guid INTEGER NOT NULL PRIMARY KEY, "
+	"text VARCHAR(140) NOT NULL, "
+	"timestamp INTEGER NOT NULL, "
+	"sender_guid INTEGER NOT NULL REFERENCES user(guid) ON DELETE CASCADE, "
+	"receiver_guid INTEGER NOT NULL REFERENCES user(guid) ON DELETE CASCADE)",
+
+	"INSERT INTO new_direct_message SELECT CAST(guid AS INTEGER), text, timestamp, CAST(sender_guid AS INTEGER), CAST(receiver_guid AS INTEGER) FROM direct_message",
+
+	"DROP TABLE direct_message",
+
+	"ALTER TABLE new_direct_message RENAME TO direct_message",
+
+ 	"CREATE TABLE new_last_sync("
+	"source INTEGER NOT NULL, "
+	"user_guid INTEGER NOT NULL, "
+	"seconds INTEGER NOT NULL, "
+	"PRIMARY KEY(source, user_guid))",
+
+	"INSERT INTO new_last_sync SELECT source, CAST(user_guid AS INTEGER), seconds FROM last_sync",
+
+	"DROP TABLE last_sync",
+
+	"ALTER TABLE new_last_sync RENAME TO last_sync",
+
+	NULL
+};
+
+const gchar *twitterdb_queries_upgrade_0_4_to_0_5[] =
+{
+	"ALTER TABLE timeline ADD COLUMN timestamp INTEGER NOT NULL DEFAULT 0",
+
+	"UPDATE timeline SET timestamp=(SELECT status.timestamp FROM status WHERE status.guid=timeline.status_guid)",
+
+	"DROP INDEX IF EXISTS timeline_user_type",
+
+	"CREATE INDEX IF NOT EXISTS timeline_page ON timeline(user_guid, type, timestamp, status_guid)",
+
+	"ALTER TABLE list_timeline ADD COLUMN timestamp INTEGER NOT NULL DEFAULT 0",
+
+	"UPDATE list_timeline SET timestamp=(SELECT status.timestamp FROM status WHERE status.guid=list_timeline.status_guid)",
+
+	"CREATE INDEX IF NOT EXISTS list_timeline_page ON list_timeline(list_guid, timestamp, status_guid)",
+
+	NULL
+};
+
+const gchar *twitterdb_queries_upgrade_0_5_to_0_6[] =
+{
+	"CREATE VIRTUAL TABLE status_search USING fts4(text, username, realname)",
+
+	"INSERT INTO status_search (docid, text, username, realname) "
+	"SELECT status.guid, status.text, author.username, author.realname FROM status "
+	"INNER JOIN \"user\" AS author ON author.guid=status.user_guid",
+
+	"CREATE TRIGGER IF NOT EXISTS status_search_delete AFTER DELETE ON status "
+	"BEGIN DELETE FROM status_search WHERE docid=old.guid; END",
+
+	NULL
+};
+
+const gchar *twitterdb_queries_upgrade_0_6_to_0_7[] =
+{
+	"CREATE TABLE IF NOT EXISTS timeline_read_mark ("
+	"user_guid INTEGER NOT NULL REFERENCES user(guid) ON DELETE CASCADE, "
+	"type INTEGER NOT NULL, "
+	"timestamp INTEGER NOT NULL, "
+	"PRIMARY KEY(user_guid, type))",
+
+	"CREATE TABLE IF NOT EXISTS list_read_mark ("
+	"list_guid INTEGER NOT NULL PRIMARY KEY REFERENCES list(guid) ON DELETE CASCADE, "
+	"timestamp INTEGER NOT NULL)",
+
+	"INSERT INTO timeline_read_mark (user_guid, type, timestamp) "
+	"SELECT timeline.user_guid, timeline.type, MAX(timeline.timestamp) FROM timeline "
+	"INNER JOIN status ON status.guid=timeline.status_guid WHERE status.read=1 "
+	"GROUP BY timeline.user_guid, timeline.type",
+
+	"INSERT INTO list_read_mark (list_guid, timestamp) "
+	"SELECT list_timeline.list_guid, MAX(list_timeline.timestamp) FROM list_timeline "
+	"INNER JOIN status ON status.guid=list_timeline.status_guid WHERE status.read=1 "
+	"GROUP BY list_timeline.list_guid",
+
+	NULL
+};
+
+const gchar *twitterdb_queries_upgrade_0_8_to_0_9[] =
+{
+	"CREATE TABLE IF NOT EXISTS sync_gap("
+	"source INTEGER NOT NULL, "
+	"user_guid INTEGER NOT NULL, "
+	"since_id INTEGER NOT NULL, "
+	"max_id INTEGER NOT NULL, "
+	"PRIMARY KEY(source, user_guid))",
+
+	NULL
+};
+
+const gchar *twitterdb_queries_get_timeline_groups = "SELECT DISTINCT user_guid, type FROM timeline";
+
+const gchar *twitterdb_queries_get_timeline_cutoff =
+	"SELECT timestamp FROM timeline WHERE user_guid=? AND type=? ORDER BY timestamp DESC LIMIT 1 OFFSET ?";
+
+const gchar *twitterdb_queries_delete_old_timeline_entries =
+	"DELETE FROM timeline WHERE rowid IN (SELECT rowid FROM timeline WHERE user_guid=? AND type=? AND timestamp<=? LIMIT ?)";
+
+const gchar *twitterdb_queries_get_list_timeline_groups = "SELECT DISTINCT list_guid FROM list_timeline";
+
+const gchar *twitterdb_queries_get_list_timeline_cutoff =
+	"SELECT timestamp FROM list_timeline WHERE list_guid=? ORDER BY timestamp DESC LIMIT 1 OFFSET ?";
+
+const gchar *twitterdb_queries_delete_old_list_timeline_entries =
+	"DELETE FROM list_timeline WHERE rowid IN (SELECT rowid FROM list_timeline WHERE list_guid=? AND timestamp<=? LIMIT ?)";
+
+const gchar *twitterdb_queries_delete_expired_statuses = "DELETE FROM status WHERE guid IN (SELECT guid FROM status WHERE timestamp<? LIMIT ?)";
+
+const gchar *twitterdb_queries_delete_orphaned_statuses =
+	"DELETE FROM status WHERE guid IN "
+	"(SELECT guid FROM status WHERE "
+	"NOT EXISTS (SELECT 1 FROM timeline WHERE timeline.status_guid=status.guid) AND "
+	"NOT EXISTS (SELECT 1 FROM list_timeline WHERE list_timeline.status_guid=status.guid) LIMIT ?)";
+
+const gchar *twitterdb_queries_delete_orphaned_users =
+	"DELETE FROM user WHERE guid IN "
+	"(SELECT guid FROM user WHERE "
+	"NOT EXISTS (SELECT 1 FROM status WHERE status.user_guid=user.guid) AND "
+	"NOT EXISTS (SELECT 1 FROM timeline WHERE timeline.user_guid=user.guid) AND "
+	"NOT EXISTS (SELECT 1 FROM follower WHERE follower.user1_guid=user.guid) AND "
+	"NOT EXISTS (SELECT 1 FROM follower WHERE follower.user2_guid=user.guid) AND "
+	"NOT EXISTS (SELECT 1 FROM list WHERE list.user_guid=user.guid) AND "
+	"NOT EXISTS (SELECT 1 FROM list_member WHERE list_member.user_guid=user.guid) AND "
+	"NOT EXISTS (SELECT 1 FROM direct_message WHERE direct_message.sender_guid=user.guid) AND "
+	"NOT EXISTS (SELECT 1 FROM direct_message WHERE direct_message.receiver_guid=user.guid) AND "
+	"NOT EXISTS (SELECT 1 FROM last_sync WHERE last_sync.user_guid=user.guid) LIMIT ?)";
+
+const gchar *twitterdb_queries_get_freelist_count = "PRAGMA freelist_count";
+
+const gchar *twitterdb_queries_get_auto_vacuum = "PRAGMA auto_vacuum";
+
+const gchar *twitterdb_queries_begin_transaction = "BEGIN TRANSACTION";
+
+const gchar *twitterdb_queries_begin_immediate_transaction = "BEGIN IMMEDIATE TRANSACTION";
+
+const gchar *twitterdb_queries_commit_transaction = "COMMIT";
+
+const gchar *twitterdb_queries_rollback_transaction = "ROLLBACK";
+
 /**
  * @}
  * @}
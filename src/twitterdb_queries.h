@@ -36,6 +36,8 @@
 
 /*! Creates tables. */
 extern const gchar *twitterdb_queries_create_tables[];
+/*! Creates the secondary indexes. */
+extern const gchar *twitterdb_queries_create_indexes[];
 /*! Replaces the database model version. */
 extern const gchar *twitterdb_queries_replace_version;
 /*! Checks if a table does exist. */
@@ -48,16 +50,26 @@ extern const gchar *twitterdb_queries_get_user;
 extern const gchar *twitterdb_queries_map_username;
 /*! Counts users filterered by guid. */
 extern const gchar *twitterdb_queries_user_exists;
-/*! Creates a new user. */
+/*! Creates a new user if the guid is unknown. */
 extern const gchar *twitterdb_queries_insert_user;
-/*! Updates a user. */
+/*! Updates a user if at least one of its fields has changed. */
 extern const gchar *twitterdb_queries_update_user;
-/*! Marks all statuses read. */
-extern const gchar *twitterdb_queries_mark_statuses_read;
+/*! Sets the read mark of a timeline. */
+extern const gchar *twitterdb_queries_mark_timeline_read;
+/*! Sets the read mark of a list. */
+extern const gchar *twitterdb_queries_mark_list_read;
+/*! Counts statuses of a timeline newer than its read mark. */
+extern const gchar *twitterdb_queries_count_unread_in_timeline;
+/*! Counts statuses of a list newer than its read mark. */
+extern const gchar *twitterdb_queries_count_unread_in_list;
 /*! Counts statuses filtered by guid. */
 extern const gchar *twitterdb_queries_status_exists;
-/*! Creates a new status. */
+/*! Creates a new status if the guid is unknown. */
 extern const gchar *twitterdb_queries_insert_status;
+/*! Adds a status to the full-text index. */
+extern const gchar *twitterdb_queries_insert_status_search;
+/*! Searches the full-text index. */
+extern const gchar *twitterdb_queries_search_statuses;
 /*! Deletes an status. */
 extern const gchar *twitterdb_queries_delete_status;
 /*! Gets a status. */
@@ -72,6 +84,22 @@ extern const gchar *twitterdb_queries_get_friends;
 extern const gchar *twitterdb_queries_get_followers;
 /*! Removes all followers from a user. */
 extern const gchar *twitterdb_queries_remove_followers_from_user;
+/*! Creates the temporary table holding fetched friend/follower ids. */
+extern const gchar *twitterdb_queries_create_staged_followers;
+/*! Removes all fetched friend/follower ids. */
+extern const gchar *twitterdb_queries_clear_staged_followers;
+/*! Stores a fetched friend/follower id. */
+extern const gchar *twitterdb_queries_insert_staged_follower;
+/*! Removes friends of a user which haven't been fetched. */
+extern const gchar *twitterdb_queries_delete_unstaged_friends;
+/*! Removes followers of a user which haven't been fetched. */
+extern const gchar *twitterdb_queries_delete_unstaged_followers;
+/*! Adds fetched friends of a user. */
+extern const gchar *twitterdb_queries_insert_staged_friends;
+/*! Adds fetched followers of a user. */
+extern const gchar *twitterdb_queries_insert_staged_followers;
+/*! Gets fetched friend/follower ids without user details. */
+extern const gchar *twitterdb_queries_get_unknown_staged_followers;
 /*! Tests if one user is following another user. */
 extern const gchar *twitterdb_queries_is_follower;
 /*! Removes all friends of a user. */
@@ -96,14 +124,24 @@ extern const gchar *twitterdb_queries_get_list_guid;
 extern const gchar *twitterdb_queries_get_list_guids_from_user;
 /*! Removes all obsolete statuses from a list. */
 extern const gchar *twitterdb_queries_remove_obsolete_statuses_from_list;
-/*! Inserts a status into a timeline. */
-extern const gchar *twitterdb_queries_replace_status_into_timeline;
-/*! Inserts a status into the timeline of a list. */
-extern const gchar *twitterdb_queries_replace_into_list_timeline;
+/*! Inserts a status into a timeline unless it's already there. */
+extern const gchar *twitterdb_queries_insert_status_into_timeline;
+/*! Inserts a status into the timeline of a list unless it's already there. */
+extern const gchar *twitterdb_queries_insert_into_list_timeline;
 /*! Deletes all members of a list. */
 extern const gchar *twitterdb_queries_delete_list_members;
 /*! Assignes a user as list member. */
 extern const gchar *twitterdb_queries_replace_into_list_member;
+/*! Creates the temporary table holding fetched list member ids. */
+extern const gchar *twitterdb_queries_create_staged_list_members;
+/*! Removes the fetched member ids of a list. */
+extern const gchar *twitterdb_queries_clear_staged_list_members;
+/*! Stores a fetched list member id. */
+extern const gchar *twitterdb_queries_insert_staged_list_member;
+/*! Removes members of a list which haven't been fetched. */
+extern const gchar *twitterdb_queries_delete_unstaged_list_members;
+/*! Adds fetched members of a list. */
+extern const gchar *twitterdb_queries_insert_staged_list_members;
 /*! Gets all list members. */
 extern const gchar *twitterdb_queries_get_list_members;
 /*! Deletes a user from a list. */
@@ -112,11 +150,11 @@ extern const gchar *twitterdb_queries_delete_user_from_list;
 extern const gchar *twitterdb_queries_direct_message_exists;
 /*! Creates a new direct message. */
 extern const gchar *twitterdb_queries_insert_direct_message;
-/*! Gets all statuses from a timeline. */
+/*! Gets a page of statuses from a timeline. */
 extern const gchar *twitterdb_queries_get_tweets_from_timeline;
-/*! Gets all statuses from a timeline which are marked as new. */
+/*! Gets a page of statuses from a timeline which are newer than its read mark. */
 extern const gchar *twitterdb_queries_get_new_tweets_from_timeline;
-/*! Gets all statuses from a list. */
+/*! Gets a page of statuses from a list. */
 extern const gchar *twitterdb_queries_get_tweets_from_list;
 /*! Gets the lists of a user. */
 extern const gchar *twitterdb_queries_get_list_membership;
@@ -128,8 +166,62 @@ extern const gchar *twitterdb_queries_get_sync_seconds;
 extern const gchar *twitterdb_queries_replace_sync_seconds;
 /*! Delete last synchronization timestamps related to a source. */
 extern const gchar *twitterdb_queries_remove_sync_seconds;
+/*! Get the highest synchronized status id. */
+extern const gchar *twitterdb_queries_get_since_id;
+/*! Set the highest synchronized status id. */
+extern const gchar *twitterdb_queries_replace_since_id;
+/*! Remove the highest synchronized status id of a user or list. */
+extern const gchar *twitterdb_queries_remove_since_id;
+/*! Gets the unfilled gap of a synchronization source. */
+extern const gchar *twitterdb_queries_get_sync_gap;
+/*! Stores the unfilled gap of a synchronization source. */
+extern const gchar *twitterdb_queries_replace_sync_gap;
+/*! Removes the unfilled gap of a synchronization source. */
+extern const gchar *twitterdb_queries_remove_sync_gap;
 /*! Add prev_status column to status table, */
 extern const gchar *twitterdb_queries_add_prev_status_column;
+/*! Add since_id column to last_sync table. */
+extern const gchar *twitterdb_queries_add_since_id_column;
+/*! Converts guid columns to integers. */
+extern const gchar *twitterdb_queries_upgrade_0_3_to_0_4[];
+/*! Copies status timestamps to timelines. */
+extern const gchar *twitterdb_queries_upgrade_0_4_to_0_5[];
+/*! Creates & fills the full-text index. */
+extern const gchar *twitterdb_queries_upgrade_0_5_to_0_6[];
+/*! Creates the read mark tables & initializes them from the read flags of the stored statuses. */
+extern const gchar *twitterdb_queries_upgrade_0_6_to_0_7[];
+/*! Creates the table storing unfilled timeline gaps. */
+extern const gchar *twitterdb_queries_upgrade_0_8_to_0_9[];
+/*! Gets all (user, timeline type) pairs. */
+extern const gchar *twitterdb_queries_get_timeline_groups;
+/*! Gets the timestamp of the first status exceeding the timeline limit. */
+extern const gchar *twitterdb_queries_get_timeline_cutoff;
+/*! Removes old statuses from a timeline. */
+extern const gchar *twitterdb_queries_delete_old_timeline_entries;
+/*! Gets all lists containing statuses. */
+extern const gchar *twitterdb_queries_get_list_timeline_groups;
+/*! Gets the timestamp of the first status exceeding the list limit. */
+extern const gchar *twitterdb_queries_get_list_timeline_cutoff;
+/*! Removes old statuses from a list. */
+extern const gchar *twitterdb_queries_delete_old_list_timeline_entries;
+/*! Removes statuses older than the given timestamp. */
+extern const gchar *twitterdb_queries_delete_expired_statuses;
+/*! Removes statuses which are neither assigned to a timeline nor to a list. */
+extern const gchar *twitterdb_queries_delete_orphaned_statuses;
+/*! Removes users which are not referenced anymore. */
+extern const gchar *twitterdb_queries_delete_orphaned_users;
+/*! Gets the number of unused database pages. */
+extern const gchar *twitterdb_queries_get_freelist_count;
+/*! Gets the auto_vacuum mode (2 = incremental). */
+extern const gchar *twitterdb_queries_get_auto_vacuum;
+/*! Starts a transaction. */
+extern const gchar *twitterdb_queries_begin_transaction;
+/*! Starts a transaction and acquires the write lock immediately. */
+extern const gchar *twitterdb_queries_begin_immediate_transaction;
+/*! Commits the current transaction. */
+extern const gchar *twitterdb_queries_commit_transaction;
+/*! Rolls back the current transaction. */
+extern const gchar *twitterdb_queries_rollback_transaction;
 
 /**
  * @}
@@ -208,3 +208,300 @@ twitter_json_parse_search_result(const gchar *json, gint length, TwitterProcessS
 	yajl_free(handle);
 }
 
+/*
+ *	parse streams:
+ */
+
+/*! Maximum depth of maps whose key is tracked. */
+#define TWITTER_JSON_STREAM_MAX_DEPTH 4
+
+/*! Clear current key name. */
+#define _twitter_json_stream_clear_key(ctx) ((_twitter_json_stream_data *)ctx)->key[0] = '\0'
+/*! Test if cancellable has been cancelled and return from function if this is the case. */
+#define _twitter_json_stream_test_cancel(ctx) if(((_twitter_json_stream_data *)ctx)->cancellable && g_cancellable_is_cancelled(((_twitter_json_stream_data *)ctx)->cancellable)) return 0;
+
+/**
+ * \struct _twitter_json_stream_data
+ * \brief This structure holds data passed to the JSON parser functions.
+ */
+typedef struct
+{
+	/*! Current depth in the tree. */
+	gint depth;
+	/*! Current key. */
+	gchar key[32];
+	/*! Keys of the maps opened at depth 2 and above. */
+	gchar objects[TWITTER_JSON_STREAM_MAX_DEPTH][32];
+	/*! Found user. */
+	TwitterUser user;
+	/*! Found status. */
+	TwitterStatus status;
+	/*! Id of a deleted status. */
+	gchar deleted_id[32];
+	/*! A cancellable. */
+	GCancellable *cancellable;
+	/*! Callback function invoked for statuses. */
+	TwitterProcessStatusFunc status_func;
+	/*! Callback function invoked for deleted statuses. */
+	TwitterProcessIdFunc delete_func;
+	/*! User data. */
+	gpointer user_data;
+} _twitter_json_stream_data;
+
+/**
+ * \struct _TwitterJsonStreamParser
+ * \brief Parses JSON messages passed block by block.
+ */
+struct _TwitterJsonStreamParser
+{
+	/*! The yajl parser. */
+	yajl_handle handle;
+	/*! Data passed to the yajl callback functions. */
+	_twitter_json_stream_data data;
+};
+
+static const gchar *
+_twitter_json_stream_get_object(_twitter_json_stream_data *data, gint depth)
+{
+	if(depth < 2 || depth > TWITTER_JSON_STREAM_MAX_DEPTH || depth > data->depth)
+	{
+		return "";
+	}
+
+	return data->objects[depth - 1];
+}
+
+static int
+_twitter_json_stream_map_open(void *ctx)
+{
+	_twitter_json_stream_data *data = (_twitter_json_stream_data *)ctx;
+
+	_twitter_json_stream_test_cancel(ctx);
+
+	if(data->depth == 0)
+	{
+		/* a new message starts */
+		memset(&data->user, 0, sizeof(TwitterUser));
+		memset(&data->status, 0, sizeof(TwitterStatus));
+		data->deleted_id[0] = '\0';
+	}
+	else if(data->depth < TWITTER_JSON_STREAM_MAX_DEPTH)
+	{
+		g_strlcpy(data->objects[data->depth], data->key, 32);
+	}
+
+	++data->depth;
+	_twitter_json_stream_clear_key(ctx);
+
+	return 1;
+}
+
+static int
+_twitter_json_stream_map_close(void *ctx)
+{
+	_twitter_json_stream_data *data = (_twitter_json_stream_data *)ctx;
+
+	_twitter_json_stream_test_cancel(ctx);
+
+	if(data->depth == 1)
+	{
+		if(data->status.id[0] && data->user.id[0])
+		{
+			data->status_func(data->status, data->user, data->user_data);
+		}
+		else if(data->deleted_id[0] && data->delete_func)
+		{
+			data->delete_func(data->deleted_id, data->user_data);
+		}
+		else
+		{
+			g_debug("Skipping stream message");
+		}
+	}
+
+	--data->depth;
+	_twitter_json_stream_clear_key(ctx);
+
+	return 1;
+}
+
+static int
+_twitter_json_stream_map_key(void *ctx, const unsigned char *value, size_t length)
+{
+	_twitter_json_stream_data *data = (_twitter_json_stream_data *)ctx;
+
+	_twitter_json_stream_test_cancel(ctx);
+
+	if(length > 31)
+	{
+		length = 31;
+	}
+
+	memcpy(data->key, value, length);
+	data->key[length] = '\0';
+
+	return 1;
+}
+
+static int
+_twitter_json_stream_handle_value(void *ctx)
+{
+	_twitter_json_stream_test_cancel(ctx);
+	_twitter_json_stream_clear_key(ctx);
+
+	return 1;
+}
+
+static int
+_twitter_json_stream_handle_boolean(void *ctx, int value)
+{
+	return _twitter_json_stream_handle_value(ctx);
+}
+
+static int
+_twitter_json_stream_handle_number(void *ctx, const char *value, size_t length)
+{
+	return _twitter_json_stream_handle_value(ctx);
+}
+
+static int
+_twitter_json_stream_handle_string(void *ctx, const unsigned char *value, size_t length)
+{
+	_twitter_json_stream_data *data = (_twitter_json_stream_data *)ctx;
+	gchar *text = (gchar *)g_alloca(length + 1);
+
+	_twitter_json_stream_test_cancel(ctx);
+
+	memcpy(text, value, length);
+	text[length] = '\0';
+
+	if(data->depth == 1)
+	{
+		/* status */
+		if(!g_strcmp0("id_str", data->key))
+		{
+			g_strlcpy(data->status.id, text, 32);
+		}
+		else if(!g_strcmp0("created_at", data->key))
+		{
+			g_strlcpy(data->status.created_at, text, 32);
+		}
+		else if(!g_strcmp0("text", data->key))
+		{
+			g_strlcpy(data->status.text, text, 280);
+		}
+		else if(!g_strcmp0("in_reply_to_status_id_str", data->key))
+		{
+			g_strlcpy(data->status.prev_status, text, 32);
+		}
+	}
+	else if(data->depth == 2 && !g_strcmp0("user", _twitter_json_stream_get_object(data, 2)))
+	{
+		/* author of the status */
+		if(!g_strcmp0("id_str", data->key))
+		{
+			g_strlcpy(data->user.id, text, 32);
+		}
+		else if(!g_strcmp0("name", data->key))
+		{
+			g_strlcpy(data->user.name, text, 64);
+		}
+		else if(!g_strcmp0("screen_name", data->key))
+		{
+			g_strlcpy(data->user.screen_name, text, 64);
+		}
+		else if(!g_strcmp0("description", data->key))
+		{
+			g_strlcpy(data->user.description, text, 280);
+		}
+		else if(!g_strcmp0("profile_image_url", data->key))
+		{
+			g_strlcpy(data->user.image, text, 256);
+		}
+		else if(!g_strcmp0("url", data->key))
+		{
+			g_strlcpy(data->user.url, text, 256);
+		}
+		else if(!g_strcmp0("location", data->key))
+		{
+			g_strlcpy(data->user.location, text, 64);
+		}
+	}
+	else if(data->depth == 3 && !g_strcmp0("id_str", data->key) &&
+	        !g_strcmp0("delete", _twitter_json_stream_get_object(data, 2)) &&
+	        !g_strcmp0("status", _twitter_json_stream_get_object(data, 3)))
+	{
+		/* deletion notice: {"delete":{"status":{"id_str":"..."}}} */
+		g_strlcpy(data->deleted_id, text, 32);
+	}
+
+	_twitter_json_stream_clear_key(ctx);
+
+	return 1;
+}
+
+static yajl_callbacks _twitter_json_stream_funcs =
+{
+	_twitter_json_stream_handle_value,
+	_twitter_json_stream_handle_boolean,
+	NULL,
+	NULL,
+	_twitter_json_stream_handle_number,
+	_twitter_json_stream_handle_string,
+	_twitter_json_stream_map_open,
+	_twitter_json_stream_map_key,
+	_twitter_json_stream_map_close,
+	NULL,
+	NULL
+};
+
+TwitterJsonStreamParser *
+twitter_json_stream_parser_new(TwitterProcessStatusFunc status_func, TwitterProcessIdFunc delete_func, gpointer user_data, GCancellable *cancellable)
+{
+	TwitterJsonStreamParser *parser;
+
+	g_assert(status_func != NULL);
+
+	parser = g_slice_new0(TwitterJsonStreamParser);
+	parser->data.status_func = status_func;
+	parser->data.delete_func = delete_func;
+	parser->data.user_data = user_data;
+	parser->data.cancellable = cancellable;
+
+	/* messages are separated by newlines, keep-alive messages are empty lines */
+	parser->handle = yajl_alloc(&_twitter_json_stream_funcs, NULL, (void *)&parser->data);
+	yajl_config(parser->handle, yajl_allow_multiple_values, 1);
+
+	return parser;
+}
+
+gboolean
+twitter_json_stream_parser_feed(TwitterJsonStreamParser *parser, const gchar *json, gsize length)
+{
+	unsigned char *message;
+
+	if(parser->data.cancellable && g_cancellable_is_cancelled(parser->data.cancellable))
+	{
+		return FALSE;
+	}
+
+	if(yajl_parse(parser->handle, (const unsigned char *)json, length) != yajl_status_ok)
+	{
+		if((message = yajl_get_error(parser->handle, 0, (const unsigned char *)json, length)))
+		{
+			g_warning("Couldn't parse stream: %s", message);
+			yajl_free_error(parser->handle, message);
+		}
+
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+void
+twitter_json_stream_parser_free(TwitterJsonStreamParser *parser)
+{
+	yajl_free(parser->handle);
+	g_slice_free(TwitterJsonStreamParser, parser);
+}
@@ -37,6 +37,9 @@
  * 	@{
  */
 
+/*! A type definition for _TwitterJsonStreamParser. */
+typedef struct _TwitterJsonStreamParser TwitterJsonStreamParser;
+
 /**
  * \param json JSON data
  * \param length length of the XML data
@@ -48,6 +51,36 @@
  */
 void twitter_json_parse_search_result(const gchar *json, gint length, TwitterProcessStatusFunc parser_func, gpointer user_data, GCancellable *cancellable);
 
+/**
+ * \param status_func callback to invoke when a status is found
+ * \param delete_func callback to invoke when a status has been deleted or NULL
+ * \param user_data user data
+ * \param cancellable a GCancellable to abort the operation
+ * \return a new TwitterJsonStreamParser
+ *
+ * Creates a parser for a stream of whitespace or newline separated JSON messages (e.g. the
+ * Twitter user stream) which can be fed block by block. Messages which are neither statuses
+ * nor deletion notices are skipped.
+ */
+TwitterJsonStreamParser *twitter_json_stream_parser_new(TwitterProcessStatusFunc status_func, TwitterProcessIdFunc delete_func, gpointer user_data, GCancellable *cancellable);
+
+/**
+ * \param parser a TwitterJsonStreamParser
+ * \param json JSON data
+ * \param length length of the JSON data
+ * \return FALSE if the data is invalid or the operation has been cancelled
+ *
+ * Parses the next block of JSON data.
+ */
+gboolean twitter_json_stream_parser_feed(TwitterJsonStreamParser *parser, const gchar *json, gsize length);
+
+/**
+ * \param parser a TwitterJsonStreamParser
+ *
+ * Frees a TwitterJsonStreamParser.
+ */
+void twitter_json_stream_parser_free(TwitterJsonStreamParser *parser);
+
 /**
  * @}
  * @}
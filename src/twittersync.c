@@ -26,6 +26,7 @@
 
 #include "twittersync.h"
 #include "twitterxmlparser.h"
+#include "twitterjsonparser.h"
 
 /**
  * @addtogroup Core
@@ -40,6 +41,50 @@
 /*! Frees a string and set it to NULL. */
 #define _twittersync_free_buffer(b) if(b) { g_free(b); b = NULL; }
 
+static gboolean
+_twittersync_begin_batch(TwitterDbHandle *handle)
+{
+	GError *err = NULL;
+	gboolean result;
+
+	if(!(result = twitterdb_begin_batch(handle, &err)))
+	{
+		g_warning("Couldn't start database batch");
+		if(err)
+		{
+			g_warning("%s", err->message);
+			g_error_free(err);
+		}
+	}
+
+	return result;
+}
+
+static gboolean
+_twittersync_commit_batch(TwitterDbHandle *handle)
+{
+	GError *err = NULL;
+	gboolean result;
+
+	if(!(result = twitterdb_commit_batch(handle, &err)))
+	{
+		g_warning("Couldn't commit database batch");
+		if(err)
+		{
+			g_warning("%s", err->message);
+			g_error_free(err);
+		}
+	}
+
+	return result;
+}
+
+static gboolean
+_twittersync_feed_xml_parser(const gchar *data, gsize length, gpointer user_data)
+{
+	return twitter_xml_stream_parser_feed((TwitterXmlStreamParser *)user_data, data, length);
+}
+
 static gboolean
 _twittersync_save_status(TwitterDbHandle *handle, TwitterStatus status, TwitterUser user, gint *status_count)
 {
@@ -129,6 +174,266 @@ _twittersync_get_user_guid(TwitterDbHandle *handle, TwitterWebClient *client, co
 	return result;
 }
 
+/*
+ *	incremental synchronization:
+ */
+
+/*! Maximum number of additional pages requested to fill a gap in a timeline. */
+#define TWITTERSYNC_MAX_BACKFILL_PAGES 5
+
+/*!
+ * \struct _TwitterSyncPage
+ * \brief This structure holds the range of status ids found on a received page.
+ */
+typedef struct
+{
+	/*! Number of received statuses. */
+	gint count;
+	/*! Id of the newest status. */
+	gint64 newest;
+	/*! Id of the oldest status. */
+	gint64 oldest;
+} _TwitterSyncPage;
+
+/*!
+ * \struct _TwitterSyncGap
+ * \brief Range of statuses which couldn't be received yet.
+ */
+typedef struct
+{
+	/*! Statuses older than or equal to this id have been received. */
+	gint64 since_id;
+	/*! Backfilling continues with this max_id, 0 if there's no gap. */
+	gint64 max_id;
+} _TwitterSyncGap;
+
+static void
+_twittersync_register_page_status(_TwitterSyncPage *page, const gchar *status_id)
+{
+	gint64 id;
+
+	if((id = g_ascii_strtoll(status_id, NULL, 10)) > 0)
+	{
+		++page->count;
+
+		if(id > page->newest)
+		{
+			page->newest = id;
+		}
+
+		if(!page->oldest || id < page->oldest)
+		{
+			page->oldest = id;
+		}
+	}
+}
+
+static void
+_twittersync_set_client_id(TwitterWebClient *client, const gchar *property, gint64 id)
+{
+	gchar *value;
+
+	value = g_strdup_printf("%" G_GINT64_FORMAT, id);
+	g_object_set(G_OBJECT(client), property, value, NULL);
+	g_free(value);
+}
+
+/*
+ * Fetches statuses newer than since_id (and older than or equal to max_id if it isn't 0) page by
+ * page until a page isn't full or the page budget is exhausted. resume is set to the max_id the
+ * next request has to continue with or 0 if the range has been received completely.
+ */
+static gboolean
+_twittersync_fetch_range(TwitterWebClient *client, TwitterDbSyncSource source, const gchar *guid, gint64 since_id, gint64 max_id,
+                         _TwitterSyncPage *page, gboolean (* fetch_page)(gpointer user_data), gpointer user_data,
+                         GCancellable *cancellable, gint *pages, gint64 *newest, gint64 *resume)
+{
+	gint status_count = 0;
+	gboolean result;
+
+	*resume = 0;
+
+	g_object_get(G_OBJECT(client), "status-count", &status_count, NULL);
+
+	if(since_id)
+	{
+		_twittersync_set_client_id(client, "since-id", since_id);
+	}
+
+	if(max_id)
+	{
+		_twittersync_set_client_id(client, "max-id", max_id);
+	}
+
+	for(;;)
+	{
+		memset(page, 0, sizeof(_TwitterSyncPage));
+
+		if(!(result = fetch_page(user_data)))
+		{
+			break;
+		}
+
+		if(cancellable && g_cancellable_is_cancelled(cancellable))
+		{
+			result = FALSE;
+			break;
+		}
+
+		if(page->newest > *newest)
+		{
+			*newest = page->newest;
+		}
+
+		/* a page which isn't full reached the stored statuses */
+		if(!since_id || page->count < status_count)
+		{
+			*resume = 0;
+			break;
+		}
+
+		*resume = page->oldest - 1;
+
+		if(++*pages > TWITTERSYNC_MAX_BACKFILL_PAGES)
+		{
+			break;
+		}
+
+		/* request statuses older than the current page */
+		g_debug("Filling gap in timeline (source=%d, guid=%s): page %d", source, guid, *pages);
+		_twittersync_set_client_id(client, "max-id", *resume);
+	}
+
+	g_object_set(G_OBJECT(client), "since-id", NULL, "max-id", NULL, NULL);
+
+	return result;
+}
+
+/*
+ * Fetches all statuses newer than since_id. If a page is full there may be a gap between the
+ * received and the stored statuses, so older pages are requested with max_id until the gap is
+ * closed or TWITTERSYNC_MAX_BACKFILL_PAGES is reached. A gap which couldn't be closed is stored
+ * in gap and filled by the following synchronizations. The id of the newest received status
+ * is stored in newest.
+ */
+static gboolean
+_twittersync_fetch_incremental(TwitterWebClient *client, TwitterDbSyncSource source, const gchar *guid, gint64 since_id, _TwitterSyncGap *gap,
+                               _TwitterSyncPage *page, gboolean (* fetch_page)(gpointer user_data), gpointer user_data,
+                               GCancellable *cancellable, gint64 *newest)
+{
+	gint pages = 0;
+	gint64 older = 0;
+	gint64 resume;
+	gboolean result;
+
+	*newest = 0;
+
+	/* receive new statuses */
+	result = _twittersync_fetch_range(client, source, guid, since_id, 0, page, fetch_page, user_data, cancellable, &pages, newest, &resume);
+
+	if(result && resume)
+	{
+		/* an older gap is merged, statuses between both gaps are received again */
+		if(!gap->max_id)
+		{
+			gap->since_id = since_id;
+		}
+
+		gap->max_id = resume;
+
+		g_debug("Gap in timeline (source=%d, guid=%s) exceeds %d pages, continuing with next synchronization", source, guid, TWITTERSYNC_MAX_BACKFILL_PAGES);
+	}
+	else if(result && gap->max_id)
+	{
+		/* continue filling the gap left by a previous synchronization */
+		g_debug("Filling gap in timeline (source=%d, guid=%s): %" G_GINT64_FORMAT " - %" G_GINT64_FORMAT, source, guid, gap->since_id, gap->max_id);
+
+		if((result = _twittersync_fetch_range(client, source, guid, gap->since_id, gap->max_id, page, fetch_page, user_data, cancellable, &pages, &older, &resume)))
+		{
+			gap->max_id = resume;
+		}
+	}
+
+	return result;
+}
+
+/*
+ * Stores the id of the newest received status & the unfilled gap of a source.
+ */
+static void
+_twittersync_store_position(TwitterDbHandle *handle, TwitterDbSyncSource source, const gchar *guid, gint64 since_id, gint64 newest,
+                            const _TwitterSyncGap *stored_gap, const _TwitterSyncGap *gap)
+{
+	GError *err = NULL;
+
+	if(newest > since_id && !twitterdb_set_since_id(handle, source, guid, newest, &err))
+	{
+		g_warning("Couldn't store since_id (source=%d, guid=%s)", source, guid);
+	}
+
+	if(!err && (gap->since_id != stored_gap->since_id || gap->max_id != stored_gap->max_id))
+	{
+		if(!twitterdb_set_sync_gap(handle, source, guid, gap->since_id, gap->max_id, &err))
+		{
+			g_warning("Couldn't store gap (source=%d, guid=%s)", source, guid);
+		}
+	}
+
+	if(err)
+	{
+		g_warning("%s", err->message);
+		g_error_free(err);
+	}
+}
+
+/*
+ * Reads the id of the newest received status & the unfilled gap of a source.
+ */
+static void
+_twittersync_load_position(TwitterDbHandle *handle, TwitterDbSyncSource source, const gchar *guid, gint64 *since_id, _TwitterSyncGap *gap)
+{
+	GError *err = NULL;
+
+	if(!(*since_id = twitterdb_get_since_id(handle, source, guid, &err)) && err)
+	{
+		g_warning("%s", err->message);
+		g_error_free(err);
+		err = NULL;
+	}
+
+	if(!twitterdb_get_sync_gap(handle, source, guid, &gap->since_id, &gap->max_id, &err) && err)
+	{
+		g_warning("%s", err->message);
+		g_error_free(err);
+	}
+}
+
+/*
+ * Fetches all statuses newer than the stored since_id of the given source. The since_id is
+ * only advanced if all requests succeeded.
+ */
+static gboolean
+_twittersync_sync_incremental(TwitterDbHandle *handle, TwitterWebClient *client, TwitterDbSyncSource source, const gchar *guid,
+                              _TwitterSyncPage *page, gboolean (* fetch_page)(gpointer user_data), gpointer user_data,
+                              GCancellable *cancellable)
+{
+	gint64 since_id;
+	gint64 newest;
+	_TwitterSyncGap stored_gap;
+	_TwitterSyncGap gap;
+	gboolean result;
+
+	_twittersync_load_position(handle, source, guid, &since_id, &stored_gap);
+	gap = stored_gap;
+
+	if((result = _twittersync_fetch_incremental(client, source, guid, since_id, &gap, page, fetch_page, user_data, cancellable, &newest)))
+	{
+		_twittersync_store_position(handle, source, guid, since_id, newest, &stored_gap, &gap);
+	}
+
+	return result;
+}
+
 /*
  *	synchronize timelines:
  */
@@ -149,6 +454,8 @@ typedef struct
 {
 	/*! Database handle. */
 	TwitterDbHandle *db;
+	/*! A TwitterWebClient instance. */
+	TwitterWebClient *client;
 	/*! Pointer to status counter. */
 	gint *status_count;
 	/*! Name of the user. */
@@ -157,6 +464,8 @@ typedef struct
 	gchar user_guid[32];
 	/*! Type of the timeline. */
 	_TwitterSyncTimlineType type;
+	/*! Ids found on the current page. */
+	_TwitterSyncPage page;
 	/*! AGCancellable. */
 	GCancellable *cancellable;
 } _TwitterSyncTimelinesData;
@@ -169,7 +478,9 @@ _twittersync_update_timeline(TwitterStatus status, TwitterUser user, gpointer us
 	GError *err = NULL;
 
 	g_debug("%s: status \"%s\" from \"%s\"", __func__, status.id, user.name);
-	
+
+	_twittersync_register_page_status(&arg->page, status.id);
+
 	/* save status */
 	if(_twittersync_save_status(arg->db, status, user, arg->status_count))
 	{
@@ -207,29 +518,80 @@ _twittersync_update_timeline(TwitterStatus status, TwitterUser user, gpointer us
 }
 
 static void
-_twittersync_process_timeline(const gchar *buffer, gint length, _TwitterSyncTimlineType type, _TwitterSyncTimelinesData *arg)
+_twittersync_process_timeline(const gchar *buffer, gint length, _TwitterSyncTimelinesData *arg)
+{
+	/* write page in a single transaction */
+	if(_twittersync_begin_batch(arg->db))
+	{
+		twitter_xml_parse_timeline(buffer, length, _twittersync_update_timeline, arg, arg->cancellable);
+		_twittersync_commit_batch(arg->db);
+	}
+}
+
+static gboolean
+_twittersync_fetch_timeline_page(gpointer user_data)
+{
+	_TwitterSyncTimelinesData *arg = (_TwitterSyncTimelinesData *)user_data;
+	gchar *buffer = NULL;
+	gint length;
+	gboolean result = FALSE;
+
+	switch(arg->type)
+	{
+		case TWITTERSYNC_TIMELINE_HOME:
+			result = twitter_web_client_get_home_timeline(arg->client, &buffer, &length);
+			break;
+
+		case TWITTERSYNC_TIMELINE_REPLIES:
+			result = twitter_web_client_get_mentions(arg->client, &buffer, &length);
+			break;
+
+		case TWITTERSYNC_TIMELINE_USER_TIMELINE:
+			result = twitter_web_client_get_user_timeline(arg->client, NULL, &buffer, &length);
+			break;
+
+		default:
+			g_warning("Invalid timeline identifier: %d", arg->type);
+	}
+
+	if(result)
+	{
+		_twittersync_process_timeline(buffer, length, arg);
+	}
+
+	g_free(buffer);
+
+	return result;
+}
+
+static gboolean
+_twittersync_sync_timeline(_TwitterSyncTimelinesData *arg, _TwitterSyncTimlineType type, TwitterDbSyncSource source)
 {
 	arg->type = type;
-	twitter_xml_parse_timeline(buffer, length, _twittersync_update_timeline, arg, arg->cancellable);
+
+	return _twittersync_sync_incremental(arg->db, arg->client, source, arg->user_guid, &arg->page,
+	                                     _twittersync_fetch_timeline_page, arg, arg->cancellable);
 }
 
 gboolean
 twittersync_update_timelines(TwitterDbHandle *handle, TwitterWebClient *client, gint *status_count, GCancellable *cancellable, GError **err)
 {
 	_TwitterSyncTimelinesData *arg = (_TwitterSyncTimelinesData *)g_alloca(sizeof(_TwitterSyncTimelinesData));
-	gchar *buffer = NULL;
-	gint length;
 	gboolean result = FALSE;
 
 	g_assert(handle != NULL);
 	g_assert(client != NULL);
 
 	arg->db = handle;
+	arg->client = client;
 	arg->username = NULL;
 	memset(arg->user_guid, 0, 32);
 	arg->status_count = status_count;
 	arg->cancellable = cancellable;
 
+	/* stop waiting for database locks when synchronization is cancelled */
+	twitterdb_set_cancellable(handle, cancellable);
+
 	/* get username and guid */
 	if((arg->username = twitter_web_client_get_username(client)))
 	{
@@ -248,36 +610,21 @@ twittersync_update_timelines(TwitterDbHandle *handle, TwitterWebClient *client,
 		if(!cancellable || !g_cancellable_is_cancelled(cancellable))
 		{
 			g_debug("Fetching home timeline: \"%s\"", arg->username);
-			if((result = twitter_web_client_get_home_timeline(client, &buffer, &length)))
-			{
-				_twittersync_process_timeline(buffer, length, TWITTERSYNC_TIMELINE_HOME, arg);
-			}
-	
-			_twittersync_free_buffer(buffer);
+			result = _twittersync_sync_timeline(arg, TWITTERSYNC_TIMELINE_HOME, TWITTERDB_SYNC_SOURCE_HOME_TIMELINE);
 		}
 
 		/* replies */
 		if(result && (!cancellable || !g_cancellable_is_cancelled(cancellable)))
 		{
 			g_debug("Fetching replies: \"%s\"", arg->username);
-			if((result = twitter_web_client_get_mentions(client, &buffer, &length)))
-			{
-				_twittersync_process_timeline(buffer, length, TWITTERSYNC_TIMELINE_REPLIES, arg);
-			}
-
-			_twittersync_free_buffer(buffer);
+			result = _twittersync_sync_timeline(arg, TWITTERSYNC_TIMELINE_REPLIES, TWITTERDB_SYNC_SOURCE_REPLIES);
 		}
 
 		/* user timeline */
 		if(result && (!cancellable || !g_cancellable_is_cancelled(cancellable)))
 		{
 			g_debug("Fetching user timeline: \"%s\"", arg->username);
-			if(twitter_web_client_get_user_timeline(client, NULL, &buffer, &length))
-			{
-				_twittersync_process_timeline(buffer, length, TWITTERSYNC_TIMELINE_USER_TIMELINE, arg);
-			}
-
-			_twittersync_free_buffer(buffer);
+			_twittersync_sync_timeline(arg, TWITTERSYNC_TIMELINE_USER_TIMELINE, TWITTERDB_SYNC_SOURCE_USER_TIMELINE);
 		}
 
 		if(result && (!cancellable || !g_cancellable_is_cancelled(cancellable)))
@@ -289,10 +636,245 @@ twittersync_update_timelines(TwitterDbHandle *handle, TwitterWebClient *client,
 	return result;
 }
 
+/*
+ *	process user stream:
+ */
+
+/*!
+ * \struct _TwitterSyncStreamData
+ * \brief This structure holds data for saving messages received from a user stream.
+ */
+typedef struct
+{
+	/*! Database handle. */
+	TwitterDbHandle *db;
+	/*! Name of the user. */
+	const gchar *username;
+	/*! Guid of the user. */
+	gchar user_guid[32];
+	/*! Parses the received messages. */
+	TwitterJsonStreamParser *parser;
+	/*! TRUE if data has been received. */
+	gboolean connected;
+	/*! TRUE if a database batch has been started for the current block. */
+	gboolean batch;
+	/*! TRUE if the current block changed the database. */
+	gboolean updated;
+	/*! Number of new statuses. */
+	gint status_count;
+	/*! Function receiving stream events. */
+	TwitterSyncStreamFunc func;
+	/*! User data passed to func. */
+	gpointer user_data;
+} _TwitterSyncStreamData;
+
+static gboolean
+_twittersync_stream_mentions_user(const gchar *text, const gchar *username)
+{
+	gsize length = strlen(username);
+	const gchar *pos = text;
+
+	while((pos = strchr(pos, '@')))
+	{
+		++pos;
+
+		if(!g_ascii_strncasecmp(pos, username, length) && !g_ascii_isalnum(pos[length]) && pos[length] != '_')
+		{
+			return TRUE;
+		}
+	}
+
+	return FALSE;
+}
+
+static void
+_twittersync_stream_begin_batch(_TwitterSyncStreamData *arg)
+{
+	/* messages of a block are written in a single transaction */
+	if(!arg->batch)
+	{
+		arg->batch = _twittersync_begin_batch(arg->db);
+	}
+}
+
+static void
+_twittersync_stream_append_status(_TwitterSyncStreamData *arg, const gchar *status_id, _TwitterSyncTimlineType type)
+{
+	gboolean (* func)(TwitterDbHandle *handle, const gchar *user_guid, const gchar *status_guid, GError **err) = NULL;
+	GError *err = NULL;
+
+	switch(type)
+	{
+		case TWITTERSYNC_TIMELINE_HOME:
+			func = twitterdb_append_status_to_public_timeline;
+			break;
+
+		case TWITTERSYNC_TIMELINE_REPLIES:
+			func = twitterdb_append_status_to_replies;
+			break;
+
+		case TWITTERSYNC_TIMELINE_USER_TIMELINE:
+			func = twitterdb_append_status_to_user_timeline;
+			break;
+
+		default:
+			g_warning("Invalid timeline identifier: %d", type);
+			return;
+	}
+
+	g_debug("Appending status \"%s\" to timeline(%d)", status_id, type);
+	if(!func(arg->db, arg->user_guid, status_id, &err))
+	{
+		g_warning("Couldn't append status \"%s\" to timeline(%d)", status_id, type);
+		if(err)
+		{
+			g_warning("%s", err->message);
+			g_error_free(err);
+		}
+	}
+}
+
+static void
+_twittersync_stream_update_timelines(TwitterStatus status, TwitterUser user, gpointer user_data)
+{
+	_TwitterSyncStreamData *arg = (_TwitterSyncStreamData *)user_data;
+
+	g_debug("%s: status \"%s\" from \"%s\"", __func__, status.id, user.name);
+
+	_twittersync_stream_begin_batch(arg);
+
+	/* the user stream delivers the home timeline, own statuses are also appended to the user timeline &
+	   statuses mentioning the user to the replies */
+	if(_twittersync_save_status(arg->db, status, user, &arg->status_count))
+	{
+		arg->updated = TRUE;
+
+		_twittersync_stream_append_status(arg, status.id, TWITTERSYNC_TIMELINE_HOME);
+
+		if(!g_strcmp0(user.id, arg->user_guid))
+		{
+			_twittersync_stream_append_status(arg, status.id, TWITTERSYNC_TIMELINE_USER_TIMELINE);
+		}
+
+		if(_twittersync_stream_mentions_user(status.text, arg->username))
+		{
+			_twittersync_stream_append_status(arg, status.id, TWITTERSYNC_TIMELINE_REPLIES);
+		}
+	}
+}
+
+static void
+_twittersync_stream_remove_status(const gchar *status_id, gpointer user_data)
+{
+	_TwitterSyncStreamData *arg = (_TwitterSyncStreamData *)user_data;
+	GError *err = NULL;
+
+	_twittersync_stream_begin_batch(arg);
+
+	g_debug("Removing deleted status \"%s\"", status_id);
+	if(twitterdb_remove_status(arg->db, status_id, &err))
+	{
+		arg->updated = TRUE;
+	}
+	else
+	{
+		g_warning("Couldn't remove status \"%s\"", status_id);
+		if(err)
+		{
+			g_warning("%s", err->message);
+			g_error_free(err);
+		}
+	}
+}
+
+static gboolean
+_twittersync_feed_stream_parser(const gchar *data, gsize length, gpointer user_data)
+{
+	_TwitterSyncStreamData *arg = (_TwitterSyncStreamData *)user_data;
+	gboolean result;
+
+	if(!arg->connected)
+	{
+		g_debug("User stream of \"%s\" has been opened", arg->username);
+		arg->connected = TRUE;
+
+		if(arg->func)
+		{
+			arg->func(TWITTERSYNC_STREAM_CONNECTED, arg->user_data);
+		}
+	}
+
+	/* parse block (keep-alive newlines don't start a batch) */
+	arg->updated = FALSE;
+	result = twitter_json_stream_parser_feed(arg->parser, data, length);
+
+	if(arg->batch)
+	{
+		_twittersync_commit_batch(arg->db);
+		arg->batch = FALSE;
+	}
+
+	if(arg->updated && arg->func)
+	{
+		arg->func(TWITTERSYNC_STREAM_UPDATED, arg->user_data);
+	}
+
+	return result;
+}
+
+gboolean
+twittersync_process_user_stream(TwitterDbHandle *handle, TwitterWebClient *client, TwitterSyncStreamFunc func, gpointer user_data, GCancellable *cancellable, GError **err)
+{
+	_TwitterSyncStreamData arg;
+	const GError *last_error;
+	gboolean result = FALSE;
+
+	g_assert(handle != NULL);
+	g_assert(client != NULL);
+
+	memset(&arg, 0, sizeof(_TwitterSyncStreamData));
+	arg.db = handle;
+	arg.func = func;
+	arg.user_data = user_data;
+
+	/* stop waiting for database locks when the stream is cancelled */
+	twitterdb_set_cancellable(handle, cancellable);
+
+	/* get user guid */
+	if(!(arg.username = twitter_web_client_get_username(client)) || !_twittersync_get_user_guid(handle, client, arg.username, arg.user_guid))
+	{
+		g_set_error(err, 0, 0, "Couldn't map username of user stream");
+
+		return FALSE;
+	}
+
+	/* read stream */
+	arg.parser = twitter_json_stream_parser_new(_twittersync_stream_update_timelines, _twittersync_stream_remove_status, &arg, cancellable);
+	twitter_web_client_set_content_func(client, _twittersync_feed_stream_parser, &arg);
+
+	if(!(result = twitter_web_client_get_user_stream(client, cancellable)))
+	{
+		if((last_error = twitter_web_client_get_last_error(client)))
+		{
+			g_set_error(err, 0, last_error->code, "%s", last_error->message);
+		}
+	}
+
+	g_debug("User stream of \"%s\" has been closed (%d new statuses)", arg.username, arg.status_count);
+
+	twitter_web_client_set_content_func(client, NULL, NULL);
+	twitter_json_stream_parser_free(arg.parser);
+
+	return result;
+}
+
 /*
  *	synchronize lists:
  */
 
+/*! Maximum number of lists fetched in parallel. */
+#define TWITTERSYNC_MAX_LIST_WORKERS 4
+
 /*!
  * \struct _TwitterSyncListsData
  * \brief This structure holds data for saving list information.
@@ -307,201 +889,539 @@ typedef struct
 	GList *found_lists;
 	/*! A TwitterWebClient instance. */
 	TwitterWebClient *client;
-	/*! Owner of current list. */
+	/*! Owner of the lists. */
 	const gchar *owner;
-	/*! Pointer to current list data */
-	TwitterList *list;
 	/*! TRUE if list members should be synchronized. */
 	gboolean sync_members;
 	/*! AGCancellable. */
 	GCancellable *cancellable;
 } _TwitterSyncListsData;
 
-static void
-_twittersync_save_tweet_from_list(TwitterStatus status, TwitterUser user, gpointer user_data)
+/*!
+ * \struct _TwitterSyncListStatus
+ * \brief A status received from a list timeline.
+ */
+typedef struct
 {
-	_TwitterSyncListsData *arg = (_TwitterSyncListsData *)user_data;
+	/*! The status. */
+	TwitterStatus status;
+	/*! The author of the status. */
+	TwitterUser user;
+} _TwitterSyncListStatus;
+
+/*!
+ * \struct _TwitterSyncListTask
+ * \brief Data of a list fetched by a worker thread. Workers don't access the database,
+ * each received page is written by the thread which dispatched the task.
+ */
+typedef struct
+{
+	/*! The list to fetch. */
+	TwitterList list;
+	/*! Owner of the list. */
+	const gchar *owner;
+	/*! A TwitterWebClient instance owned by the task. */
+	TwitterWebClient *client;
+	/*! TRUE if list members should be synchronized. */
+	gboolean sync_members;
+	/*! Id of the newest stored status. */
+	gint64 since_id;
+	/*! Stored gap in the list timeline. */
+	_TwitterSyncGap stored_gap;
+	/*! Gap in the list timeline after fetching. */
+	_TwitterSyncGap gap;
+	/*! A GCancellable. */
+	GCancellable *cancellable;
+	/*! Queue receiving pages (_TwitterSyncListPage). */
+	GAsyncQueue *done;
+	/*! List members (TwitterUser) of the current page. */
+	GArray *members;
+	/*! TRUE if all list members have been received. */
+	gboolean members_ok;
+	/*! Statuses (_TwitterSyncListStatus) of the current page. */
+	GArray *statuses;
+	/*! Ids found on the current page. */
+	_TwitterSyncPage page;
+	/*! Id of the newest received status. */
+	gint64 newest;
+	/*! TRUE if all statuses have been received. */
+	gboolean statuses_ok;
+	/*! Seconds spent fetching the list. */
+	gdouble fetch_seconds;
+	/*! TRUE if members couldn't be staged, only accessed by the writer. */
+	gboolean members_failed;
+	/*! TRUE if statuses couldn't be written, only accessed by the writer. */
+	gboolean statuses_failed;
+	/*! Number of written members, only accessed by the writer. */
+	guint members_written;
+	/*! Number of written statuses, only accessed by the writer. */
+	guint statuses_written;
+	/*! Seconds spent writing the list, only accessed by the writer. */
+	gdouble write_seconds;
+} _TwitterSyncListTask;
+
+/*!
+ * \struct _TwitterSyncListPage
+ * \brief A page received by a list worker. A page without members and statuses is sent
+ * when the list has been fetched completely.
+ */
+typedef struct
+{
+	/*! The task which received the page. */
+	_TwitterSyncListTask *task;
+	/*! Received list members (TwitterUser) or NULL. */
+	GArray *members;
+	/*! Received statuses (_TwitterSyncListStatus) or NULL. */
+	GArray *statuses;
+} _TwitterSyncListPage;
+
+static TwitterWebClient *
+_twittersync_clone_client(TwitterWebClient *client)
+{
+	TwitterWebClient *clone;
+	gchar *username = NULL;
+	gchar *consumer_key = NULL;
+	gchar *consumer_secret = NULL;
+	gchar *access_key = NULL;
+	gchar *access_secret = NULL;
+	gchar *format = NULL;
+	gint status_count = 20;
+	gboolean background = FALSE;
+	GCancellable *cancellable = NULL;
+
+	g_object_get(G_OBJECT(client),
+	             "username", &username,
+	             "oauth-consumer-key", &consumer_key,
+	             "oauth-consumer-secret", &consumer_secret,
+	             "oauth-access-key", &access_key,
+	             "oauth-access-secret", &access_secret,
+	             "format", &format,
+	             "status-count", &status_count,
+	             "background", &background,
+	             "cancellable", &cancellable,
+	             NULL);
+
+	clone = twitter_web_client_new();
+	g_object_set(G_OBJECT(clone),
+	             "username", username,
+	             "oauth-consumer-key", consumer_key,
+	             "oauth-consumer-secret", consumer_secret,
+	             "oauth-access-key", access_key,
+	             "oauth-access-secret", access_secret,
+	             "format", format,
+	             "status-count", status_count,
+	             "background", background,
+	             "cancellable", cancellable,
+	             NULL);
+
+	if(cancellable)
+	{
+		g_object_unref(cancellable);
+	}
+
+	g_free(username);
+	g_free(consumer_key);
+	g_free(consumer_secret);
+	g_free(access_key);
+	g_free(access_secret);
+	g_free(format);
+
+	return clone;
+}
+
+static _TwitterSyncListTask *
+_twittersync_list_task_new(_TwitterSyncListsData *arg, TwitterList list, GAsyncQueue *done)
+{
+	_TwitterSyncListTask *task;
 	GError *err = NULL;
 
-	/* save status */
-	if(_twittersync_save_status(arg->db, status, user, arg->status_count))
+	task = (_TwitterSyncListTask *)g_malloc0(sizeof(_TwitterSyncListTask));
+	task->list = list;
+	task->owner = arg->owner;
+	task->client = _twittersync_clone_client(arg->client);
+	task->sync_members = arg->sync_members;
+	task->cancellable = arg->cancellable;
+	task->done = done;
+
+	/* get id of the newest received status */
+	_twittersync_load_position(arg->db, TWITTERDB_SYNC_SOURCE_LIST_TIMELINE, list.id, &task->since_id, &task->stored_gap);
+	task->gap = task->stored_gap;
+
+	/* remove member ids staged by a previous synchronization */
+	if(task->sync_members && !twitterdb_clear_staged_list_members(arg->db, list.id, &err))
 	{
-		/* append status to list */
-		g_debug("Appending status %s to list \"%s\" (%s)", status.id, arg->list->name, arg->list->id);
-		if(!twitterdb_append_status_to_list(arg->db, arg->list->id, status.id, &err))
+		g_warning("Couldn't clear staged members of list \"%s\"", list.name);
+		task->members_failed = TRUE;
+
+		if(err)
 		{
-			g_warning("Couldn't append status %s to list \"%s\" (%s)", status.id, arg->list->name, arg->list->id);
-			if(err)
+			g_warning("%s", err->message);
+			g_error_free(err);
+		}
+	}
+
+	return task;
+}
+
+static void
+_twittersync_list_task_free(_TwitterSyncListTask *task)
+{
+	g_object_unref(task->client);
+	g_free(task);
+}
+
+/* hand the current page over to the writer, an empty page finishes the task */
+static void
+_twittersync_push_list_page(_TwitterSyncListTask *task)
+{
+	_TwitterSyncListPage *page;
+
+	page = g_slice_new(_TwitterSyncListPage);
+	page->task = task;
+	page->members = task->members;
+	page->statuses = task->statuses;
+
+	task->members = NULL;
+	task->statuses = NULL;
+
+	g_async_queue_push(task->done, page);
+}
+
+static void
+_twittersync_list_page_free(_TwitterSyncListPage *page)
+{
+	if(page->members)
+	{
+		g_array_free(page->members, TRUE);
+	}
+
+	if(page->statuses)
+	{
+		g_array_free(page->statuses, TRUE);
+	}
+
+	g_slice_free(_TwitterSyncListPage, page);
+}
+
+static void
+_twittersync_collect_list_member(TwitterUser user, gpointer user_data)
+{
+	g_array_append_val(((_TwitterSyncListTask *)user_data)->members, user);
+}
+
+static gboolean
+_twittersync_fetch_list_members(_TwitterSyncListTask *task)
+{
+	gchar *buffer = NULL;
+	gint length;
+	gchar next_cursor[64] = "-1";
+	TwitterXmlStreamParser *parser;
+	const GError *err;
+	gboolean result = TRUE;
+
+	while(result && g_strcmp0(next_cursor, "0"))
+	{
+		if(task->cancellable && g_cancellable_is_cancelled(task->cancellable))
+		{
+			result = FALSE;
+			break;
+		}
+
+		/* get list members from Twitter service */
+		g_debug("Getting members from list \"%s\", cursor=\"%s\"", task->list.name, next_cursor);
+
+		task->members = g_array_new(FALSE, FALSE, sizeof(TwitterUser));
+		parser = twitter_xml_stream_parser_new_list_members(_twittersync_collect_list_member, task, task->cancellable);
+		twitter_web_client_set_content_func(task->client, _twittersync_feed_xml_parser, parser);
+
+		if((twitter_web_client_get_users_from_list(task->client, task->owner, task->list.id, next_cursor, &buffer, &length)))
+		{
+			twitter_xml_stream_parser_get_next_cursor(parser, next_cursor, 64);
+
+			/* the writer stores the page while the next one is fetched */
+			_twittersync_push_list_page(task);
+		}
+		else
+		{
+			g_array_free(task->members, TRUE);
+			task->members = NULL;
+
+			g_warning("Couldn't get list members from: \"%s\"", task->list.name);
+			if((err = twitter_web_client_get_last_error(task->client)))
 			{
 				g_warning("%s", err->message);
-				g_error_free(err);
 			}
+
+			result = FALSE;
 		}
+
+		twitter_web_client_set_content_func(task->client, NULL, NULL);
+		twitter_xml_stream_parser_free(parser);
+
+		/* free memory */
+		_twittersync_free_buffer(buffer);
 	}
+
+	return result;
+}
+
+static void
+_twittersync_collect_list_status(TwitterStatus status, TwitterUser user, gpointer user_data)
+{
+	_TwitterSyncListTask *task = (_TwitterSyncListTask *)user_data;
+	_TwitterSyncListStatus item;
+
+	_twittersync_register_page_status(&task->page, status.id);
+
+	item.status = status;
+	item.user = user;
+	g_array_append_val(task->statuses, item);
 }
 
 static gboolean
-_twittersync_save_tweets_from_list(_TwitterSyncListsData *arg)
+_twittersync_fetch_list_page(gpointer user_data)
 {
+	_TwitterSyncListTask *task = (_TwitterSyncListTask *)user_data;
 	gchar *buffer = NULL;
 	gint length;
-	GError *err = NULL;
+	const GError *err;
 	gboolean result = FALSE;
 
 	/* get tweets from list */
-	g_debug("Getting tweets from list: \"%s\"", arg->list->id);
-	if(twitter_web_client_get_timeline_from_list(arg->client, arg->owner, arg->list->id, &buffer, &length))
+	g_debug("Getting tweets from list: \"%s\"", task->list.id);
+	task->statuses = g_array_new(FALSE, FALSE, sizeof(_TwitterSyncListStatus));
+
+	if(twitter_web_client_get_timeline_from_list(task->client, task->owner, task->list.id, &buffer, &length))
+	{
+		twitter_xml_parse_timeline(buffer, length, _twittersync_collect_list_status, task, task->cancellable);
+		result = !task->cancellable || !g_cancellable_is_cancelled(task->cancellable);
+	}
+	else
+	{
+		g_warning("Couldn't get tweets from list: \"%s\"", task->list.id);
+		if((err = twitter_web_client_get_last_error(task->client)))
+		{
+			g_warning("%s", err->message);
+		}
+	}
+
+	/* the writer stores the page while the next one is fetched */
+	if(result)
+	{
+		_twittersync_push_list_page(task);
+	}
+	else
 	{
-		/* save tweets */
-		twitter_xml_parse_timeline(buffer, length, _twittersync_save_tweet_from_list, arg, arg->cancellable);
+		g_array_free(task->statuses, TRUE);
+		task->statuses = NULL;
+	}
+
+	/* free memory */
+	g_free(buffer);
+
+	return result;
+}
+
+static void
+_twittersync_fetch_list_worker(_TwitterSyncListTask *task, gpointer user_data)
+{
+	GTimer *timer;
+
+	timer = g_timer_new();
 
-		if(!arg->cancellable || !g_cancellable_is_cancelled(arg->cancellable))
-		{
-			result = TRUE;
-		}
+	if(task->sync_members)
+	{
+		task->members_ok = _twittersync_fetch_list_members(task);
 	}
-	else
+
+	if(!task->cancellable || !g_cancellable_is_cancelled(task->cancellable))
 	{
-		g_warning("Couldn't get tweets from list: \"%s\"", arg->list->id);
-		if((err = (GError *)twitter_web_client_get_last_error(arg->client)))
-		{
-			g_warning("%s", err->message);
-		}
+		task->statuses_ok = _twittersync_fetch_incremental(task->client, TWITTERDB_SYNC_SOURCE_LIST_TIMELINE, task->list.id, task->since_id, &task->gap,
+		                                                   &task->page, _twittersync_fetch_list_page, task, task->cancellable, &task->newest);
 	}
 
-	/* free memory */
-	g_free(buffer);
+	task->fetch_seconds = g_timer_elapsed(timer, NULL);
+	g_timer_destroy(timer);
 
-	return result;
+	/* tell the writer that the list has been fetched */
+	_twittersync_push_list_page(task);
 }
 
+/* save the users of a page & stage them as list members */
 static void
-_twittersync_add_list_member(TwitterUser user, gpointer user_data)
+_twittersync_write_list_members(TwitterDbHandle *handle, _TwitterSyncListTask *task, GArray *members)
 {
-	_TwitterSyncListsData *arg = (_TwitterSyncListsData *)user_data;
+	TwitterUser *user;
 	GError *err = NULL;
+	guint i;
 
-	/* save user */
-	g_debug("Registering user \"%s\" (%s)", user.screen_name, user.id);
-	if(twitterdb_save_user(arg->db, user.id, user.screen_name, user.name, user.image, user.location, user.url, user.description, &err))
+	if(!_twittersync_begin_batch(handle))
 	{
-		g_debug("Adding member \"%s\" to list \"@%s/%s\" (%s)", user.name, arg->owner, arg->list->name, arg->list->id);
-		if(!twitterdb_append_user_to_list(arg->db, arg->list->id, user.id, &err))
+		task->members_failed = TRUE;
+		return;
+	}
+
+	for(i = 0; i < members->len && !task->members_failed; ++i)
+	{
+		user = &g_array_index(members, TwitterUser, i);
+
+		/* save user */
+		g_debug("Registering user \"%s\" (%s)", user->screen_name, user->id);
+		if(twitterdb_save_user(handle, user->id, user->screen_name, user->name, user->image, user->location, user->url, user->description, &err))
 		{
-			g_debug("Couldn't append member \"%s\" to list \"@%s/%s\" (%s)", user.name, arg->owner, arg->list->name, arg->list->id);
-			if(err)
+			g_debug("Staging member \"%s\" of list \"@%s/%s\" (%s)", user->name, task->owner, task->list.name, task->list.id);
+			if(twitterdb_stage_list_member(handle, task->list.id, user->id, &err))
 			{
-				g_warning("%s", err->message);
-				g_error_free(err);
+				++task->members_written;
+			}
+			else
+			{
+				g_warning("Couldn't stage member \"%s\" of list \"@%s/%s\" (%s)", user->name, task->owner, task->list.name, task->list.id);
+				task->members_failed = TRUE;
 			}
 		}
-	}
-	else
-	{
-		g_debug("Couldn't append member \"%s\" to list \"@%s/%s\"", user.name, arg->owner, arg->list->name);
+		else
+		{
+			g_debug("Couldn't append member \"%s\" to list \"@%s/%s\"", user->name, task->owner, task->list.name);
+		}
+
 		if(err)
 		{
 			g_warning("%s", err->message);
 			g_error_free(err);
+			err = NULL;
 		}
 	}
+
+	if(!_twittersync_commit_batch(handle))
+	{
+		task->members_failed = TRUE;
+	}
 }
 
-static gboolean
-_twittersync_update_list_members(_TwitterSyncListsData *arg)
+/* save the statuses of a page & append them to the list */
+static void
+_twittersync_write_list_statuses(TwitterDbHandle *handle, _TwitterSyncListTask *task, GArray *statuses, gint *status_count)
 {
-	gchar *buffer = NULL;
-	gint length;
-	gchar next_cursor[64] = "-1";
+	_TwitterSyncListStatus *item;
 	GError *err = NULL;
-	gboolean result = FALSE;
+	guint i;
 
-	/* remove followers */
-	g_debug("Removing followers from \"%s\"", arg->list->name);
-	if(twitterdb_remove_users_from_list(arg->db, arg->list->id, &err))
+	if(!_twittersync_begin_batch(handle))
 	{
-		result = TRUE;
+		task->statuses_failed = TRUE;
+		return;
+	}
 
-		while(g_strcmp0(next_cursor, "0") && (!arg->cancellable || !g_cancellable_is_cancelled(arg->cancellable)) && result)
-		{
-			/* get list members from Twitter service */
-			g_debug("Getting members from list, cursor=\"%s\"", next_cursor);
+	for(i = 0; i < statuses->len; ++i)
+	{
+		item = &g_array_index(statuses, _TwitterSyncListStatus, i);
 
-			if((twitter_web_client_get_users_from_list(arg->client, arg->owner, arg->list->id, next_cursor, &buffer, &length)))
+		/* save status */
+		if(_twittersync_save_status(handle, item->status, item->user, status_count))
+		{
+			/* append status to list */
+			g_debug("Appending status %s to list \"%s\" (%s)", item->status.id, task->list.name, task->list.id);
+			if(twitterdb_append_status_to_list(handle, task->list.id, item->status.id, &err))
 			{
-				/* add list members */
-				twitter_xml_parse_list_members(buffer, length, _twittersync_add_list_member, next_cursor, 64, arg);
+				++task->statuses_written;
 			}
 			else
 			{
-				g_warning("Couldn't get list members from: \"%s\"", arg->list->name);
-				if((err = (GError *)twitter_web_client_get_last_error(arg->client)))
+				g_warning("Couldn't append status %s to list \"%s\" (%s)", item->status.id, task->list.name, task->list.id);
+				if(err)
 				{
 					g_warning("%s", err->message);
+					g_error_free(err);
 					err = NULL;
-					result = FALSE;
 				}
 			}
-
-			/* free memory */
-			_twittersync_free_buffer(buffer);
-
-			if(err)
-			{
-				g_error_free(err);
-				err = NULL;
-			}
 		}
 	}
-	else
+
+	if(!_twittersync_commit_batch(handle))
 	{
-		g_warning("Couldn't remove users from list: \"%s\"", arg->list->name);
+		task->statuses_failed = TRUE;
+	}
+}
 
-		if(err)
-		{
-			g_warning("%s", err->message);
-			g_error_free(err);
-		}
+/* write a received page in its own batch */
+static void
+_twittersync_write_list_page(TwitterDbHandle *handle, _TwitterSyncListPage *page, gint *status_count)
+{
+	GTimer *timer;
+
+	timer = g_timer_new();
+
+	if(page->members && !page->task->members_failed)
+	{
+		_twittersync_write_list_members(handle, page->task, page->members);
 	}
 
-	return result;
+	if(page->statuses)
+	{
+		_twittersync_write_list_statuses(handle, page->task, page->statuses, status_count);
+	}
+
+	page->task->write_seconds += g_timer_elapsed(timer, NULL);
+	g_timer_destroy(timer);
 }
 
+/* replace the list members by the staged ids & store the position of the list timeline */
 static gboolean
-_twittersync_process_list_from_database(TwitterList list, TwitterUser user, _TwitterSyncListsData *arg)
+_twittersync_finish_list(TwitterDbHandle *handle, _TwitterSyncListTask *task)
 {
+	guint added = 0;
+	guint removed = 0;
 	GError *err = NULL;
-	gboolean exists;
-	gboolean remove = FALSE;
+	gboolean members_ok = !task->sync_members;
 	gboolean result = FALSE;
 
-	g_debug("Processing list: \"@%s/%s\" (%s)", user.name, list.name, list.id);
-
-	/* set list data */
-	arg->list = &list;
-
-	/* check if list does still exist online */
-	if((exists = (g_list_find_custom(arg->found_lists, list.id, (GCompareFunc)&g_strcmp0) ? TRUE : FALSE)))
+	if(task->sync_members && task->members_ok && !task->members_failed)
 	{
-		g_debug("Updating list: \"%s\" (%s)", list.name, list.id);
+		g_debug("Reconciling members of list \"%s\" (%s)", task->list.name, task->list.id);
 
-		if(arg->sync_members)
+		if(_twittersync_begin_batch(handle))
 		{
-			/* update list members */
-			result = _twittersync_update_list_members(arg);
+			members_ok = twitterdb_reconcile_list_members(handle, task->list.id, &added, &removed, &err);
+
+			if(!_twittersync_commit_batch(handle))
+			{
+				members_ok = FALSE;
+			}
 		}
 
-		/* save tweets */
-		if(result)
+		if(err)
 		{
-			result = _twittersync_save_tweets_from_list(arg);
+			g_warning("%s", err->message);
+			g_error_free(err);
 		}
 	}
 
+	/* store id of the newest received status */
+	if(task->statuses_ok && !task->statuses_failed)
+	{
+		_twittersync_store_position(handle, TWITTERDB_SYNC_SOURCE_LIST_TIMELINE, task->list.id, task->since_id, task->newest, &task->stored_gap, &task->gap);
+		result = members_ok;
+	}
+
+	g_debug("Synchronized list \"%s\" (%s): %u member(s) (%u added, %u removed), %u status(es), fetched in %.3fs, written in %.3fs",
+	        task->list.name, task->list.id, task->members_written, added, removed, task->statuses_written, task->fetch_seconds, task->write_seconds);
+
+	return result;
+}
+
+static gboolean
+_twittersync_remove_stale_list(TwitterDbHandle *handle, TwitterList list, gboolean exists)
+{
+	GError *err = NULL;
+	gboolean remove = FALSE;
+	gboolean result = TRUE;
+
 	/* remove list if timeline is empty (I implemented this workaround because Twitter sometimes
 	 * sends deleted lists)
 	 */
-	if(!twitterdb_count_tweets_from_list(arg->db, list.id, &err))
+	if(!twitterdb_count_tweets_from_list(handle, list.id, &err))
 	{
 		remove = TRUE;
 	}
@@ -518,7 +1438,7 @@ _twittersync_process_list_from_database(TwitterList list, TwitterUser user, _Twi
 	if(!exists || remove)
 	{
 		g_debug("Removing list: \"%s\" (%s)", list.name, list.id);
-		if(!(result = twitterdb_remove_list(arg->db, list.id, &err)))
+		if(!(result = twitterdb_remove_list(handle, list.id, &err)))
 		{
 			g_warning("Couldn't remove list: \"%s\" (%s)", list.name, list.id);
 			if(err)
@@ -532,6 +1452,111 @@ _twittersync_process_list_from_database(TwitterList list, TwitterUser user, _Twi
 	return result;
 }
 
+/*
+ * Fetches the lists found online on a bounded pool of worker threads, each with its own
+ * TwitterWebClient. The calling thread is the only writer: it stores each received page in
+ * its own batch and replaces the members of a list when the list has been fetched completely.
+ */
+static gboolean
+_twittersync_process_lists_from_database(GList *lists, TwitterUser user, _TwitterSyncListsData *arg)
+{
+	GThreadPool *pool;
+	GAsyncQueue *done;
+	_TwitterSyncListTask *task;
+	_TwitterSyncListPage *page;
+	TwitterList *list;
+	GList *iter;
+	gint pending = 0;
+	GError *err = NULL;
+	gboolean result = TRUE;
+
+	done = g_async_queue_new();
+
+	if(!(pool = g_thread_pool_new((GFunc)_twittersync_fetch_list_worker, NULL, TWITTERSYNC_MAX_LIST_WORKERS, FALSE, &err)))
+	{
+		g_warning("Couldn't create thread pool, fetching lists sequentially");
+		if(err)
+		{
+			g_warning("%s", err->message);
+			g_error_free(err);
+		}
+	}
+
+	for(iter = lists; iter; iter = iter->next)
+	{
+		if(arg->cancellable && g_cancellable_is_cancelled(arg->cancellable))
+		{
+			result = FALSE;
+			break;
+		}
+
+		list = (TwitterList *)iter->data;
+		g_debug("Processing list: \"@%s/%s\" (%s)", user.name, list->name, list->id);
+
+		/* check if list does still exist online */
+		if(g_list_find_custom(arg->found_lists, list->id, (GCompareFunc)&g_strcmp0))
+		{
+			g_debug("Updating list: \"%s\" (%s)", list->name, list->id);
+
+			task = _twittersync_list_task_new(arg, *list, done);
+			++pending;
+
+			if(pool)
+			{
+				g_thread_pool_push(pool, task, NULL);
+			}
+			else
+			{
+				_twittersync_fetch_list_worker(task, NULL);
+			}
+		}
+		else if(!_twittersync_remove_stale_list(arg->db, *list, FALSE))
+		{
+			result = FALSE;
+		}
+	}
+
+	/* write pages in the order they have been received */
+	while(pending)
+	{
+		page = (_TwitterSyncListPage *)g_async_queue_pop(done);
+		task = page->task;
+
+		if(page->members || page->statuses)
+		{
+			_twittersync_write_list_page(arg->db, page, arg->status_count);
+		}
+		else
+		{
+			/* the list has been fetched completely */
+			--pending;
+
+			if(!_twittersync_finish_list(arg->db, task))
+			{
+				result = FALSE;
+			}
+
+			if(!_twittersync_remove_stale_list(arg->db, task->list, TRUE))
+			{
+				result = FALSE;
+			}
+
+			_twittersync_list_task_free(task);
+		}
+
+		_twittersync_list_page_free(page);
+	}
+
+	if(pool)
+	{
+		g_thread_pool_free(pool, FALSE, TRUE);
+	}
+
+	g_async_queue_unref(done);
+
+	return result;
+}
+
 static void
 _twittersync_save_list(TwitterList list, TwitterUser user, gpointer user_data)
 {
@@ -567,8 +1592,6 @@ twittersync_update_lists(TwitterDbHandle *handle, TwitterWebClient *client, gint
 	gchar user_guid[32] = { 0 };
 	const GError *last_error;
 	GList *lists;
-	GList *iter;
-	static gint list_size = 0;
 	TwitterUser user;
 	gboolean result = FALSE;
 
@@ -579,14 +1602,12 @@ twittersync_update_lists(TwitterDbHandle *handle, TwitterWebClient *client, gint
 	arg->found_lists = NULL;
 	arg->client = client;
 	arg->owner = NULL;
-	arg->list = NULL;
 	arg->status_count = status_count;
+	arg->sync_members = sync_members;
 	arg->cancellable = cancellable;
 
-	if(!list_size)
-	{
-		list_size = sizeof(TwitterList);
-	}
+	/* stop waiting for database locks when synchronization is cancelled */
+	twitterdb_set_cancellable(handle, cancellable);
 
 	/* set owner */
 	if((arg->owner = twitter_web_client_get_username(client)))
@@ -610,20 +1631,9 @@ twittersync_update_lists(TwitterDbHandle *handle, TwitterWebClient *client, gint
 				twitter_xml_parse_lists(buffer, length, _twittersync_save_list, arg);
 
 				/* remove non-existing lists from database, update list members & get tweets */
-				if((lists = iter = twitterdb_get_lists(handle, user_guid, &user, NULL)))
+				if((lists = twitterdb_get_lists(handle, user_guid, &user, NULL)))
 				{
-					while(iter)
-					{
-						if(cancellable && g_cancellable_is_cancelled(cancellable))
-						{
-							result = FALSE;
-							break;
-						}
-					
-						 _twittersync_process_list_from_database(*(TwitterList *)iter->data, user, arg);
-						iter = iter->next;
-					}
-
+					result = _twittersync_process_lists_from_database(lists, user, arg);
 					twitterdb_free_get_lists_result(lists);
 				}
 			}
@@ -740,8 +1750,6 @@ typedef struct
 	TwitterDbHandle *db;
 	/*! A TwitterWebClient instance. */
 	TwitterWebClient *client;
-	/*! List containing friend ids. */
-	GList *follower_ids;
 	/*! Status. */
 	gboolean success;
 	/*! Guid of the user. */
@@ -750,15 +1758,54 @@ typedef struct
 	gchar username[64];
 	/*! TRUE to synchronize friends. */
 	gboolean sync_friends;
+	/*! Number of added friendships. */
+	guint added;
+	/*! Number of removed friendships. */
+	guint removed;
+	/*! Friend ids of the current page. */
+	GPtrArray *page;
 	/*! AGCancellable. */
 	GCancellable *cancellable;
 } _TwitterSyncFriendData;
 
-/* create friend id list */
+/* collect received friend ids */
 static void
 _twittersync_parse_follower_id(const gchar *user_id, _TwitterSyncFriendData *arg)
 {
-	arg->follower_ids = g_list_append(arg->follower_ids, g_strdup(user_id));
+	g_ptr_array_add(arg->page, g_strdup(user_id));
+}
+
+/* stage the friend ids of the current page */
+static gboolean
+_twittersync_stage_follower_ids(_TwitterSyncFriendData *arg)
+{
+	guint i;
+	GError *err = NULL;
+	gboolean success;
+
+	if((success = _twittersync_begin_batch(arg->db)))
+	{
+		for(i = 0; i < arg->page->len && success; ++i)
+		{
+			if(!(success = twitterdb_stage_follower(arg->db, g_ptr_array_index(arg->page, i), &err)))
+			{
+				g_warning("Couldn't stage friend id \"%s\"", (gchar *)g_ptr_array_index(arg->page, i));
+
+				if(err)
+				{
+					g_warning("%s", err->message);
+					g_error_free(err);
+				}
+			}
+		}
+
+		if(!_twittersync_commit_batch(arg->db))
+		{
+			success = FALSE;
+		}
+	}
+
+	return success;
 }
 
 static gboolean
@@ -767,6 +1814,7 @@ _twittersync_get_follower_ids(_TwitterSyncFriendData *arg, GError **err)
 	gchar *buffer = NULL;
 	gint length;
 	gchar next_cursor[64] = "-1";
+	TwitterXmlStreamParser *parser;
 	const GError *client_err;
 
 	g_assert(arg->success == TRUE);
@@ -779,11 +1827,19 @@ _twittersync_get_follower_ids(_TwitterSyncFriendData *arg, GError **err)
 	{
 		g_debug("username mapped successfully: \"%s\" => \"%s\"", arg->username, arg->user_guid);
 
+		/* remove ids staged by a previous synchronization */
+		arg->success = twitterdb_clear_staged_followers(arg->db, err);
+
 		/* get friend ids */
 		while(g_strcmp0(next_cursor, "0") && (!arg->cancellable || !g_cancellable_is_cancelled(arg->cancellable)) && arg->success)
 		{
 			g_debug("Fetching %s of user: \"%s\", cursor=\"%s\"", arg->sync_friends ? "friends" : "followers", arg->username, next_cursor);
 
+			/* download the page first, the database isn't locked during the transfer */
+			arg->page = g_ptr_array_new_with_free_func(g_free);
+			parser = twitter_xml_stream_parser_new_ids((TwitterProcessIdFunc)_twittersync_parse_follower_id, arg, arg->cancellable);
+			twitter_web_client_set_content_func(arg->client, _twittersync_feed_xml_parser, parser);
+
 			if(arg->sync_friends)
 			{
 				arg->success = twitter_web_client_get_friends(arg->client, arg->username, next_cursor, &buffer, &length);
@@ -793,26 +1849,38 @@ _twittersync_get_follower_ids(_TwitterSyncFriendData *arg, GError **err)
 				arg->success = twitter_web_client_get_followers(arg->client, arg->username, next_cursor, &buffer, &length);
 			}
 
+			twitter_web_client_set_content_func(arg->client, NULL, NULL);
+
 			if(arg->success)
 			{
-				twitter_xml_parse_ids(buffer, length, (TwitterProcessIdFunc)_twittersync_parse_follower_id, next_cursor, 64, arg->cancellable, arg);
+				twitter_xml_stream_parser_get_next_cursor(parser, next_cursor, 64);
+
+				/* stage the page in a single transaction */
+				arg->success = _twittersync_stage_follower_ids(arg);
 			}
 			else
 			{
 				g_warning("Couldn't get friends of user \"%s\"", arg->user_guid);
 
-				if(!err && (client_err = (GError *)twitter_web_client_get_last_error(arg->client)))
+				if(err && !*err && (client_err = (GError *)twitter_web_client_get_last_error(arg->client)))
 				{
 					g_set_error(err, 0, 0, "%s", client_err->message);
 					client_err = NULL;
-					arg->success = FALSE;
 				}
 			}
 
+			twitter_xml_stream_parser_free(parser);
+			g_ptr_array_free(arg->page, TRUE);
+			arg->page = NULL;
+
 			g_free(buffer);
 			buffer = NULL;
 		}
 	}
+	else
+	{
+		arg->success = FALSE;
+	}
 
 	if(arg->cancellable && g_cancellable_is_cancelled(arg->cancellable))
 	{
@@ -822,69 +1890,28 @@ _twittersync_get_follower_ids(_TwitterSyncFriendData *arg, GError **err)
 	return arg->success;
 }
 
-/* remove deleted friends */
+/* replace stored friends by staged ids */
 static gboolean
-_twittersync_remove_deleted_friends(_TwitterSyncFriendData *arg, GError **err)
+_twittersync_reconcile_friends(_TwitterSyncFriendData *arg, GError **err)
 {
-	gchar *follower_id;
-	GList *old_followers;
-	GList *iter = NULL;
-
 	g_assert(arg->success == TRUE);
 
-	/* get old friend ids */
-	g_debug("Getting old %s of user \"%s\" (\"%s\")", arg->sync_friends ? "friends" : "followers", arg->username, arg->user_guid);
-
-	if(arg->sync_friends)
-	{
-		old_followers = twitterdb_get_friends(arg->db, arg->user_guid, err);
-	}
-	else
-	{
-		old_followers = twitterdb_get_followers(arg->db, arg->user_guid, err);
-	}
-
-	if(*err)
-	{
-		arg->success = FALSE;
-	}
-	else
-	{
-		iter = old_followers;
-	}
+	g_debug("Reconciling %s of user \"%s\" (\"%s\")", arg->sync_friends ? "friends" : "followers", arg->username, arg->user_guid);
 
-	/* find deleted ids */
-	while(iter && arg->success)
+	if((arg->success = _twittersync_begin_batch(arg->db)))
 	{
-		follower_id = (gchar *)iter->data;
-		g_debug("Testing %s: \"%s\"", arg->sync_friends ? "friend" : "follower", follower_id);
-
-		if(!g_list_find_custom(arg->follower_ids, follower_id, (GCompareFunc)&g_strcmp0))
-		{
-			g_debug("Removing friendship: \"%s\" => \"%s\"", arg->user_guid, follower_id);
-			arg->success = twitterdb_remove_follower(arg->db, arg->user_guid, follower_id, err);
-		}
+		arg->success = twitterdb_reconcile_followers(arg->db, arg->user_guid, arg->sync_friends, &arg->added, &arg->removed, err);
 
-		if(arg->cancellable && g_cancellable_is_cancelled(arg->cancellable))
+		if(!_twittersync_commit_batch(arg->db))
 		{
 			arg->success = FALSE;
-			break;
 		}
-
-		iter = iter->next;
-	}
-
-	/* cleanup */
-	if(old_followers)
-	{
-		g_list_foreach(old_followers, (GFunc)&g_free, NULL);
-		g_list_free(old_followers);
 	}
 
 	return arg->success;
 }
 
-/* add friends */
+/* add unknown friends */
 static void
 _twittersync_register_follower(TwitterUser user, _TwitterSyncFriendData *arg)
 {
@@ -905,6 +1932,11 @@ _twittersync_register_follower(TwitterUser user, _TwitterSyncFriendData *arg)
 		{
 			arg->success = twitterdb_add_follower(arg->db, user.id, arg->user_guid, &err);
 		}
+
+		if(arg->success)
+		{
+			++arg->added;
+		}
 	}
 
 	/* display & free error message */
@@ -916,40 +1948,28 @@ _twittersync_register_follower(TwitterUser user, _TwitterSyncFriendData *arg)
 }
 
 static void
-_twittersync_add_follower(const gchar *user_id, _TwitterSyncFriendData *arg)
+_twittersync_lookup_followers(const gchar **ids, gint count, _TwitterSyncFriendData *arg)
 {
 	gchar *buffer = NULL;
 	gint length;
-	GError *err = NULL;
 
-	/* check if user has already been registerd */
-	if(twitterdb_user_exists(arg->db, user_id, &err))
-	{
-		/* user exists => update friendship */
-		if(arg->sync_friends)
-		{
-			arg->success = twitterdb_add_follower(arg->db, arg->user_guid, user_id, &err);
-		}
-		else
-		{
-			arg->success = twitterdb_add_follower(arg->db, user_id, arg->user_guid, &err);
-		}
-	}
-	else if(!err)
+	/* register users & update friendships */
+	g_debug("Looking up %d user(s)", count);
+	if((arg->success = twitter_web_client_lookup_users(arg->client, ids, count, &buffer, &length)))
 	{
-		/* user doesn't exist => register user & update friendship */
-		g_debug("Fetching user details (id=\"%s\")", user_id);
-		if((arg->success = twitter_web_client_get_user_details_by_id(arg->client, user_id, &buffer, &length)))
+		if((arg->success = _twittersync_begin_batch(arg->db)))
 		{
-			twitter_xml_parse_user_details(buffer, length, (TwitterProcessUserFunc)_twittersync_register_follower, arg);
+			twitter_xml_parse_users(buffer, length, (TwitterProcessUserFunc)_twittersync_register_follower, arg, arg->cancellable);
+
+			if(!_twittersync_commit_batch(arg->db))
+			{
+				arg->success = FALSE;
+			}
 		}
 	}
-
-	if(err)
+	else
 	{
-		g_warning("%s", err->message);
-		g_error_free(err);
-		arg->success = FALSE;
+		g_warning("Couldn't look up users");
 	}
 
 	g_free(buffer);
@@ -958,32 +1978,47 @@ _twittersync_add_follower(const gchar *user_id, _TwitterSyncFriendData *arg)
 static gboolean
 _twittersync_save_friends(_TwitterSyncFriendData *arg, GError **err)
 {
-	GList *iter = arg->follower_ids;
+	GList *unknown;
+	GList *iter;
+	const gchar *ids[TWITTER_MAX_LOOKUP_USERS];
+	gint count = 0;
 
 	g_assert(arg->success);
 
-	g_debug("Adding received friends.");
+	g_debug("Adding unknown %s.", arg->sync_friends ? "friends" : "followers");
+
+	unknown = twitterdb_get_unknown_staged_followers(arg->db, err);
+
+	if(err && *err)
+	{
+		arg->success = FALSE;
+	}
+
+	iter = unknown;
 
+	/* fetch user details in batches */
 	while(iter && arg->success)
 	{
-		if(arg->sync_friends)
-		{
-			g_debug("Adding friend \"%s\"", (gchar *)iter->data);
-		}
-		else
+		ids[count] = (const gchar *)iter->data;
+		iter = iter->next;
+
+		if(++count == TWITTER_MAX_LOOKUP_USERS || !iter)
 		{
-			g_debug("Adding follower \"%s\"", (gchar *)iter->data);
+			_twittersync_lookup_followers(ids, count, arg);
+			count = 0;
 		}
 
-		_twittersync_add_follower((gchar *)iter->data, arg);
-
 		if(arg->cancellable && g_cancellable_is_cancelled(arg->cancellable))
 		{
 			arg->success = FALSE;
-			break;
 		}
+	}
 
-		iter = iter->next;
+	/* cleanup */
+	if(unknown)
+	{
+		g_list_foreach(unknown, (GFunc)&g_free, NULL);
+		g_list_free(unknown);
 	}
 
 	return arg->success;
@@ -997,29 +2032,34 @@ _twittersync_update_followers(TwitterDbHandle *handle, TwitterWebClient *client,
 	/* initialize argument */
 	arg->db = handle;
 	arg->client = client;
-	arg->follower_ids = NULL;
 	arg->success = TRUE;
 	arg->sync_friends = sync_friends;
+	arg->added = 0;
+	arg->removed = 0;
 	g_strlcpy(arg->username, twitter_web_client_get_username(client), 64);
 	memset(arg->user_guid, 0, 64);
 	arg->cancellable = cancellable;
 
+	/* stop waiting for database locks when synchronization is cancelled */
+	twitterdb_set_cancellable(handle, cancellable);
+
 	/* get friends */
 	if(_twittersync_get_follower_ids(arg, err))
 	{
-		/* removing deleted followers */
-		if(_twittersync_remove_deleted_friends(arg, err))
+		/* replace stored friends by received ones */
+		if(_twittersync_reconcile_friends(arg, err))
 		{
-			/* save new friends */
+			/* fetch details of unknown friends */
 			_twittersync_save_friends(arg, err);
 		}
 	}
 
+	g_debug("%s of user \"%s\" synchronized: %u added, %u removed", sync_friends ? "Friends" : "Followers", arg->username, arg->added, arg->removed);
+
 	/* cleanup */
-	if(arg->follower_ids)
+	if(*arg->user_guid)
 	{
-		g_list_foreach(arg->follower_ids, (GFunc)&g_free, NULL);
-		g_list_free(arg->follower_ids);
+		twitterdb_clear_staged_followers(handle, NULL);
 	}
 
 	return arg->success;
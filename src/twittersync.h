@@ -38,6 +38,26 @@
  * 	@{
  */
 
+/**
+ * \enum TwitterSyncStreamEvent
+ * \brief Events reported while a user stream is processed.
+ */
+typedef enum
+{
+	/*! The first data has been received from the stream. */
+	TWITTERSYNC_STREAM_CONNECTED,
+	/*! Received messages have been written to the database. */
+	TWITTERSYNC_STREAM_UPDATED
+} TwitterSyncStreamEvent;
+
+/**
+ * \param event the reported event
+ * \param user_data user data
+ *
+ * Receives events of a processed user stream. It's invoked by the thread reading the stream.
+ */
+typedef void (* TwitterSyncStreamFunc)(TwitterSyncStreamEvent event, gpointer user_data);
+
 /**
  * \param handle database handle
  * \param client a TwitterWebClient instance
@@ -64,6 +84,22 @@ gboolean twittersync_update_lists(TwitterDbHandle *handle, TwitterWebClient *cli
  */
 gboolean twittersync_update_timelines(TwitterDbHandle *handle, TwitterWebClient *client, gint *status_count, GCancellable *cancellable, GError **err);
 
+/**
+ * \param handle database handle
+ * \param client a TwitterWebClient instance
+ * \param func function receiving stream events or NULL
+ * \param user_data user data passed to func
+ * \param cancellable a GCancellable closing the stream
+ * \param err a GError structure to store failure messages
+ * \return TRUE if the stream has been closed by the remote host.
+ *
+ * Opens the user stream of an account & writes received statuses to the home timeline,
+ * user timeline and replies until the stream is closed, stalls or is cancelled. Deleted
+ * statuses are removed from the database. On failure the code of err is the HTTP status
+ * of the response or 0 on network errors.
+ */
+gboolean twittersync_process_user_stream(TwitterDbHandle *handle, TwitterWebClient *client, TwitterSyncStreamFunc func, gpointer user_data, GCancellable *cancellable, GError **err);
+
 /**
  * \param handle database handle
  * \param client a TwitterWebClient instance
@@ -657,6 +657,8 @@ typedef struct
 	GString *buffer;
 	/*! Holds the found user information. */
 	TwitterUser user;
+	/*! Depth of user elements in the XML tree. */
+	gint user_depth;
 	/*! Callback invoked when a user is found. */
 	TwitterProcessUserFunc parser_func;
 	/*! User data. */
@@ -664,9 +666,10 @@ typedef struct
 } _TwitterXMLUserParserData;
 
 static void
-_twitter_xml_user_data_init(_TwitterXMLUserParserData *data, TwitterProcessUserFunc parser_func, gpointer user_data)
+_twitter_xml_user_data_init(_TwitterXMLUserParserData *data, gint user_depth, TwitterProcessUserFunc parser_func, gpointer user_data)
 {
 	memset(data, 0, sizeof(_TwitterXMLUserParserData));
+	data->user_depth = user_depth;
 	data->parser_func = parser_func;
 	data->user_data = user_data;
 }
@@ -693,6 +696,12 @@ _twitter_xml_user_parser_start_element(GMarkupParseContext *context,
 
 	++data->depth;
 
+	/* reset user */
+	if(data->depth == data->user_depth)
+	{
+		memset(&data->user, 0, sizeof(TwitterUser));
+	}
+
 	/* reset buffer */
 	if(data->depth >= 1)
 	{	
@@ -712,11 +721,11 @@ _twitter_xml_user_parser_end_element(GMarkupParseContext *context, const gchar *
 {
 	_TwitterXMLUserParserData *data = (_TwitterXMLUserParserData *)user_data;
 
-	if(data->depth == 1 && !g_ascii_strcasecmp(element_name, "user"))
+	if(data->depth == data->user_depth && !g_ascii_strcasecmp(element_name, "user"))
 	{
 		data->parser_func(data->user, data->user_data);
 	}
-	else if(data->depth == 2)
+	else if(data->depth == data->user_depth + 1)
 	{
 		_twitter_xml_process_user_section(&data->user, element_name, data->buffer);
 	}
@@ -753,13 +762,41 @@ twitter_xml_parse_user_details(const gchar *xml, gint length, TwitterProcessUser
 
 	g_return_if_fail(parser_func != NULL);
 
-	_twitter_xml_user_data_init(&data, parser_func, user_data);
+	_twitter_xml_user_data_init(&data, 1, parser_func, user_data);
 	ctx = g_markup_parse_context_new(&_twitter_xml_user_parser, 0, (gpointer)&data, NULL);
 	g_markup_parse_context_parse(ctx, xml, length, NULL);
 	g_markup_parse_context_free(ctx);
 	_twitter_xml_user_data_free(data);
 }
 
+void
+twitter_xml_parse_users(const gchar *xml, gint length, TwitterProcessUserFunc parser_func, gpointer user_data, GCancellable *cancellable)
+{
+	GMarkupParseContext *ctx;
+	_TwitterXMLUserParserData data;
+	gint offset = 0;
+	gint size = 128;
+
+	g_return_if_fail(parser_func != NULL);
+
+	_twitter_xml_user_data_init(&data, 2, parser_func, user_data);
+	ctx = g_markup_parse_context_new(&_twitter_xml_user_parser, 0, (gpointer)&data, NULL);
+
+	while((offset < length) && (!cancellable || !g_cancellable_is_cancelled(cancellable)))
+	{
+		if(offset + size > length)
+		{
+			size = length - offset;
+		}
+	
+		g_markup_parse_context_parse(ctx, xml + offset, size, NULL);
+		offset += size;
+	}
+
+	g_markup_parse_context_free(ctx);
+	_twitter_xml_user_data_free(data);
+}
+
 /*
  *	Twitter direct message parsing:
  */
@@ -1242,6 +1279,109 @@ twitter_xml_parse_ids(const gchar *xml, gint length, TwitterProcessIdFunc parser
 	_twitter_xml_id_data_free(data);
 }
 
+/*
+ *	incremental parsing:
+ */
+
+/*!
+ * \struct _TwitterXmlStreamParser
+ * \brief Parses XML data passed block by block.
+ */
+struct _TwitterXmlStreamParser
+{
+	/*! The parse context. */
+	GMarkupParseContext *ctx;
+	/*! Data passed to the GMarkupParser functions. */
+	gpointer data;
+	/*! Next cursor found in the parsed data. */
+	const gchar *next_cursor;
+	/*! Frees the parser data. */
+	GDestroyNotify free_data;
+	/*! A GCancellable to abort the operation. */
+	GCancellable *cancellable;
+};
+
+static void
+_twitter_xml_stream_free_id_data(gpointer data)
+{
+	_twitter_xml_id_data_free(*(_TwitterXMLIdParserData *)data);
+	g_slice_free(_TwitterXMLIdParserData, data);
+}
+
+static void
+_twitter_xml_stream_free_list_members_data(gpointer data)
+{
+	_twitter_xml_list_members_data_free(*(_TwitterXMLListMembersParserData *)data);
+	g_slice_free(_TwitterXMLListMembersParserData, data);
+}
+
+TwitterXmlStreamParser *
+twitter_xml_stream_parser_new_ids(TwitterProcessIdFunc parser_func, gpointer user_data, GCancellable *cancellable)
+{
+	TwitterXmlStreamParser *parser;
+	_TwitterXMLIdParserData *data;
+
+	g_return_val_if_fail(parser_func != NULL, NULL);
+
+	data = g_slice_new(_TwitterXMLIdParserData);
+	_twitter_xml_id_data_init(data, parser_func, user_data);
+
+	parser = g_slice_new(TwitterXmlStreamParser);
+	parser->ctx = g_markup_parse_context_new(&_twitter_xml_id_parser, 0, (gpointer)data, NULL);
+	parser->data = data;
+	parser->next_cursor = data->next_cursor;
+	parser->free_data = _twitter_xml_stream_free_id_data;
+	parser->cancellable = cancellable;
+
+	return parser;
+}
+
+TwitterXmlStreamParser *
+twitter_xml_stream_parser_new_list_members(TwitterProcessListMemberFunc parser_func, gpointer user_data, GCancellable *cancellable)
+{
+	TwitterXmlStreamParser *parser;
+	_TwitterXMLListMembersParserData *data;
+
+	g_return_val_if_fail(parser_func != NULL, NULL);
+
+	data = g_slice_new(_TwitterXMLListMembersParserData);
+	_twitter_xml_list_members_data_init(data, parser_func, user_data);
+
+	parser = g_slice_new(TwitterXmlStreamParser);
+	parser->ctx = g_markup_parse_context_new(&_twitter_xml_list_members_parser, 0, (gpointer)data, NULL);
+	parser->data = data;
+	parser->next_cursor = data->next_cursor;
+	parser->free_data = _twitter_xml_stream_free_list_members_data;
+	parser->cancellable = cancellable;
+
+	return parser;
+}
+
+gboolean
+twitter_xml_stream_parser_feed(TwitterXmlStreamParser *parser, const gchar *xml, gsize length)
+{
+	if(parser->cancellable && g_cancellable_is_cancelled(parser->cancellable))
+	{
+		return FALSE;
+	}
+
+	return g_markup_parse_context_parse(parser->ctx, xml, length, NULL);
+}
+
+void
+twitter_xml_stream_parser_get_next_cursor(TwitterXmlStreamParser *parser, gchar next_cursor[], gint cursor_size)
+{
+	g_strlcpy(next_cursor, parser->next_cursor, cursor_size);
+}
+
+void
+twitter_xml_stream_parser_free(TwitterXmlStreamParser *parser)
+{
+	g_markup_parse_context_free(parser->ctx);
+	parser->free_data(parser->data);
+	g_slice_free(TwitterXmlStreamParser, parser);
+}
+
 /*
  *	single status parsing:
  */
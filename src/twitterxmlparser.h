@@ -36,6 +36,9 @@
  * 	@{
  */
 
+/*! A type definition for _TwitterXmlStreamParser. */
+typedef struct _TwitterXmlStreamParser TwitterXmlStreamParser;
+
 /**
  * \param xml XML data
  * \param length length of the XML data
@@ -90,6 +93,17 @@ void twitter_xml_parse_list_members(const gchar *xml, gint length, TwitterProces
  */
 void twitter_xml_parse_user_details(const gchar *xml, gint length, TwitterProcessUserFunc parser_func, gpointer user_data);
 
+/**
+ * \param xml XML data
+ * \param length length of the XML data
+ * \param parser_func callback to invoke when a user is found
+ * \param user_data user data 
+ * \param cancellable a GCancellable to abort the operation
+ *
+ * Parses a list of users (e.g. the result of a user lookup).
+ */
+void twitter_xml_parse_users(const gchar *xml, gint length, TwitterProcessUserFunc parser_func, gpointer user_data, GCancellable *cancellable);
+
 /**
  * \param xml XML data
  * \param length length of the XML data
@@ -123,6 +137,52 @@ gboolean twitter_xml_parse_friendship(const gchar *xml, gint length, TwitterFrie
  */
 void twitter_xml_parse_ids(const gchar *xml, gint length, TwitterProcessIdFunc parser_func, gchar next_cursor[], gint cursor_size, GCancellable *cancellable, gpointer user_data);
 
+/**
+ * \param parser_func callback to invoke when an id is found
+ * \param user_data user data
+ * \param cancellable a GCancellable to abort the operation
+ * \return a new TwitterXmlStreamParser
+ *
+ * Creates a parser for ids which can be fed block by block.
+ */
+TwitterXmlStreamParser *twitter_xml_stream_parser_new_ids(TwitterProcessIdFunc parser_func, gpointer user_data, GCancellable *cancellable);
+
+/**
+ * \param parser_func callback to invoke when a list member is found
+ * \param user_data user data
+ * \param cancellable a GCancellable to abort the operation
+ * \return a new TwitterXmlStreamParser
+ *
+ * Creates a parser for list members which can be fed block by block.
+ */
+TwitterXmlStreamParser *twitter_xml_stream_parser_new_list_members(TwitterProcessListMemberFunc parser_func, gpointer user_data, GCancellable *cancellable);
+
+/**
+ * \param parser a TwitterXmlStreamParser
+ * \param xml XML data
+ * \param length length of the XML data
+ * \return FALSE if the data is invalid or the operation has been cancelled
+ *
+ * Parses the next block of XML data.
+ */
+gboolean twitter_xml_stream_parser_feed(TwitterXmlStreamParser *parser, const gchar *xml, gsize length);
+
+/**
+ * \param parser a TwitterXmlStreamParser
+ * \param next_cursor location to store the next cursor
+ * \param cursor_size size of the buffer to store the next cursor
+ *
+ * Copies the next cursor found in the parsed data.
+ */
+void twitter_xml_stream_parser_get_next_cursor(TwitterXmlStreamParser *parser, gchar next_cursor[], gint cursor_size);
+
+/**
+ * \param parser a TwitterXmlStreamParser
+ *
+ * Frees a TwitterXmlStreamParser.
+ */
+void twitter_xml_stream_parser_free(TwitterXmlStreamParser *parser);
+
 /**
  * \param xml XML data
  * \param length length of the XML data
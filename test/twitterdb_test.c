@@ -0,0 +1,359 @@
+/***************************************************************************
+    begin........: October 2011
+    copyright....: Sebastian Fedrau
+    email........: lord-kefir@arcor.de
+ ***************************************************************************/
+
+/***************************************************************************
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+    General Public License for more details.
+ ***************************************************************************/
+/*!
+ * \file twitterdb_test.c
+ * \brief Tests of the database layer, run against a temporary database file.
+ * \author Sebastian Fedrau <lord-kefir@arcor.de>
+ * \version 0.1.0
+ * \date 17. October 2011
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <glib.h>
+#include <glib/gstdio.h>
+
+#include "../src/twitterdb.h"
+#include "../src/twitterdb_queries.h"
+#include "../src/application.h"
+
+/*! Number of threads writing to the database. */
+#define TEST_CONTENTION_WRITERS    DATABASE_POOL_SIZE
+/*! Number of threads reading from the database. */
+#define TEST_CONTENTION_READERS    DATABASE_POOL_SIZE
+/*! Number of transactions or queries per thread. */
+#define TEST_CONTENTION_ITERATIONS 50
+
+/**
+ * \struct _TestContentionWorker
+ * \brief Data of a thread started by _test_contention().
+ */
+typedef struct
+{
+	/*! TRUE to save users, FALSE to look them up. */
+	gboolean writer;
+	/*! Identifies the thread. */
+	gint id;
+	/*! The first failure. */
+	GError *err;
+} _TestContentionWorker;
+
+/*
+ *	helpers:
+ */
+static gint
+_test_count_rows(const gchar *filename, const gchar *table)
+{
+	sqlite3 *db;
+	sqlite3_stmt *stmt;
+	gchar *query;
+	gint count = -1;
+
+	if(sqlite3_open_v2(filename, &db, SQLITE_OPEN_READONLY, NULL) == SQLITE_OK)
+	{
+		query = g_strdup_printf("SELECT COUNT(*) FROM \"%s\"", table);
+
+		if(sqlite3_prepare_v2(db, query, -1, &stmt, NULL) == SQLITE_OK)
+		{
+			if(sqlite3_step(stmt) == SQLITE_ROW)
+			{
+				count = sqlite3_column_int(stmt, 0);
+			}
+
+			sqlite3_finalize(stmt);
+		}
+
+		g_free(query);
+	}
+
+	sqlite3_close(db);
+
+	return count;
+}
+
+/*
+ *	query plans:
+ */
+static gboolean
+_test_query_uses_index(sqlite3 *db, const gchar *query, const gchar *index)
+{
+	gchar *sql;
+	gchar *pattern;
+	sqlite3_stmt *stmt;
+	const gchar *detail;
+	gboolean found = FALSE;
+	gboolean sorted = FALSE;
+
+	sql = g_strconcat("EXPLAIN QUERY PLAN ", query, NULL);
+	pattern = g_strconcat("INDEX ", index, " ", NULL);
+
+	if(sqlite3_prepare_v2(db, sql, -1, &stmt, NULL) == SQLITE_OK)
+	{
+		while(sqlite3_step(stmt) == SQLITE_ROW)
+		{
+			/* the plan description is stored in the last column */
+			if((detail = (const gchar *)sqlite3_column_text(stmt, sqlite3_column_count(stmt) - 1)))
+			{
+				if(strstr(detail, pattern))
+				{
+					found = TRUE;
+				}
+
+				if(strstr(detail, "TEMP B-TREE"))
+				{
+					sorted = TRUE;
+				}
+			}
+		}
+
+		sqlite3_finalize(stmt);
+	}
+	else
+	{
+		g_printerr("Couldn't prepare statement: %s\n", sqlite3_errmsg(db));
+	}
+
+	if(!found || sorted)
+	{
+		g_printerr("Query isn't answered from index \"%s\": %s\n", index, query);
+	}
+
+	g_free(sql);
+	g_free(pattern);
+
+	return found && !sorted;
+}
+
+static gboolean
+_test_query_plans(const gchar *filename)
+{
+	sqlite3 *db;
+	const gchar *queries[] =
+	{
+		twitterdb_queries_get_tweets_from_timeline,
+		twitterdb_queries_get_new_tweets_from_timeline,
+		twitterdb_queries_get_tweets_from_list,
+		twitterdb_queries_count_unread_in_timeline,
+		twitterdb_queries_count_unread_in_list,
+		NULL
+	};
+	const gchar *indexes[] = { "timeline_page", "timeline_page", "list_timeline_page", "timeline_page", "list_timeline_page" };
+	gint i;
+	gboolean result = FALSE;
+
+	/* the plan text is the one of the bundled SQLite version */
+	if(sqlite3_open_v2(filename, &db, SQLITE_OPEN_READONLY, NULL) == SQLITE_OK)
+	{
+		result = TRUE;
+
+		for(i = 0; queries[i]; ++i)
+		{
+			if(!_test_query_uses_index(db, queries[i], indexes[i]))
+			{
+				result = FALSE;
+			}
+		}
+	}
+
+	sqlite3_close(db);
+
+	return result;
+}
+
+/*
+ *	concurrent access:
+ */
+static gpointer
+_test_contention_worker(_TestContentionWorker *worker)
+{
+	TwitterDbHandle *handle;
+	gchar guid[32];
+	gchar username[64];
+	gint i;
+	gboolean result = TRUE;
+
+	for(i = 0; i < TEST_CONTENTION_ITERATIONS && result; ++i)
+	{
+		/* take a pooled connection for every iteration */
+		if(!(handle = twitterdb_get_handle(&worker->err)))
+		{
+			break;
+		}
+
+		g_snprintf(guid, 32, "%d", worker->id * TEST_CONTENTION_ITERATIONS + i + 1);
+
+		if(worker->writer)
+		{
+			/* save each user in its own write batch */
+			g_snprintf(username, 64, "user%s", guid);
+
+			if((result = twitterdb_begin_batch(handle, &worker->err)))
+			{
+				if((result = twitterdb_save_user(handle, guid, username, username, "", "", "", "", &worker->err)))
+				{
+					result = twitterdb_commit_batch(handle, &worker->err);
+				}
+				else
+				{
+					twitterdb_rollback_batch(handle);
+				}
+			}
+		}
+		else
+		{
+			/* read while the writers hold the write lock */
+			twitterdb_user_exists(handle, guid, &worker->err);
+			result = worker->err == NULL;
+		}
+
+		twitterdb_close_handle(handle);
+	}
+
+	return NULL;
+}
+
+static gboolean
+_test_contention(const gchar *filename)
+{
+	_TestContentionWorker workers[TEST_CONTENTION_WRITERS + TEST_CONTENTION_READERS];
+	GThread *threads[TEST_CONTENTION_WRITERS + TEST_CONTENTION_READERS];
+	gint count = TEST_CONTENTION_WRITERS + TEST_CONTENTION_READERS;
+	gint rows;
+	gint i;
+	gboolean result = TRUE;
+
+	/* start writers & readers */
+	for(i = 0; i < count; ++i)
+	{
+		workers[i].writer = i < TEST_CONTENTION_WRITERS;
+		workers[i].id = i;
+		workers[i].err = NULL;
+
+		if(!(threads[i] = g_thread_create((GThreadFunc)_test_contention_worker, &workers[i], TRUE, &workers[i].err)))
+		{
+			g_printerr("Couldn't start worker %d\n", i);
+		}
+	}
+
+	/* wait for workers */
+	for(i = 0; i < count; ++i)
+	{
+		if(threads[i])
+		{
+			g_thread_join(threads[i]);
+		}
+
+		if(workers[i].err)
+		{
+			g_printerr("%s %d failed: %s\n", workers[i].writer ? "Writer" : "Reader", i, workers[i].err->message);
+			g_error_free(workers[i].err);
+			result = FALSE;
+		}
+	}
+
+	/* every committed user must have been stored */
+	if((rows = _test_count_rows(filename, "user")) != TEST_CONTENTION_WRITERS * TEST_CONTENTION_ITERATIONS)
+	{
+		g_printerr("Found %d of %d saved users\n", rows, TEST_CONTENTION_WRITERS * TEST_CONTENTION_ITERATIONS);
+		result = FALSE;
+	}
+
+	return result;
+}
+
+/*
+ *	main:
+ */
+static gboolean
+_test_run(const gchar *name, gboolean (* test)(const gchar *filename), const gchar *filename)
+{
+	gboolean result;
+
+	g_print("%s... ", name);
+	result = test(filename);
+	g_print("%s\n", result ? "PASS" : "FAIL");
+
+	return result;
+}
+
+/**
+ * \param argc number of arguments
+ * \param argv specified arguments
+ * \return EXIT_SUCCESS if all tests have passed
+ *
+ * Creates a temporary database with the current model and runs the tests on it.
+ */
+int
+main(int argc, char *argv[])
+{
+	gchar *filename = NULL;
+	gchar *path;
+	TwitterDbHandle *handle;
+	gint fd;
+	GError *err = NULL;
+	gboolean result = FALSE;
+
+	g_thread_init(NULL);
+
+	/* create temporary database */
+	if((fd = g_file_open_tmp("twitterdb-test-XXXXXX.db", &filename, &err)) != -1)
+	{
+		close(fd);
+		twitterdb_set_filename(filename);
+
+		if((handle = twitterdb_get_handle(&err)))
+		{
+			result = twitterdb_init(handle, DATABASE_MODEL_MAJOR, DATABASE_MODEL_MINOR, TRUE, &err);
+			twitterdb_close_handle(handle);
+		}
+	}
+
+	if(err)
+	{
+		g_printerr("Couldn't create test database: %s\n", err->message);
+		g_error_free(err);
+	}
+
+	/* run tests */
+	if(result)
+	{
+		result = _test_run("Paging and unread query plans", _test_query_plans, filename);
+		result = _test_run("Concurrent writers and readers", _test_contention, filename) && result;
+	}
+
+	/* cleanup */
+	twitterdb_cleanup();
+
+	if(filename)
+	{
+		g_remove(filename);
+
+		path = g_strconcat(filename, "-wal", NULL);
+		g_remove(path);
+		g_free(path);
+
+		path = g_strconcat(filename, "-shm", NULL);
+		g_remove(path);
+		g_free(path);
+
+		g_free(filename);
+	}
+
+	return result ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+